@@ -1,4 +1,4 @@
-from typing import Any, Callable, Union
+from typing import Any, Callable, Optional, Union
 from typing_extensions import final
 
 from aerospike_helpers.batch.records import BatchRecords
@@ -253,6 +253,9 @@ POLICY_GEN_GT: int
 POLICY_GEN_IGNORE: int
 POLICY_KEY_DIGEST: int
 POLICY_KEY_SEND: int
+POLICY_PRIORITY_BULK: int
+POLICY_PRIORITY_DEFAULT: int
+POLICY_PRIORITY_INTERACTIVE: int
 POLICY_READ_MODE_AP_ALL: int
 POLICY_READ_MODE_AP_ONE: int
 POLICY_READ_MODE_SC_ALLOW_REPLICA: int
@@ -326,17 +329,22 @@ class Client:
     def batch_remove(self, keys: list, policy_batch: dict = ..., policy_batch_remove: dict = ...) -> BatchRecords: ...
     def batch_read(self, keys: list, bins: list[str] = ..., policy_batch: dict = ...) -> BatchRecords: ...
     def batch_write(self, batch_records: BatchRecords, policy_batch: dict = ...) -> BatchRecords: ...
+    def clear_read_cache(self) -> None: ...
     def close(self) -> None: ...
-    def connect(self, username: str = ..., password: str = ...) -> Client: ...
+    def connect(self, username: str = ..., password: str = ..., *, lazy: bool = ..., snapshot: bytes = ...) -> Client: ...
     def exists(self, key: tuple, policy: dict = ...) -> tuple: ...
     def exists_many(self, keys: list, policy: dict = ...) -> list: ...
+    def export_cluster_snapshot(self) -> bytes: ...
     def get(self, key: tuple, policy: dict = ...) -> tuple: ...
     def get_cdtctx_base64(self, ctx: list) -> str: ...
+    def get_command_limit_stats(self) -> Union[list, None]: ...
     def get_expression_base64(self, expression) -> str: ...
     def get_key_partition_id(self, ns, set, key) -> int: ...
     def get_many(self, keys: list, policy: dict = ...) -> list: ...
+    def get_node_latencies(self) -> Union[dict, None]: ...
     def get_node_names(self) -> list: ...
     def get_nodes(self) -> list: ...
+    def get_read_cache_stats(self) -> Union[dict, None]: ...
     def increment(self, key: tuple, bin: str, offset: int, meta: dict = ..., policy: dict = ...) -> None: ...
     def index_cdt_create(self, *args, **kwargs) -> Any: ...
     def index_geo2dsphere_create(self, ns: str, set: str, bin: str, name: str, policy: dict = ...) -> None: ...
@@ -422,6 +430,14 @@ class GeoJSON:
     def unwrap(self) -> dict: ...
     def wrap(self, geo_data: dict) -> None: ...
 
+@final
+class Key(tuple):
+    namespace: str
+    set: Optional[str]
+    key: Union[str, int, bytes, bytearray, None]
+    digest: bytes
+    def __new__(cls, namespace: str, set: Optional[str], key: Union[str, int, bytes, bytearray, None] = ..., digest: Union[bytes, bytearray, None] = ...) -> Key: ...
+
 class KeyOrderedDict(dict):
     def __init__(self, *args, **kwargs) -> None: ...
 
@@ -432,28 +448,34 @@ class Query:
     def __init__(self, *args, **kwargs) -> None: ...
     def add_ops(self, ops: list) -> None: ...
     def apply(self, module: str, function: str, arguments: list = ...) -> Any: ...
+    def checkpoint(self) -> bytes: ...
     def execute_background(self, policy: dict = ...) -> int: ...
     def foreach(self, callback: Callable, policy: dict = ..., options: dict = ...) -> None: ...
     def get_partitions_status(self) -> tuple: ...
     def is_done(self) -> bool: ...
     def paginate(self) -> None: ...
     def results(self, policy: dict = ..., options: dict = ...) -> list: ...
+    def resume(self, checkpoint: bytes) -> None: ...
     # TODO: this isn't an infinite list of bins
     def select(self, *args, **kwargs) -> None: ...
+    def split(self, n: int) -> list[dict]: ...
     def where(self, predicate: tuple, ctx: list = ...) -> None: ...
 
 class Scan:
     def __init__(self, *args, **kwargs) -> None: ...
     def add_ops(self, ops: list) -> None: ...
     def apply(self, module: str, function: str, arguments: list = ...) -> Any: ...
+    def checkpoint(self) -> bytes: ...
     def foreach(self, callback: Callable, policy: dict = ..., options: dict = ..., nodename: str = ...) -> None: ...
     def execute_background(self, policy: dict = ...) -> int: ...
     def get_partitions_status(self) -> tuple: ...
     def is_done(self) -> bool: ...
     def paginate(self) -> None: ...
     def results(self, policy: dict = ..., nodename: str = ...) -> list: ...
+    def resume(self, checkpoint: bytes) -> None: ...
     # TODO: this isn't an infinite list of bins
     def select(self, *args, **kwargs) -> None: ...
+    def split(self, n: int) -> list[dict]: ...
 
 @final
 class null:
@@ -463,11 +485,14 @@ def calc_digest(ns: str, set: str, key: Union[str, int, bytearray]) -> bytearray
 def client(config: dict) -> Client: ...
 def geodata(geo_data: dict) -> GeoJSON: ...
 def geojson(geojson_str: str) -> GeoJSON: ...
+def get_allocator_stats() -> dict: ...
 def get_cdtctx_base64(ctx: list) -> str: ...
 def get_expression_base64(expression) -> str: ...
 def get_partition_id(*args, **kwargs) -> Any: ...
-def set_deserializer(callback: Callable) -> None: ...
+def set_deserializer(callback: Callable, batch: bool = False, buffer: bool = False) -> None: ...
+def drain_logs() -> int: ...
+def get_log_stats() -> dict[str, int]: ...
 def set_log_handler(callback: Callable = ...) -> None: ...
 def set_log_level(log_level: int) -> None: ...
-def set_serializer(callback: Callable) -> None: ...
+def set_serializer(callback: Callable, batch: bool = False) -> None: ...
 def unset_serializers() -> None: ...
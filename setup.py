@@ -215,6 +215,8 @@ setup(
             [
                 'src/main/aerospike.c',
                 'src/main/exception.c',
+                'src/main/fastcall.c',
+                'src/main/interpreter.c',
                 'src/main/log.c',
                 'src/main/client/type.c',
                 'src/main/client/apply.c',
@@ -226,6 +228,16 @@ setup(
                 'src/main/client/cdt_operation_utils.c',
                 'src/main/client/close.c',
                 'src/main/client/connect.c',
+                'src/main/client/cluster_snapshot.c',
+                'src/main/client/read_cache.c',
+                'src/main/client/single_flight.c',
+                'src/main/client/auto_batch.c',
+                'src/main/client/hedged_read.c',
+                'src/main/client/latency_router.c',
+                'src/main/client/adaptive_policy.c',
+                'src/main/client/command_limits.c',
+                'src/main/client/fork.c',
+                'src/main/client/client_utils.c',
                 'src/main/client/exists.c',
                 'src/main/client/exists_many.c',
                 'src/main/client/get.c',
@@ -272,16 +284,23 @@ setup(
                 'src/main/geospatial/unwrap.c',
                 'src/main/geospatial/loads.c',
                 'src/main/geospatial/dumps.c',
+                'src/main/geospatial/json.c',
                 'src/main/policy.c',
+                'src/main/latency_window.c',
+                'src/main/allocator.c',
                 'src/main/conversions.c',
+                'src/main/msgpack_conversions.c',
+                'src/main/msgpack_writer.c',
+                'src/main/native_serializer.c',
                 'src/main/convert_expressions.c',
                 'src/main/policy_config.c',
                 'src/main/calc_digest.c',
                 'src/main/predicates.c',
                 'src/main/tls_config.c',
-                'src/main/global_hosts/type.c',
+                'src/main/global_hosts/registry.c',
                 'src/main/nullobject/type.c',
                 'src/main/cdt_types/type.c',
+                'src/main/key_object/type.c',
                 'src/main/key_ordered_dict/type.c',
                 'src/main/client/set_xdr_filter.c',
                 'src/main/client/get_expression_base64.c',
@@ -0,0 +1,52 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include <Python.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <aerospike/as_error.h>
+#include <aerospike/as_policy.h>
+
+#include "types.h"
+
+/**
+ * Creates the adaptive policy described by the "adaptive_timeouts" and
+ * "retry_budget" dicts of the client config, either of which may be NULL.
+ * Returns NULL and sets err if the config is invalid.
+ */
+adaptive_policy *adaptive_policy_new(PyObject *py_timeouts,
+                                     PyObject *py_budget, as_error *err);
+
+void adaptive_policy_destroy(adaptive_policy *adaptive);
+
+/**
+ * Adjusts the socket timeout and retries of policy, the base policy of a
+ * single-record read or write, before the command is sent. Returns the time
+ * the command starts, to be passed to adaptive_policy_end(), or 0 if the
+ * client has no adaptive policy.
+ */
+uint64_t adaptive_policy_begin(AerospikeClient *self, as_policy_base *policy,
+                               bool read);
+
+/**
+ * Records the latency and outcome of a command started with
+ * adaptive_policy_begin().
+ */
+void adaptive_policy_end(AerospikeClient *self, uint64_t start, bool read,
+                         as_error *err);
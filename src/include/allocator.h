@@ -0,0 +1,69 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include <Python.h>
+#include <stddef.h>
+
+/**
+ * Where the binding's own allocations are counted. Memory handed to the C
+ * client, which frees it with cf_free(), must not come from here, so the
+ * values converted by conversions.c and policy.c are not counted.
+ */
+typedef enum {
+    // Per-client structures of the optional features.
+    ALLOCATOR_CLIENT,
+    // Batch record policies and automatic batches.
+    ALLOCATOR_BATCH,
+    // Read cache entries and coalesced reads.
+    ALLOCATOR_READ_CACHE,
+    // Hedged read calls.
+    ALLOCATOR_HEDGED_READ,
+    // Bin names and other strings copied for the length of a command.
+    ALLOCATOR_OPERATIONS,
+    ALLOCATOR_SUBSYSTEMS
+} allocator_subsystem;
+
+/**
+ * Selects the allocator from the AEROSPIKE_ALLOCATOR environment variable,
+ * once per process: "system" (the default), "pymem" for PyMem_RawMalloc(),
+ * which tracemalloc sees, or "cached" for size classes cached per thread.
+ * Called with the GIL held when the module is imported.
+ */
+int Aerospike_Init_Allocator(void);
+
+/**
+ * Thread safe and callable without the GIL. Return NULL when out of memory.
+ */
+void *allocator_malloc(allocator_subsystem subsystem, size_t size);
+void *allocator_calloc(allocator_subsystem subsystem, size_t count,
+                       size_t size);
+void *allocator_realloc(allocator_subsystem subsystem, void *ptr, size_t size);
+char *allocator_strdup(allocator_subsystem subsystem, const char *str);
+void allocator_free(void *ptr);
+
+/**
+ * Held across fork() so the child sees consistent free lists.
+ */
+void allocator_fork_lock(void);
+void allocator_fork_unlock(void);
+
+/**
+ * Python functions
+ *          aerospike.get_allocator_stats()
+ */
+PyObject *Aerospike_Get_Allocator_Stats(PyObject *parent, PyObject *args);
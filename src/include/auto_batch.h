@@ -0,0 +1,71 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include <Python.h>
+#include <stdbool.h>
+
+#include <aerospike/as_error.h>
+#include <aerospike/as_key.h>
+#include <aerospike/as_record.h>
+
+#include "types.h"
+
+/**
+ * Batch records shared by the reads merged into one batch command. Each
+ * reader releases it once its record is converted.
+ */
+typedef struct auto_batch_records_s auto_batch_records;
+
+/**
+ * Creates the batcher described by the "auto_batch" dict of the client
+ * config. Returns NULL and sets err if the config is invalid.
+ */
+auto_batcher *auto_batcher_new(PyObject *py_config, as_error *err);
+
+void auto_batcher_destroy(auto_batcher *batcher);
+
+/**
+ * Returns true if a get() of key with py_policy can be merged into a batch.
+ */
+bool auto_batch_covers_get(AerospikeClient *self, PyObject *py_policy,
+                           as_key *key);
+
+/**
+ * Reads key as part of the next batch read. On success rec points into
+ * batch, which must be released with auto_batch_release() once rec is no
+ * longer used. Must be called with the GIL held; releases it while waiting.
+ */
+as_status auto_batch_get(AerospikeClient *self, as_key *key, as_error *err,
+                         as_record **rec, auto_batch_records **batch);
+
+void auto_batch_release(auto_batch_records *batch);
+
+/**
+ * Returns true if a put() of rec under key with py_policy can be merged into
+ * a batch.
+ */
+bool auto_batch_covers_put(AerospikeClient *self, PyObject *py_policy,
+                           as_key *key, as_record *rec);
+
+/**
+ * Writes rec as part of the next batch write. The bin values of rec are
+ * moved out of it. Must be called with the GIL held; releases it while
+ * waiting.
+ */
+as_status auto_batch_put(AerospikeClient *self, as_key *key, as_record *rec,
+                         as_error *err);
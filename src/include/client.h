@@ -35,7 +35,7 @@
  * CLIENT TYPE
  ******************************************************************************/
 
-PyTypeObject *AerospikeClient_Ready(void);
+PyTypeObject *AerospikeClient_Ready(PyObject *module);
 
 /**
  * Create a new Aerospike client object and connect to the database.
@@ -50,7 +50,7 @@ AerospikeClient *AerospikeClient_New(PyObject *self, PyObject *args,
 /**
  * Connect to the database.
  */
-int AerospikeClientConnect(AerospikeClient *self);
+int AerospikeClientConnect(AerospikeClient *self, bool lazy);
 
 PyObject *AerospikeClient_Connect(AerospikeClient *self, PyObject *args,
                                   PyObject *kwds);
@@ -67,12 +67,63 @@ PyObject *AerospikeClient_Close(AerospikeClient *self, PyObject *args,
 PyObject *AerospikeClient_is_connected(AerospikeClient *self, PyObject *args,
                                        PyObject *kwds);
 
+/**
+ * Finish a lazy connect, waiting for it if block is set.
+ */
+int AerospikeClient_Await_Connect(AerospikeClient *self, bool block);
+
+/**
+ * Finish a lazy connect or a reconnect after fork() before the client is
+ * used.
+ */
+int AerospikeClient_Ensure_Connected(AerospikeClient *self);
+
+/**
+ * Export the known nodes of the cluster.
+ *          client.export_cluster_snapshot()
+ */
+PyObject *AerospikeClient_Export_Cluster_Snapshot(AerospikeClient *self,
+                                                  PyObject *args);
+
+/**
+ * Add the nodes of an exported cluster snapshot to the seeds.
+ */
+as_status apply_cluster_snapshot(as_config *config, PyObject *py_snapshot,
+                                 as_error *err);
+
+/**
+ * Move the first seed to accept a connection to the front of the seeds.
+ */
+void probe_cluster_seeds(as_config *config);
+
 /**
  * Get the shm_key to the cluster.
  */
 PyObject *AerospikeClient_shm_key(AerospikeClient *self, PyObject *args,
                                   PyObject *kwds);
 
+/*******************************************************************************
+ * FORK HANDLING
+ ******************************************************************************/
+
+/**
+ * Register the pthread_atfork() handler that drops inherited clusters in the
+ * child process.
+ */
+void Aerospike_Init_Fork_Handler(void);
+
+/**
+ * Add a connected client to, or remove it from, the fork handler's list.
+ */
+void AerospikeClient_Fork_Track(AerospikeClient *self);
+void AerospikeClient_Fork_Untrack(AerospikeClient *self);
+
+/**
+ * Connect a client inherited across fork() again. Called on first use of the
+ * client in the child.
+ */
+int AerospikeClient_Reconnect_After_Fork(AerospikeClient *self);
+
 /*******************************************************************************
  * KVS OPERATIONS
  ******************************************************************************/
@@ -97,8 +148,8 @@ PyObject *AerospikeClient_Apply_Invoke(AerospikeClient *self, PyObject *py_key,
  *		client.exists((x,y,z))
  *
  */
-PyObject *AerospikeClient_Exists(AerospikeClient *self, PyObject *args,
-                                 PyObject *kwds);
+PyObject *AerospikeClient_Exists(AerospikeClient *self, PyObject *const *args,
+                                 Py_ssize_t nargs, PyObject *kwnames);
 
 PyObject *AerospikeClient_Exists_Invoke(AerospikeClient *self, PyObject *py_key,
                                         PyObject *py_policy);
@@ -109,8 +160,8 @@ PyObject *AerospikeClient_Exists_Invoke(AerospikeClient *self, PyObject *py_key,
  *		client.get((x,y,z))
  *
  */
-PyObject *AerospikeClient_Get(AerospikeClient *self, PyObject *args,
-                              PyObject *kwds);
+PyObject *AerospikeClient_Get(AerospikeClient *self, PyObject *const *args,
+                              Py_ssize_t nargs, PyObject *kwnames);
 
 PyObject *AerospikeClient_Get_Invoke(AerospikeClient *self, PyObject *py_key,
                                      PyObject *py_policy);
@@ -121,8 +172,8 @@ PyObject *AerospikeClient_Get_Invoke(AerospikeClient *self, PyObject *py_key,
  *		client.select((x,y,z), (bin1, bin2, bin3))
  *
  */
-PyObject *AerospikeClient_Select(AerospikeClient *self, PyObject *args,
-                                 PyObject *kwds);
+PyObject *AerospikeClient_Select(AerospikeClient *self, PyObject *const *args,
+                                 Py_ssize_t nargs, PyObject *kwnames);
 
 /**
  * Write a record in the database.
@@ -130,8 +181,8 @@ PyObject *AerospikeClient_Select(AerospikeClient *self, PyObject *args,
  *		client.put((x,y,z), ...)
  *
  */
-PyObject *AerospikeClient_Put(AerospikeClient *self, PyObject *args,
-                              PyObject *kwds);
+PyObject *AerospikeClient_Put(AerospikeClient *self, PyObject *const *args,
+                              Py_ssize_t nargs, PyObject *kwnames);
 
 PyObject *AerospikeClient_Put_Invoke(AerospikeClient *self, PyObject *py_key,
                                      PyObject *py_bins, PyObject *py_meta,
@@ -144,8 +195,8 @@ PyObject *AerospikeClient_Put_Invoke(AerospikeClient *self, PyObject *py_key,
  *		client.remove((x,y,z))
  *
  */
-PyObject *AerospikeClient_Remove(AerospikeClient *self, PyObject *args,
-                                 PyObject *kwds);
+PyObject *AerospikeClient_Remove(AerospikeClient *self, PyObject *const *args,
+                                 Py_ssize_t nargs, PyObject *kwnames);
 
 PyObject *AerospikeClient_Remove_Invoke(AerospikeClient *self, PyObject *py_key,
                                         PyObject *py_meta, PyObject *py_policy);
@@ -180,8 +231,9 @@ PyObject *AerospikeClient_Prepend(AerospikeClient *self, PyObject *args,
  *		client.increment((x,y,z))
  *
  */
-PyObject *AerospikeClient_Increment(AerospikeClient *self, PyObject *args,
-                                    PyObject *kwds);
+PyObject *AerospikeClient_Increment(AerospikeClient *self,
+                                    PyObject *const *args, Py_ssize_t nargs,
+                                    PyObject *kwnames);
 /**
  * Touch a record in the database.
  *
@@ -196,8 +248,8 @@ PyObject *AerospikeClient_Touch(AerospikeClient *self, PyObject *args,
  *		client.operate((x,y,z))
  *
  */
-PyObject *AerospikeClient_Operate(AerospikeClient *self, PyObject *args,
-                                  PyObject *kwds);
+PyObject *AerospikeClient_Operate(AerospikeClient *self, PyObject *const *args,
+                                  Py_ssize_t nargs, PyObject *kwnames);
 /**
  * Performs operate ordered operations
  *
@@ -441,8 +493,8 @@ PyObject *AerospikeClient_Set_Log_Handler(AerospikeClient *self, PyObject *args,
  *		client.get_many([keys], policies)
  *
  */
-PyObject *AerospikeClient_Get_Many(AerospikeClient *self, PyObject *args,
-                                   PyObject *kwds);
+PyObject *AerospikeClient_Get_Many(AerospikeClient *self, PyObject *const *args,
+                                   Py_ssize_t nargs, PyObject *kwnames);
 
 /**
  * Get records in a batch
@@ -450,8 +502,9 @@ PyObject *AerospikeClient_Get_Many(AerospikeClient *self, PyObject *args,
  *		client.batch_get_ops([keys], policies)
  *
  */
-PyObject *AerospikeClient_Batch_GetOps(AerospikeClient *self, PyObject *args,
-                                       PyObject *kwds);
+PyObject *AerospikeClient_Batch_GetOps(AerospikeClient *self,
+                                       PyObject *const *args, Py_ssize_t nargs,
+                                       PyObject *kwnames);
 
 /**
  * Read/Write multiple records for specified batch keys in one batch call.
@@ -462,8 +515,9 @@ PyObject *AerospikeClient_Batch_GetOps(AerospikeClient *self, PyObject *args,
  *		client.batch_write([batch_records], policy)
  *
  */
-PyObject *AerospikeClient_BatchWrite(AerospikeClient *self, PyObject *args,
-                                     PyObject *kwds);
+PyObject *AerospikeClient_BatchWrite(AerospikeClient *self,
+                                     PyObject *const *args, Py_ssize_t nargs,
+                                     PyObject *kwnames);
 
 /**
  * Perform read/write operations on multiple keys.
@@ -472,8 +526,9 @@ PyObject *AerospikeClient_BatchWrite(AerospikeClient *self, PyObject *args,
  *		client.batch_operate([keys], [ops], policy_batch, policy_batch_write)
  *
  */
-PyObject *AerospikeClient_Batch_Operate(AerospikeClient *self, PyObject *args,
-                                        PyObject *kwds);
+PyObject *AerospikeClient_Batch_Operate(AerospikeClient *self,
+                                        PyObject *const *args, Py_ssize_t nargs,
+                                        PyObject *kwnames);
 
 /**
  * Perform reads on multiple keys.
@@ -481,8 +536,9 @@ PyObject *AerospikeClient_Batch_Operate(AerospikeClient *self, PyObject *args,
  *      client.batch_read([keys], [bins], policy_batch)
  *
  */
-PyObject *AerospikeClient_BatchRead(AerospikeClient *self, PyObject *args,
-                                    PyObject *kwds);
+PyObject *AerospikeClient_BatchRead(AerospikeClient *self,
+                                    PyObject *const *args, Py_ssize_t nargs,
+                                    PyObject *kwnames);
 
 /**
  * Remove multiple records by key.
@@ -491,8 +547,9 @@ PyObject *AerospikeClient_BatchRead(AerospikeClient *self, PyObject *args,
  *		client.batch_remove([keys], policy_batch, policy_batch_remove)
  *
  */
-PyObject *AerospikeClient_Batch_Remove(AerospikeClient *self, PyObject *args,
-                                       PyObject *kwds);
+PyObject *AerospikeClient_Batch_Remove(AerospikeClient *self,
+                                       PyObject *const *args, Py_ssize_t nargs,
+                                       PyObject *kwnames);
 
 /**
  * Apply a user defined function (UDF) to multiple keys.
@@ -501,8 +558,9 @@ PyObject *AerospikeClient_Batch_Remove(AerospikeClient *self, PyObject *args,
  *		client.batch_apply([keys], module, function, [args], policy_batch, policy_batch_remove)
  *
  */
-PyObject *AerospikeClient_Batch_Apply(AerospikeClient *self, PyObject *args,
-                                      PyObject *kwds);
+PyObject *AerospikeClient_Batch_Apply(AerospikeClient *self,
+                                      PyObject *const *args, Py_ssize_t nargs,
+                                      PyObject *kwnames);
 
 /**
  * Filter bins from records in a batch
@@ -510,8 +568,9 @@ PyObject *AerospikeClient_Batch_Apply(AerospikeClient *self, PyObject *args,
  *		client.select_many([keys], [bins], policies)
  *
  */
-PyObject *AerospikeClient_Select_Many(AerospikeClient *self, PyObject *args,
-                                      PyObject *kwds);
+PyObject *AerospikeClient_Select_Many(AerospikeClient *self,
+                                      PyObject *const *args, Py_ssize_t nargs,
+                                      PyObject *kwnames);
 
 /**
  * Check existence of given keys
@@ -519,8 +578,9 @@ PyObject *AerospikeClient_Select_Many(AerospikeClient *self, PyObject *args,
  *		client.exists_many([keys], policies)
  *
  */
-PyObject *AerospikeClient_Exists_Many(AerospikeClient *self, PyObject *args,
-                                      PyObject *kwds);
+PyObject *AerospikeClient_Exists_Many(AerospikeClient *self,
+                                      PyObject *const *args, Py_ssize_t nargs,
+                                      PyObject *kwnames);
 
 /**
 * Perform xdr-set-filter info operation on the database.
@@ -578,8 +638,8 @@ char *return_search_string(aerospike *as);
 /**
  * Close the aerospike object depending on the global_hosts entries
  */
-void close_aerospike_object(aerospike *as, as_error *err, char *alias_to_search,
-                            PyObject *py_persistent_item, bool do_destroy);
+void close_aerospike_object(aerospike *as, as_error *err,
+                            char *alias_to_search);
 /**
  * Check type for 'operate' operation
  */
@@ -0,0 +1,57 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include <Python.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <aerospike/as_error.h>
+
+/*
+ * Helpers shared by the client's optional features, which are configured
+ * with a dict of settings and keep locks that a fork() may leave held.
+ */
+
+/**
+ * Returns a monotonic time in microseconds.
+ */
+uint64_t client_now_us(void);
+
+/**
+ * Reads the integer setting name of the feature config from py_config, if
+ * set, into value. Returns false, with err set, if it is not an integer from
+ * min to max.
+ */
+bool client_config_get_uint(PyObject *py_config, const char *config,
+                            const char *name, uint64_t min, uint64_t max,
+                            uint64_t *value, as_error *err);
+
+/**
+ * client_config_get_uint() for a uint32_t setting.
+ */
+bool client_config_get_uint32(PyObject *py_config, const char *config,
+                              const char *name, uint32_t min, uint32_t max,
+                              uint32_t *value, as_error *err);
+
+/**
+ * Calls reset with udata if this is a child forked since *pid was set, then
+ * sets *pid to this process. reset reinitializes the locks and drops the
+ * state of threads which did not survive the fork.
+ */
+void client_check_fork(pid_t *pid, void (*reset)(void *udata), void *udata);
@@ -0,0 +1,112 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include <Python.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <aerospike/aerospike_batch.h>
+#include <aerospike/as_batch.h>
+#include <aerospike/as_error.h>
+#include <aerospike/as_key.h>
+
+#include "types.h"
+
+// The most limits a client config may hold.
+#define COMMAND_LIMITS_MAX 32
+
+typedef enum {
+    COMMAND_LIMIT_READ = 1 << 0,
+    COMMAND_LIMIT_WRITE = 1 << 1,
+    COMMAND_LIMIT_UDF = 1 << 2,
+    COMMAND_LIMIT_BATCH = 1 << 3,
+    COMMAND_LIMIT_SCAN = 1 << 4,
+    COMMAND_LIMIT_QUERY = 1 << 5,
+    // Priority lanes. Batches, scans and queries are bulk unless their policy
+    // sets "priority", other commands are interactive.
+    COMMAND_LIMIT_INTERACTIVE = 1 << 6,
+    COMMAND_LIMIT_BULK = 1 << 7
+} command_limit_type;
+
+/**
+ * The limits a command holds a slot of, released once it completes.
+ */
+typedef struct {
+    uint32_t held;
+} command_permit;
+
+/**
+ * Creates the limits described by the "command_limits" list of the client
+ * config. Returns NULL and sets err if the config is invalid.
+ */
+command_limiter *command_limiter_new(PyObject *py_limits, as_error *err);
+
+void command_limiter_destroy(command_limiter *limiter);
+
+/**
+ * Waits until every limit matching a command of type on key, in the lane
+ * chosen by py_policy, lets it run. The records count against rates. Must be
+ * called with the GIL held; releases it while waiting. The permit must be
+ * passed to command_limits_release() once the command completes.
+ *
+ * The wait is bounded by the total_timeout of py_policy, else of the client's
+ * default policy for the command. Returns false and sets err to
+ * AEROSPIKE_ERR_TIMEOUT, holding no limit, if it passes first.
+ */
+bool command_limits_acquire(AerospikeClient *self, command_limit_type type,
+                            PyObject *py_policy, const as_key *key,
+                            uint32_t records, command_permit *permit,
+                            as_error *err);
+
+/**
+ * Batches are limited by the namespace and set of their first key, and
+ * count each key against rates.
+ */
+bool command_limits_acquire_batch(AerospikeClient *self, PyObject *py_policy,
+                                  const as_batch *batch,
+                                  command_permit *permit, as_error *err);
+bool command_limits_acquire_records(AerospikeClient *self, PyObject *py_policy,
+                                    const as_batch_records *records,
+                                    command_permit *permit, as_error *err);
+
+/**
+ * Scans and queries count as one record against rates, and hold their permit
+ * until they complete, including those running a callback.
+ */
+bool command_limits_acquire_set(AerospikeClient *self, command_limit_type type,
+                                PyObject *py_policy, const char *ns,
+                                const char *set, command_permit *permit,
+                                as_error *err);
+
+void command_limits_release(AerospikeClient *self, command_permit *permit);
+
+/**
+ * Bracket the user callback of a scan or query foreach on the thread running
+ * it. Commands the callback sends are not held to max_concurrent, since the
+ * slot they would wait for may be the one held by the foreach itself. They
+ * still count against rates.
+ */
+void command_limits_callback_begin(void);
+void command_limits_callback_end(void);
+
+/**
+ * Python methods
+ *          client.get_command_limit_stats()
+ */
+PyObject *AerospikeClient_Get_Command_Limit_Stats(AerospikeClient *self,
+                                                  PyObject *args);
@@ -97,15 +97,26 @@ as_status pyobject_to_list(AerospikeClient *self, as_error *err,
                            PyObject *py_list, as_list **list,
                            as_static_pool *static_pool, int serializer_type);
 
-as_status pyobject_to_key(as_error *err, PyObject *py_key, as_key *key);
+/**
+ * self may be NULL, in which case an aerospike.Key is converted like a key
+ * tuple.
+ */
+as_status pyobject_to_key(AerospikeClient *self, as_error *err,
+                          PyObject *py_key, as_key *key);
 
 as_status pyobject_to_index(AerospikeClient *self, as_error *err,
                             PyObject *py_value, long *long_val);
 
+/**
+ * Converts the bins py_rec and meta py_meta to rec. Bin values for a batch
+ * serializer are set aside in deferred, if not NULL, for
+ * deferred_values_serialize() to add to rec.
+ */
 as_status pyobject_to_record(AerospikeClient *self, as_error *err,
                              PyObject *py_rec, PyObject *py_meta,
                              as_record *rec, int serializer_option,
-                             as_static_pool *static_pool);
+                             as_static_pool *static_pool,
+                             deferred_values *deferred);
 
 as_status val_to_pyobject(AerospikeClient *self, as_error *err,
                           const as_val *val, PyObject **py_map);
@@ -120,6 +131,11 @@ as_status map_to_pyobject(AerospikeClient *self, as_error *err,
 as_status list_to_pyobject(AerospikeClient *self, as_error *err,
                            const as_list *list, PyObject **py_list);
 
+PyObject *new_presized_dict(Py_ssize_t size);
+
+as_status geojson_to_pyobject(as_error *err, const char *locstr,
+                              Py_ssize_t len, PyObject **py_geo);
+
 as_status as_list_of_map_to_py_tuple_list(AerospikeClient *self, as_error *err,
                                           const as_list *list,
                                           PyObject **py_list);
@@ -128,6 +144,17 @@ as_status record_to_pyobject(AerospikeClient *self, as_error *err,
                              const as_record *rec, const as_key *key,
                              PyObject **obj);
 
+/**
+ * record_to_pyobject() which sets bin values for a batch deserializer aside
+ * in deferred, see deferred_values_add_bytes().
+ */
+as_status record_to_pyobject_deferred(AerospikeClient *self, as_error *err,
+                                      const as_record *rec, const as_key *key,
+                                      deferred_values *deferred,
+                                      PyObject **obj);
+
+PyObject *record_tuple_copy(AerospikeClient *self, PyObject *py_rec);
+
 as_status record_to_resultpyobject(AerospikeClient *self, as_error *err,
                                    const as_record *rec, PyObject **obj);
 
@@ -140,7 +167,8 @@ as_status record_to_pyobject_cnvt_list_to_map(AerospikeClient *self,
                                               const as_key *key,
                                               PyObject **obj);
 
-as_status key_to_pyobject(as_error *err, const as_key *key, PyObject **obj);
+as_status key_to_pyobject(AerospikeClient *self, as_error *err,
+                          const as_key *key, PyObject **obj);
 
 as_status metadata_to_pyobject(as_error *err, const as_record *rec,
                                PyObject **obj);
@@ -194,6 +222,7 @@ as_status as_batch_read_results_to_pyobject(as_error *err,
 
 as_status batch_read_records_to_pyobject(AerospikeClient *self, as_error *err,
                                          as_batch_read_records *records,
+                                         deferred_values *deferred,
                                          PyObject **py_recs);
 
 as_status string_and_pyuni_from_pystring(PyObject *py_string,
@@ -212,6 +241,13 @@ as_status convert_partition_filter(AerospikeClient *self,
                                    as_partition_filter *partition_filter,
                                    as_partitions_status **ps, as_error *err);
 
+as_status as_partitions_status_to_checkpoint(
+    as_error *err, const as_partitions_status *parts_all, PyObject **py_bytes);
+
+as_status checkpoint_to_as_partitions_status(as_error *err,
+                                             PyObject *py_checkpoint,
+                                             as_partitions_status **pss);
+
 as_status get_int_from_py_int(as_error *err, PyObject *py_long,
                               int *int_pointer, const char *py_object_name);
 
@@ -220,10 +256,15 @@ as_partitions_status_to_pyobject(as_error *err,
                                  const as_partitions_status *parts_status,
                                  PyObject **py_dict);
 
+as_status as_partitions_status_split_to_pyobject(
+    as_error *err, const as_partitions_status *parts_status, long n,
+    PyObject **py_list);
+
 as_status as_partition_status_to_pyobject(
     as_error *err, const as_partition_status *part_status, PyObject **py_tuple);
 
 as_status as_batch_result_to_BatchRecord(AerospikeClient *self, as_error *err,
                                          as_batch_result *bres,
                                          PyObject *py_batch_record,
-                                         bool checking_if_records_exist);
+                                         bool checking_if_records_exist,
+                                         deferred_values *deferred);
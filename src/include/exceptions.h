@@ -20,5 +20,19 @@
 
 PyObject *AerospikeException_New(void);
 void raise_exception(as_error *err);
-PyObject *raise_exception_old(as_error *err);
-void remove_exception(as_error *err);
+
+/**
+ * Raises the exception for err. The exception's key, bin, module, func and
+ * name attributes are set to the arguments which are not NULL, if it has
+ * them.
+ */
+void raise_exception_base(as_error *err, PyObject *py_key, PyObject *py_bin,
+                          PyObject *py_module, PyObject *py_func,
+                          PyObject *py_name);
+
+/**
+ * Returns a new reference to the exception raise_exception() would raise for
+ * err, with the same msg, file, line and in_doubt attributes. NULL with an
+ * exception set on failure.
+ */
+PyObject *exception_from_error(as_error *err);
@@ -0,0 +1,60 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include <Python.h>
+#include <stdbool.h>
+
+struct Aerospike_State;
+
+/**
+ * Keyword parser for METH_FASTCALL | METH_KEYWORDS methods whose arguments
+ * are all objects, the equivalent of an "O...|O..." format string.
+ *
+ *		static const char *kwlist[] = {"key", "policy", NULL};
+ *		static fastcall_parser parser = {"get", kwlist, 1};
+ *
+ * Parsers are static and shared by every interpreter, so they hold no Python
+ * objects. Each is given a slot the first time it is used, under which the
+ * module state of each interpreter keeps its keyword names interned, so that
+ * keywords passed by the interpreter usually match by identity.
+ */
+typedef struct {
+    const char *fname;
+    const char **keywords;
+    // Number of leading arguments which are required.
+    Py_ssize_t required;
+    // Set the first time the parser is used. The slot is 1-based.
+    Py_ssize_t nkeywords;
+    Py_ssize_t slot;
+} fastcall_parser;
+
+#define FASTCALL_MAX_ARGS 8
+// Parsers past this many compare keywords by value.
+#define FASTCALL_MAX_PARSERS 32
+
+/**
+ * Parses the arguments of a METH_FASTCALL | METH_KEYWORDS call into the
+ * PyObject ** that follow, one per keyword of parser. Arguments which are
+ * not passed leave their output untouched. References are borrowed. state is
+ * the module state of the object called, which caches the keyword names.
+ *
+ * Returns false with a TypeError set if the arguments do not match.
+ */
+bool fastcall_parse(fastcall_parser *parser, struct Aerospike_State *state,
+                    PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames,
+                    ...);
@@ -26,7 +26,7 @@
  * FUNCTIONS
  ******************************************************************************/
 
-PyTypeObject *AerospikeGeospatial_Ready(void);
+PyTypeObject *AerospikeGeospatial_Ready(PyObject *module);
 
 PyObject *AerospikeGeospatial_Wrap(AerospikeGeospatial *self, PyObject *args,
                                    PyObject *kwds);
@@ -54,3 +54,31 @@ AerospikeGeospatial *Aerospike_Set_Geo_Json(PyObject *parent, PyObject *args,
                                             PyObject *kwds);
 
 PyObject *AerospikeGeospatial_New(as_error *err, PyObject *value);
+
+/**
+ * Creates a Geospatial object holding a raw GeoJSON string, which is only
+ * parsed when its geo_data is first accessed.
+ */
+PyObject *AerospikeGeospatial_NewFromGeoJSON(as_error *err,
+                                             PyObject *py_geojson);
+
+/**
+ * Returns a new reference to the geo_data of a Geospatial object, parsing its
+ * raw GeoJSON string if needed.
+ */
+PyObject *AerospikeGeospatial_GetGeoData(AerospikeGeospatial *self,
+                                         as_error *err);
+
+/**
+ * Returns a new reference to the GeoJSON string of a Geospatial object,
+ * reusing the raw string it was read with when geo_data was never accessed.
+ */
+PyObject *AerospikeGeospatial_GetGeoJSON(PyObject *py_geo, as_error *err);
+
+/**
+ * Native JSON decoding and encoding of GeoJSON values. Both return NULL,
+ * without a Python error set, for input they do not handle.
+ */
+PyObject *geojson_loads(const char *str, Py_ssize_t len);
+
+PyObject *geojson_dumps(PyObject *py_obj);
@@ -14,10 +14,76 @@
  * limitations under the License.
  ******************************************************************************/
 
+
 #pragma once
 
 #include <Python.h>
 #include <stdbool.h>
+
+#include <aerospike/aerospike.h>
+#include <aerospike/as_error.h>
+
 #include "types.h"
-AerospikeGlobalHosts *AerospikeGobalHosts_New(aerospike *as);
-void AerospikeGlobalHosts_Del(PyObject *self);
+
+/*
+ * The aerospike objects shared by clients created with use_shared_connection,
+ * keyed by return_search_string(). The table is process wide and holds no
+ * Python objects, so clients in different interpreters share connections.
+ *
+ * The table has a lock of its own. Functions which may connect must be called
+ * without the GIL, the others never wait for it. The lock is not held while
+ * connecting, so fork() does not wait for a connect.
+ */
+
+/**
+ * Points self at the shared aerospike object for alias, connecting it again
+ * first if it was inherited from a parent process. Returns false if there is
+ * none. Must be called without the GIL.
+ */
+bool AerospikeGlobalHosts_Share(AerospikeClient *self, const char *alias,
+                                as_error *err);
+
+/**
+ * Adds the aerospike object a client just connected, used by that client.
+ */
+void AerospikeGlobalHosts_Add(const char *alias, aerospike *as);
+
+/**
+ * Drops a client's use of the shared aerospike object as. Returns true if it
+ * was the last one, in which case the entry is removed and the caller closes
+ * as.
+ */
+bool AerospikeGlobalHosts_Release(const char *alias, aerospike *as);
+
+/**
+ * Removes the entry for alias without closing it, so that the next client
+ * connects anew.
+ */
+void AerospikeGlobalHosts_Remove(const char *alias);
+
+/**
+ * Connects the shared aerospike object as again if it was inherited from a
+ * parent process. Returns false if as is not shared. Must be called without
+ * the GIL.
+ */
+bool AerospikeGlobalHosts_Revalidate(const char *alias, aerospike *as,
+                                     as_error *err);
+
+/**
+ * Returns shm_key, or the first key after it which no shared aerospike object
+ * uses.
+ */
+int AerospikeGlobalHosts_Unique_Shm_Key(int shm_key);
+
+/**
+ * Take and release the table's lock, which the fork handler holds across
+ * fork().
+ */
+void AerospikeGlobalHosts_Lock(void);
+void AerospikeGlobalHosts_Unlock(void);
+
+/**
+ * Forgets the connects of the parent's threads. Called in the child after
+ * fork(), with the lock held.
+ */
+void AerospikeGlobalHosts_Fork_Child(void);
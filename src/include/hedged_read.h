@@ -0,0 +1,63 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include <Python.h>
+#include <stdbool.h>
+
+#include <aerospike/aerospike.h>
+#include <aerospike/as_error.h>
+#include <aerospike/as_key.h>
+#include <aerospike/as_policy.h>
+#include <aerospike/as_record.h>
+
+#include "types.h"
+
+/**
+ * Creates the reader described by the "hedged_reads" dict of the client
+ * config. Returns NULL and sets err if the config is invalid.
+ */
+hedged_reader *hedged_reader_new(PyObject *py_config, as_error *err);
+
+/**
+ * Stops the worker threads once the reads they are making complete. They
+ * are started again by the next hedged read. Called without the GIL.
+ */
+void hedged_reader_stop(hedged_reader *reader);
+
+/**
+ * Stops the worker threads and frees reader. Called without the GIL.
+ */
+void hedged_reader_destroy(hedged_reader *reader);
+
+/**
+ * Returns true if a read made with policy (NULL for the client default) can
+ * be hedged. Reads with a filter expression are not.
+ */
+bool hedged_read_covers(AerospikeClient *self, as_policy_read *policy,
+                        bool has_filter);
+
+/**
+ * Reads the NULL terminated bins (NULL for all bins) of key. If no response
+ * arrives within the hedge delay, the read is sent again, to a replica when
+ * the C client picks one, and the first response is returned in rec or err.
+ *
+ * Called without the GIL.
+ */
+as_status hedged_read(hedged_reader *reader, aerospike *as,
+                      as_policy_read *policy, as_key *key, const char **bins,
+                      as_error *err, as_record **rec);
@@ -0,0 +1,48 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <Python.h>
+
+/*
+ * Callbacks from the C client run on its threads and must take the GIL of
+ * the interpreter that made the call. PyGILState_Ensure() only knows the main
+ * interpreter, so for the others a thread state is created for the duration
+ * of the callback.
+ */
+typedef struct {
+    PyGILState_STATE gstate;
+    // Set if the thread state was created by Aerospike_GIL_Ensure().
+    PyThreadState *tstate;
+} Aerospike_GIL_State;
+
+/**
+ * Returns the interpreter of the calling thread, which must hold the GIL.
+ */
+PyInterpreterState *Aerospike_Current_Interpreter(void);
+
+/**
+ * Takes the GIL of interp from a thread which may not have a thread state for
+ * it. interp may be NULL for the main interpreter.
+ */
+Aerospike_GIL_State Aerospike_GIL_Ensure(PyInterpreterState *interp);
+
+/**
+ * Releases the GIL taken by Aerospike_GIL_Ensure().
+ */
+void Aerospike_GIL_Release(Aerospike_GIL_State *state);
@@ -0,0 +1,48 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <Python.h>
+#include <stdbool.h>
+
+#include <aerospike/as_key.h>
+
+#define AEROSPIKE_KEY_NAME "aerospike.Key"
+
+struct Aerospike_State;
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+PyTypeObject *AerospikeKey_Ready(PyObject *module);
+
+/**
+ * Returns true if py_obj is an aerospike.Key of the module with state. state
+ * may be NULL, in which case nothing is a Key.
+ */
+bool AerospikeKey_Check(struct Aerospike_State *state, PyObject *py_obj);
+
+/**
+ * Creates an aerospike.Key of the module with state for a key whose digest is
+ * already computed. py_ns, py_set and py_key are borrowed. Returns NULL with
+ * an exception set on failure.
+ */
+PyObject *AerospikeKey_New(struct Aerospike_State *state, PyObject *py_ns,
+                           PyObject *py_set, PyObject *py_key,
+                           const as_digest *digest);
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <Python.h>
+#include <stdbool.h>
 
 #include "types.h"
 
@@ -24,6 +25,10 @@
  * FUNCTIONS
  ******************************************************************************/
 
-PyTypeObject *AerospikeKeyOrderedDict_Ready(void);
+PyTypeObject *AerospikeKeyOrderedDict_Ready(PyObject *module);
 
-PyObject *AerospikeKeyOrderedDict_Get_Type(void);
+/**
+ * Returns true if py_obj is an aerospike.KeyOrderedDict, or a subclass of
+ * one, from any interpreter.
+ */
+bool AerospikeKeyOrderedDict_Check(PyObject *py_obj);
@@ -0,0 +1,53 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include <Python.h>
+#include <stdbool.h>
+
+#include <aerospike/as_error.h>
+
+#include "types.h"
+
+/**
+ * Creates the router described by the "latency_probes" dict of the client
+ * config. Returns NULL and sets err if the config is invalid.
+ */
+latency_router *latency_router_new(PyObject *py_config, as_error *err);
+
+/**
+ * Starts measuring the nodes of the client's cluster once it is connected.
+ * Does nothing if the client has no router.
+ */
+void latency_router_start(AerospikeClient *self);
+
+/**
+ * Stops the measuring thread. Called without the GIL.
+ */
+void latency_router_stop(latency_router *router);
+
+/**
+ * Stops the measuring thread and frees router. Called without the GIL.
+ */
+void latency_router_destroy(latency_router *router);
+
+/**
+ * Python methods
+ *          client.get_node_latencies()
+ */
+PyObject *AerospikeClient_Get_Node_Latencies(AerospikeClient *self,
+                                             PyObject *args);
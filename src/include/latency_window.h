@@ -0,0 +1,45 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Latencies kept, the most recent ones.
+#define LATENCY_WINDOW_SIZE 1024
+// The percentile is recomputed after this many new samples.
+#define LATENCY_WINDOW_RECOMPUTE 128
+
+/**
+ * Recent latencies and a percentile of them. Not thread safe.
+ */
+typedef struct latency_window_s {
+    uint32_t samples[LATENCY_WINDOW_SIZE];
+    uint32_t size;
+    uint32_t next;
+    uint32_t new_samples;
+    double percentile;
+    // The percentile of the samples, 0 until first computed.
+    uint32_t value;
+} latency_window;
+
+void latency_window_init(latency_window *window, double percentile);
+
+/**
+ * Adds a latency. Returns true if value was recomputed.
+ */
+bool latency_window_add(latency_window *window, uint32_t latency);
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <Python.h>
+#include <aerospike/as_error.h>
 #include <aerospike/as_status.h>
 
 /*
@@ -59,4 +60,28 @@ PyObject *Aerospike_Set_Log_Level(PyObject *parent, PyObject *args,
 PyObject *Aerospike_Set_Log_Handler(PyObject *parent, PyObject *args,
                                     PyObject *kwds);
 
+/**
+ * Deliver all queued log records to the log handler now
+ *          aerospike.drain_logs()
+ */
+PyObject *Aerospike_Drain_Logs(PyObject *parent, PyObject *args);
+
+/**
+ * Get counters of the log queue
+ *          aerospike.get_log_stats()
+ */
+PyObject *Aerospike_Get_Log_Stats(PyObject *parent, PyObject *args);
+
 void Aerospike_Enable_Default_Logging();
+
+/**
+ * Resets the log queue in a forked child. Called from the pthread_atfork()
+ * child handler, so it must not call into Python.
+ */
+void log_fork_child(void);
+
+/**
+ * Restarts the log dispatcher in a forked child if the parent was running it.
+ * Must be called with the GIL held.
+ */
+as_status log_dispatcher_resume(as_error *err);
@@ -19,3 +19,11 @@
 // pyval is a PyObject* classname is a string
 #define AS_Matches_Classname(pyval, classname)                                 \
     (strcmp((pyval)->ob_type->tp_name, (classname)) == 0)
+
+// Critical sections lock an object on free-threaded builds and are no-ops
+// with the GIL. They are part of the C API from Python 3.13, which is also
+// the first version with a free-threaded build.
+#ifndef Py_BEGIN_CRITICAL_SECTION
+#define Py_BEGIN_CRITICAL_SECTION(op) {
+#define Py_END_CRITICAL_SECTION() }
+#endif
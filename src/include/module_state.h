@@ -0,0 +1,74 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <Python.h>
+
+#include "fastcall.h"
+#include "types.h"
+
+/*
+ * State of one instance of the aerospike module. Every interpreter that
+ * imports the module gets its own, as Python objects can't be shared between
+ * interpreters.
+ */
+struct Aerospike_State {
+    PyObject *exception;
+    PyTypeObject *client;
+    PyTypeObject *query;
+    PyTypeObject *scan;
+    PyTypeObject *kdict;
+    PyTypeObject *key;
+    PyObject *predicates;
+    PyTypeObject *geospatial;
+    PyTypeObject *null_object;
+    PyTypeObject *wildcard_object;
+    PyTypeObject *infinite_object;
+    // Owner of the memory of views passed to buffer deserializers.
+    PyTypeObject *bytes_view;
+    // Set with aerospike.set_serializer() and set_deserializer(), see
+    // serializer.c.
+    user_serializer_callback *user_serializer;
+    user_serializer_callback *user_deserializer;
+    // Imported the first time the native serializer needs them.
+    PyObject *py_decimal_type;
+    PyObject *py_uuid_type;
+    // Tuples of the interned keyword names of each fastcall_parser, by its
+    // slot, created the first time it is used. See fastcall.c.
+    PyObject *fastcall_keywords[FASTCALL_MAX_PARSERS];
+};
+
+#define Aerospike_State(o) ((struct Aerospike_State *)PyModule_GetState(o))
+
+/**
+ * Returns the state of the aerospike module imported by the current
+ * interpreter, or NULL with an exception set if it can't be found.
+ */
+struct Aerospike_State *Aerospike_Get_State(void);
+
+/**
+ * Returns the state of the module which created type, or one of its base
+ * types. NULL with an exception set if it can't be found.
+ */
+struct Aerospike_State *Aerospike_Get_Type_State(PyTypeObject *type);
+
+/**
+ * Creates a heap type from spec which belongs to module. base may be NULL.
+ */
+PyTypeObject *Aerospike_New_Type(PyObject *module, PyType_Spec *spec,
+                                 PyTypeObject *base);
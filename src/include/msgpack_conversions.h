@@ -0,0 +1,44 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include <Python.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <aerospike/as_bytes.h>
+#include <aerospike/as_error.h>
+
+#include "types.h"
+
+/**
+ * Decodes a msgpack encoded CDT (list or map bin value) straight into Python
+ * lists and dicts, without building an intermediate as_val tree.
+ */
+as_status msgpack_to_pyobject(AerospikeClient *self, as_error *err,
+                              const uint8_t *buffer, uint32_t size,
+                              PyObject **py_obj);
+
+/**
+ * Packs a Python list or dict straight into a msgpack buffer, returned as an
+ * as_bytes of type AS_BYTES_LIST or AS_BYTES_MAP that can be set as a bin.
+ * The caller owns the returned as_bytes.
+ */
+as_status pyobject_to_msgpack_bytes(AerospikeClient *self, as_error *err,
+                                    PyObject *py_obj, as_bytes **bytes,
+                                    as_static_pool *static_pool,
+                                    int serializer_type);
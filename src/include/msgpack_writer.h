@@ -0,0 +1,73 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include <Python.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <aerospike/as_error.h>
+
+/*
+ * A growing buffer of msgpack, shared by the CDT packer of
+ * msgpack_conversions.c and the built-in serializer of native_serializer.c.
+ * The buffer comes from cf_realloc(), so it can be handed to an as_bytes
+ * which frees it.
+ */
+typedef struct {
+    uint8_t *buffer;
+    uint32_t size;
+    uint32_t capacity;
+} msgpack_writer;
+
+#define MSGPACK_WRITER_INIT {.buffer = NULL, .size = 0, .capacity = 0}
+
+/**
+ * Appends count bytes to the buffer and returns them, or NULL and sets err if
+ * the buffer cannot grow.
+ */
+uint8_t *msgpack_reserve(as_error *err, msgpack_writer *writer,
+                         uint32_t count);
+
+/**
+ * Stores value big endian in width bytes.
+ */
+void msgpack_put_uint(uint8_t *bytes, uint64_t value, uint32_t width);
+
+/**
+ * Appends a header byte followed by value in width bytes.
+ */
+as_status msgpack_write_header(as_error *err, msgpack_writer *writer,
+                               uint8_t header, uint64_t value, uint32_t width);
+
+as_status msgpack_write_data(as_error *err, msgpack_writer *writer,
+                             const void *data, Py_ssize_t len);
+
+/**
+ * Sets err unless len fits the 32 bit lengths of msgpack.
+ */
+as_status msgpack_check_size(as_error *err, Py_ssize_t len);
+
+/**
+ * Append an integer, double or array or map header in their smallest form.
+ */
+as_status msgpack_pack_int64(as_error *err, msgpack_writer *writer,
+                             int64_t i);
+as_status msgpack_pack_double(as_error *err, msgpack_writer *writer,
+                              double d);
+as_status msgpack_pack_container_header(as_error *err, msgpack_writer *writer,
+                                        bool is_map, Py_ssize_t count);
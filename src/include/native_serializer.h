@@ -0,0 +1,47 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include <Python.h>
+#include <stdbool.h>
+
+#include <aerospike/as_bytes.h>
+#include <aerospike/as_error.h>
+
+/**
+ * Serializes a Python value with the built-in serializer used by
+ * SERIALIZER_JSON. Tuples, sets, frozensets, bytearrays, datetimes, dates,
+ * timedeltas, Decimals, UUIDs and integers wider than 64 bits are supported,
+ * along with str, bytes, int, float, bool, None, list and dict holding any of
+ * them. Subclasses of these types are refused.
+ *
+ * bytes is set to an AS_BYTES_PYTHON blob which owns its buffer.
+ */
+as_status pyobject_to_native_bytes(as_error *err, PyObject *py_obj,
+                                   as_bytes **bytes);
+
+/**
+ * Returns true if an AS_BYTES_PYTHON blob was written by
+ * pyobject_to_native_bytes(), as opposed to a legacy pickled value.
+ */
+bool is_native_bytes(as_bytes *bytes);
+
+/**
+ * Deserializes a blob written by pyobject_to_native_bytes().
+ */
+as_status native_bytes_to_pyobject(as_error *err, as_bytes *bytes,
+                                   PyObject **py_obj);
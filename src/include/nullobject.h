@@ -20,4 +20,4 @@
 #include <stdbool.h>
 #include "types.h"
 PyObject *AerospikeNullObject_New();
-PyTypeObject *AerospikeNullObject_Ready();
+PyTypeObject *AerospikeNullObject_Ready(PyObject *module);
@@ -48,6 +48,12 @@ enum Aerospike_send_bool_as_values {
     SEND_BOOL_AS_AS_BOOL, /* default for writing Python bools */
 };
 
+enum Aerospike_priority_values {
+    POLICY_PRIORITY_DEFAULT, /* bulk for batches, scans and queries */
+    POLICY_PRIORITY_INTERACTIVE,
+    POLICY_PRIORITY_BULK,
+};
+
 enum Aerospike_list_operations {
     OP_LIST_APPEND = 1001,
     OP_LIST_APPEND_ITEMS,
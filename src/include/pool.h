@@ -14,6 +14,9 @@
 typedef struct bytes_static_pool {
     as_bytes bytes_pool[AS_MAX_STORE_SIZE];
     uint32_t current_bytes_id;
+    // Objects whose memory is wrapped by as_bytes in the pool, see
+    // POOL_HOLD_BUFFERS.
+    PyObject *py_buffers;
 } as_static_pool;
 
 #define BYTES_CNT(static_pool)                                                 \
@@ -29,7 +32,16 @@ typedef struct bytes_static_pool {
         as_error_update(err, AEROSPIKE_ERR, "Cannot allocate as_bytes");       \
     }
 
+/*
+ * Lets serialized values wrap the buffers returned by a user serializer
+ * instead of copying them. Only for pools whose as_bytes stay in place and
+ * are released with POOL_DESTROY once the command is done.
+ */
+#define POOL_HOLD_BUFFERS(static_pool)                                         \
+    ((as_static_pool *)static_pool)->py_buffers = PyList_New(0)
+
 #define POOL_DESTROY(static_pool)                                              \
     for (uint32_t iter = 0; iter < BYTES_CNT(static_pool); iter++) {           \
         as_bytes_destroy(&BYTES_POOL(static_pool)[iter]);                      \
-    }
+    }                                                                          \
+    Py_CLEAR(((as_static_pool *)static_pool)->py_buffers)
@@ -28,7 +28,7 @@
  * FUNCTIONS
  ******************************************************************************/
 
-PyTypeObject *AerospikeQuery_Ready(void);
+PyTypeObject *AerospikeQuery_Ready(PyObject *module);
 
 AerospikeQuery *AerospikeQuery_New(AerospikeClient *client, PyObject *args,
                                    PyObject *kwds);
@@ -136,6 +136,34 @@ PyObject *AerospikeQuery_Is_Done(AerospikeQuery *self);
  */
 PyObject *AerospikeQuery_Get_Partitions_status(AerospikeQuery *self);
 
+/**
+ * Splits the partitions of the query into n partition filters.
+ *
+ *    Returns a list of partition_filter dicts, each with the partition status
+ *    for its range if the query is tracking its partitions.
+ *
+ */
+PyObject *AerospikeQuery_Split(AerospikeQuery *self, PyObject *args,
+                               PyObject *kwds);
+
+/**
+ * Serializes the partition status of the query into bytes.
+ *
+ *    query.checkpoint()
+ *
+ */
+PyObject *AerospikeQuery_Checkpoint(AerospikeQuery *self);
+
+/**
+ * Restores the partition status saved by checkpoint(), so the next
+ * results() or foreach() continues from it.
+ *
+ *    query.resume(checkpoint)
+ *
+ */
+PyObject *AerospikeQuery_Resume(AerospikeQuery *self, PyObject *args,
+                                PyObject *kwds);
+
 /**
  * Store the Unicode -> UTF8 string converted PyObject into 
  * a pool of PyObjects. So that, they will be decref'ed at later stages
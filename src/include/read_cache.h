@@ -0,0 +1,94 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include <Python.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <aerospike/as_error.h>
+#include <aerospike/as_key.h>
+#include <aerospike/as_policy.h>
+#include <aerospike/as_record.h>
+
+#include "types.h"
+
+/**
+ * Creates the read cache described by the "read_cache" dict of the client
+ * config. Returns NULL and sets err if the config is invalid.
+ */
+read_cache *read_cache_new(PyObject *py_config, as_error *err);
+
+void read_cache_destroy(read_cache *cache);
+
+/**
+ * Returns true if records of key's namespace and set are cached and a read
+ * with policy may be served from the cache. Entries are shared by reads
+ * whose policy agrees with the client's default read policy on the fields
+ * which change what is returned: key, replica, read modes and deserialize.
+ */
+bool read_cache_covers(AerospikeClient *self, const as_policy_read *policy,
+                       const as_key *key);
+
+/**
+ * Returns the invalidation epoch of the cache, to be taken before a read
+ * whose record is passed to read_cache_put().
+ */
+uint64_t read_cache_epoch(read_cache *cache);
+
+/**
+ * Returns a copy of the cached record of key, or NULL on a miss. Large
+ * records are validated with a header read before being served. Must be
+ * called with the GIL held; never raises.
+ */
+PyObject *read_cache_lookup(AerospikeClient *self, as_policy_read *policy,
+                            as_key *key);
+
+/**
+ * Caches a copy of py_rec, the record rec read for key, in the cache of self
+ * unless records were invalidated since epoch, in which case rec may predate
+ * a write.
+ */
+void read_cache_put(AerospikeClient *self, uint64_t epoch, as_key *key,
+                    as_record *rec, PyObject *py_rec);
+
+/**
+ * Drops the cached record of key after a write to it.
+ */
+void read_cache_invalidate(read_cache *cache, as_key *key);
+
+/**
+ * Drops all cached records.
+ */
+void read_cache_clear(read_cache *cache);
+
+/**
+ * Returns a copy of a record returned by read_cache_lookup() holding only
+ * the bins named in bins, a NULL terminated array. Bin values are shared
+ * with py_rec, which read_cache_lookup() already deep-copied for the caller.
+ */
+PyObject *read_cache_project(PyObject *py_rec, char **bins);
+
+/**
+ * Python methods
+ *          client.get_read_cache_stats()
+ *          client.clear_read_cache()
+ */
+PyObject *AerospikeClient_Get_Read_Cache_Stats(AerospikeClient *self,
+                                               PyObject *args);
+PyObject *AerospikeClient_Clear_Read_Cache(AerospikeClient *self,
+                                           PyObject *args);
@@ -28,7 +28,7 @@
  * FUNCTIONS
  ******************************************************************************/
 
-PyTypeObject *AerospikeScan_Ready(void);
+PyTypeObject *AerospikeScan_Ready(PyObject *module);
 
 AerospikeScan *AerospikeScan_New(AerospikeClient *client, PyObject *args,
                                  PyObject *kwds);
@@ -132,3 +132,31 @@ PyObject *AerospikeScan_Is_Done(AerospikeScan *self, PyObject *args,
  *
  */
 PyObject *AerospikeScan_Get_Partitions_status(AerospikeScan *self);
+
+/**
+ * Splits the partitions of the scan into n partition filters.
+ *
+ *    Returns a list of partition_filter dicts, each with the partition status
+ *    for its range if the scan is tracking its partitions.
+ *
+ */
+PyObject *AerospikeScan_Split(AerospikeScan *self, PyObject *args,
+                               PyObject *kwds);
+
+/**
+ * Serializes the partition status of the scan into bytes.
+ *
+ *    scan.checkpoint()
+ *
+ */
+PyObject *AerospikeScan_Checkpoint(AerospikeScan *self);
+
+/**
+ * Restores the partition status saved by checkpoint(), so the next
+ * results() or foreach() continues from it.
+ *
+ *    scan.resume(checkpoint)
+ *
+ */
+PyObject *AerospikeScan_Resume(AerospikeScan *self, PyObject *args,
+                                PyObject *kwds);
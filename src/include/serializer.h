@@ -19,6 +19,7 @@
 #include <Python.h>
 #include <stdbool.h>
 #include "aerospike/as_error.h"
+#include "aerospike/as_record.h"
 #include "types.h"
 /*typedef struct {
     as_error error;
@@ -32,7 +33,7 @@
  *
  */
 
-PyObject *AerospikeClient_Set_Serializer(AerospikeClient *self, PyObject *args,
+PyObject *AerospikeClient_Set_Serializer(PyObject *parent, PyObject *args,
                                          PyObject *kwds);
 /**
  * Sets the deserializer
@@ -40,26 +41,37 @@ PyObject *AerospikeClient_Set_Serializer(AerospikeClient *self, PyObject *args,
  *		client.set_deserializer()
  *
  */
-PyObject *AerospikeClient_Set_Deserializer(AerospikeClient *self,
-                                           PyObject *args, PyObject *kwds);
+PyObject *AerospikeClient_Set_Deserializer(PyObject *parent, PyObject *args,
+                                           PyObject *kwds);
 
 /**
  * Serializes Py_Object (value) into as_bytes using serialization logic
  * based on serializer_policy.
  */
-PyObject *AerospikeClient_Unset_Serializers(AerospikeClient *self,
-                                            PyObject *args, PyObject *kwds);
+PyObject *AerospikeClient_Unset_Serializers(PyObject *parent, PyObject *args,
+                                            PyObject *kwds);
 /**
  * Unsets the serializer and deserializer
  *
  *		client.unset_serializers()
  *
  */
-extern as_status serialize_based_on_serializer_policy(AerospikeClient *self,
-                                                      int32_t serializer_policy,
-                                                      as_bytes **bytes,
-                                                      PyObject *value,
-                                                      as_error *error_p);
+extern as_status serialize_based_on_serializer_policy(
+    AerospikeClient *self, int32_t serializer_policy, as_bytes **bytes,
+    PyObject *value, as_static_pool *static_pool, as_error *error_p);
+
+/**
+ * Records whether the current call on this thread passed a serializer to
+ * put(), which selects the serializer used by
+ * serialize_based_on_serializer_policy().
+ */
+void set_client_put_serializer(bool is_client_put_serializer);
+
+/**
+ * Creates the type of the memory owner behind the views passed to
+ * deserializers registered with buffer=True.
+ */
+PyTypeObject *AerospikeBytesView_Ready(PyObject *module);
 
 /**
  * Deserializes Py_Object (value) into as_bytes using Deserialization logic
@@ -69,4 +81,33 @@ extern as_status deserialize_based_on_as_bytes_type(AerospikeClient *self,
                                                     as_bytes *bytes,
                                                     PyObject **retval,
                                                     as_error *error_p);
+
+/**
+ * Sets the value of a bin aside for a batch serializer, to be serialized with
+ * the other bins of the record in deferred_values_serialize(). deferred
+ * starts zeroed. Returns false if the value must be serialized right away.
+ */
+bool deferred_values_add_value(AerospikeClient *self,
+                               deferred_values *deferred,
+                               int32_t serializer_policy, PyObject *py_value,
+                               PyObject *py_name);
+as_status deferred_values_serialize(deferred_values *deferred, as_record *rec,
+                                    as_static_pool *static_pool,
+                                    as_error *error_p);
+
+/**
+ * Prepares deferred to collect the raw bytes of bins for the batch
+ * deserializer of self, if it has one. Records converted with deferred hold
+ * the raw bytes until deferred_values_deserialize() replaces them.
+ */
+void deferred_values_init(AerospikeClient *self, deferred_values *deferred);
+PyObject *deferred_values_add_bytes(deferred_values *deferred,
+                                    const as_val *val, PyObject *py_bins,
+                                    const char *name);
+void deferred_values_deserialize(deferred_values *deferred, bool resolve);
+
+/**
+ * Releases the values of deferred without resolving them.
+ */
+void deferred_values_destroy(deferred_values *deferred);
 #endif
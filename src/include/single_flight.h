@@ -0,0 +1,55 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include <Python.h>
+#include <stdbool.h>
+
+#include <aerospike/as_error.h>
+#include <aerospike/as_key.h>
+#include <aerospike/as_policy.h>
+
+#include "types.h"
+
+/**
+ * A read in progress which other threads reading the same record with the
+ * same bins and policy wait for, instead of sending their own command.
+ */
+typedef struct single_flight_s single_flight;
+
+/**
+ * Joins the read of key, made with policy (NULL for the client default) for
+ * the NULL terminated bins (NULL for all bins).
+ *
+ * Returns true if another thread was already reading it. The result of that
+ * read is then set in py_rec, a copy of the record, or in err.
+ *
+ * Returns false if the caller must do the read itself. If leader is set, the
+ * caller must then pass the outcome to single_flight_land().
+ *
+ * Must be called with the GIL held.
+ */
+bool single_flight_join(AerospikeClient *self, as_key *key,
+                        as_policy_read *policy, char **bins,
+                        single_flight **leader, as_error *err,
+                        PyObject **py_rec);
+
+/**
+ * Hands the outcome of a read to the threads waiting for it.
+ */
+void single_flight_land(AerospikeClient *self, single_flight *flight,
+                        as_error *err, PyObject *py_rec);
@@ -17,7 +17,9 @@
 #pragma once
 
 #include <Python.h>
+#include <pthread.h>
 #include <stdbool.h>
+#include <sys/types.h>
 
 #include <aerospike/aerospike.h>
 #include <aerospike/as_key.h>
@@ -30,9 +32,6 @@
 // Bin names can be of type Unicode in Python
 // DB supports 32767 maximum number of bins
 #define MAX_UNICODE_OBJECTS 32767
-extern int counter;
-extern PyObject *py_global_hosts;
-extern bool user_shm_key;
 
 typedef struct {
     PyObject_HEAD
@@ -46,32 +45,98 @@ typedef struct {
     PyObject_HEAD
 } AerospikeCDTInfObject;
 
-typedef struct {
-    PyObject_HEAD aerospike *as;
-    int shm_key;
-    int ref_cnt;
-} AerospikeGlobalHosts;
-
 typedef struct {
     as_error error;
     PyObject *callback;
+    // The callback takes a list of values and returns a list of results.
+    bool batch;
+    // The deserializer is passed a memoryview over the record buffer.
+    bool buffer;
 } user_serializer_callback;
 
+/*
+ * Bin values waiting for a batch serializer or deserializer, so that it is
+ * called once per command. Each command that defers values owns one, passed
+ * down to the conversion of its records. Only whole bin values are deferred;
+ * values nested in lists and maps are converted right away.
+ */
+typedef struct {
+    user_serializer_callback *callback;
+    // Values for the serializer, or raw bytes for the deserializer.
+    PyObject *py_values;
+    // The bin of each value: its name when serializing, a (bins dict, name)
+    // tuple when deserializing, as a command may read several records.
+    PyObject *py_positions;
+} deferred_values;
+
 typedef struct {
     PyObject *ob[MAX_UNICODE_OBJECTS];
     int size;
 } UnicodePyObjects;
 
-typedef struct {
+// Client-side cache of records, see read_cache.h.
+typedef struct read_cache_s read_cache;
+// Merges single-record commands into batches, see auto_batch.h.
+typedef struct auto_batcher_s auto_batcher;
+// Sends slow reads again, see hedged_read.h.
+typedef struct hedged_reader_s hedged_reader;
+// Orders the rack preference by latency, see latency_router.h.
+typedef struct latency_router_s latency_router;
+// Adapts timeouts and retries to observed latency, see adaptive_policy.h.
+typedef struct adaptive_policy_s adaptive_policy;
+// Limits the rate and concurrency of commands, see command_limits.h.
+typedef struct command_limiter_s command_limiter;
+
+typedef struct AerospikeClient {
     PyObject_HEAD aerospike *as;
     int is_conn_16;
     user_serializer_callback user_serializer_call_info;
     user_serializer_callback user_deserializer_call_info;
-    uint8_t is_client_put_serializer;
     uint8_t strict_types;
     bool has_connected;
     bool use_shared_connection;
+    // The shm config set shm_key, used by the next connect.
+    bool user_shm_key;
     uint8_t send_bool_as;
+    bool direct_cdt_decode;
+    bool direct_cdt_encode;
+    // Background connect started with lazy set, finished on first use.
+    // connect_done is set under connect_lock, with connect_cond signalled.
+    bool connect_pending;
+    bool connect_done;
+    pthread_mutex_t connect_lock;
+    pthread_cond_t connect_cond;
+    pthread_t connect_thread;
+    as_error connect_err;
+    // NULL unless the "read_cache" config is set.
+    read_cache *read_cache;
+    // Reads in progress by key, NULL unless "coalesce_reads" is set.
+    PyObject *py_flights;
+    // NULL unless the "auto_batch" config is set.
+    auto_batcher *auto_batcher;
+    // NULL unless the "hedged_reads" config is set.
+    hedged_reader *hedged_reader;
+    // NULL unless the "latency_probes" config is set.
+    latency_router *latency_router;
+    // NULL unless "adaptive_timeouts" or "retry_budget" is set.
+    adaptive_policy *adaptive_policy;
+    // NULL unless the "command_limits" config is set.
+    command_limiter *command_limiter;
+    // Set in a forked child whose cluster belonged to the parent, and cleared
+    // once the client is connected again.
+    bool reconnect_after_fork;
+    // Held by the thread reconnecting after fork; others wait on it.
+    pthread_mutex_t reconnect_lock;
+    // Links of the list of clients visited by the fork handler.
+    bool fork_tracked;
+    struct AerospikeClient *fork_prev;
+    struct AerospikeClient *fork_next;
+    // Interpreter which created the client, for callbacks from C client
+    // threads.
+    PyInterpreterState *interp;
+    // State of the module the client's type belongs to, which the type keeps
+    // alive.
+    struct Aerospike_State *state;
 } AerospikeClient;
 
 typedef struct {
@@ -91,6 +156,8 @@ typedef struct {
 
 typedef struct {
     PyObject_HEAD PyObject *geo_data;
+    // Raw GeoJSON string, kept until geo_data is needed.
+    PyObject *geo_json;
 } AerospikeGeospatial;
 
 typedef struct {
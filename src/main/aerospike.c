@@ -19,10 +19,12 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "allocator.h"
 #include "client.h"
 #include "query.h"
 #include "geo.h"
 #include "scan.h"
+#include "key_object.h"
 #include "key_ordered_dict.h"
 #include "predicates.h"
 #include "exceptions.h"
@@ -34,10 +36,8 @@
 #include "nullobject.h"
 #include "cdt_types.h"
 #include <aerospike/as_log_macros.h>
-
-PyObject *py_global_hosts;
-int counter = 0xA8000000;
-bool user_shm_key = false;
+#include <citrusleaf/alloc.h>
+#include "module_state.h"
 
 PyDoc_STRVAR(client_doc, "client(config) -> client object\n\
 \n\
@@ -66,6 +66,12 @@ static PyMethodDef Aerospike_Methods[] = {
      METH_VARARGS | METH_KEYWORDS, "Sets the log level"},
     {"set_log_handler", (PyCFunction)Aerospike_Set_Log_Handler,
      METH_VARARGS | METH_KEYWORDS, "Enables the log handler"},
+    {"drain_logs", (PyCFunction)Aerospike_Drain_Logs, METH_NOARGS,
+     "Delivers all queued log records to the log handler"},
+    {"get_log_stats", (PyCFunction)Aerospike_Get_Log_Stats, METH_NOARGS,
+     "Gets the delivered, dropped and pending log record counts"},
+    {"get_allocator_stats", (PyCFunction)Aerospike_Get_Allocator_Stats,
+     METH_NOARGS, "Gets the allocator and the bytes allocated by subsystem"},
     {"geodata", (PyCFunction)Aerospike_Set_Geo_Data,
      METH_VARARGS | METH_KEYWORDS,
      "Creates a GeoJSON object from geospatial data."},
@@ -104,104 +110,153 @@ static AerospikeConstants auth_mode_constants[] = {
 #define AUTH_MODE_CONSTANTS_ARR_SIZE                                           \
     (sizeof(auth_mode_constants) / sizeof(AerospikeConstants))
 
-struct Aerospike_State {
-    PyObject *exception;
-    PyTypeObject *client;
-    PyTypeObject *query;
-    PyTypeObject *scan;
-    PyTypeObject *kdict;
-    PyObject *predicates;
-    PyTypeObject *geospatial;
-    PyTypeObject *null_object;
-    PyTypeObject *wildcard_object;
-    PyTypeObject *infinite_object;
-};
-
-#define Aerospike_State(o) ((struct Aerospike_State *)PyModule_GetState(o))
+/*
+ * The heap types and serializer callbacks may refer back to the module, so
+ * the state takes part in garbage collection.
+ */
+static int Aerospike_Traverse(PyObject *aerospike, visitproc visit, void *arg)
+{
+    struct Aerospike_State *state = Aerospike_State(aerospike);
+    if (!state) {
+        return 0;
+    }
+
+    Py_VISIT(state->exception);
+    Py_VISIT(state->client);
+    Py_VISIT(state->query);
+    Py_VISIT(state->scan);
+    Py_VISIT(state->kdict);
+    Py_VISIT(state->key);
+    Py_VISIT(state->predicates);
+    Py_VISIT(state->geospatial);
+    Py_VISIT(state->null_object);
+    Py_VISIT(state->wildcard_object);
+    Py_VISIT(state->infinite_object);
+    Py_VISIT(state->bytes_view);
+    Py_VISIT(state->py_decimal_type);
+    Py_VISIT(state->py_uuid_type);
+    for (int i = 0; i < FASTCALL_MAX_PARSERS; i++) {
+        Py_VISIT(state->fastcall_keywords[i]);
+    }
+    if (state->user_serializer) {
+        Py_VISIT(state->user_serializer->callback);
+    }
+    if (state->user_deserializer) {
+        Py_VISIT(state->user_deserializer->callback);
+    }
+
+    return 0;
+}
+
+static void clear_serializer(user_serializer_callback **slot)
+{
+    user_serializer_callback *callback = *slot;
+    if (callback) {
+        *slot = NULL;
+        Py_CLEAR(callback->callback);
+        cf_free(callback);
+    }
+}
 
 static int Aerospike_Clear(PyObject *aerospike)
 {
-    Py_CLEAR(Aerospike_State(aerospike)->exception);
-    Py_CLEAR(Aerospike_State(aerospike)->client);
-    Py_CLEAR(Aerospike_State(aerospike)->query);
-    Py_CLEAR(Aerospike_State(aerospike)->scan);
-    Py_CLEAR(Aerospike_State(aerospike)->kdict);
-    Py_CLEAR(Aerospike_State(aerospike)->predicates);
-    Py_CLEAR(Aerospike_State(aerospike)->geospatial);
-    Py_CLEAR(Aerospike_State(aerospike)->null_object);
-    Py_CLEAR(Aerospike_State(aerospike)->wildcard_object);
-    Py_CLEAR(Aerospike_State(aerospike)->infinite_object);
+    struct Aerospike_State *state = Aerospike_State(aerospike);
+    if (!state) {
+        return 0;
+    }
+
+    Py_CLEAR(state->exception);
+    Py_CLEAR(state->client);
+    Py_CLEAR(state->query);
+    Py_CLEAR(state->scan);
+    Py_CLEAR(state->kdict);
+    Py_CLEAR(state->key);
+    Py_CLEAR(state->predicates);
+    Py_CLEAR(state->geospatial);
+    Py_CLEAR(state->null_object);
+    Py_CLEAR(state->wildcard_object);
+    Py_CLEAR(state->infinite_object);
+    Py_CLEAR(state->bytes_view);
+    Py_CLEAR(state->py_decimal_type);
+    Py_CLEAR(state->py_uuid_type);
+    for (int i = 0; i < FASTCALL_MAX_PARSERS; i++) {
+        Py_CLEAR(state->fastcall_keywords[i]);
+    }
+    clear_serializer(&state->user_serializer);
+    clear_serializer(&state->user_deserializer);
 
     return 0;
 }
 
-PyMODINIT_FUNC PyInit_aerospike(void)
+static void Aerospike_Free(void *aerospike)
 {
+    Aerospike_Clear((PyObject *)aerospike);
+}
 
-    const char version[] = "13.0.0";
-    // Makes things "thread-safe"
-    Py_Initialize();
-    int i = 0;
-
-    static struct PyModuleDef moduledef = {PyModuleDef_HEAD_INIT,
-                                           "aerospike",
-                                           "Aerospike Python Client",
-                                           sizeof(struct Aerospike_State),
-                                           Aerospike_Methods,
-                                           NULL,
-                                           NULL,
-                                           Aerospike_Clear};
+/*
+ * Adds py_obj to the module. The caller keeps its own reference in the module
+ * state.
+ */
+static int add_object(PyObject *aerospike, const char *name, PyObject *py_obj)
+{
+    if (!py_obj) {
+        return -1;
+    }
 
-    PyObject *aerospike = PyModule_Create(&moduledef);
+    Py_INCREF(py_obj);
+    if (PyModule_AddObject(aerospike, name, py_obj) == -1) {
+        Py_DECREF(py_obj);
+        return -1;
+    }
+    return 0;
+}
 
-    // In case adding objects to module fails, we can properly deallocate the module state later
-    memset(Aerospike_State(aerospike), NULL, sizeof(struct Aerospike_State));
+static int Aerospike_Exec(PyObject *aerospike)
+{
+    const char version[] = "13.0.0";
+    struct Aerospike_State *state = Aerospike_State(aerospike);
+    int i = 0;
 
+    // Process wide, so only the first import sets them up.
     Aerospike_Enable_Default_Logging();
+    if (Aerospike_Init_Allocator() == -1) {
+        return -1;
+    }
 
-    py_global_hosts = PyDict_New();
+    Aerospike_Init_Fork_Handler();
 
     PyModule_AddStringConstant(aerospike, "__version__", version);
 
-    PyObject *exception = AerospikeException_New();
-    Py_INCREF(exception);
-    int retval = PyModule_AddObject(aerospike, "exception", exception);
-    if (retval == -1) {
-        goto CLEANUP;
+    state->exception = AerospikeException_New();
+    if (add_object(aerospike, "exception", state->exception) == -1) {
+        return -1;
+    }
+
+    state->client = AerospikeClient_Ready(aerospike);
+    if (add_object(aerospike, "Client", (PyObject *)state->client) == -1) {
+        return -1;
     }
-    Aerospike_State(aerospike)->exception = exception;
 
-    PyTypeObject *client = AerospikeClient_Ready();
-    Py_INCREF(client);
-    retval = PyModule_AddObject(aerospike, "Client", (PyObject *)client);
-    if (retval == -1) {
-        goto CLEANUP;
+    state->query = AerospikeQuery_Ready(aerospike);
+    if (add_object(aerospike, "Query", (PyObject *)state->query) == -1) {
+        return -1;
     }
-    Aerospike_State(aerospike)->client = client;
 
-    PyTypeObject *query = AerospikeQuery_Ready();
-    Py_INCREF(query);
-    retval = PyModule_AddObject(aerospike, "Query", (PyObject *)query);
-    if (retval == -1) {
-        goto CLEANUP;
+    state->scan = AerospikeScan_Ready(aerospike);
+    if (add_object(aerospike, "Scan", (PyObject *)state->scan) == -1) {
+        return -1;
     }
-    Aerospike_State(aerospike)->query = query;
 
-    PyTypeObject *scan = AerospikeScan_Ready();
-    Py_INCREF(scan);
-    retval = PyModule_AddObject(aerospike, "Scan", (PyObject *)scan);
-    if (retval == -1) {
-        goto CLEANUP;
+    state->kdict = AerospikeKeyOrderedDict_Ready(aerospike);
+    if (add_object(aerospike, "KeyOrderedDict", (PyObject *)state->kdict) ==
+        -1) {
+        return -1;
     }
-    Aerospike_State(aerospike)->scan = scan;
 
-    PyTypeObject *kdict = AerospikeKeyOrderedDict_Ready();
-    Py_INCREF(kdict);
-    retval = PyModule_AddObject(aerospike, "KeyOrderedDict", (PyObject *)kdict);
-    if (retval == -1) {
-        goto CLEANUP;
+    state->key = AerospikeKey_Ready(aerospike);
+    if (add_object(aerospike, "Key", (PyObject *)state->key) == -1) {
+        return -1;
     }
-    Aerospike_State(aerospike)->kdict = kdict;
 
     /*
 	 * Add constants to module.
@@ -219,51 +274,128 @@ PyMODINIT_FUNC PyInit_aerospike(void)
     declare_policy_constants(aerospike);
     declare_log_constants(aerospike);
 
-    PyObject *predicates = AerospikePredicates_New();
-    Py_INCREF(predicates);
-    retval = PyModule_AddObject(aerospike, "predicates", predicates);
-    if (retval == -1) {
-        goto CLEANUP;
+    state->predicates = AerospikePredicates_New();
+    if (add_object(aerospike, "predicates", state->predicates) == -1) {
+        return -1;
+    }
+
+    state->geospatial = AerospikeGeospatial_Ready(aerospike);
+    if (add_object(aerospike, "GeoJSON", (PyObject *)state->geospatial) ==
+        -1) {
+        return -1;
+    }
+
+    state->null_object = AerospikeNullObject_Ready(aerospike);
+    if (add_object(aerospike, "null", (PyObject *)state->null_object) == -1) {
+        return -1;
+    }
+
+    state->wildcard_object = AerospikeWildcardObject_Ready(aerospike);
+    if (add_object(aerospike, "CDTWildcard",
+                   (PyObject *)state->wildcard_object) == -1) {
+        return -1;
     }
-    Aerospike_State(aerospike)->predicates = predicates;
 
-    PyTypeObject *geospatial = AerospikeGeospatial_Ready();
-    Py_INCREF(geospatial);
-    retval = PyModule_AddObject(aerospike, "GeoJSON", (PyObject *)geospatial);
-    if (retval == -1) {
-        goto CLEANUP;
+    state->infinite_object = AerospikeInfiniteObject_Ready(aerospike);
+    if (add_object(aerospike, "CDTInfinite",
+                   (PyObject *)state->infinite_object) == -1) {
+        return -1;
     }
-    Aerospike_State(aerospike)->geospatial = geospatial;
 
-    PyTypeObject *null_object = AerospikeNullObject_Ready();
-    Py_INCREF(null_object);
-    retval = PyModule_AddObject(aerospike, "null", (PyObject *)null_object);
-    if (retval == -1) {
-        goto CLEANUP;
+    // Not part of the module's API, so not added to it.
+    state->bytes_view = AerospikeBytesView_Ready(aerospike);
+    if (!state->bytes_view) {
+        return -1;
+    }
+
+    return 0;
+}
+
+static PyModuleDef_Slot Aerospike_Slots[] = {
+    {Py_mod_exec, Aerospike_Exec},
+#if PY_VERSION_HEX >= 0x030C0000
+    // Nothing is shared between interpreters but the C client's clusters,
+    // which are not Python objects.
+    {Py_mod_multiple_interpreters, Py_MOD_PER_INTERPRETER_GIL_SUPPORTED},
+#endif
+#if PY_VERSION_HEX >= 0x030D0000
+    {Py_mod_gil, Py_MOD_GIL_NOT_USED},
+#endif
+    {0, NULL}};
+
+static struct PyModuleDef moduledef = {PyModuleDef_HEAD_INIT,
+                                       "aerospike",
+                                       "Aerospike Python Client",
+                                       sizeof(struct Aerospike_State),
+                                       Aerospike_Methods,
+                                       Aerospike_Slots,
+                                       Aerospike_Traverse,
+                                       Aerospike_Clear,
+                                       Aerospike_Free};
+
+struct Aerospike_State *Aerospike_Get_State(void)
+{
+    PyObject *py_name = PyUnicode_FromString("aerospike");
+    if (!py_name) {
+        return NULL;
     }
-    Aerospike_State(aerospike)->null_object = null_object;
-
-    PyTypeObject *wildcard_object = AerospikeWildcardObject_Ready();
-    Py_INCREF(wildcard_object);
-    retval = PyModule_AddObject(aerospike, "CDTWildcard",
-                                (PyObject *)wildcard_object);
-    if (retval == -1) {
-        goto CLEANUP;
+    PyObject *module = PyImport_GetModule(py_name);
+    Py_DECREF(py_name);
+
+    if (!module) {
+        if (!PyErr_Occurred()) {
+            PyErr_SetString(PyExc_ImportError,
+                            "The aerospike module has not been imported");
+        }
+        return NULL;
     }
-    Aerospike_State(aerospike)->wildcard_object = wildcard_object;
-
-    PyTypeObject *infinite_object = AerospikeInfiniteObject_Ready();
-    Py_INCREF(infinite_object);
-    retval = PyModule_AddObject(aerospike, "CDTInfinite",
-                                (PyObject *)infinite_object);
-    if (retval == -1) {
-        goto CLEANUP;
+    if (PyModule_GetDef(module) != &moduledef) {
+        Py_DECREF(module);
+        PyErr_SetString(PyExc_ImportError,
+                        "sys.modules['aerospike'] is not the aerospike module");
+        return NULL;
+    }
+
+    // sys.modules keeps the module alive.
+    struct Aerospike_State *state = Aerospike_State(module);
+    Py_DECREF(module);
+    return state;
+}
+
+struct Aerospike_State *Aerospike_Get_Type_State(PyTypeObject *type)
+{
+#if PY_VERSION_HEX >= 0x030B0000
+    PyObject *module = PyType_GetModuleByDef(type, &moduledef);
+    return module ? Aerospike_State(module) : NULL;
+#else
+    // Types can only find their module from 3.11, before that it is looked
+    // up in the current interpreter.
+    return Aerospike_Get_State();
+#endif
+}
+
+PyTypeObject *Aerospike_New_Type(PyObject *module, PyType_Spec *spec,
+                                 PyTypeObject *base)
+{
+    PyObject *py_bases = NULL;
+    if (base) {
+        py_bases = PyTuple_Pack(1, (PyObject *)base);
+        if (!py_bases) {
+            return NULL;
+        }
     }
-    Aerospike_State(aerospike)->infinite_object = infinite_object;
 
-    return aerospike;
+#if PY_VERSION_HEX >= 0x03090000
+    PyObject *type = PyType_FromModuleAndSpec(module, spec, py_bases);
+#else
+    PyObject *type = PyType_FromSpecWithBases(spec, py_bases);
+#endif
 
-CLEANUP:
-    Aerospike_Clear(aerospike);
-    return NULL;
+    Py_XDECREF(py_bases);
+    return (PyTypeObject *)type;
+}
+
+PyMODINIT_FUNC PyInit_aerospike(void)
+{
+    return PyModuleDef_Init(&moduledef);
 }
@@ -0,0 +1,471 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "allocator.h"
+
+// Room for the header, keeping blocks aligned as malloc() does.
+#define ALLOCATOR_HEADER_SIZE 16
+// Cached blocks are 32 bytes to 4 KiB, header included.
+#define ALLOCATOR_CLASSES 8
+#define ALLOCATOR_MIN_CLASS 32
+// Blocks not in a size class go straight to malloc().
+#define ALLOCATOR_LARGE 0xff
+// Blocks a thread keeps in each class before returning half of them.
+#define THREAD_CACHE_MAX 64
+#define ALLOCATOR_SLAB_SIZE (64 * 1024)
+
+typedef enum {
+    ALLOCATOR_SYSTEM,
+    ALLOCATOR_PYMEM,
+    ALLOCATOR_CACHED
+} allocator_mode;
+
+static const char *mode_names[] = {"system", "pymem", "cached"};
+
+static const char *subsystem_names[ALLOCATOR_SUBSYSTEMS] = {
+    "client", "batch", "read_cache", "hedged_read", "operations"};
+
+typedef struct {
+    // The size asked for.
+    size_t size;
+    uint8_t subsystem;
+    uint8_t size_class;
+    // The allocator of the block, fixed at import but kept to be safe.
+    uint8_t mode;
+} block_header;
+
+typedef struct free_block_s {
+    struct free_block_s *next;
+} free_block;
+
+typedef struct {
+    free_block *blocks;
+    uint32_t count;
+} free_list;
+
+typedef struct {
+    free_list lists[ALLOCATOR_CLASSES];
+} thread_cache;
+
+typedef struct {
+    uint64_t bytes;
+    uint64_t blocks;
+    uint64_t total_bytes;
+} allocator_counters;
+
+static allocator_mode mode = ALLOCATOR_SYSTEM;
+static const char *invalid_mode = NULL;
+static pthread_once_t allocator_once = PTHREAD_ONCE_INIT;
+
+static allocator_counters counters[ALLOCATOR_SUBSYSTEMS];
+
+// Blocks returned by threads, and the slab new blocks are cut from. Slabs are
+// never freed, so the memory of the cache is reused rather than fragmented.
+static pthread_mutex_t central_lock = PTHREAD_MUTEX_INITIALIZER;
+static free_list central[ALLOCATOR_CLASSES];
+static char *slab = NULL;
+static size_t slab_left = 0;
+static uint64_t reserved_bytes = 0;
+static pthread_key_t cache_key;
+
+static size_t class_size(uint8_t size_class)
+{
+    return (size_t)ALLOCATOR_MIN_CLASS << size_class;
+}
+
+static uint8_t size_class_of(size_t total)
+{
+    for (uint8_t i = 0; i < ALLOCATOR_CLASSES; i++) {
+        if (total <= class_size(i)) {
+            return i;
+        }
+    }
+    return ALLOCATOR_LARGE;
+}
+
+static void *raw_malloc(allocator_mode raw_mode, size_t size)
+{
+    return raw_mode == ALLOCATOR_PYMEM ? PyMem_RawMalloc(size) : malloc(size);
+}
+
+static void *raw_realloc(allocator_mode raw_mode, void *ptr, size_t size)
+{
+    return raw_mode == ALLOCATOR_PYMEM ? PyMem_RawRealloc(ptr, size)
+                                       : realloc(ptr, size);
+}
+
+static void raw_free(allocator_mode raw_mode, void *ptr)
+{
+    if (raw_mode == ALLOCATOR_PYMEM) {
+        PyMem_RawFree(ptr);
+    }
+    else {
+        free(ptr);
+    }
+}
+
+/*******************************************************************************
+ * THREAD CACHE
+ ******************************************************************************/
+
+static void list_push(free_list *list, free_block *block)
+{
+    block->next = list->blocks;
+    list->blocks = block;
+    list->count++;
+}
+
+static free_block *list_pop(free_list *list)
+{
+    free_block *block = list->blocks;
+    if (block) {
+        list->blocks = block->next;
+        list->count--;
+    }
+    return block;
+}
+
+/*
+ * Moves count blocks from one list to the other. The central list is locked
+ * by the caller.
+ */
+static void list_move(free_list *from, free_list *to, uint32_t count)
+{
+    for (uint32_t i = 0; i < count && from->blocks; i++) {
+        list_push(to, list_pop(from));
+    }
+}
+
+static void thread_cache_destroy(void *udata)
+{
+    thread_cache *cache = (thread_cache *)udata;
+
+    pthread_mutex_lock(&central_lock);
+    for (uint8_t i = 0; i < ALLOCATOR_CLASSES; i++) {
+        list_move(&cache->lists[i], &central[i], cache->lists[i].count);
+    }
+    pthread_mutex_unlock(&central_lock);
+    free(cache);
+}
+
+static thread_cache *thread_cache_get(void)
+{
+    thread_cache *cache = (thread_cache *)pthread_getspecific(cache_key);
+    if (!cache) {
+        cache = (thread_cache *)calloc(1, sizeof(thread_cache));
+        if (cache && pthread_setspecific(cache_key, cache) != 0) {
+            free(cache);
+            cache = NULL;
+        }
+    }
+    return cache;
+}
+
+/*
+ * Takes half a thread cache of blocks from the central list, or from the slab
+ * once it is empty.
+ */
+static void refill(free_list *list, uint8_t size_class)
+{
+    size_t size = class_size(size_class);
+
+    pthread_mutex_lock(&central_lock);
+    list_move(&central[size_class], list, THREAD_CACHE_MAX / 2);
+    while (list->count < THREAD_CACHE_MAX / 2) {
+        if (slab_left < size) {
+            // The rest of the old slab is lost, at most a block's worth.
+            slab = (char *)malloc(ALLOCATOR_SLAB_SIZE);
+            if (!slab) {
+                slab_left = 0;
+                break;
+            }
+            slab_left = ALLOCATOR_SLAB_SIZE;
+            reserved_bytes += ALLOCATOR_SLAB_SIZE;
+        }
+        list_push(list, (free_block *)slab);
+        slab += size;
+        slab_left -= size;
+    }
+    pthread_mutex_unlock(&central_lock);
+}
+
+static void *cached_malloc(uint8_t size_class)
+{
+    thread_cache *cache = thread_cache_get();
+    if (!cache) {
+        return NULL;
+    }
+
+    free_list *list = &cache->lists[size_class];
+    if (!list->blocks) {
+        refill(list, size_class);
+    }
+    return list_pop(list);
+}
+
+static void cached_free(void *block, uint8_t size_class)
+{
+    thread_cache *cache = thread_cache_get();
+    if (!cache) {
+        pthread_mutex_lock(&central_lock);
+        list_push(&central[size_class], (free_block *)block);
+        pthread_mutex_unlock(&central_lock);
+        return;
+    }
+
+    free_list *list = &cache->lists[size_class];
+    list_push(list, (free_block *)block);
+    if (list->count > THREAD_CACHE_MAX) {
+        pthread_mutex_lock(&central_lock);
+        list_move(list, &central[size_class], THREAD_CACHE_MAX / 2);
+        pthread_mutex_unlock(&central_lock);
+    }
+}
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+static void allocator_init(void)
+{
+    const char *name = getenv("AEROSPIKE_ALLOCATOR");
+    if (!name || !name[0]) {
+        return;
+    }
+
+    invalid_mode = name;
+    for (int i = 0; i < (int)(sizeof(mode_names) / sizeof(mode_names[0]));
+         i++) {
+        if (strcmp(name, mode_names[i]) == 0) {
+            mode = (allocator_mode)i;
+            invalid_mode = NULL;
+            break;
+        }
+    }
+
+    if (mode == ALLOCATOR_CACHED &&
+        pthread_key_create(&cache_key, thread_cache_destroy) != 0) {
+        mode = ALLOCATOR_SYSTEM;
+    }
+}
+
+int Aerospike_Init_Allocator(void)
+{
+    pthread_once(&allocator_once, allocator_init);
+
+    if (invalid_mode) {
+        return PyErr_WarnFormat(PyExc_RuntimeWarning, 1,
+                                "unknown AEROSPIKE_ALLOCATOR \"%s\", using "
+                                "\"system\"",
+                                invalid_mode);
+    }
+    return 0;
+}
+
+void *allocator_malloc(allocator_subsystem subsystem, size_t size)
+{
+    if (size > SIZE_MAX - ALLOCATOR_HEADER_SIZE) {
+        return NULL;
+    }
+
+    size_t total = size + ALLOCATOR_HEADER_SIZE;
+    uint8_t size_class =
+        mode == ALLOCATOR_CACHED ? size_class_of(total) : ALLOCATOR_LARGE;
+    allocator_mode raw_mode =
+        mode == ALLOCATOR_PYMEM ? ALLOCATOR_PYMEM : ALLOCATOR_SYSTEM;
+
+    block_header *header =
+        (block_header *)(size_class == ALLOCATOR_LARGE
+                             ? raw_malloc(raw_mode, total)
+                             : cached_malloc(size_class));
+    if (!header) {
+        return NULL;
+    }
+
+    header->size = size;
+    header->subsystem = (uint8_t)subsystem;
+    header->size_class = size_class;
+    header->mode = (uint8_t)raw_mode;
+
+    allocator_counters *counter = &counters[subsystem];
+    __atomic_fetch_add(&counter->bytes, size, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&counter->blocks, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&counter->total_bytes, size, __ATOMIC_RELAXED);
+
+    return (char *)header + ALLOCATOR_HEADER_SIZE;
+}
+
+void *allocator_calloc(allocator_subsystem subsystem, size_t count, size_t size)
+{
+    if (size && count > SIZE_MAX / size) {
+        return NULL;
+    }
+
+    // Cached blocks are reused, so they are cleared here whatever the mode.
+    void *ptr = allocator_malloc(subsystem, count * size);
+    if (ptr) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+char *allocator_strdup(allocator_subsystem subsystem, const char *str)
+{
+    size_t size = strlen(str) + 1;
+    char *copy = (char *)allocator_malloc(subsystem, size);
+    if (copy) {
+        memcpy(copy, str, size);
+    }
+    return copy;
+}
+
+void *allocator_realloc(allocator_subsystem subsystem, void *ptr, size_t size)
+{
+    if (!ptr) {
+        return allocator_malloc(subsystem, size);
+    }
+
+    if (size > SIZE_MAX - ALLOCATOR_HEADER_SIZE) {
+        return NULL;
+    }
+
+    block_header *header =
+        (block_header *)((char *)ptr - ALLOCATOR_HEADER_SIZE);
+    size_t total = size + ALLOCATOR_HEADER_SIZE;
+
+    if (header->size_class == ALLOCATOR_LARGE ||
+        total <= class_size(header->size_class)) {
+        allocator_counters *old = &counters[header->subsystem];
+        size_t old_size = header->size;
+
+        if (header->size_class == ALLOCATOR_LARGE) {
+            header = (block_header *)raw_realloc((allocator_mode)header->mode,
+                                                 header, total);
+            if (!header) {
+                return NULL;
+            }
+        }
+
+        __atomic_fetch_sub(&old->bytes, old_size, __ATOMIC_RELAXED);
+        __atomic_fetch_sub(&old->blocks, 1, __ATOMIC_RELAXED);
+
+        header->size = size;
+        header->subsystem = (uint8_t)subsystem;
+
+        allocator_counters *counter = &counters[subsystem];
+        __atomic_fetch_add(&counter->bytes, size, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&counter->blocks, 1, __ATOMIC_RELAXED);
+        if (size > old_size) {
+            __atomic_fetch_add(&counter->total_bytes, size - old_size,
+                               __ATOMIC_RELAXED);
+        }
+        return (char *)header + ALLOCATOR_HEADER_SIZE;
+    }
+
+    // The block outgrew its size class.
+    void *new_ptr = allocator_malloc(subsystem, size);
+    if (new_ptr) {
+        memcpy(new_ptr, ptr, header->size);
+        allocator_free(ptr);
+    }
+    return new_ptr;
+}
+
+void allocator_free(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+
+    block_header *header =
+        (block_header *)((char *)ptr - ALLOCATOR_HEADER_SIZE);
+
+    allocator_counters *counter = &counters[header->subsystem];
+    __atomic_fetch_sub(&counter->bytes, header->size, __ATOMIC_RELAXED);
+    __atomic_fetch_sub(&counter->blocks, 1, __ATOMIC_RELAXED);
+
+    if (header->size_class == ALLOCATOR_LARGE) {
+        raw_free((allocator_mode)header->mode, header);
+    }
+    else {
+        cached_free(header, header->size_class);
+    }
+}
+
+void allocator_fork_lock(void)
+{
+    pthread_mutex_lock(&central_lock);
+}
+
+void allocator_fork_unlock(void)
+{
+    // The caches of the parent's other threads are not in the child, and
+    // their blocks are lost to it.
+    pthread_mutex_unlock(&central_lock);
+}
+
+/**
+ *******************************************************************************************************
+ * Returns the allocator and the memory allocated through it by subsystem.
+ *
+ * Returns a dict.
+ *******************************************************************************************************
+ */
+PyObject *Aerospike_Get_Allocator_Stats(PyObject *parent, PyObject *args)
+{
+    PyObject *py_subsystems = PyDict_New();
+    if (!py_subsystems) {
+        return NULL;
+    }
+
+    for (int i = 0; i < ALLOCATOR_SUBSYSTEMS; i++) {
+        allocator_counters *counter = &counters[i];
+        PyObject *py_counters = Py_BuildValue(
+            "{s:K,s:K,s:K}", "bytes",
+            (unsigned long long)__atomic_load_n(&counter->bytes,
+                                                __ATOMIC_RELAXED),
+            "blocks",
+            (unsigned long long)__atomic_load_n(&counter->blocks,
+                                                __ATOMIC_RELAXED),
+            "total_bytes",
+            (unsigned long long)__atomic_load_n(&counter->total_bytes,
+                                                __ATOMIC_RELAXED));
+        if (!py_counters || PyDict_SetItemString(py_subsystems,
+                                                 subsystem_names[i],
+                                                 py_counters) == -1) {
+            Py_XDECREF(py_counters);
+            Py_DECREF(py_subsystems);
+            return NULL;
+        }
+        Py_DECREF(py_counters);
+    }
+
+    pthread_mutex_lock(&central_lock);
+    uint64_t reserved = reserved_bytes;
+    pthread_mutex_unlock(&central_lock);
+
+    return Py_BuildValue("{s:s,s:K,s:N}", "allocator", mode_names[mode],
+                         "reserved_bytes", (unsigned long long)reserved,
+                         "subsystems", py_subsystems);
+}
@@ -69,7 +69,7 @@ static PyObject *Aerospike_Calc_Digest_Invoke(PyObject *py_ns, PyObject *py_set,
     PyDict_SetItemString(py_keydict, "key", py_key);
 
     // Convert python key object to as_key
-    pyobject_to_key(&err, py_keydict, &key);
+    pyobject_to_key(NULL, &err, py_keydict, &key);
     if (err.code != AEROSPIKE_OK) {
         goto CLEANUP;
     }
@@ -20,120 +20,48 @@
 #include <unistd.h>
 #include "types.h"
 #include "cdt_types.h"
+#include "module_state.h"
 
-static PyObject *AerospikeWildCardType_New(PyTypeObject *parent, PyObject *args,
-                                           PyObject *kwds);
-static PyObject *AerospikeInfiniteType_New(PyTypeObject *parent, PyObject *args,
-                                           PyObject *kwds);
+static PyObject *AerospikeCDTType_New(PyTypeObject *type, PyObject *args,
+                                      PyObject *kwds)
+{
+    return type->tp_alloc(type, 0);
+}
 
 /*******************************************************************************
  * PYTHON TYPE DESCRIPTOR
  ******************************************************************************/
 
-static PyTypeObject AerospikeCDTWildcard_Type = {
-    PyVarObject_HEAD_INIT(NULL, 0) AS_CDT_WILDCARD_NAME, // tp_name
-    sizeof(AerospikeCDTWildcardObject),                  // tp_basicsize
-    0,                                                   // tp_itemsize
-    0,                                                   // tp_dealloc
-    0,                                                   // tp_print
-    0,                                                   // tp_getattr
-    0,                                                   // tp_setattr
-    0,                                                   // tp_compare
-    0,                                                   // tp_repr
-    0,                                                   // tp_as_number
-    0,                                                   // tp_as_sequence
-    0,                                                   // tp_as_mapping
-    0,                                                   // tp_hash
-    0,                                                   // tp_call
-    0,                                                   // tp_str
-    0,                                                   // tp_getattro
-    0,                                                   // tp_setattro
-    0,                                                   // tp_as_buffer
-    Py_TPFLAGS_DEFAULT,                                  // tp_flags
-    "A type used to match anything when used in a Map or list "
-    "comparison.\n",          //tp_doc
-    0,                        // tp_traverse
-    0,                        // tp_clear
-    0,                        // tp_richcompare
-    0,                        // tp_weaklistoffset
-    0,                        // tp_iter
-    0,                        // tp_iternext
-    0,                        // tp_methods
-    0,                        // tp_members
-    0,                        // tp_getset
-    0,                        // tp_base
-    0,                        // tp_dict
-    0,                        // tp_descr_get
-    0,                        // tp_descr_set
-    0,                        // tp_dictoffset
-    0,                        // tp_init
-    0,                        // tp_alloc
-    AerospikeWildCardType_New // tp_new
-};
-
-PyTypeObject *AerospikeWildcardObject_Ready()
-{
-    return PyType_Ready(&AerospikeCDTWildcard_Type) == 0
-               ? &AerospikeCDTWildcard_Type
-               : NULL;
-}
+static PyType_Slot AerospikeCDTWildcard_Type_Slots[] = {
+    {Py_tp_doc, "A type used to match anything when used in a Map or list "
+                "comparison.\n"},
+    {Py_tp_new, AerospikeCDTType_New},
+    {0, NULL}};
 
-static PyTypeObject AerospikeCDTInfinite_Type = {
-    PyVarObject_HEAD_INIT(NULL, 0) AS_CDT_INFINITE_NAME, // tp_name
-    sizeof(AerospikeCDTInfObject),                       // tp_basicsize
-    0,                                                   // tp_itemsize
-    0,                                                   // tp_dealloc
-    0,                                                   // tp_print
-    0,                                                   // tp_getattr
-    0,                                                   // tp_setattr
-    0,                                                   // tp_compare
-    0,                                                   // tp_repr
-    0,                                                   // tp_as_number
-    0,                                                   // tp_as_sequence
-    0,                                                   // tp_as_mapping
-    0,                                                   // tp_hash
-    0,                                                   // tp_call
-    0,                                                   // tp_str
-    0,                                                   // tp_getattro
-    0,                                                   // tp_setattro
-    0,                                                   // tp_as_buffer
-    Py_TPFLAGS_DEFAULT,                                  // tp_flags
-    "A type used to match anything when used in a Map or list "
-    "comparison.\n",          //tp_doc
-    0,                        // tp_traverse
-    0,                        // tp_clear
-    0,                        // tp_richcompare
-    0,                        // tp_weaklistoffset
-    0,                        // tp_iter
-    0,                        // tp_iternext
-    0,                        // tp_methods
-    0,                        // tp_members
-    0,                        // tp_getset
-    0,                        // tp_base
-    0,                        // tp_dict
-    0,                        // tp_descr_get
-    0,                        // tp_descr_set
-    0,                        // tp_dictoffset
-    0,                        // tp_init
-    0,                        // tp_alloc
-    AerospikeInfiniteType_New // tp_new
-};
+static PyType_Spec AerospikeCDTWildcard_Type_Spec = {
+    .name = AS_CDT_WILDCARD_NAME,
+    .basicsize = sizeof(AerospikeCDTWildcardObject),
+    .flags = Py_TPFLAGS_DEFAULT,
+    .slots = AerospikeCDTWildcard_Type_Slots};
 
-PyTypeObject *AerospikeInfiniteObject_Ready()
+PyTypeObject *AerospikeWildcardObject_Ready(PyObject *module)
 {
-    return PyType_Ready(&AerospikeCDTInfinite_Type) == 0
-               ? &AerospikeCDTInfinite_Type
-               : NULL;
+    return Aerospike_New_Type(module, &AerospikeCDTWildcard_Type_Spec, NULL);
 }
 
-static PyObject *AerospikeWildCardType_New(PyTypeObject *parent, PyObject *args,
-                                           PyObject *kwds)
-{
-    return (PyObject *)PyObject_New(AerospikeCDTWildcardObject, parent);
-}
+static PyType_Slot AerospikeCDTInfinite_Type_Slots[] = {
+    {Py_tp_doc, "A type used to match anything when used in a Map or list "
+                "comparison.\n"},
+    {Py_tp_new, AerospikeCDTType_New},
+    {0, NULL}};
+
+static PyType_Spec AerospikeCDTInfinite_Type_Spec = {
+    .name = AS_CDT_INFINITE_NAME,
+    .basicsize = sizeof(AerospikeCDTInfObject),
+    .flags = Py_TPFLAGS_DEFAULT,
+    .slots = AerospikeCDTInfinite_Type_Slots};
 
-static PyObject *AerospikeInfiniteType_New(PyTypeObject *parent, PyObject *args,
-                                           PyObject *kwds)
+PyTypeObject *AerospikeInfiniteObject_Ready(PyObject *module)
 {
-    return (PyObject *)PyObject_New(AerospikeCDTInfObject, parent);
+    return Aerospike_New_Type(module, &AerospikeCDTInfinite_Type_Spec, NULL);
 }
@@ -0,0 +1,246 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include <aerospike/as_error.h>
+#include <aerospike/as_policy.h>
+
+#include "adaptive_policy.h"
+#include "allocator.h"
+#include "client.h"
+#include "client_utils.h"
+#include "latency_window.h"
+
+#define ADAPTIVE_DEFAULT_PERCENTILE 99.0
+#define ADAPTIVE_DEFAULT_MULTIPLIER 1.5
+#define ADAPTIVE_DEFAULT_MIN_TIMEOUT_MS 10
+#define ADAPTIVE_DEFAULT_RETRY_RATIO 0.1
+#define ADAPTIVE_DEFAULT_MAX_TOKENS 100
+
+struct adaptive_policy_s {
+    pthread_mutex_t lock;
+    bool adapt_timeouts;
+    double multiplier;
+    uint32_t min_timeout_ms;
+    latency_window reads;
+    latency_window writes;
+    // Retries are allowed while more than half of max_tokens remain. Each
+    // command which does not fail adds ratio tokens and each failure takes
+    // one, so retries stop once failures exceed ratio of the traffic.
+    bool retry_budget;
+    double ratio;
+    double max_tokens;
+    double tokens;
+    // A lock inherited across fork() may have been held.
+    pid_t pid;
+};
+
+/*
+ * Errors which a retry may not get, and which do not measure the latency of
+ * a response.
+ */
+static bool is_failure(as_status status)
+{
+    switch (status) {
+    case AEROSPIKE_ERR_TIMEOUT:
+    case AEROSPIKE_ERR_CONNECTION:
+    case AEROSPIKE_ERR_NO_MORE_CONNECTIONS:
+    case AEROSPIKE_ERR_INVALID_NODE:
+    case AEROSPIKE_ERR_DEVICE_OVERLOAD:
+    case AEROSPIKE_ERR_CLUSTER_CHANGE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static void adaptive_policy_fork_reset(void *udata)
+{
+    adaptive_policy *adaptive = (adaptive_policy *)udata;
+    pthread_mutex_init(&adaptive->lock, NULL);
+}
+/*******************************************************************************
+ * CONFIG
+ ******************************************************************************/
+
+static bool config_get_double(PyObject *py_config, const char *config,
+                              const char *name, double min, double max,
+                              double *value, as_error *err)
+{
+    PyObject *py_value = PyDict_GetItemString(py_config, name);
+    if (!py_value) {
+        return true;
+    }
+
+    double temp = PyFloat_AsDouble(py_value);
+    if (PyErr_Occurred() || !(temp > min && temp <= max)) {
+        PyErr_Clear();
+        as_error_update(err, AEROSPIKE_ERR_PARAM,
+                        "%s %s must be greater than %g and at most %g", config,
+                        name, min, max);
+        return false;
+    }
+
+    *value = temp;
+    return true;
+}
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+adaptive_policy *adaptive_policy_new(PyObject *py_timeouts,
+                                     PyObject *py_budget, as_error *err)
+{
+    if (py_timeouts && !PyDict_Check(py_timeouts)) {
+        as_error_update(err, AEROSPIKE_ERR_PARAM,
+                        "adaptive_timeouts must be a dict");
+        return NULL;
+    }
+    if (py_budget && !PyDict_Check(py_budget)) {
+        as_error_update(err, AEROSPIKE_ERR_PARAM,
+                        "retry_budget must be a dict");
+        return NULL;
+    }
+
+    adaptive_policy *adaptive = (adaptive_policy *)allocator_calloc(
+        ALLOCATOR_CLIENT, 1, sizeof(adaptive_policy));
+    if (!adaptive) {
+        as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                        "Failed to allocate memory for adaptive policies");
+        return NULL;
+    }
+    double percentile = ADAPTIVE_DEFAULT_PERCENTILE;
+    uint32_t max_tokens = ADAPTIVE_DEFAULT_MAX_TOKENS;
+    adaptive->multiplier = ADAPTIVE_DEFAULT_MULTIPLIER;
+    adaptive->min_timeout_ms = ADAPTIVE_DEFAULT_MIN_TIMEOUT_MS;
+    adaptive->ratio = ADAPTIVE_DEFAULT_RETRY_RATIO;
+
+    if (py_timeouts) {
+        adaptive->adapt_timeouts = true;
+        if (!config_get_double(py_timeouts, "adaptive_timeouts", "percentile",
+                               0, 99.99, &percentile, err) ||
+            !config_get_double(py_timeouts, "adaptive_timeouts",
+                               "multiplier", 0, 100, &adaptive->multiplier,
+                               err) ||
+            !client_config_get_uint32(py_timeouts, "adaptive_timeouts",
+                                      "min_timeout", 1, 3600000,
+                                      &adaptive->min_timeout_ms, err)) {
+            allocator_free(adaptive);
+            return NULL;
+        }
+    }
+
+    if (py_budget) {
+        adaptive->retry_budget = true;
+        if (!config_get_double(py_budget, "retry_budget", "ratio", 0, 1,
+                               &adaptive->ratio, err) ||
+            !client_config_get_uint32(py_budget, "retry_budget", "max_tokens",
+                                      1, 1000000, &max_tokens, err)) {
+            allocator_free(adaptive);
+            return NULL;
+        }
+    }
+
+    latency_window_init(&adaptive->reads, percentile);
+    latency_window_init(&adaptive->writes, percentile);
+    adaptive->max_tokens = max_tokens;
+    adaptive->tokens = max_tokens;
+    pthread_mutex_init(&adaptive->lock, NULL);
+    adaptive->pid = getpid();
+    return adaptive;
+}
+
+void adaptive_policy_destroy(adaptive_policy *adaptive)
+{
+    if (!adaptive) {
+        return;
+    }
+    pthread_mutex_destroy(&adaptive->lock);
+    allocator_free(adaptive);
+}
+
+uint64_t adaptive_policy_begin(AerospikeClient *self, as_policy_base *policy,
+                               bool read)
+{
+    adaptive_policy *adaptive = self->adaptive_policy;
+    if (!adaptive) {
+        return 0;
+    }
+
+    client_check_fork(&adaptive->pid, adaptive_policy_fork_reset, adaptive);
+
+    pthread_mutex_lock(&adaptive->lock);
+    if (adaptive->retry_budget &&
+        adaptive->tokens <= adaptive->max_tokens / 2) {
+        policy->max_retries = 0;
+    }
+
+    // A shorter socket timeout only serves to retry sooner, so the timeout
+    // of a command which will not be retried is left alone.
+    uint32_t latency_us =
+        read ? adaptive->reads.value : adaptive->writes.value;
+    if (adaptive->adapt_timeouts && latency_us > 0 &&
+        policy->max_retries > 0) {
+        uint32_t timeout_ms =
+            (uint32_t)(latency_us * adaptive->multiplier / 1000) + 1;
+        if (timeout_ms < adaptive->min_timeout_ms) {
+            timeout_ms = adaptive->min_timeout_ms;
+        }
+        // The configured socket timeout remains the longest.
+        if (policy->socket_timeout == 0 ||
+            timeout_ms < policy->socket_timeout) {
+            policy->socket_timeout = timeout_ms;
+        }
+    }
+    pthread_mutex_unlock(&adaptive->lock);
+
+    return client_now_us();
+}
+
+void adaptive_policy_end(AerospikeClient *self, uint64_t start, bool read,
+                         as_error *err)
+{
+    adaptive_policy *adaptive = self->adaptive_policy;
+    if (!adaptive || start == 0) {
+        return;
+    }
+
+    uint64_t latency_us = client_now_us() - start;
+    bool failed = is_failure(err->code);
+
+    pthread_mutex_lock(&adaptive->lock);
+    if (failed) {
+        adaptive->tokens = adaptive->tokens > 1 ? adaptive->tokens - 1 : 0;
+    }
+    else {
+        adaptive->tokens += adaptive->ratio;
+        if (adaptive->tokens > adaptive->max_tokens) {
+            adaptive->tokens = adaptive->max_tokens;
+        }
+        if (adaptive->adapt_timeouts) {
+            latency_window_add(read ? &adaptive->reads : &adaptive->writes,
+                               latency_us < UINT32_MAX ? (uint32_t)latency_us
+                                                       : UINT32_MAX);
+        }
+    }
+    pthread_mutex_unlock(&adaptive->lock);
+}
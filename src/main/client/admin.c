@@ -226,13 +226,7 @@ PyObject *AerospikeClient_Admin_Drop_User(AerospikeClient *self, PyObject *args,
 
     char *alias_to_search = NULL;
     alias_to_search = return_search_string(self->as);
-    PyObject *py_persistent_item = NULL;
-
-    py_persistent_item = PyDict_GetItemString(py_global_hosts, alias_to_search);
-    if (py_persistent_item) {
-        PyDict_DelItemString(py_global_hosts, alias_to_search);
-        AerospikeGlobalHosts_Del(py_persistent_item);
-    }
+    AerospikeGlobalHosts_Remove(alias_to_search);
     PyMem_Free(alias_to_search);
     alias_to_search = NULL;
 
@@ -429,13 +423,7 @@ PyObject *AerospikeClient_Admin_Change_Password(AerospikeClient *self,
 
     char *alias_to_search = NULL;
     alias_to_search = return_search_string(self->as);
-    PyObject *py_persistent_item = NULL;
-
-    py_persistent_item = PyDict_GetItemString(py_global_hosts, alias_to_search);
-    if (py_persistent_item) {
-        PyDict_DelItemString(py_global_hosts, alias_to_search);
-        AerospikeGlobalHosts_Del(py_persistent_item);
-    }
+    AerospikeGlobalHosts_Remove(alias_to_search);
     PyMem_Free(alias_to_search);
     alias_to_search = NULL;
 
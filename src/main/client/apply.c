@@ -22,10 +22,14 @@
 #include <aerospike/as_error.h>
 #include <aerospike/as_record.h>
 
+#include "adaptive_policy.h"
 #include "client.h"
+#include "command_limits.h"
 #include "conversions.h"
 #include "exceptions.h"
 #include "policy.h"
+#include "read_cache.h"
+#include "serializer.h"
 
 /**
  *******************************************************************************************************
@@ -92,9 +96,9 @@ PyObject *AerospikeClient_Apply_Invoke(AerospikeClient *self, PyObject *py_key,
         goto CLEANUP;
     }
 
-    self->is_client_put_serializer = false;
+    set_client_put_serializer(false);
     // Convert python key object to as_key
-    pyobject_to_key(&err, py_key, &key);
+    pyobject_to_key(self, &err, py_key, &key);
     if (err.code != AEROSPIKE_OK) {
         goto CLEANUP;
     }
@@ -138,10 +142,22 @@ PyObject *AerospikeClient_Apply_Invoke(AerospikeClient *self, PyObject *py_key,
     }
 
     // Invoke operation
+    command_permit permit;
+    if (!command_limits_acquire(self, COMMAND_LIMIT_UDF, py_policy, &key, 1,
+                                &permit, &err)) {
+        goto CLEANUP;
+    }
+    uint64_t start =
+        adaptive_policy_begin(self, &apply_policy_p->base, false);
     Py_BEGIN_ALLOW_THREADS
     aerospike_key_apply(self->as, &err, apply_policy_p, &key, module, function,
                         arglist, &result);
     Py_END_ALLOW_THREADS
+    command_limits_release(self, &permit);
+    adaptive_policy_end(self, start, false, &err);
+    if (self->read_cache) {
+        read_cache_invalidate(self->read_cache, &key);
+    }
 
     if (err.code == AEROSPIKE_OK) {
         val_to_pyobject(self, &err, result, &py_result);
@@ -171,23 +187,8 @@ CLEANUP:
     as_val_destroy(result);
 
     if (err.code != AEROSPIKE_OK) {
-        PyObject *py_err = NULL;
-        error_to_pyobject(&err, &py_err);
-        PyObject *exception_type = raise_exception_old(&err);
-        if (PyObject_HasAttrString(exception_type, "key")) {
-            PyObject_SetAttrString(exception_type, "key", py_key);
-        }
-        if (PyObject_HasAttrString(exception_type, "bin")) {
-            PyObject_SetAttrString(exception_type, "bin", Py_None);
-        }
-        if (PyObject_HasAttrString(exception_type, "module")) {
-            PyObject_SetAttrString(exception_type, "module", py_module);
-        }
-        if (PyObject_HasAttrString(exception_type, "func")) {
-            PyObject_SetAttrString(exception_type, "func", py_function);
-        }
-        PyErr_SetObject(exception_type, py_err);
-        Py_DECREF(py_err);
+        raise_exception_base(&err, py_key, Py_None, py_module, py_function,
+                             NULL);
         return NULL;
     }
 
@@ -0,0 +1,410 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <aerospike/aerospike_batch.h>
+#include <aerospike/as_batch.h>
+#include <aerospike/as_error.h>
+#include <aerospike/as_key.h>
+#include <aerospike/as_operations.h>
+#include <aerospike/as_record.h>
+
+#include "auto_batch.h"
+#include "allocator.h"
+#include "client.h"
+#include "client_utils.h"
+
+#define AUTO_BATCH_DEFAULT_WINDOW_US 200
+#define AUTO_BATCH_DEFAULT_MAX_KEYS 64
+
+/*
+ * A single-record command waiting to be sent as part of a batch. It lives on
+ * the stack of the calling thread, which waits until it is done.
+ */
+typedef struct auto_batch_request_s {
+    struct auto_batch_request_s *next;
+    as_key *key;
+    // Writes only, owned by the batcher once submitted.
+    as_operations *ops;
+    // Reads only, set when done.
+    auto_batch_records *batch;
+    as_batch_read_record *read;
+    as_error err;
+    bool done;
+} auto_batch_request;
+
+typedef struct {
+    auto_batch_request *head;
+    auto_batch_request *tail;
+    uint32_t size;
+    // The first caller of a window waits it out and sends the batch.
+    bool flushing;
+} auto_batch_queue;
+
+struct auto_batcher_s {
+    pthread_mutex_t lock;
+    // Signaled when a queue is full and when requests are done.
+    pthread_cond_t cond;
+    auto_batch_queue reads;
+    auto_batch_queue writes;
+    uint32_t window_us;
+    uint32_t max_keys;
+    bool batch_reads;
+    bool batch_writes;
+    // A batcher inherited across fork() may have been mid-window.
+    pid_t pid;
+};
+
+struct auto_batch_records_s {
+    as_batch_records *records;
+    uint32_t refs;
+};
+
+/*******************************************************************************
+ * BATCH EXECUTION
+ ******************************************************************************/
+
+static void execute_reads(aerospike *as, auto_batch_request *head,
+                          uint32_t size)
+{
+    // Reads are only merged when made with the default read policy, so the
+    // batch gets its timeouts and read modes.
+    as_policy_read *read_policy = &as->config.policies.read;
+    as_policy_batch policy;
+    as_policy_batch_init(&policy);
+    policy.base.socket_timeout = read_policy->base.socket_timeout;
+    policy.base.total_timeout = read_policy->base.total_timeout;
+    policy.base.max_retries = read_policy->base.max_retries;
+    policy.base.sleep_between_retries =
+        read_policy->base.sleep_between_retries;
+    policy.base.compress = read_policy->base.compress;
+    policy.replica = read_policy->replica;
+    policy.read_mode_ap = read_policy->read_mode_ap;
+    policy.read_mode_sc = read_policy->read_mode_sc;
+    policy.deserialize = read_policy->deserialize;
+
+    auto_batch_records *batch = (auto_batch_records *)allocator_malloc(
+        ALLOCATOR_BATCH, sizeof(auto_batch_records));
+    if (!batch) {
+        for (auto_batch_request *req = head; req; req = req->next) {
+            as_error_update(&req->err, AEROSPIKE_ERR_CLIENT,
+                            "Failed to allocate memory for batch");
+        }
+        return;
+    }
+    batch->records = as_batch_records_create(size);
+    batch->refs = size;
+
+    for (auto_batch_request *req = head; req; req = req->next) {
+        as_batch_read_record *record = as_batch_read_reserve(batch->records);
+        as_key_init_digest(&record->key, req->key->ns, req->key->set,
+                           req->key->digest.value);
+        record->read_all_bins = true;
+    }
+
+    as_error err;
+    as_error_init(&err);
+    aerospike_batch_read(as, &err, &policy, batch->records);
+
+    uint32_t i = 0;
+    for (auto_batch_request *req = head; req; req = req->next) {
+        as_batch_read_record *record =
+            (as_batch_read_record *)as_vector_get(&batch->records->list, i++);
+        req->batch = batch;
+        req->read = record;
+        if (err.code != AEROSPIKE_OK) {
+            as_error_copy(&req->err, &err);
+        }
+        else if (record->result != AEROSPIKE_OK) {
+            as_error_update(&req->err, record->result, "%s",
+                            as_error_string(record->result));
+        }
+    }
+}
+
+static void execute_writes(aerospike *as, auto_batch_request *head,
+                           uint32_t size)
+{
+    // Writes are only merged when made with the default write policy.
+    as_policy_write *write_policy = &as->config.policies.write;
+    as_policy_batch_write policy;
+    as_policy_batch_write_init(&policy);
+    policy.key = write_policy->key;
+    policy.commit_level = write_policy->commit_level;
+    policy.gen = write_policy->gen;
+    policy.exists = write_policy->exists;
+    policy.durable_delete = write_policy->durable_delete;
+
+    as_batch_records *records = as_batch_records_create(size);
+
+    for (auto_batch_request *req = head; req; req = req->next) {
+        as_batch_write_record *record = as_batch_write_reserve(records);
+        as_key_init_digest(&record->key, req->key->ns, req->key->set,
+                           req->key->digest.value);
+        record->policy = &policy;
+        record->ops = req->ops;
+    }
+
+    as_error err;
+    as_error_init(&err);
+    aerospike_batch_write(as, &err, NULL, records);
+
+    uint32_t i = 0;
+    for (auto_batch_request *req = head; req; req = req->next) {
+        as_batch_write_record *record =
+            (as_batch_write_record *)as_vector_get(&records->list, i++);
+        if (record->result != AEROSPIKE_OK &&
+            record->result != AEROSPIKE_NO_RESPONSE) {
+            as_error_update(&req->err, record->result, "%s",
+                            as_error_string(record->result));
+        }
+        else if (err.code != AEROSPIKE_OK) {
+            as_error_copy(&req->err, &err);
+        }
+    }
+
+    // The operations belong to the requests, not the batch records.
+    as_batch_records_destroy(records);
+    for (auto_batch_request *req = head; req; req = req->next) {
+        as_operations_destroy(req->ops);
+        req->ops = NULL;
+    }
+}
+
+/*
+ * Queues req and waits until it is done. The first request of a window
+ * sends the batch once the window passes or max_keys requests are queued.
+ * Called without the GIL.
+ */
+static void auto_batch_submit(aerospike *as, auto_batcher *batcher,
+                              auto_batch_queue *queue, auto_batch_request *req,
+                              bool write)
+{
+    pthread_mutex_lock(&batcher->lock);
+
+    if (queue->tail) {
+        queue->tail->next = req;
+    }
+    else {
+        queue->head = req;
+    }
+    queue->tail = req;
+    queue->size++;
+
+    if (!queue->flushing) {
+        queue->flushing = true;
+
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += (long)batcher->window_us * 1000;
+        deadline.tv_sec += deadline.tv_nsec / 1000000000;
+        deadline.tv_nsec %= 1000000000;
+
+        while (queue->size < batcher->max_keys) {
+            if (pthread_cond_timedwait(&batcher->cond, &batcher->lock,
+                                       &deadline) == ETIMEDOUT) {
+                break;
+            }
+        }
+
+        auto_batch_request *head = queue->head;
+        uint32_t size = queue->size;
+        queue->head = NULL;
+        queue->tail = NULL;
+        queue->size = 0;
+        queue->flushing = false;
+        pthread_mutex_unlock(&batcher->lock);
+
+        if (write) {
+            execute_writes(as, head, size);
+        }
+        else {
+            execute_reads(as, head, size);
+        }
+
+        pthread_mutex_lock(&batcher->lock);
+        // A request may go away as soon as it is done and the lock released.
+        for (auto_batch_request *next = NULL; head; head = next) {
+            next = head->next;
+            head->done = true;
+        }
+        pthread_cond_broadcast(&batcher->cond);
+    }
+    else if (queue->size >= batcher->max_keys) {
+        pthread_cond_broadcast(&batcher->cond);
+    }
+
+    while (!req->done) {
+        pthread_cond_wait(&batcher->cond, &batcher->lock);
+    }
+    pthread_mutex_unlock(&batcher->lock);
+}
+
+static void auto_batcher_fork_reset(void *udata)
+{
+    auto_batcher *batcher = (auto_batcher *)udata;
+
+    // The threads of queued requests did not survive the fork.
+    pthread_mutex_init(&batcher->lock, NULL);
+    pthread_cond_init(&batcher->cond, NULL);
+    memset(&batcher->reads, 0, sizeof(auto_batch_queue));
+    memset(&batcher->writes, 0, sizeof(auto_batch_queue));
+}
+/*******************************************************************************
+ * CONFIG
+ ******************************************************************************/
+
+static bool config_get_bool(PyObject *py_config, const char *name,
+                            bool *value)
+{
+    PyObject *py_value = PyDict_GetItemString(py_config, name);
+    if (py_value) {
+        *value = PyObject_IsTrue(py_value) == 1;
+    }
+    return true;
+}
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+auto_batcher *auto_batcher_new(PyObject *py_config, as_error *err)
+{
+    if (!PyDict_Check(py_config)) {
+        as_error_update(err, AEROSPIKE_ERR_PARAM,
+                        "auto_batch must be a dict");
+        return NULL;
+    }
+
+    auto_batcher *batcher = (auto_batcher *)allocator_calloc(
+        ALLOCATOR_CLIENT, 1, sizeof(auto_batcher));
+    if (!batcher) {
+        as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                        "Failed to allocate memory for auto_batch");
+        return NULL;
+    }
+    batcher->window_us = AUTO_BATCH_DEFAULT_WINDOW_US;
+    batcher->max_keys = AUTO_BATCH_DEFAULT_MAX_KEYS;
+    batcher->batch_reads = true;
+    batcher->batch_writes = true;
+
+    if (!client_config_get_uint32(py_config, "auto_batch", "window", 1,
+                                  1000000, &batcher->window_us, err) ||
+        !client_config_get_uint32(py_config, "auto_batch", "max_keys", 1, 5000,
+                                  &batcher->max_keys, err) ||
+        !config_get_bool(py_config, "reads", &batcher->batch_reads) ||
+        !config_get_bool(py_config, "writes", &batcher->batch_writes)) {
+        allocator_free(batcher);
+        return NULL;
+    }
+
+    pthread_mutex_init(&batcher->lock, NULL);
+    pthread_cond_init(&batcher->cond, NULL);
+    batcher->pid = getpid();
+    return batcher;
+}
+
+void auto_batcher_destroy(auto_batcher *batcher)
+{
+    if (!batcher) {
+        return;
+    }
+    pthread_mutex_destroy(&batcher->lock);
+    pthread_cond_destroy(&batcher->cond);
+    allocator_free(batcher);
+}
+
+bool auto_batch_covers_get(AerospikeClient *self, PyObject *py_policy,
+                           as_key *key)
+{
+    return self->auto_batcher && self->auto_batcher->batch_reads &&
+           (!py_policy || py_policy == Py_None) && as_key_digest(key);
+}
+
+as_status auto_batch_get(AerospikeClient *self, as_key *key, as_error *err,
+                         as_record **rec, auto_batch_records **batch)
+{
+    auto_batcher *batcher = self->auto_batcher;
+    auto_batch_request req = {.key = key};
+    as_error_init(&req.err);
+
+    client_check_fork(&batcher->pid, auto_batcher_fork_reset, batcher);
+
+    Py_BEGIN_ALLOW_THREADS
+    auto_batch_submit(self->as, batcher, &batcher->reads, &req, false);
+    Py_END_ALLOW_THREADS
+
+    *batch = req.batch;
+    if (req.err.code != AEROSPIKE_OK) {
+        return as_error_copy(err, &req.err);
+    }
+    *rec = &req.read->record;
+    return err->code;
+}
+
+void auto_batch_release(auto_batch_records *batch)
+{
+    if (__atomic_sub_fetch(&batch->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+        as_batch_records_destroy(batch->records);
+        allocator_free(batch);
+    }
+}
+
+bool auto_batch_covers_put(AerospikeClient *self, PyObject *py_policy,
+                           as_key *key, as_record *rec)
+{
+    // Batch records are keyed by digest, so a key sent to the server would
+    // be lost.
+    return self->auto_batcher && self->auto_batcher->batch_writes &&
+           (!py_policy || py_policy == Py_None) &&
+           self->as->config.policies.write.key != AS_POLICY_KEY_SEND &&
+           rec->bins.size > 0 && as_key_digest(key);
+}
+
+as_status auto_batch_put(AerospikeClient *self, as_key *key, as_record *rec,
+                         as_error *err)
+{
+    auto_batcher *batcher = self->auto_batcher;
+    auto_batch_request req = {.key = key};
+    as_error_init(&req.err);
+
+    req.ops = as_operations_new(rec->bins.size);
+    req.ops->ttl = rec->ttl;
+    req.ops->gen = rec->gen;
+    for (uint16_t i = 0; i < rec->bins.size; i++) {
+        as_bin *bin = &rec->bins.entries[i];
+        as_operations_add_write(req.ops, bin->name, bin->valuep);
+        // The operation owns the value now.
+        bin->valuep = NULL;
+    }
+
+    client_check_fork(&batcher->pid, auto_batcher_fork_reset, batcher);
+
+    Py_BEGIN_ALLOW_THREADS
+    auto_batch_submit(self->as, batcher, &batcher->writes, &req, true);
+    Py_END_ALLOW_THREADS
+
+    if (req.err.code != AEROSPIKE_OK) {
+        return as_error_copy(err, &req.err);
+    }
+    return err->code;
+}
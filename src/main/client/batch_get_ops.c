@@ -25,10 +25,14 @@
 #include <aerospike/as_operations.h>
 #include <aerospike/as_map_operations.h>
 #include <aerospike/aerospike_info.h>
+#include "allocator.h"
 #include "client.h"
+#include "command_limits.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "fastcall.h"
 #include "policy.h"
+#include "interpreter.h"
 
 #include <aerospike/as_double.h>
 #include <aerospike/as_integer.h>
@@ -56,8 +60,7 @@ static bool batch_read_operate_cb(const as_batch_read *results, uint32_t n,
     as_batch_read *r = NULL;
 
     // Lock Python State
-    PyGILState_STATE gstate;
-    gstate = PyGILState_Ensure();
+    Aerospike_GIL_State gstate = Aerospike_GIL_Ensure(data->client->interp);
 
     for (uint32_t i = 0; i < n; i++) {
         PyObject *py_key = NULL;
@@ -69,7 +72,7 @@ static bool batch_read_operate_cb(const as_batch_read *results, uint32_t n,
 
         r = (as_batch_read *)&results[i];
         py_key = PyList_GetItem(data->py_keys, i);
-        // key_to_pyobject(&err, &r->key, &py_key);
+        // key_to_pyobject(data->client, &err, &r->key, &py_key);
         rec = &r->record;
 
         as_error_init(&err);
@@ -80,7 +83,14 @@ static bool batch_read_operate_cb(const as_batch_read *results, uint32_t n,
             bins_to_pyobject(data->client, &err, rec, &py_rec_bins, false);
         }
         else {
-            py_rec_meta = raise_exception_old(&err);
+            as_error_update(&err, r->result, "%s",
+                            as_error_string(r->result));
+            py_rec_meta = exception_from_error(&err);
+            if (!py_rec_meta) {
+                PyErr_Clear();
+                Py_INCREF(Py_None);
+                py_rec_meta = Py_None;
+            }
             Py_INCREF(Py_None);
             py_rec_bins = Py_None;
         }
@@ -93,7 +103,7 @@ static bool batch_read_operate_cb(const as_batch_read *results, uint32_t n,
         PyList_Append(data->py_results, py_rec);
     }
 
-    PyGILState_Release(gstate);
+    Aerospike_GIL_Release(&gstate);
 
     return true;
 }
@@ -171,7 +181,7 @@ static PyObject *AerospikeClient_Batch_GetOps_Invoke(AerospikeClient *self,
             as_error_update(err, AEROSPIKE_ERR_PARAM, "Key should be a tuple.");
             goto CLEANUP;
         }
-        pyobject_to_key(err, py_key, as_batch_keyat(&batch, i));
+        pyobject_to_key(self, err, py_key, as_batch_keyat(&batch, i));
         if (err->code != AEROSPIKE_OK) {
             as_error_update(err, AEROSPIKE_ERR_PARAM, "Key should be valid.");
             goto CLEANUP;
@@ -187,10 +197,15 @@ static PyObject *AerospikeClient_Batch_GetOps_Invoke(AerospikeClient *self,
 
     as_error_init(&data.error);
 
-    Py_BEGIN_ALLOW_THREADS
-    aerospike_batch_get_ops(self->as, &data.error, batch_policy_p, &batch, &ops,
-                            batch_read_operate_cb, &data);
-    Py_END_ALLOW_THREADS
+    command_permit permit;
+    if (command_limits_acquire_batch(self, py_policy, &batch, &permit,
+                                     &data.error)) {
+        Py_BEGIN_ALLOW_THREADS
+        aerospike_batch_get_ops(self->as, &data.error, batch_policy_p, &batch,
+                                &ops, batch_read_operate_cb, &data);
+        Py_END_ALLOW_THREADS
+        command_limits_release(self, &permit);
+    }
 
     as_error_copy(err, &data.error);
 
@@ -200,7 +215,7 @@ static PyObject *AerospikeClient_Batch_GetOps_Invoke(AerospikeClient *self,
 
 CLEANUP:
     for (unsigned int i = 0; i < unicodeStrVector->size; i++) {
-        free(as_vector_get_ptr(unicodeStrVector, i));
+        allocator_free(as_vector_get_ptr(unicodeStrVector, i));
     }
 
     if (exp_list_p) {
@@ -229,8 +244,9 @@ CLEANUP:
  * Otherwise returns 0 on success for other operations.
  *******************************************************************************************************
  */
-PyObject *AerospikeClient_Batch_GetOps(AerospikeClient *self, PyObject *args,
-                                       PyObject *kwds)
+PyObject *AerospikeClient_Batch_GetOps(AerospikeClient *self,
+                                       PyObject *const *args, Py_ssize_t nargs,
+                                       PyObject *kwnames)
 {
     as_error err;
     PyObject *py_policy = NULL;
@@ -241,9 +257,10 @@ PyObject *AerospikeClient_Batch_GetOps(AerospikeClient *self, PyObject *args,
     as_error_init(&err);
 
     // Python Function Keyword Arguments
-    static char *kwlist[] = {"keys", "list", "policy", NULL};
-    if (PyArg_ParseTupleAndKeywords(args, kwds, "OO|O:batch_getops", kwlist,
-                                    &py_keys, &py_ops, &py_policy) == false) {
+    static const char *kwlist[] = {"keys", "list", "policy", NULL};
+    static fastcall_parser parser = {"batch_get_ops", kwlist, 2};
+    if (fastcall_parse(&parser, self->state, args, nargs, kwnames, &py_keys,
+                       &py_ops, &py_policy) == false) {
         return NULL;
     }
 
@@ -28,10 +28,15 @@
 #include <aerospike/as_operations.h>
 #include <aerospike/as_log_macros.h>
 
+#include "allocator.h"
 #include "client.h"
+#include "command_limits.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "fastcall.h"
 #include "policy.h"
+#include "read_cache.h"
+#include "interpreter.h"
 
 // Struct for Python User-Data for the Callback
 typedef struct {
@@ -53,8 +58,7 @@ static bool batch_operate_cb(const as_batch_result *results, uint32_t n,
     bool success = true;
 
     // Lock Python State
-    PyGILState_STATE gstate;
-    gstate = PyGILState_Ensure();
+    Aerospike_GIL_State gstate = Aerospike_GIL_Ensure(data->client->interp);
 
     for (uint32_t i = 0; i < n; i++) {
 
@@ -62,7 +66,8 @@ static bool batch_operate_cb(const as_batch_result *results, uint32_t n,
         res = (as_batch_read *)&results[i];
 
         // NOTE these conversions shouldn't go wrong but if they do, return
-        if (key_to_pyobject(&err, res->key, &py_key) != AEROSPIKE_OK) {
+        if (key_to_pyobject(data->client, &err, res->key, &py_key) !=
+            AEROSPIKE_OK) {
             as_log_error("unable to convert res->key at results index: %d", i);
             success = false;
             break;
@@ -80,7 +85,7 @@ static bool batch_operate_cb(const as_batch_result *results, uint32_t n,
         Py_DECREF(py_key);
 
         as_batch_result_to_BatchRecord(data->client, &err, res, py_batch_record,
-                                       false);
+                                       false, NULL);
         if (err.code != AEROSPIKE_OK) {
             as_log_error(
                 "as_batch_result_to_BatchRecord failed at results index: %d",
@@ -93,7 +98,7 @@ static bool batch_operate_cb(const as_batch_result *results, uint32_t n,
         Py_DECREF(py_batch_record);
     }
 
-    PyGILState_Release(gstate);
+    Aerospike_GIL_Release(&gstate);
     return success;
 }
 
@@ -190,7 +195,7 @@ static PyObject *AerospikeClient_Batch_Operate_Invoke(
             goto CLEANUP;
         }
 
-        pyobject_to_key(err, py_key, tmp_key);
+        pyobject_to_key(self, err, py_key, tmp_key);
         if (err->code != AEROSPIKE_OK) {
             as_error_update(err, AEROSPIKE_ERR_PARAM,
                             "failed to convert key at index: %d", i);
@@ -287,13 +292,23 @@ static PyObject *AerospikeClient_Batch_Operate_Invoke(
     as_error batch_apply_err;
     as_error_init(&batch_apply_err);
 
-    Py_BEGIN_ALLOW_THREADS
+    // A timeout waiting for a command limit is reported in the result, as a
+    // timeout of the batch itself is.
+    command_permit permit;
+    if (command_limits_acquire_batch(self, py_policy_batch, &batch, &permit,
+                                     &batch_apply_err)) {
+        Py_BEGIN_ALLOW_THREADS
 
-    aerospike_batch_operate(self->as, &batch_apply_err, policy_batch_p,
-                            policy_batch_write_p, &batch, &ops,
-                            batch_operate_cb, &data);
+        aerospike_batch_operate(self->as, &batch_apply_err, policy_batch_p,
+                                policy_batch_write_p, &batch, &ops,
+                                batch_operate_cb, &data);
 
-    Py_END_ALLOW_THREADS
+        Py_END_ALLOW_THREADS
+        command_limits_release(self, &permit);
+    }
+    if (self->read_cache) {
+        read_cache_clear(self->read_cache);
+    }
 
     Py_DECREF(data.py_results);
     Py_DECREF(data.func_name);
@@ -306,7 +321,7 @@ static PyObject *AerospikeClient_Batch_Operate_Invoke(
 
 CLEANUP:
     for (unsigned int i = 0; i < unicodeStrVector->size; i++) {
-        free(as_vector_get_ptr(unicodeStrVector, i));
+        allocator_free(as_vector_get_ptr(unicodeStrVector, i));
     }
 
     if (batch_exp_list_p) {
@@ -346,8 +361,9 @@ CLEANUP:
  * Otherwise returns 0 on success for other operations.
  *******************************************************************************************************
  */
-PyObject *AerospikeClient_Batch_Operate(AerospikeClient *self, PyObject *args,
-                                        PyObject *kwds)
+PyObject *AerospikeClient_Batch_Operate(AerospikeClient *self,
+                                        PyObject *const *args, Py_ssize_t nargs,
+                                        PyObject *kwnames)
 {
     as_error err;
     PyObject *py_policy_batch = NULL;
@@ -359,11 +375,12 @@ PyObject *AerospikeClient_Batch_Operate(AerospikeClient *self, PyObject *args,
     as_error_init(&err);
 
     // Python Function Keyword Arguments
-    static char *kwlist[] = {"keys", "ops", "policy_batch",
-                             "policy_batch_write", NULL};
-    if (PyArg_ParseTupleAndKeywords(args, kwds, "OO|OO:batch_Operate", kwlist,
-                                    &py_keys, &py_ops, &py_policy_batch,
-                                    &py_policy_batch_write) == false) {
+    static const char *kwlist[] = {"keys", "ops", "policy_batch",
+                                   "policy_batch_write", NULL};
+    static fastcall_parser parser = {"batch_operate", kwlist, 2};
+    if (fastcall_parse(&parser, self->state, args, nargs, kwnames, &py_keys,
+                       &py_ops, &py_policy_batch,
+                       &py_policy_batch_write) == false) {
         return NULL;
     }
 
@@ -6,9 +6,13 @@
 #include <aerospike/as_log_macros.h>
 
 #include "types.h"
+#include "command_limits.h"
 #include "policy.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "fastcall.h"
+#include "serializer.h"
+#include "interpreter.h"
 
 // Struct for Python User-Data for the Callback
 typedef struct {
@@ -17,6 +21,9 @@ typedef struct {
     PyObject *func_name;
     AerospikeClient *client;
     bool checking_if_records_exist;
+    // Records are converted on the calling thread, so values for a batch
+    // deserializer are set aside until the whole batch is in.
+    deferred_values deferred;
 } LocalData;
 
 static bool batch_read_cb(const as_batch_result *results, uint32_t n,
@@ -31,8 +38,7 @@ static bool batch_read_cb(const as_batch_result *results, uint32_t n,
     bool success = true;
 
     // Lock Python State
-    PyGILState_STATE gstate;
-    gstate = PyGILState_Ensure();
+    Aerospike_GIL_State gstate = Aerospike_GIL_Ensure(data->client->interp);
 
     for (uint32_t i = 0; i < n; i++) {
 
@@ -40,7 +46,8 @@ static bool batch_read_cb(const as_batch_result *results, uint32_t n,
         res = (as_batch_read *)&results[i];
 
         // NOTE these conversions shouldn't go wrong but if they do, return
-        if (key_to_pyobject(&err, res->key, &py_key) != AEROSPIKE_OK) {
+        if (key_to_pyobject(data->client, &err, res->key, &py_key) !=
+            AEROSPIKE_OK) {
             as_log_error("unable to convert res->key at results index: %d", i);
             success = false;
             break;
@@ -60,7 +67,8 @@ static bool batch_read_cb(const as_batch_result *results, uint32_t n,
 
         // Initialize BatchRecord instance
         as_batch_result_to_BatchRecord(data->client, &err, res, py_batch_record,
-                                       data->checking_if_records_exist);
+                                       data->checking_if_records_exist,
+                                       &data->deferred);
         if (err.code != AEROSPIKE_OK) {
             as_log_error(
                 "as_batch_result_to_BatchRecord failed at results index: %d",
@@ -74,20 +82,21 @@ static bool batch_read_cb(const as_batch_result *results, uint32_t n,
         Py_DECREF(py_batch_record);
     }
 
-    PyGILState_Release(gstate);
+    Aerospike_GIL_Release(&gstate);
     return success;
 }
 
-PyObject *AerospikeClient_BatchRead(AerospikeClient *self, PyObject *args,
-                                    PyObject *kwds)
+PyObject *AerospikeClient_BatchRead(AerospikeClient *self,
+                                    PyObject *const *args, Py_ssize_t nargs,
+                                    PyObject *kwnames)
 {
     PyObject *py_keys = NULL;
     PyObject *py_bins = NULL;
     PyObject *py_policy_batch = NULL;
-    static char *kwlist[] = {"keys", "bins", "policy", NULL};
-    if (PyArg_ParseTupleAndKeywords(args, kwds, "O|OO:batch_read", kwlist,
-                                    &py_keys, &py_bins,
-                                    &py_policy_batch) == false) {
+    static const char *kwlist[] = {"keys", "bins", "policy", NULL};
+    static fastcall_parser parser = {"batch_read", kwlist, 1};
+    if (fastcall_parse(&parser, self->state, args, nargs, kwnames, &py_keys,
+                       &py_bins, &py_policy_batch) == false) {
         return NULL;
     }
 
@@ -132,7 +141,7 @@ PyObject *AerospikeClient_BatchRead(AerospikeClient *self, PyObject *args,
             goto CLEANUP2;
         }
 
-        pyobject_to_key(&err, py_key, tmp_key);
+        pyobject_to_key(self, &err, py_key, tmp_key);
         if (err.code != AEROSPIKE_OK) {
             as_error_update(&err, AEROSPIKE_ERR_PARAM,
                             "failed to convert key at index: %d", i);
@@ -244,22 +253,35 @@ PyObject *AerospikeClient_BatchRead(AerospikeClient *self, PyObject *args,
         }
     }
 
-    Py_BEGIN_ALLOW_THREADS
+    // A timeout waiting for a command limit is reported in the result, as a
+    // timeout of the batch itself is.
+    command_permit permit;
+    bool permitted = command_limits_acquire_batch(self, py_policy_batch,
+                                                  &batch, &permit, &err);
 
-    if (py_bins == NULL) {
-        aerospike_batch_get(self->as, &err, policy_batch_p, &batch,
-                            batch_read_cb, &data);
-    }
-    else if (bin_count == 0) {
-        aerospike_batch_exists(self->as, &err, policy_batch_p, &batch,
-                               batch_read_cb, &data);
-    }
-    else {
-        aerospike_batch_get_bins(self->as, &err, policy_batch_p, &batch,
-                                 filter_bins, bin_count, batch_read_cb, &data);
-    }
+    deferred_values_init(self, &data.deferred);
+
+    if (permitted) {
+        Py_BEGIN_ALLOW_THREADS
 
-    Py_END_ALLOW_THREADS
+        if (py_bins == NULL) {
+            aerospike_batch_get(self->as, &err, policy_batch_p, &batch,
+                                batch_read_cb, &data);
+        }
+        else if (bin_count == 0) {
+            aerospike_batch_exists(self->as, &err, policy_batch_p, &batch,
+                                   batch_read_cb, &data);
+        }
+        else {
+            aerospike_batch_get_bins(self->as, &err, policy_batch_p, &batch,
+                                     filter_bins, bin_count, batch_read_cb,
+                                     &data);
+        }
+
+        Py_END_ALLOW_THREADS
+        command_limits_release(self, &permit);
+    }
+    deferred_values_deserialize(&data.deferred, err.code == AEROSPIKE_OK);
 
     PyObject *py_br_res = PyLong_FromLong((long)err.code);
     PyObject_SetAttrString(br_instance, FIELD_NAME_BATCH_RESULT, py_br_res);
@@ -25,14 +25,18 @@
 #include <aerospike/as_geojson.h>
 #include <aerospike/as_msgpack_ext.h>
 
+#include "allocator.h"
 #include "client.h"
+#include "command_limits.h"
 #include "conversions.h"
 #include "serializer.h"
 #include "exceptions.h"
+#include "fastcall.h"
 #include "policy.h"
 #include "cdt_operation_utils.h"
 #include "geo.h"
 #include "cdt_types.h"
+#include "read_cache.h"
 
 #define GET_BATCH_POLICY_FROM_PYOBJECT(__policy, __policy_type,                \
                                        __conversion_func, __batch_type)        \
@@ -43,7 +47,14 @@
             as_exp *expr = NULL;                                               \
             as_exp *expr_p = expr;                                             \
             if (py___policy != NULL) {                                         \
-                __policy = (__policy_type *)malloc(sizeof(__policy_type));     \
+                __policy = (__policy_type *)allocator_malloc(                  \
+                    ALLOCATOR_BATCH, sizeof(__policy_type));                   \
+                if (!__policy) {                                               \
+                    as_error_update(err, AEROSPIKE_ERR_CLIENT,                 \
+                                    "Failed to allocate memory for policy");   \
+                    Py_DECREF(py___policy);                                    \
+                    goto CLEANUP0;                                             \
+                }                                                              \
                 garb->policy_to_free = __policy;                               \
                 if (__conversion_func(self, err, py___policy, __policy,        \
                                       &__policy, expr,                         \
@@ -95,7 +106,7 @@ void garbage_destroy(garbage *garb)
 
     void *pol = garb->policy_to_free;
     if (pol != NULL) {
-        free(pol);
+        allocator_free(pol);
     }
 
     as_operations *ops = garb->ops_to_free;
@@ -318,7 +329,7 @@ static PyObject *AerospikeClient_BatchWriteInvoke(AerospikeClient *self,
             as_batch_read_record *rr;
             rr = as_batch_read_reserve(&batch_records);
 
-            if (pyobject_to_key(err, py_key, &rr->key) != AEROSPIKE_OK) {
+            if (pyobject_to_key(self, err, py_key, &rr->key) != AEROSPIKE_OK) {
                 goto CLEANUP0;
             }
 
@@ -338,7 +349,7 @@ static PyObject *AerospikeClient_BatchWriteInvoke(AerospikeClient *self,
             as_batch_write_record *wr;
             wr = as_batch_write_reserve(&batch_records);
 
-            if (pyobject_to_key(err, py_key, &wr->key) != AEROSPIKE_OK) {
+            if (pyobject_to_key(self, err, py_key, &wr->key) != AEROSPIKE_OK) {
                 goto CLEANUP0;
             }
 
@@ -399,7 +410,7 @@ static PyObject *AerospikeClient_BatchWriteInvoke(AerospikeClient *self,
             as_batch_apply_record *ar;
             ar = as_batch_apply_reserve(&batch_records);
 
-            if (pyobject_to_key(err, py_key, &ar->key) != AEROSPIKE_OK) {
+            if (pyobject_to_key(self, err, py_key, &ar->key) != AEROSPIKE_OK) {
                 goto CLEANUP0;
             }
 
@@ -420,7 +431,7 @@ static PyObject *AerospikeClient_BatchWriteInvoke(AerospikeClient *self,
             as_batch_remove_record *rer;
             rer = as_batch_remove_reserve(&batch_records);
 
-            if (pyobject_to_key(err, py_key, &rer->key) != AEROSPIKE_OK) {
+            if (pyobject_to_key(self, err, py_key, &rer->key) != AEROSPIKE_OK) {
                 goto CLEANUP0;
             }
 
@@ -439,11 +450,22 @@ static PyObject *AerospikeClient_BatchWriteInvoke(AerospikeClient *self,
         Py_XDECREF(py_ops_list);
     }
 
-    Py_BEGIN_ALLOW_THREADS
+    // A timeout waiting for a command limit is reported in the result, as a
+    // timeout of the batch itself is.
+    command_permit permit;
+    if (command_limits_acquire_records(self, py_policy, &batch_records,
+                                       &permit, err)) {
+        Py_BEGIN_ALLOW_THREADS
 
-    aerospike_batch_write(self->as, err, batch_policy_p, &batch_records);
+        aerospike_batch_write(self->as, err, batch_policy_p, &batch_records);
 
-    Py_END_ALLOW_THREADS
+        Py_END_ALLOW_THREADS
+        command_limits_release(self, &permit);
+    }
+    // Batch writes may touch any cached record.
+    if (self->read_cache) {
+        read_cache_clear(self->read_cache);
+    }
 
     PyObject *py_bw_res = PyLong_FromLong((long)err->code);
     if (PyObject_HasAttrString(py_obj, FIELD_NAME_BATCH_RESULT)) {
@@ -528,7 +550,7 @@ CLEANUP4:
     }
 
     for (unsigned int i = 0; i < unicodeStrVector->size; i++) {
-        free(as_vector_get_ptr(unicodeStrVector, i));
+        allocator_free(as_vector_get_ptr(unicodeStrVector, i));
     }
 
     as_vector_destroy(unicodeStrVector);
@@ -557,8 +579,9 @@ CLEANUP4:
  *
  * Returns information about a host.
  ********************************************************************************************************/
-PyObject *AerospikeClient_BatchWrite(AerospikeClient *self, PyObject *args,
-                                     PyObject *kwds)
+PyObject *AerospikeClient_BatchWrite(AerospikeClient *self,
+                                     PyObject *const *args, Py_ssize_t nargs,
+                                     PyObject *kwnames)
 {
     PyObject *py_policy = NULL;
     PyObject *py_batch_recs = NULL;
@@ -566,10 +589,11 @@ PyObject *AerospikeClient_BatchWrite(AerospikeClient *self, PyObject *args,
     as_error err;
     as_error_init(&err);
 
-    static char *kwlist[] = {"batch_records", "policy_batch", NULL};
+    static const char *kwlist[] = {"batch_records", "policy_batch", NULL};
+    static fastcall_parser parser = {"batch_write", kwlist, 1};
 
-    if (PyArg_ParseTupleAndKeywords(args, kwds, "O|O:batch_write", kwlist,
-                                    &py_batch_recs, &py_policy) == false) {
+    if (fastcall_parse(&parser, self->state, args, nargs, kwnames,
+                       &py_batch_recs, &py_policy) == false) {
         return NULL;
     }
 
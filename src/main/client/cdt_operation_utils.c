@@ -1,5 +1,6 @@
 #include <Python.h>
 
+#include "allocator.h"
 #include "cdt_operation_utils.h"
 #include "client.h"
 #include "conversions.h"
@@ -35,10 +36,14 @@ as_status get_bin(as_error *err, PyObject *op_dict, as_vector *unicodeStrVector,
             then decref'ing the item itself.
             and storing the char* on a list of items to delete.
             */
-        char *dupStr = strdup(*binName);
-        *binName = dupStr;
-        as_vector_append(unicodeStrVector, dupStr);
+        char *dupStr = allocator_strdup(ALLOCATOR_OPERATIONS, *binName);
         Py_DECREF(intermediateUnicode);
+        if (!dupStr) {
+            return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                                   "Failed to allocate memory for bin");
+        }
+        *binName = dupStr;
+        as_vector_append(unicodeStrVector, &dupStr);
     }
     return AEROSPIKE_OK;
 }
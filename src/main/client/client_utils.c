@@ -0,0 +1,85 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <aerospike/as_error.h>
+
+#include "client_utils.h"
+
+uint64_t client_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+bool client_config_get_uint(PyObject *py_config, const char *config,
+                            const char *name, uint64_t min, uint64_t max,
+                            uint64_t *value, as_error *err)
+{
+    PyObject *py_value = PyDict_GetItemString(py_config, name);
+    if (!py_value) {
+        return true;
+    }
+
+    if (!PyLong_Check(py_value)) {
+        as_error_update(err, AEROSPIKE_ERR_PARAM,
+                        "%s %s must be an integer", config, name);
+        return false;
+    }
+
+    unsigned long long temp = PyLong_AsUnsignedLongLong(py_value);
+    if (PyErr_Occurred() || temp < min || temp > max) {
+        PyErr_Clear();
+        as_error_update(err, AEROSPIKE_ERR_PARAM,
+                        "%s %s must be between %llu and %llu", config, name,
+                        (unsigned long long)min, (unsigned long long)max);
+        return false;
+    }
+
+    *value = temp;
+    return true;
+}
+
+bool client_config_get_uint32(PyObject *py_config, const char *config,
+                              const char *name, uint32_t min, uint32_t max,
+                              uint32_t *value, as_error *err)
+{
+    uint64_t temp = *value;
+    if (!client_config_get_uint(py_config, config, name, min, max, &temp,
+                                err)) {
+        return false;
+    }
+
+    *value = (uint32_t)temp;
+    return true;
+}
+
+void client_check_fork(pid_t *pid, void (*reset)(void *udata), void *udata)
+{
+    pid_t current = getpid();
+    if (__atomic_load_n(pid, __ATOMIC_ACQUIRE) == current) {
+        return;
+    }
+
+    reset(udata);
+    __atomic_store_n(pid, current, __ATOMIC_RELEASE);
+}
@@ -23,6 +23,8 @@
 #include "conversions.h"
 #include "exceptions.h"
 #include "global_hosts.h"
+#include "hedged_read.h"
+#include "latency_router.h"
 
 #define MAX_PORT_SIZE 6
 #define MAX_SHM_SIZE 19
@@ -45,8 +47,6 @@ PyObject *AerospikeClient_Close(AerospikeClient *self, PyObject *args,
 {
     as_error err;
     char *alias_to_search = NULL;
-    PyObject *py_persistent_item = NULL;
-    AerospikeGlobalHosts *global_host = NULL;
 
     // Initialize error
     as_error_init(&err);
@@ -60,21 +60,21 @@ PyObject *AerospikeClient_Close(AerospikeClient *self, PyObject *args,
         goto CLEANUP;
     }
 
+    // Hedged reads and node probes still running use the cluster.
+    if (self->hedged_reader) {
+        Py_BEGIN_ALLOW_THREADS
+        hedged_reader_stop(self->hedged_reader);
+        Py_END_ALLOW_THREADS
+    }
+    if (self->latency_router) {
+        Py_BEGIN_ALLOW_THREADS
+        latency_router_stop(self->latency_router);
+        Py_END_ALLOW_THREADS
+    }
+
     if (self->use_shared_connection) {
         alias_to_search = return_search_string(self->as);
-        py_persistent_item =
-            PyDict_GetItemString(py_global_hosts, alias_to_search);
-
-        if (py_persistent_item) {
-            global_host = (AerospikeGlobalHosts *)py_persistent_item;
-            // It is only safe to do a reference counted close if the
-            // local as is pointing to the global as
-            if (self->as == global_host->as) {
-                close_aerospike_object(self->as, &err, alias_to_search,
-                                       py_persistent_item, false);
-            }
-        }
-
+        close_aerospike_object(self->as, &err, alias_to_search);
         PyMem_Free(alias_to_search);
         alias_to_search = NULL;
     }
@@ -144,17 +144,13 @@ char *return_search_string(aerospike *as)
     return alias_to_search;
 }
 
-void close_aerospike_object(aerospike *as, as_error *err, char *alias_to_search,
-                            PyObject *py_persistent_item, bool do_destroy)
+void close_aerospike_object(aerospike *as, as_error *err, char *alias_to_search)
 {
-    if (((AerospikeGlobalHosts *)py_persistent_item)->ref_cnt == 1) {
-        PyDict_DelItemString(py_global_hosts, alias_to_search);
-        AerospikeGlobalHosts_Del(py_persistent_item);
+    // It is only safe to do a reference counted close if as is the shared
+    // aerospike object, which the last client using it closes.
+    if (AerospikeGlobalHosts_Release(alias_to_search, as)) {
         Py_BEGIN_ALLOW_THREADS
         aerospike_close(as, err);
         Py_END_ALLOW_THREADS
     }
-    else {
-        ((AerospikeGlobalHosts *)py_persistent_item)->ref_cnt--;
-    }
 }
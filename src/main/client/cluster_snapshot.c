@@ -0,0 +1,442 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <aerospike/aerospike.h>
+#include <aerospike/as_cluster.h>
+#include <aerospike/as_config.h>
+#include <aerospike/as_error.h>
+#include <aerospike/as_node.h>
+
+#include "allocator.h"
+#include "client.h"
+#include "exceptions.h"
+
+/*
+ * A snapshot is a short text blob:
+ *
+ *     as-cluster-snapshot 1
+ *     <node name> <address> <port>
+ *     ...
+ *
+ * Addresses are written without IPv6 brackets.
+ */
+#define SNAPSHOT_HEADER "as-cluster-snapshot 1\n"
+#define SNAPSHOT_MAX_LINE 256
+// Seeds probed at once. The others keep their place after them.
+#define SEED_PROBE_MAX 64
+
+/*
+ * Seeds probed in parallel before a connect. The probe threads are detached,
+ * as a name lookup cannot be interrupted, so the last one of them or the
+ * connecting thread to let go frees it.
+ */
+typedef struct seed_probe_s {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t refs;
+    uint32_t n_seeds;
+    uint32_t n_done;
+    uint32_t timeout_ms;
+    // Index of the first seed which accepted a connection, or -1.
+    int first;
+    char *names[SEED_PROBE_MAX];
+    uint16_t ports[SEED_PROBE_MAX];
+} seed_probe;
+
+typedef struct seed_probe_job_s {
+    seed_probe *probe;
+    uint32_t index;
+} seed_probe_job;
+
+static bool config_has_host(as_config *config, const char *name, uint16_t port)
+{
+    for (uint32_t i = 0; i < config->hosts->size; i++) {
+        as_host *host = (as_host *)as_vector_get(config->hosts, i);
+        if (host->port == port && strcmp(host->name, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Returns true if a TCP connection to name:port opens within timeout_ms.
+ */
+static bool seed_reachable(const char *name, uint16_t port,
+                           uint32_t timeout_ms)
+{
+    char service[6];
+    snprintf(service, sizeof(service), "%u", port);
+
+    struct addrinfo hints = {0};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo *addresses = NULL;
+    if (getaddrinfo(name, service, &hints, &addresses) != 0) {
+        return false;
+    }
+
+    bool reachable = false;
+    for (struct addrinfo *ai = addresses; ai && !reachable; ai = ai->ai_next) {
+        int fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+            reachable = true;
+        }
+        else if (errno == EINPROGRESS) {
+            struct pollfd pfd = {.fd = fd, .events = POLLOUT};
+            int error = 0;
+            socklen_t len = sizeof(error);
+            reachable =
+                poll(&pfd, 1, (int)timeout_ms) == 1 &&
+                getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len) == 0 &&
+                error == 0;
+        }
+        close(fd);
+    }
+    freeaddrinfo(addresses);
+    return reachable;
+}
+
+static void seed_probe_release(seed_probe *probe)
+{
+    pthread_mutex_lock(&probe->lock);
+    uint32_t refs = --probe->refs;
+    pthread_mutex_unlock(&probe->lock);
+    if (refs) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < probe->n_seeds; i++) {
+        allocator_free(probe->names[i]);
+    }
+    pthread_mutex_destroy(&probe->lock);
+    pthread_cond_destroy(&probe->cond);
+    allocator_free(probe);
+}
+
+static void *seed_probe_run(void *udata)
+{
+    seed_probe_job *job = (seed_probe_job *)udata;
+    seed_probe *probe = job->probe;
+    uint32_t index = job->index;
+    allocator_free(job);
+
+    bool reachable = seed_reachable(probe->names[index], probe->ports[index],
+                                    probe->timeout_ms);
+
+    pthread_mutex_lock(&probe->lock);
+    if (reachable && probe->first < 0) {
+        probe->first = (int)index;
+    }
+    probe->n_done++;
+    pthread_cond_signal(&probe->cond);
+    pthread_mutex_unlock(&probe->lock);
+
+    seed_probe_release(probe);
+    return NULL;
+}
+
+/*
+ * Waits until a seed is found reachable, every seed failed or the connect
+ * timeout passed. Returns the index of the seed found, or -1.
+ */
+static int seed_probe_wait(seed_probe *probe, uint32_t n_started)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += (long)(probe->timeout_ms % 1000) * 1000000;
+    deadline.tv_sec += probe->timeout_ms / 1000 + deadline.tv_nsec / 1000000000;
+    deadline.tv_nsec %= 1000000000;
+
+    pthread_mutex_lock(&probe->lock);
+    while (probe->first < 0 && probe->n_done < n_started) {
+        if (pthread_cond_timedwait(&probe->cond, &probe->lock, &deadline) ==
+            ETIMEDOUT) {
+            break;
+        }
+    }
+    int first = probe->first;
+    pthread_mutex_unlock(&probe->lock);
+
+    return first;
+}
+
+/**
+ *******************************************************************************************************
+ * Probes the seeds of config in parallel and moves the first one to accept a
+ * connection to the front. The C client tries its seeds one at a time, each
+ * up to the connect timeout, so seeds which are gone, such as old nodes of a
+ * snapshot, would otherwise delay the connect. Seeds are only reordered,
+ * never dropped, as the cluster falls back on them if it loses every node.
+ * Does nothing if there is one seed, or none answers. Called without the
+ * GIL.
+ *
+ * @param config                The config of a client which is not connected.
+ *******************************************************************************************************
+ */
+void probe_cluster_seeds(as_config *config)
+{
+    if (!config->hosts || config->hosts->size < 2) {
+        return;
+    }
+
+    seed_probe *probe = (seed_probe *)allocator_calloc(ALLOCATOR_CLIENT, 1,
+                                                       sizeof(seed_probe));
+    if (!probe) {
+        return;
+    }
+    pthread_mutex_init(&probe->lock, NULL);
+    pthread_cond_init(&probe->cond, NULL);
+    probe->refs = 1;
+    probe->first = -1;
+    probe->timeout_ms = config->conn_timeout_ms ? config->conn_timeout_ms
+                                                : 1000;
+
+    uint32_t n_seeds = config->hosts->size < SEED_PROBE_MAX
+                           ? config->hosts->size
+                           : SEED_PROBE_MAX;
+    for (uint32_t i = 0; i < n_seeds; i++) {
+        as_host *host = (as_host *)as_vector_get(config->hosts, i);
+        probe->names[i] = allocator_strdup(ALLOCATOR_CLIENT, host->name);
+        probe->ports[i] = host->port;
+        if (!probe->names[i]) {
+            break;
+        }
+        probe->n_seeds++;
+    }
+
+    // Started threads hold a reference each, taken before they may run.
+    uint32_t n_started = 0;
+    for (uint32_t i = 0; i < probe->n_seeds; i++) {
+        seed_probe_job *job = (seed_probe_job *)allocator_malloc(
+            ALLOCATOR_CLIENT, sizeof(seed_probe_job));
+        if (!job) {
+            break;
+        }
+        job->probe = probe;
+        job->index = i;
+
+        pthread_mutex_lock(&probe->lock);
+        probe->refs++;
+        pthread_mutex_unlock(&probe->lock);
+
+        pthread_t thread;
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        int rc = pthread_create(&thread, &attr, seed_probe_run, job);
+        pthread_attr_destroy(&attr);
+        if (rc != 0) {
+            allocator_free(job);
+            pthread_mutex_lock(&probe->lock);
+            probe->refs--;
+            pthread_mutex_unlock(&probe->lock);
+            break;
+        }
+        n_started++;
+    }
+
+    int first = n_started ? seed_probe_wait(probe, n_started) : -1;
+    seed_probe_release(probe);
+
+    if (first > 0) {
+        as_host *hosts = (as_host *)config->hosts->list;
+        as_host found = hosts[first];
+        memmove(&hosts[1], &hosts[0], first * sizeof(as_host));
+        hosts[0] = found;
+    }
+}
+
+/**
+ *******************************************************************************************************
+ * Adds the nodes of a snapshot written by export_cluster_snapshot() to the
+ * seeds of config, after the configured ones. Nodes that are already seeds
+ * are skipped. TLS seeds reuse the TLS name of the first configured seed.
+ *
+ * @param config                The config of a client which is not connected.
+ * @param py_snapshot           bytes returned by export_cluster_snapshot().
+ * @param err                   The as_error to be populated by the function
+ *                              with the encountered error if any.
+ *******************************************************************************************************
+ */
+as_status apply_cluster_snapshot(as_config *config, PyObject *py_snapshot,
+                                 as_error *err)
+{
+    if (!PyBytes_Check(py_snapshot)) {
+        return as_error_update(err, AEROSPIKE_ERR_PARAM,
+                               "Cluster snapshot must be bytes");
+    }
+
+    const char *data = PyBytes_AS_STRING(py_snapshot);
+    Py_ssize_t size = PyBytes_GET_SIZE(py_snapshot);
+    size_t header_len = strlen(SNAPSHOT_HEADER);
+
+    if ((size_t)size < header_len ||
+        memcmp(data, SNAPSHOT_HEADER, header_len) != 0) {
+        return as_error_update(err, AEROSPIKE_ERR_PARAM,
+                               "Invalid cluster snapshot");
+    }
+
+    const char *tls_name = NULL;
+    if (config->tls.enable && config->hosts && config->hosts->size > 0) {
+        tls_name = ((as_host *)as_vector_get(config->hosts, 0))->tls_name;
+    }
+
+    const char *pos = data + header_len;
+    const char *end = data + size;
+
+    while (pos < end) {
+        const char *eol = memchr(pos, '\n', end - pos);
+        if (!eol || eol - pos >= SNAPSHOT_MAX_LINE) {
+            return as_error_update(err, AEROSPIKE_ERR_PARAM,
+                                   "Invalid cluster snapshot");
+        }
+
+        char line[SNAPSHOT_MAX_LINE];
+        memcpy(line, pos, eol - pos);
+        line[eol - pos] = '\0';
+        pos = eol + 1;
+
+        char node_name[AS_NODE_NAME_MAX_SIZE];
+        char address[SNAPSHOT_MAX_LINE];
+        unsigned int port = 0;
+        if (sscanf(line, "%19s %255s %u", node_name, address, &port) != 3 ||
+            port == 0 || port > UINT16_MAX) {
+            return as_error_update(err, AEROSPIKE_ERR_PARAM,
+                                   "Invalid cluster snapshot entry: %s", line);
+        }
+
+        if (config_has_host(config, address, (uint16_t)port)) {
+            continue;
+        }
+
+        if (tls_name) {
+            as_config_tls_add_host(config, address, tls_name, (uint16_t)port);
+        }
+        else {
+            as_config_add_host(config, address, (uint16_t)port);
+        }
+    }
+
+    return err->code;
+}
+
+/**
+ *******************************************************************************************************
+ * Returns the nodes the client currently knows as a snapshot which can be
+ * passed to a later connect(), so that a new process does not depend on the
+ * configured seeds alone.
+ *
+ * @param self                  AerospikeClient object
+ *
+ * Returns bytes. In case of error, appropriate exceptions will be raised.
+ *******************************************************************************************************
+ */
+PyObject *AerospikeClient_Export_Cluster_Snapshot(AerospikeClient *self,
+                                                  PyObject *args)
+{
+    as_error err;
+    as_error_init(&err);
+    as_nodes *nodes = NULL;
+    char *buffer = NULL;
+    PyObject *py_snapshot = NULL;
+
+    if (!self || !self->as) {
+        as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid aerospike object");
+        goto CLEANUP;
+    }
+
+    if (!self->is_conn_16 || !self->as->cluster) {
+        as_error_update(&err, AEROSPIKE_ERR_CLUSTER,
+                        "No connection to aerospike cluster");
+        goto CLEANUP;
+    }
+
+    nodes = as_nodes_reserve(self->as->cluster);
+    if (!nodes || nodes->size == 0) {
+        as_error_update(&err, AEROSPIKE_ERR_CLUSTER, "Cluster is empty");
+        goto CLEANUP;
+    }
+
+    size_t capacity = strlen(SNAPSHOT_HEADER) + nodes->size * SNAPSHOT_MAX_LINE;
+    buffer = (char *)cf_malloc(capacity);
+    size_t len = strlen(SNAPSHOT_HEADER);
+    memcpy(buffer, SNAPSHOT_HEADER, len);
+
+    for (uint32_t i = 0; i < nodes->size; i++) {
+        as_node *node = nodes->array[i];
+        const char *address = as_node_get_address_string(node);
+        const char *split_point = strrchr(address, ':');
+        if (!split_point) {
+            as_error_update(&err, AEROSPIKE_ERR_CLIENT,
+                            "Malformed host name string");
+            goto CLEANUP;
+        }
+
+        // Strip the brackets of IPv6 addresses.
+        const char *host = address;
+        int host_len = (int)(split_point - address);
+        if (host_len >= 2 && host[0] == '[' && host[host_len - 1] == ']') {
+            host++;
+            host_len -= 2;
+        }
+
+        int written = snprintf(buffer + len, SNAPSHOT_MAX_LINE, "%s %.*s %s\n",
+                               node->name, host_len, host, split_point + 1);
+        if (written < 0 || written >= SNAPSHOT_MAX_LINE) {
+            as_error_update(&err, AEROSPIKE_ERR_CLIENT,
+                            "Node address too long for cluster snapshot");
+            goto CLEANUP;
+        }
+        len += written;
+    }
+
+    py_snapshot = PyBytes_FromStringAndSize(buffer, len);
+
+CLEANUP:
+    if (nodes) {
+        as_nodes_release(nodes);
+    }
+    if (buffer) {
+        cf_free(buffer);
+    }
+
+    if (err.code != AEROSPIKE_OK) {
+        raise_exception(&err);
+        return NULL;
+    }
+
+    return py_snapshot;
+}
@@ -0,0 +1,685 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <aerospike/aerospike_batch.h>
+#include <aerospike/as_batch.h>
+#include <aerospike/as_error.h>
+#include <aerospike/as_key.h>
+
+#include "allocator.h"
+#include "client.h"
+#include "client_utils.h"
+#include "command_limits.h"
+#include "policy.h"
+
+#define COMMAND_LIMIT_COMMANDS                                                 \
+    (COMMAND_LIMIT_READ | COMMAND_LIMIT_WRITE | COMMAND_LIMIT_UDF |            \
+     COMMAND_LIMIT_BATCH | COMMAND_LIMIT_SCAN | COMMAND_LIMIT_QUERY)
+#define COMMAND_LIMIT_LANES (COMMAND_LIMIT_INTERACTIVE | COMMAND_LIMIT_BULK)
+
+typedef struct {
+    pthread_mutex_t lock;
+    // Signaled when a command completes.
+    pthread_cond_t cond;
+    // Empty to match any namespace or set.
+    char ns[AS_NAMESPACE_MAX_SIZE];
+    char set[AS_SET_MAX_SIZE];
+    bool any_set;
+    // The commands and lanes matched.
+    uint32_t types;
+    // Token bucket of records per second, unlimited if rate is 0.
+    double rate;
+    double burst;
+    double tokens;
+    uint64_t refilled_us;
+    // Unlimited if 0.
+    uint32_t max_concurrent;
+    uint32_t in_flight;
+    uint64_t commands;
+    uint64_t waits;
+    uint64_t wait_us;
+    uint64_t timeouts;
+} command_limit;
+
+struct command_limiter_s {
+    command_limit limits[COMMAND_LIMITS_MAX];
+    uint32_t n_limits;
+    // Locks inherited across fork() may have been held.
+    pid_t pid;
+};
+
+// Depth of foreach callbacks running on this thread.
+static __thread uint32_t callback_depth;
+
+static bool limit_matches(command_limit *limit, uint32_t type, const char *ns,
+                          const char *set)
+{
+    return (limit->types & type & COMMAND_LIMIT_COMMANDS) &&
+           (limit->types & type & COMMAND_LIMIT_LANES) &&
+           (!limit->ns[0] || (ns && strcmp(limit->ns, ns) == 0)) &&
+           (limit->any_set || (set && strcmp(limit->set, set) == 0));
+}
+
+/*
+ * The policy was checked when it was converted, so an invalid priority cannot
+ * be seen here.
+ */
+static uint32_t command_lane(PyObject *py_policy, command_limit_type type)
+{
+    PyObject *py_priority = NULL;
+    if (py_policy && PyDict_Check(py_policy)) {
+        py_priority = PyDict_GetItemString(py_policy, "priority");
+    }
+
+    long priority = POLICY_PRIORITY_DEFAULT;
+    if (py_priority && PyLong_Check(py_priority)) {
+        priority = PyLong_AsLong(py_priority);
+    }
+
+    switch (priority) {
+    case POLICY_PRIORITY_INTERACTIVE:
+        return COMMAND_LIMIT_INTERACTIVE;
+    case POLICY_PRIORITY_BULK:
+        return COMMAND_LIMIT_BULK;
+    default:
+        return type & (COMMAND_LIMIT_BATCH | COMMAND_LIMIT_SCAN |
+                       COMMAND_LIMIT_QUERY)
+                   ? COMMAND_LIMIT_BULK
+                   : COMMAND_LIMIT_INTERACTIVE;
+    }
+}
+
+/*
+ * Waits until signaled, or for at most wait_us if it is not 0.
+ */
+static void limit_wait(command_limit *limit, uint64_t wait_us)
+{
+    if (!wait_us) {
+        pthread_cond_wait(&limit->cond, &limit->lock);
+        return;
+    }
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += wait_us / 1000000;
+    deadline.tv_nsec += (wait_us % 1000000) * 1000;
+    deadline.tv_sec += deadline.tv_nsec / 1000000000;
+    deadline.tv_nsec %= 1000000000;
+    pthread_cond_timedwait(&limit->cond, &limit->lock, &deadline);
+}
+
+/*
+ * Waits for a slot, unless exempt, and for the tokens of records, until
+ * deadline_us unless it is 0. A command larger than the burst waits for a
+ * full bucket and leaves it in debt. Returns false if the deadline passed
+ * first. Called without the GIL.
+ */
+static bool limit_acquire(command_limit *limit, uint32_t records,
+                          uint64_t deadline_us, bool exempt)
+{
+    uint64_t start = 0;
+    bool acquired = false;
+
+    pthread_mutex_lock(&limit->lock);
+    while (true) {
+        uint64_t now = client_now_us();
+        bool full = !exempt && limit->max_concurrent &&
+                    limit->in_flight >= limit->max_concurrent;
+        // How long the bucket takes to hold enough tokens.
+        uint64_t wait_us = 0;
+
+        if (!full && limit->rate > 0) {
+            limit->tokens +=
+                (double)(now - limit->refilled_us) * limit->rate / 1000000;
+            limit->refilled_us = now;
+            if (limit->tokens > limit->burst) {
+                limit->tokens = limit->burst;
+            }
+
+            double needed =
+                (double)records < limit->burst ? (double)records : limit->burst;
+            if (limit->tokens < needed) {
+                wait_us = (uint64_t)((needed - limit->tokens) / limit->rate *
+                                     1000000) +
+                          1;
+            }
+        }
+
+        if (!full && !wait_us) {
+            acquired = true;
+            break;
+        }
+
+        if (deadline_us) {
+            if (now >= deadline_us) {
+                limit->timeouts++;
+                break;
+            }
+            if (!wait_us || deadline_us - now < wait_us) {
+                wait_us = deadline_us - now;
+            }
+        }
+
+        start = start ? start : now;
+        limit_wait(limit, wait_us);
+    }
+
+    if (acquired) {
+        if (limit->rate > 0) {
+            limit->tokens -= records;
+        }
+        limit->in_flight++;
+        limit->commands++;
+    }
+    if (start) {
+        limit->waits++;
+        limit->wait_us += client_now_us() - start;
+    }
+    pthread_mutex_unlock(&limit->lock);
+    return acquired;
+}
+
+/*
+ * Gives back the slot of a command, and its tokens if it never ran.
+ */
+static void limit_release(command_limit *limit, uint32_t refund)
+{
+    pthread_mutex_lock(&limit->lock);
+    limit->in_flight--;
+    if (refund && limit->rate > 0) {
+        limit->tokens += refund;
+        if (limit->tokens > limit->burst) {
+            limit->tokens = limit->burst;
+        }
+    }
+    pthread_cond_broadcast(&limit->cond);
+    pthread_mutex_unlock(&limit->lock);
+}
+
+static void command_limiter_fork_reset(void *udata)
+{
+    command_limiter *limiter = (command_limiter *)udata;
+
+    // The commands in flight belonged to threads of the parent.
+    for (uint32_t i = 0; i < limiter->n_limits; i++) {
+        command_limit *limit = &limiter->limits[i];
+        pthread_mutex_init(&limit->lock, NULL);
+        pthread_cond_init(&limit->cond, NULL);
+        limit->in_flight = 0;
+    }
+}
+/*******************************************************************************
+ * CONFIG
+ ******************************************************************************/
+
+static bool config_get_string(PyObject *py_config, const char *name,
+                              char *value, size_t size, bool *found,
+                              as_error *err)
+{
+    PyObject *py_value = PyDict_GetItemString(py_config, name);
+    if (!py_value || py_value == Py_None) {
+        return true;
+    }
+
+    const char *str = PyUnicode_Check(py_value) ? PyUnicode_AsUTF8(py_value)
+                                                : NULL;
+    if (!str || strlen(str) >= size) {
+        PyErr_Clear();
+        as_error_update(err, AEROSPIKE_ERR_PARAM,
+                        "command_limits %s must be a string shorter than %zu "
+                        "characters",
+                        name, size);
+        return false;
+    }
+
+    strcpy(value, str);
+    if (found) {
+        *found = true;
+    }
+    return true;
+}
+
+static bool config_get_types(PyObject *py_config, uint32_t *types,
+                             as_error *err)
+{
+    PyObject *py_types = PyDict_GetItemString(py_config, "commands");
+    if (!py_types || py_types == Py_None) {
+        *types = COMMAND_LIMIT_COMMANDS;
+        return true;
+    }
+
+    if (!PyList_Check(py_types)) {
+        as_error_update(err, AEROSPIKE_ERR_PARAM,
+                        "command_limits commands must be a list");
+        return false;
+    }
+
+    static const struct {
+        const char *name;
+        command_limit_type type;
+    } names[] = {{"read", COMMAND_LIMIT_READ},
+                 {"write", COMMAND_LIMIT_WRITE},
+                 {"udf", COMMAND_LIMIT_UDF},
+                 {"batch", COMMAND_LIMIT_BATCH},
+                 {"scan", COMMAND_LIMIT_SCAN},
+                 {"query", COMMAND_LIMIT_QUERY}};
+
+    *types = 0;
+    for (Py_ssize_t i = 0; i < PyList_Size(py_types); i++) {
+        PyObject *py_type = PyList_GetItem(py_types, i);
+        const char *name =
+            PyUnicode_Check(py_type) ? PyUnicode_AsUTF8(py_type) : NULL;
+        uint32_t type = 0;
+        for (size_t j = 0; name && j < sizeof(names) / sizeof(names[0]);
+             j++) {
+            if (strcmp(name, names[j].name) == 0) {
+                type = names[j].type;
+            }
+        }
+        if (!type) {
+            PyErr_Clear();
+            as_error_update(err, AEROSPIKE_ERR_PARAM,
+                            "command_limits commands must be \"read\", "
+                            "\"write\", \"udf\", \"batch\", \"scan\" or "
+                            "\"query\"");
+            return false;
+        }
+        *types |= type;
+    }
+    return true;
+}
+
+static bool config_get_lanes(PyObject *py_config, uint32_t *lanes,
+                             as_error *err)
+{
+    char priority[16] = "";
+    if (!config_get_string(py_config, "priority", priority, sizeof(priority),
+                           NULL, err)) {
+        return false;
+    }
+
+    if (!priority[0]) {
+        *lanes = COMMAND_LIMIT_LANES;
+    }
+    else if (strcmp(priority, "interactive") == 0) {
+        *lanes = COMMAND_LIMIT_INTERACTIVE;
+    }
+    else if (strcmp(priority, "bulk") == 0) {
+        *lanes = COMMAND_LIMIT_BULK;
+    }
+    else {
+        as_error_update(err, AEROSPIKE_ERR_PARAM,
+                        "command_limits priority must be \"interactive\" or "
+                        "\"bulk\"");
+        return false;
+    }
+    return true;
+}
+
+static bool config_get_number(PyObject *py_config, const char *name,
+                              double *value, as_error *err)
+{
+    PyObject *py_value = PyDict_GetItemString(py_config, name);
+    if (!py_value || py_value == Py_None) {
+        return true;
+    }
+
+    double temp = PyFloat_AsDouble(py_value);
+    if (PyErr_Occurred() || !(temp > 0)) {
+        PyErr_Clear();
+        as_error_update(err, AEROSPIKE_ERR_PARAM,
+                        "command_limits %s must be a positive number", name);
+        return false;
+    }
+
+    *value = temp;
+    return true;
+}
+
+static bool config_get_limit(PyObject *py_config, command_limit *limit,
+                             as_error *err)
+{
+    if (!PyDict_Check(py_config)) {
+        as_error_update(err, AEROSPIKE_ERR_PARAM,
+                        "command_limits must be a list of dicts");
+        return false;
+    }
+
+    double max_concurrent = 0;
+    uint32_t lanes = 0;
+    bool set_found = false;
+
+    if (!config_get_string(py_config, "namespace", limit->ns,
+                           AS_NAMESPACE_MAX_SIZE, NULL, err) ||
+        !config_get_string(py_config, "set", limit->set, AS_SET_MAX_SIZE,
+                           &set_found, err) ||
+        !config_get_types(py_config, &limit->types, err) ||
+        !config_get_lanes(py_config, &lanes, err) ||
+        !config_get_number(py_config, "rate", &limit->rate, err) ||
+        !config_get_number(py_config, "burst", &limit->burst, err) ||
+        !config_get_number(py_config, "max_concurrent", &max_concurrent,
+                           err)) {
+        return false;
+    }
+
+    if (max_concurrent > UINT32_MAX ||
+        max_concurrent != (uint32_t)max_concurrent) {
+        as_error_update(err, AEROSPIKE_ERR_PARAM,
+                        "command_limits max_concurrent must be an integer");
+        return false;
+    }
+
+    limit->types |= lanes;
+    limit->any_set = !set_found;
+    limit->max_concurrent = (uint32_t)max_concurrent;
+    // By default a second's worth of commands may be sent at once.
+    if (limit->burst == 0) {
+        limit->burst = limit->rate;
+    }
+    limit->tokens = limit->burst;
+    limit->refilled_us = client_now_us();
+    pthread_mutex_init(&limit->lock, NULL);
+    pthread_cond_init(&limit->cond, NULL);
+    return true;
+}
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+command_limiter *command_limiter_new(PyObject *py_limits, as_error *err)
+{
+    if (!PyList_Check(py_limits)) {
+        as_error_update(err, AEROSPIKE_ERR_PARAM,
+                        "command_limits must be a list of dicts");
+        return NULL;
+    }
+
+    Py_ssize_t n_limits = PyList_Size(py_limits);
+    if (n_limits > COMMAND_LIMITS_MAX) {
+        as_error_update(err, AEROSPIKE_ERR_PARAM,
+                        "command_limits may hold at most %d limits",
+                        COMMAND_LIMITS_MAX);
+        return NULL;
+    }
+
+    command_limiter *limiter = (command_limiter *)allocator_calloc(
+        ALLOCATOR_CLIENT, 1, sizeof(command_limiter));
+    if (!limiter) {
+        as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                        "Failed to allocate memory for command_limits");
+        return NULL;
+    }
+    for (Py_ssize_t i = 0; i < n_limits; i++) {
+        if (!config_get_limit(PyList_GetItem(py_limits, i),
+                              &limiter->limits[i], err)) {
+            command_limiter_destroy(limiter);
+            return NULL;
+        }
+        limiter->n_limits++;
+    }
+
+    limiter->pid = getpid();
+    return limiter;
+}
+
+void command_limiter_destroy(command_limiter *limiter)
+{
+    if (!limiter) {
+        return;
+    }
+    for (uint32_t i = 0; i < limiter->n_limits; i++) {
+        pthread_mutex_destroy(&limiter->limits[i].lock);
+        pthread_cond_destroy(&limiter->limits[i].cond);
+    }
+    allocator_free(limiter);
+}
+
+/*
+ * The total_timeout of the command's policy, else of the client's default
+ * policy for its type. The policy was checked when it was converted.
+ */
+static uint32_t command_timeout(AerospikeClient *self, PyObject *py_policy,
+                                uint32_t type)
+{
+    PyObject *py_timeout = NULL;
+    if (py_policy && PyDict_Check(py_policy)) {
+        py_timeout = PyDict_GetItemString(py_policy, "total_timeout");
+    }
+
+    if (py_timeout && PyLong_Check(py_timeout)) {
+        unsigned long timeout = PyLong_AsUnsignedLong(py_timeout);
+        if (!PyErr_Occurred()) {
+            return (uint32_t)timeout;
+        }
+        PyErr_Clear();
+    }
+
+    as_policies *policies = &self->as->config.policies;
+    if (type & COMMAND_LIMIT_BATCH) {
+        return policies->batch.base.total_timeout;
+    }
+    if (type & COMMAND_LIMIT_SCAN) {
+        return policies->scan.base.total_timeout;
+    }
+    if (type & COMMAND_LIMIT_QUERY) {
+        return policies->query.base.total_timeout;
+    }
+    if (type & COMMAND_LIMIT_UDF) {
+        return policies->apply.base.total_timeout;
+    }
+    if (type & COMMAND_LIMIT_WRITE) {
+        return policies->write.base.total_timeout;
+    }
+    return policies->read.base.total_timeout;
+}
+
+static bool limits_acquire(AerospikeClient *self, uint32_t type,
+                           PyObject *py_policy, const char *ns,
+                           const char *set, uint32_t records,
+                           command_permit *permit, as_error *err)
+{
+    command_limiter *limiter = self->command_limiter;
+    client_check_fork(&limiter->pid, command_limiter_fork_reset, limiter);
+
+    uint32_t matches = 0;
+    for (uint32_t i = 0; i < limiter->n_limits; i++) {
+        if (limit_matches(&limiter->limits[i], type, ns, set)) {
+            matches |= 1u << i;
+        }
+    }
+    if (!matches) {
+        return true;
+    }
+
+    uint32_t timeout = command_timeout(self, py_policy, type);
+    uint64_t deadline_us =
+        timeout ? client_now_us() + (uint64_t)timeout * 1000 : 0;
+    bool exempt = callback_depth > 0;
+    uint32_t held = 0;
+
+    // Limits are always taken in config order, so commands waiting for one
+    // while holding another cannot deadlock.
+    Py_BEGIN_ALLOW_THREADS
+    for (uint32_t i = 0; i < limiter->n_limits; i++) {
+        if (!(matches & (1u << i))) {
+            continue;
+        }
+        if (!limit_acquire(&limiter->limits[i], records, deadline_us,
+                           exempt)) {
+            break;
+        }
+        held |= 1u << i;
+    }
+
+    if (held != matches) {
+        // The command does not run, so it gives back what it took.
+        for (uint32_t i = 0; i < limiter->n_limits; i++) {
+            if (held & (1u << i)) {
+                limit_release(&limiter->limits[i], records);
+            }
+        }
+    }
+    Py_END_ALLOW_THREADS
+
+    if (held != matches) {
+        as_error_update(err, AEROSPIKE_ERR_TIMEOUT,
+                        "Timed out after %u ms waiting for a command limit",
+                        timeout);
+        return false;
+    }
+
+    permit->held = matches;
+    return true;
+}
+
+bool command_limits_acquire(AerospikeClient *self, command_limit_type type,
+                            PyObject *py_policy, const as_key *key,
+                            uint32_t records, command_permit *permit,
+                            as_error *err)
+{
+    permit->held = 0;
+    if (!self->command_limiter) {
+        return true;
+    }
+
+    type |= command_lane(py_policy, type);
+    return limits_acquire(self, type, py_policy, key ? key->ns : NULL,
+                          key ? key->set : NULL, records, permit, err);
+}
+
+bool command_limits_acquire_batch(AerospikeClient *self, PyObject *py_policy,
+                                  const as_batch *batch,
+                                  command_permit *permit, as_error *err)
+{
+    const as_key *key = batch->keys.size > 0 ? &batch->keys.entries[0] : NULL;
+    return command_limits_acquire(self, COMMAND_LIMIT_BATCH, py_policy, key,
+                                  batch->keys.size, permit, err);
+}
+
+bool command_limits_acquire_records(AerospikeClient *self, PyObject *py_policy,
+                                    const as_batch_records *records,
+                                    command_permit *permit, as_error *err)
+{
+    const as_key *key = NULL;
+    if (records->list.size > 0) {
+        as_batch_base_record *record =
+            (as_batch_base_record *)as_vector_get(
+                (as_vector *)&records->list, 0);
+        key = &record->key;
+    }
+    return command_limits_acquire(self, COMMAND_LIMIT_BATCH, py_policy, key,
+                                  records->list.size, permit, err);
+}
+
+bool command_limits_acquire_set(AerospikeClient *self, command_limit_type type,
+                                PyObject *py_policy, const char *ns,
+                                const char *set, command_permit *permit,
+                                as_error *err)
+{
+    permit->held = 0;
+    if (!self->command_limiter) {
+        return true;
+    }
+
+    type |= command_lane(py_policy, type);
+    return limits_acquire(self, type, py_policy, ns, set, 1, permit, err);
+}
+
+void command_limits_release(AerospikeClient *self, command_permit *permit)
+{
+    command_limiter *limiter = self->command_limiter;
+    if (!permit->held) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < limiter->n_limits; i++) {
+        if (permit->held & (1u << i)) {
+            limit_release(&limiter->limits[i], 0);
+        }
+    }
+    permit->held = 0;
+}
+
+void command_limits_callback_begin(void)
+{
+    callback_depth++;
+}
+
+void command_limits_callback_end(void)
+{
+    callback_depth--;
+}
+
+/**
+ *******************************************************************************************************
+ * Returns the counters of each command limit, in config order.
+ *
+ * @param self                  AerospikeClient object
+ *
+ * Returns a list of dicts, or None if no command limits are configured.
+ *******************************************************************************************************
+ */
+PyObject *AerospikeClient_Get_Command_Limit_Stats(AerospikeClient *self,
+                                                  PyObject *args)
+{
+    command_limiter *limiter = self->command_limiter;
+    if (!limiter) {
+        Py_RETURN_NONE;
+    }
+
+    PyObject *py_stats = PyList_New(limiter->n_limits);
+    if (!py_stats) {
+        return NULL;
+    }
+
+    client_check_fork(&limiter->pid, command_limiter_fork_reset, limiter);
+
+    for (uint32_t i = 0; i < limiter->n_limits; i++) {
+        command_limit *limit = &limiter->limits[i];
+
+        pthread_mutex_lock(&limit->lock);
+        uint32_t in_flight = limit->in_flight;
+        uint64_t commands = limit->commands;
+        uint64_t waits = limit->waits;
+        uint64_t wait_us = limit->wait_us;
+        uint64_t timeouts = limit->timeouts;
+        pthread_mutex_unlock(&limit->lock);
+
+        PyObject *py_limit = Py_BuildValue(
+            "{s:s,s:s,s:I,s:K,s:K,s:d,s:K}", "namespace", limit->ns, "set",
+            limit->set, "in_flight", in_flight, "commands",
+            (unsigned long long)commands, "waits", (unsigned long long)waits,
+            "wait_time", (double)wait_us / 1000000, "timeouts",
+            (unsigned long long)timeouts);
+        if (!py_limit) {
+            Py_DECREF(py_stats);
+            return NULL;
+        }
+        PyList_SET_ITEM(py_stats, i, py_limit);
+    }
+
+    return py_stats;
+}
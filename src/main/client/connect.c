@@ -15,6 +15,7 @@
  ******************************************************************************/
 
 #include <Python.h>
+#include <pthread.h>
 
 #include <aerospike/aerospike.h>
 #include <aerospike/as_error.h>
@@ -22,9 +23,103 @@
 #include "client.h"
 #include "conversions.h"
 #include "global_hosts.h"
+#include "latency_router.h"
 #include "exceptions.h"
+#include "macros.h"
 
 #define MAX_PORT_SIZE 6
+// First shm key tried for clients whose shm config does not set one.
+#define DEFAULT_SHM_KEY ((int)0xA8000000)
+
+static void *lazy_connect_run(void *udata)
+{
+    AerospikeClient *self = (AerospikeClient *)udata;
+
+    probe_cluster_seeds(&self->as->config);
+    aerospike_connect(self->as, &self->connect_err);
+
+    pthread_mutex_lock(&self->connect_lock);
+    self->connect_done = true;
+    pthread_cond_broadcast(&self->connect_cond);
+    pthread_mutex_unlock(&self->connect_lock);
+
+    return NULL;
+}
+
+/**
+ *******************************************************************************************************
+ * Finishes a connect started with lazy set.
+ *
+ * @param self                  AerospikeClient object
+ * @param block                 Wait for the background connect if it is
+ *                              still running.
+ *
+ * Returns 0 once the client is connected, 1 if block is false and the
+ * connect is still running. If the connect failed, its error is raised and
+ * -1 returned.
+ *******************************************************************************************************
+ */
+int AerospikeClient_Await_Connect(AerospikeClient *self, bool block)
+{
+    if (!__atomic_load_n(&self->connect_pending, __ATOMIC_ACQUIRE)) {
+        return 0;
+    }
+
+    // The connect thread holds the lock only to signal it is done.
+    pthread_mutex_lock(&self->connect_lock);
+    bool done = self->connect_done;
+    pthread_mutex_unlock(&self->connect_lock);
+
+    if (!done) {
+        if (!block) {
+            return 1;
+        }
+        Py_BEGIN_ALLOW_THREADS
+        pthread_mutex_lock(&self->connect_lock);
+        while (!self->connect_done) {
+            pthread_cond_wait(&self->connect_cond, &self->connect_lock);
+        }
+        pthread_mutex_unlock(&self->connect_lock);
+        Py_END_ALLOW_THREADS
+    }
+
+    int rv = 0;
+
+    // Only one thread may join the connect thread. Another thread may have
+    // done so while we were waiting.
+    Py_BEGIN_CRITICAL_SECTION(self);
+    if (__atomic_load_n(&self->connect_pending, __ATOMIC_ACQUIRE)) {
+        // The thread is done, so joining it holds the GIL only briefly.
+        pthread_join(self->connect_thread, NULL);
+        __atomic_store_n(&self->connect_pending, false, __ATOMIC_RELEASE);
+
+        if (self->connect_err.code != AEROSPIKE_OK) {
+            self->is_conn_16 = false;
+            rv = -1;
+        }
+        else {
+            latency_router_start(self);
+        }
+    }
+    Py_END_CRITICAL_SECTION();
+
+    if (rv == -1) {
+        raise_exception(&self->connect_err);
+    }
+    return rv;
+}
+
+int AerospikeClient_Ensure_Connected(AerospikeClient *self)
+{
+    if (AerospikeClient_Await_Connect(self, true)) {
+        return -1;
+    }
+    if (__atomic_load_n(&self->reconnect_after_fork, __ATOMIC_ACQUIRE)) {
+        return AerospikeClient_Reconnect_After_Fork(self);
+    }
+    return 0;
+}
+
 /**
  *******************************************************************************************************
  * Establishes a connection to the Aerospike DB instance.
@@ -36,7 +131,7 @@
  * In case of error,appropriate exceptions will be raised.
  *******************************************************************************************************
  */
-int AerospikeClientConnect(AerospikeClient *self)
+int AerospikeClientConnect(AerospikeClient *self, bool lazy)
 {
     as_error err;
     as_error_init(&err);
@@ -54,79 +149,50 @@ int AerospikeClientConnect(AerospikeClient *self)
     free_alias_to_search = true;
 
     if (self->use_shared_connection) {
-        PyObject *py_persistent_item =
-            PyDict_GetItemString(py_global_hosts, alias_to_search);
-        if (py_persistent_item) {
-            aerospike *as = ((AerospikeGlobalHosts *)py_persistent_item)->as;
-            //Destroy the initial aerospike object as it has to point to the one in
-            //the persistent list now
-            if (as != self->as) {
-                // If the client has previously connected
-                // Other clients may share its aerospike* pointer
-                // So it is not safe to destroy it
-                if (!self->has_connected) {
-                    aerospike_destroy(self->as);
-                }
-                self->as = as;
-                self->as->config.shm_key =
-                    ((AerospikeGlobalHosts *)py_persistent_item)->shm_key;
-
-                //Increase ref count of global host entry
-                ((AerospikeGlobalHosts *)py_persistent_item)->ref_cnt++;
-            }
-            else {
-                // If there is a matching global host entry,
-                // and this client was disconnected, increment the ref_cnt of the global.
-                // If the client is already connected, do nothing.
-                if (!self->is_conn_16) {
-                    ((AerospikeGlobalHosts *)py_persistent_item)->ref_cnt++;
-                }
-            }
+        bool shared = false;
+
+        Py_BEGIN_ALLOW_THREADS
+        shared = AerospikeGlobalHosts_Share(self, alias_to_search, &err);
+        Py_END_ALLOW_THREADS
+
+        if (shared) {
             goto CLEANUP;
         }
     }
     //Generate unique shm_key
-    PyObject *py_key, *py_value;
-    Py_ssize_t pos = 0;
-    int flag = 0;
-    int shm_key;
     if (self->as->config.use_shm) {
-        if (user_shm_key) {
-            shm_key = self->as->config.shm_key;
-            user_shm_key = false;
-        }
-        else {
-            shm_key = counter;
-        }
-        while (1) {
-            flag = 0;
-            while (PyDict_Next(py_global_hosts, &pos, &py_key, &py_value)) {
-                if (((AerospikeGlobalHosts *)py_value)->as->config.use_shm) {
-                    if (((AerospikeGlobalHosts *)py_value)->shm_key ==
-                        shm_key) {
-                        flag = 1;
-                        break;
-                    }
-                }
-            }
-            if (!flag) {
-                self->as->config.shm_key = shm_key;
-                break;
-            }
-            shm_key = shm_key + 1;
+        // The key must be unique among the shared aerospike objects.
+        int shm_key = self->user_shm_key ? (int)self->as->config.shm_key
+                                         : DEFAULT_SHM_KEY;
+        self->user_shm_key = false;
+        self->as->config.shm_key = AerospikeGlobalHosts_Unique_Shm_Key(shm_key);
+    }
+
+    // Shared connections are published as soon as they are created, so
+    // they always connect in the foreground.
+    if (lazy && !self->use_shared_connection) {
+        as_error_init(&self->connect_err);
+        self->connect_done = false;
+        if (pthread_create(&self->connect_thread, NULL, lazy_connect_run,
+                           self) == 0) {
+            __atomic_store_n(&self->connect_pending, true, __ATOMIC_RELEASE);
+            goto CLEANUP;
         }
-        self->as->config.shm_key = shm_key;
     }
 
     Py_BEGIN_ALLOW_THREADS
+    // The seeds of shared connections key the global host entries, so their
+    // order is kept.
+    if (!self->use_shared_connection) {
+        probe_cluster_seeds(&self->as->config);
+    }
     aerospike_connect(self->as, &err);
     Py_END_ALLOW_THREADS
     if (err.code != AEROSPIKE_OK) {
         goto CLEANUP;
     }
     if (self->use_shared_connection) {
-        PyObject *py_newobject = (PyObject *)AerospikeGobalHosts_New(self->as);
-        PyDict_SetItemString(py_global_hosts, alias_to_search, py_newobject);
+        AerospikeGlobalHosts_Add(alias_to_search, self->as);
     }
 
 CLEANUP:
@@ -141,6 +207,9 @@ CLEANUP:
     }
     self->is_conn_16 = true;
     self->has_connected = true;
+    if (!__atomic_load_n(&self->connect_pending, __ATOMIC_ACQUIRE)) {
+        latency_router_start(self);
+    }
     return 0;
 }
 
@@ -165,14 +234,29 @@ PyObject *AerospikeClient_Connect(AerospikeClient *self, PyObject *args,
     as_error_init(&err);
     PyObject *py_username = NULL;
     PyObject *py_password = NULL;
+    int lazy = 0;
+    PyObject *py_snapshot = NULL;
+
+    static char *kwlist[] = {"username", "password", "lazy", "snapshot",
+                             NULL};
 
     if (self->as && aerospike_cluster_is_connected(self->as)) {
         Py_INCREF(self);
         return (PyObject *)self;
     }
 
-    if (PyArg_ParseTuple(args, "|OO:connect", &py_username, &py_password) ==
-        false) {
+    if (PyArg_ParseTupleAndKeywords(args, kwds, "|OO$pO:connect", kwlist,
+                                    &py_username, &py_password, &lazy,
+                                    &py_snapshot) == false) {
+        return NULL;
+    }
+
+    // The seeds of shared connections key the global host entries.
+    if (py_snapshot && py_snapshot != Py_None &&
+        !self->use_shared_connection &&
+        apply_cluster_snapshot(&self->as->config, py_snapshot, &err) !=
+            AEROSPIKE_OK) {
+        raise_exception(&err);
         return NULL;
     }
 
@@ -183,7 +267,7 @@ PyObject *AerospikeClient_Connect(AerospikeClient *self, PyObject *args,
         as_config_set_user(&self->as->config, username, password);
     }
 
-    if (AerospikeClientConnect(self) == -1) {
+    if (AerospikeClientConnect(self, lazy) == -1) {
         return NULL;
     }
 
@@ -211,6 +295,14 @@ PyObject *AerospikeClient_is_connected(AerospikeClient *self, PyObject *args,
         return Py_False;
     }
 
+    // Report a lazy connect that is still running instead of waiting for it.
+    int connect_status = AerospikeClient_Await_Connect(self, false);
+    if (connect_status != 0) {
+        PyErr_Clear();
+        Py_INCREF(Py_False);
+        return Py_False;
+    }
+
     if (self->as && aerospike_cluster_is_connected(self->as)) {
         Py_INCREF(Py_True);
         return Py_True;
@@ -22,9 +22,12 @@
 #include <aerospike/as_error.h>
 #include <aerospike/as_record.h>
 
+#include "adaptive_policy.h"
 #include "client.h"
+#include "command_limits.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "fastcall.h"
 #include "policy.h"
 
 /**
@@ -74,7 +77,7 @@ extern PyObject *AerospikeClient_Exists_Invoke(AerospikeClient *self,
     }
 
     // Convert python key object to as_key
-    pyobject_to_key(&err, py_key, &key);
+    pyobject_to_key(self, &err, py_key, &key);
     if (err.code != AEROSPIKE_OK) {
         goto CLEANUP;
     }
@@ -90,15 +93,23 @@ extern PyObject *AerospikeClient_Exists_Invoke(AerospikeClient *self,
     }
 
     // Invoke operation
+    command_permit permit;
+    if (!command_limits_acquire(self, COMMAND_LIMIT_READ, py_policy, &key, 1,
+                                &permit, &err)) {
+        goto CLEANUP;
+    }
+    uint64_t start = adaptive_policy_begin(self, &read_policy_p->base, true);
     Py_BEGIN_ALLOW_THREADS
     aerospike_key_exists(self->as, &err, read_policy_p, &key, &rec);
     Py_END_ALLOW_THREADS
+    command_limits_release(self, &permit);
+    adaptive_policy_end(self, start, true, &err);
 
     if (err.code == AEROSPIKE_OK) {
         PyObject *py_result_key = NULL;
         PyObject *py_result_meta = NULL;
 
-        key_to_pyobject(&err, &key, &py_result_key);
+        key_to_pyobject(self, &err, &key, &py_result_key);
         metadata_to_pyobject(&err, rec, &py_result_meta);
 
         py_result = PyTuple_New(2);
@@ -111,7 +122,7 @@ extern PyObject *AerospikeClient_Exists_Invoke(AerospikeClient *self,
         PyObject *py_result_key = NULL;
         PyObject *py_result_meta = Py_None;
 
-        key_to_pyobject(&err, &key, &py_result_key);
+        key_to_pyobject(self, &err, &key, &py_result_key);
 
         py_result = PyTuple_New(2);
         PyTuple_SetItem(py_result, 0, py_result_key);
@@ -139,17 +150,7 @@ CLEANUP:
     }
 
     if (err.code != AEROSPIKE_OK) {
-        PyObject *py_err = NULL;
-        error_to_pyobject(&err, &py_err);
-        PyObject *exception_type = raise_exception_old(&err);
-        if (PyObject_HasAttrString(exception_type, "key")) {
-            PyObject_SetAttrString(exception_type, "key", py_key);
-        }
-        if (PyObject_HasAttrString(exception_type, "bin")) {
-            PyObject_SetAttrString(exception_type, "bin", Py_None);
-        }
-        PyErr_SetObject(exception_type, py_err);
-        Py_DECREF(py_err);
+        raise_exception_base(&err, py_key, Py_None, NULL, NULL, NULL);
     }
 
     return py_result;
@@ -168,19 +169,20 @@ CLEANUP:
  * In case of error,appropriate exceptions will be raised.
  *******************************************************************************************************
  */
-PyObject *AerospikeClient_Exists(AerospikeClient *self, PyObject *args,
-                                 PyObject *kwds)
+PyObject *AerospikeClient_Exists(AerospikeClient *self, PyObject *const *args,
+                                 Py_ssize_t nargs, PyObject *kwnames)
 {
     // Python Function Arguments
     PyObject *py_key = NULL;
     PyObject *py_policy = NULL;
 
     // Python Function Keyword Arguments
-    static char *kwlist[] = {"key", "policy", NULL};
+    static const char *kwlist[] = {"key", "policy", NULL};
+    static fastcall_parser parser = {"exists", kwlist, 1};
 
     // Python Function Argument Parsing
-    if (PyArg_ParseTupleAndKeywords(args, kwds, "O|O:exists", kwlist, &py_key,
-                                    &py_policy) == false) {
+    if (fastcall_parse(&parser, self->state, args, nargs, kwnames, &py_key,
+                       &py_policy) == false) {
         return NULL;
     }
 
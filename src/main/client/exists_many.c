@@ -25,13 +25,17 @@
 #include <aerospike/as_batch.h>
 
 #include "client.h"
+#include "command_limits.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "fastcall.h"
 #include "policy.h"
+#include "interpreter.h"
 
 typedef struct _exists_many_cb_data {
     PyObject *py_recs;
     as_error *cb_err;
+    AerospikeClient *client;
 } exists_many_cb_data;
 
 static void make_batch_safe_to_free(as_batch *batch, int size);
@@ -57,8 +61,8 @@ static bool batch_exists_cb(const as_batch_read *results, uint32_t n,
     as_error_init(&local_err);
 
     // Lock Python State
-    PyGILState_STATE gstate;
-    gstate = PyGILState_Ensure();
+    Aerospike_GIL_State gstate =
+        Aerospike_GIL_Ensure(local_data->client->interp);
 
     // Loop over results array
     for (uint32_t i = 0; i < n; i++) {
@@ -68,7 +72,8 @@ static bool batch_exists_cb(const as_batch_read *results, uint32_t n,
         PyObject *py_key = NULL;
 
         if (results[i].result == AEROSPIKE_OK) {
-            key_to_pyobject(&local_err, results[i].key, &py_key);
+            key_to_pyobject(local_data->client, &local_err, results[i].key,
+                            &py_key);
             if (!py_key) {
                 py_key = Py_None;
                 Py_INCREF(py_key);
@@ -85,12 +90,13 @@ static bool batch_exists_cb(const as_batch_read *results, uint32_t n,
             if (!py_rec) {
                 as_error_update(local_data->cb_err, AEROSPIKE_ERR_CLIENT,
                                 "Failed to create metadata tuple");
-                PyGILState_Release(gstate);
+                Aerospike_GIL_Release(&gstate);
                 return false;
             }
         }
         else {
-            key_to_pyobject(&local_err, results[i].key, &py_key);
+            key_to_pyobject(local_data->client, &local_err, results[i].key,
+                            &py_key);
             if (!py_key) {
                 py_key = Py_None;
                 Py_INCREF(py_key);
@@ -98,7 +104,7 @@ static bool batch_exists_cb(const as_batch_read *results, uint32_t n,
             py_rec = Py_BuildValue("OO", py_key, Py_None);
             Py_DECREF(py_key);
             if (!py_rec) {
-                PyGILState_Release(gstate);
+                Aerospike_GIL_Release(&gstate);
                 as_error_update(local_data->cb_err, AEROSPIKE_ERR_CLIENT,
                                 "Failed to create metadata tuple");
                 return false;
@@ -106,14 +112,14 @@ static bool batch_exists_cb(const as_batch_read *results, uint32_t n,
         }
         if (PyList_SetItem(py_recs, i, py_rec) != 0) {
             Py_XDECREF(py_rec);
-            PyGILState_Release(gstate);
+            Aerospike_GIL_Release(&gstate);
             as_error_update(local_data->cb_err, AEROSPIKE_ERR_CLIENT,
                             "Failed to add record to metadata tuple");
             return false;
         }
     }
     // Release Python State
-    PyGILState_Release(gstate);
+    Aerospike_GIL_Release(&gstate);
     return true;
 }
 
@@ -125,6 +131,7 @@ static bool batch_exists_cb(const as_batch_read *results, uint32_t n,
  * @param self                  AerospikeClient object
  * @param py_keys               The list of keys
  * @param batch_policy_p        as_policy_batch object
+ * @param py_policy             The policy dict, for its priority
  *
  * Returns the record if key exists otherwise NULL.
  *******************************************************************************************************
@@ -132,7 +139,8 @@ static bool batch_exists_cb(const as_batch_read *results, uint32_t n,
 static PyObject *
 batch_exists_aerospike_batch_exists(as_error *err, AerospikeClient *self,
                                     PyObject *py_keys,
-                                    as_policy_batch *batch_policy_p)
+                                    as_policy_batch *batch_policy_p,
+                                    PyObject *py_policy)
 {
 
     as_batch batch;
@@ -142,6 +150,7 @@ batch_exists_aerospike_batch_exists(as_error *err, AerospikeClient *self,
     as_error_init(&local_err);
     cb_data.py_recs = NULL;
     cb_data.cb_err = &local_err;
+    cb_data.client = self;
 
     // Convert python keys list to as_key ** and add it to as_batch.keys
     // keys can be specified in PyList or PyTuple
@@ -170,7 +179,7 @@ batch_exists_aerospike_batch_exists(as_error *err, AerospikeClient *self,
                 goto CLEANUP;
             }
 
-            pyobject_to_key(err, py_key, as_batch_keyat(&batch, i));
+            pyobject_to_key(self, err, py_key, as_batch_keyat(&batch, i));
 
             if (err->code != AEROSPIKE_OK) {
                 goto CLEANUP;
@@ -184,11 +193,17 @@ batch_exists_aerospike_batch_exists(as_error *err, AerospikeClient *self,
     }
 
     // Invoke C-client API
+    command_permit permit;
+    if (!command_limits_acquire_batch(self, py_policy, &batch, &permit, err)) {
+        Py_CLEAR(cb_data.py_recs);
+        goto CLEANUP;
+    }
     Py_BEGIN_ALLOW_THREADS
     aerospike_batch_exists(self->as, err, batch_policy_p, &batch,
                            (aerospike_batch_read_callback)batch_exists_cb,
                            &cb_data);
     Py_END_ALLOW_THREADS
+    command_limits_release(self, &permit);
     if (err->code != AEROSPIKE_OK) {
         as_error_update(err, err->code, NULL);
         Py_CLEAR(cb_data.py_recs);
@@ -258,7 +273,7 @@ static PyObject *AerospikeClient_Exists_Many_Invoke(AerospikeClient *self,
     }
 
     py_recs = batch_exists_aerospike_batch_exists(&err, self, py_keys,
-                                                  batch_policy_p);
+                                                  batch_policy_p, py_policy);
 
 CLEANUP:
 
@@ -268,17 +283,7 @@ CLEANUP:
     }
 
     if (err.code != AEROSPIKE_OK) {
-        PyObject *py_err = NULL;
-        error_to_pyobject(&err, &py_err);
-        PyObject *exception_type = raise_exception_old(&err);
-        if (PyObject_HasAttrString(exception_type, "key")) {
-            PyObject_SetAttrString(exception_type, "key", py_keys);
-        }
-        if (PyObject_HasAttrString(exception_type, "bin")) {
-            PyObject_SetAttrString(exception_type, "bin", Py_None);
-        }
-        PyErr_SetObject(exception_type, py_err);
-        Py_DECREF(py_err);
+        raise_exception_base(&err, py_keys, Py_None, NULL, NULL, NULL);
         return NULL;
     }
 
@@ -299,19 +304,21 @@ CLEANUP:
  * In case of error,appropriate exceptions will be raised.
  *******************************************************************************************************
  */
-PyObject *AerospikeClient_Exists_Many(AerospikeClient *self, PyObject *args,
-                                      PyObject *kwds)
+PyObject *AerospikeClient_Exists_Many(AerospikeClient *self,
+                                      PyObject *const *args, Py_ssize_t nargs,
+                                      PyObject *kwnames)
 {
     // Python Function Arguments
     PyObject *py_keys = NULL;
     PyObject *py_policy = NULL;
 
     // Python Function Keyword Arguments
-    static char *kwlist[] = {"keys", "policy", NULL};
+    static const char *kwlist[] = {"keys", "policy", NULL};
+    static fastcall_parser parser = {"exists_many", kwlist, 1};
 
     // Python Function Argument Parsing
-    if (PyArg_ParseTupleAndKeywords(args, kwds, "O|O:exists_many", kwlist,
-                                    &py_keys, &py_policy) == false) {
+    if (fastcall_parse(&parser, self->state, args, nargs, kwnames, &py_keys,
+                       &py_policy) == false) {
         return NULL;
     }
 
@@ -0,0 +1,194 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <pthread.h>
+#include <stdbool.h>
+
+#include <aerospike/aerospike.h>
+#include <aerospike/as_error.h>
+
+#include "allocator.h"
+#include "client.h"
+#include "exceptions.h"
+#include "global_hosts.h"
+#include "latency_router.h"
+#include "log.h"
+#include "macros.h"
+
+// Connected clients, so the child handler can find their clusters.
+static AerospikeClient *fork_clients = NULL;
+// Held across fork() so the child sees a consistent list. Without the GIL,
+// clients may be created and destroyed concurrently.
+static pthread_mutex_t fork_clients_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t fork_handler_once = PTHREAD_ONCE_INIT;
+
+static void fork_prepare(void)
+{
+    AerospikeGlobalHosts_Lock();
+    pthread_mutex_lock(&fork_clients_lock);
+    allocator_fork_lock();
+}
+
+static void fork_parent(void)
+{
+    allocator_fork_unlock();
+    pthread_mutex_unlock(&fork_clients_lock);
+    AerospikeGlobalHosts_Unlock();
+}
+
+/*
+ * Runs in the child right after fork(). Only the forking thread exists at
+ * this point, so nothing here may block on a lock or call into Python.
+ */
+static void fork_child(void)
+{
+    for (AerospikeClient *client = fork_clients; client;
+         client = client->fork_next) {
+        if (!client->as || !client->is_conn_16) {
+            continue;
+        }
+        // The cluster's tend thread did not survive the fork and its sockets
+        // are still used by the parent. Forget it rather than close it:
+        // as_cluster_destroy() would join a thread that does not exist here.
+        // Clients sharing the aerospike object just clear it again.
+        client->as->cluster = NULL;
+        client->reconnect_after_fork = true;
+        // A thread of the parent may have been reconnecting it.
+        pthread_mutex_init(&client->reconnect_lock, NULL);
+        // A lazy connect in progress did not survive either.
+        client->connect_pending = false;
+        pthread_mutex_init(&client->connect_lock, NULL);
+        pthread_cond_init(&client->connect_cond, NULL);
+    }
+    AerospikeGlobalHosts_Fork_Child();
+    allocator_fork_unlock();
+    pthread_mutex_unlock(&fork_clients_lock);
+    AerospikeGlobalHosts_Unlock();
+
+    log_fork_child();
+}
+
+static void fork_handler_register(void)
+{
+    pthread_atfork(fork_prepare, fork_parent, fork_child);
+}
+
+void Aerospike_Init_Fork_Handler(void)
+{
+    pthread_once(&fork_handler_once, fork_handler_register);
+}
+
+void AerospikeClient_Fork_Track(AerospikeClient *self)
+{
+    pthread_mutex_lock(&fork_clients_lock);
+    if (!self->fork_tracked) {
+        self->fork_prev = NULL;
+        self->fork_next = fork_clients;
+        if (fork_clients) {
+            fork_clients->fork_prev = self;
+        }
+        fork_clients = self;
+        self->fork_tracked = true;
+    }
+    pthread_mutex_unlock(&fork_clients_lock);
+}
+
+void AerospikeClient_Fork_Untrack(AerospikeClient *self)
+{
+    pthread_mutex_lock(&fork_clients_lock);
+    if (self->fork_tracked) {
+        if (self->fork_prev) {
+            self->fork_prev->fork_next = self->fork_next;
+        }
+        else {
+            fork_clients = self->fork_next;
+        }
+        if (self->fork_next) {
+            self->fork_next->fork_prev = self->fork_prev;
+        }
+        self->fork_prev = NULL;
+        self->fork_next = NULL;
+        self->fork_tracked = false;
+    }
+    pthread_mutex_unlock(&fork_clients_lock);
+}
+
+static void reconnect(AerospikeClient *self, as_error *err)
+{
+    char *alias_to_search = NULL;
+    if (self->use_shared_connection) {
+        alias_to_search = return_search_string(self->as);
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    // Clients sharing the aerospike object connect it once per process.
+    if (!alias_to_search ||
+        !AerospikeGlobalHosts_Revalidate(alias_to_search, self->as, err)) {
+        aerospike_connect(self->as, err);
+    }
+    Py_END_ALLOW_THREADS
+
+    PyMem_Free(alias_to_search);
+}
+
+/**
+ *******************************************************************************************************
+ * Connects a client inherited from a parent process again. The new cluster
+ * is built from the client's config; with shared memory enabled the child
+ * attaches to the partition map the parent already maintains.
+ *
+ * @param self                  AerospikeClient object
+ *
+ * Returns 0 on success. In case of error, appropriate exceptions will be
+ * raised and -1 returned.
+ *******************************************************************************************************
+ */
+int AerospikeClient_Reconnect_After_Fork(AerospikeClient *self)
+{
+    as_error err;
+    as_error_init(&err);
+
+    // Threads racing to use the client reconnect it once. The others wait
+    // until it is connected: reconnect() releases the GIL, and the flag stays
+    // set until then so no command is sent on the cleared cluster.
+    Py_BEGIN_ALLOW_THREADS
+    pthread_mutex_lock(&self->reconnect_lock);
+    Py_END_ALLOW_THREADS
+
+    if (self->reconnect_after_fork) {
+        if (log_dispatcher_resume(&err) == AEROSPIKE_OK) {
+            reconnect(self, &err);
+        }
+        if (err.code != AEROSPIKE_OK) {
+            // Operations fail with a connection error instead of using the
+            // cleared cluster.
+            self->is_conn_16 = false;
+        }
+        else {
+            latency_router_start(self);
+        }
+        __atomic_store_n(&self->reconnect_after_fork, false, __ATOMIC_RELEASE);
+    }
+
+    pthread_mutex_unlock(&self->reconnect_lock);
+
+    if (err.code != AEROSPIKE_OK) {
+        raise_exception(&err);
+        return -1;
+    }
+    return 0;
+}
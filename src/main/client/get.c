@@ -22,10 +22,18 @@
 #include <aerospike/as_error.h>
 #include <aerospike/as_record.h>
 
+#include "adaptive_policy.h"
+#include "auto_batch.h"
 #include "client.h"
+#include "command_limits.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "fastcall.h"
+#include "hedged_read.h"
 #include "policy.h"
+#include "read_cache.h"
+#include "serializer.h"
+#include "single_flight.h"
 
 /**
  *******************************************************************************************************
@@ -60,6 +68,10 @@ PyObject *AerospikeClient_Get_Invoke(AerospikeClient *self, PyObject *py_key,
     // Initialised flags
     bool key_initialised = false;
     bool record_initialised = false;
+    bool use_cache = false;
+    uint64_t cache_epoch = 0;
+    single_flight *flight = NULL;
+    auto_batch_records *read_batch = NULL;
 
     // Initialize error
     as_error_init(&err);
@@ -76,7 +88,7 @@ PyObject *AerospikeClient_Get_Invoke(AerospikeClient *self, PyObject *py_key,
     }
 
     // Convert python key object to as_key
-    pyobject_to_key(&err, py_key, &key);
+    pyobject_to_key(self, &err, py_key, &key);
     if (err.code != AEROSPIKE_OK) {
         goto CLEANUP;
     }
@@ -91,15 +103,58 @@ PyObject *AerospikeClient_Get_Invoke(AerospikeClient *self, PyObject *py_key,
         goto CLEANUP;
     }
 
+    // Filtered reads depend on more than the record, so they bypass the cache.
+    use_cache = self->read_cache && !exp_list_p &&
+                read_cache_covers(self, read_policy_p, &key);
+    if (use_cache) {
+        // Taken first, so that a write made during the read below keeps the
+        // record it read out of the cache.
+        cache_epoch = read_cache_epoch(self->read_cache);
+        py_rec = read_cache_lookup(self, read_policy_p, &key);
+        if (py_rec) {
+            goto CLEANUP;
+        }
+    }
+
+    // Concurrent identical reads share one command.
+    if (self->py_flights && !exp_list_p &&
+        single_flight_join(self, &key, read_policy_p, NULL, &flight, &err,
+                           &py_rec)) {
+        goto CLEANUP;
+    }
+
     // Invoke operation
-    Py_BEGIN_ALLOW_THREADS
-    aerospike_key_get(self->as, &err, read_policy_p, &key, &rec);
-    Py_END_ALLOW_THREADS
+    command_permit permit;
+    if (!command_limits_acquire(self, COMMAND_LIMIT_READ, py_policy, &key, 1,
+                                &permit, &err)) {
+        goto CLEANUP;
+    }
+    uint64_t start = adaptive_policy_begin(self, &read_policy_p->base, true);
+    if (!exp_list_p && auto_batch_covers_get(self, py_policy, &key)) {
+        // The record belongs to the batch, which is released below.
+        auto_batch_get(self, &key, &err, &rec, &read_batch);
+    }
+    else if (hedged_read_covers(self, read_policy_p, exp_list_p != NULL)) {
+        Py_BEGIN_ALLOW_THREADS
+        hedged_read(self->hedged_reader, self->as, read_policy_p, &key, NULL,
+                    &err, &rec);
+        Py_END_ALLOW_THREADS
+    }
+    else {
+        Py_BEGIN_ALLOW_THREADS
+        aerospike_key_get(self->as, &err, read_policy_p, &key, &rec);
+        Py_END_ALLOW_THREADS
+    }
+    command_limits_release(self, &permit);
+    adaptive_policy_end(self, start, true, &err);
     if (err.code == AEROSPIKE_OK) {
-        record_initialised = true;
+        record_initialised = !read_batch;
 
-        if (record_to_pyobject(self, &err, rec, &key, &py_rec) !=
-            AEROSPIKE_OK) {
+        deferred_values deferred;
+        deferred_values_init(self, &deferred);
+        record_to_pyobject_deferred(self, &err, rec, &key, &deferred, &py_rec);
+        deferred_values_deserialize(&deferred, err.code == AEROSPIKE_OK);
+        if (err.code != AEROSPIKE_OK) {
             goto CLEANUP;
         }
         if (!read_policy_p ||
@@ -113,6 +168,9 @@ PyObject *AerospikeClient_Get_Invoke(AerospikeClient *self, PyObject *py_key,
             Py_INCREF(Py_None);
             PyTuple_SetItem(p_key, 2, Py_None);
         }
+        if (use_cache) {
+            read_cache_put(self, cache_epoch, &key, rec, py_rec);
+        }
     }
     else {
         as_error_update(&err, err.code, NULL);
@@ -120,6 +178,10 @@ PyObject *AerospikeClient_Get_Invoke(AerospikeClient *self, PyObject *py_key,
 
 CLEANUP:
 
+    if (flight) {
+        single_flight_land(self, flight, &err, py_rec);
+    }
+
     if (exp_list_p) {
         as_exp_destroy(exp_list_p);
         ;
@@ -135,18 +197,12 @@ CLEANUP:
         as_record_destroy(rec);
     }
 
+    if (read_batch) {
+        auto_batch_release(read_batch);
+    }
+
     if (err.code != AEROSPIKE_OK) {
-        PyObject *py_err = NULL;
-        error_to_pyobject(&err, &py_err);
-        PyObject *exception_type = raise_exception_old(&err);
-        if (PyObject_HasAttrString(exception_type, "key")) {
-            PyObject_SetAttrString(exception_type, "key", py_key);
-        }
-        if (PyObject_HasAttrString(exception_type, "bin")) {
-            PyObject_SetAttrString(exception_type, "bin", Py_None);
-        }
-        PyErr_SetObject(exception_type, py_err);
-        Py_DECREF(py_err);
+        raise_exception_base(&err, py_key, Py_None, NULL, NULL, NULL);
         return NULL;
     }
 
@@ -166,19 +222,20 @@ CLEANUP:
  * In case of error,appropriate exceptions will be raised.
  *******************************************************************************************************
  */
-PyObject *AerospikeClient_Get(AerospikeClient *self, PyObject *args,
-                              PyObject *kwds)
+PyObject *AerospikeClient_Get(AerospikeClient *self, PyObject *const *args,
+                              Py_ssize_t nargs, PyObject *kwnames)
 {
     // Python Function Arguments
     PyObject *py_key = NULL;
     PyObject *py_policy = NULL;
 
     // Python Function Keyword Arguments
-    static char *kwlist[] = {"key", "policy", NULL};
+    static const char *kwlist[] = {"key", "policy", NULL};
+    static fastcall_parser parser = {"get", kwlist, 1};
 
     // Python Function Argument Parsing
-    if (PyArg_ParseTupleAndKeywords(args, kwds, "O|O:get", kwlist, &py_key,
-                                    &py_policy) == false) {
+    if (fastcall_parse(&parser, self->state, args, nargs, kwnames, &py_key,
+                       &py_policy) == false) {
         return NULL;
     }
 
@@ -78,7 +78,7 @@ PyObject *AerospikeClient_Get_Key_Digest_Invoke(AerospikeClient *self,
     PyDict_SetItemString(py_keydict, "key", py_key);
 
     // Convert python key object to as_key
-    pyobject_to_key(&err, py_keydict, &key);
+    pyobject_to_key(self, &err, py_keydict, &key);
     if (err.code != AEROSPIKE_OK) {
         goto CLEANUP;
     }
@@ -92,7 +92,7 @@ PyObject *AerospikeClient_Get_Key_PartitionID_Invoke(AerospikeClient *self,
     }
 
     // Convert python key object to as_key
-    pyobject_to_key(&err, py_keydict, &key);
+    pyobject_to_key(self, &err, py_keydict, &key);
     if (err.code != AEROSPIKE_OK) {
         goto CLEANUP;
     }
@@ -25,9 +25,12 @@
 #include <aerospike/as_batch.h>
 
 #include "client.h"
+#include "command_limits.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "fastcall.h"
 #include "policy.h"
+#include "serializer.h"
 
 #define MAX_STACK_ALLOCATION 4000
 
@@ -39,6 +42,7 @@
  * @param self                  AerospikeClient object
  * @param py_keys               The list of keys
  * @param batch_policy_p        as_policy_batch object
+ * @param py_policy             The policy dict, for its priority
  *
  * Returns the record if key exists otherwise NULL.
  *******************************************************************************************************
@@ -46,7 +50,8 @@
 static PyObject *batch_get_aerospike_batch_read(as_error *err,
                                                 AerospikeClient *self,
                                                 PyObject *py_keys,
-                                                as_policy_batch *batch_policy_p)
+                                                as_policy_batch *batch_policy_p,
+                                                PyObject *py_policy)
 {
     PyObject *py_recs = NULL;
 
@@ -83,7 +88,7 @@ static PyObject *batch_get_aerospike_batch_read(as_error *err,
 
             record = as_batch_read_reserve(&records);
 
-            pyobject_to_key(err, py_key, &record->key);
+            pyobject_to_key(self, err, py_key, &record->key);
             record->read_all_bins = true;
 
             if (err->code != AEROSPIKE_OK) {
@@ -98,13 +103,22 @@ static PyObject *batch_get_aerospike_batch_read(as_error *err,
     }
 
     // Invoke C-client API
+    command_permit permit;
+    if (!command_limits_acquire_records(self, py_policy, &records, &permit,
+                                        err)) {
+        goto CLEANUP;
+    }
     Py_BEGIN_ALLOW_THREADS
     aerospike_batch_read(self->as, err, batch_policy_p, &records);
     Py_END_ALLOW_THREADS
+    command_limits_release(self, &permit);
     if (err->code != AEROSPIKE_OK) {
         goto CLEANUP;
     }
-    batch_read_records_to_pyobject(self, err, &records, &py_recs);
+    deferred_values deferred;
+    deferred_values_init(self, &deferred);
+    batch_read_records_to_pyobject(self, err, &records, &deferred, &py_recs);
+    deferred_values_deserialize(&deferred, err->code == AEROSPIKE_OK);
 
 CLEANUP:
     if (batch_initialised == true) {
@@ -173,7 +187,8 @@ static PyObject *AerospikeClient_Get_Many_Invoke(AerospikeClient *self,
     }
 
     py_recs =
-        batch_get_aerospike_batch_read(&err, self, py_keys, batch_policy_p);
+        batch_get_aerospike_batch_read(&err, self, py_keys, batch_policy_p,
+                                       py_policy);
 
 CLEANUP:
 
@@ -182,17 +197,7 @@ CLEANUP:
     }
 
     if (err.code != AEROSPIKE_OK) {
-        PyObject *py_err = NULL;
-        error_to_pyobject(&err, &py_err);
-        PyObject *exception_type = raise_exception_old(&err);
-        if (PyObject_HasAttrString(exception_type, "key")) {
-            PyObject_SetAttrString(exception_type, "key", py_keys);
-        }
-        if (PyObject_HasAttrString(exception_type, "bin")) {
-            PyObject_SetAttrString(exception_type, "bin", Py_None);
-        }
-        PyErr_SetObject(exception_type, py_err);
-        Py_DECREF(py_err);
+        raise_exception_base(&err, py_keys, Py_None, NULL, NULL, NULL);
         return NULL;
     }
 
@@ -213,19 +218,20 @@ CLEANUP:
  * In case of error,appropriate exceptions will be raised.
  *******************************************************************************************************
  */
-PyObject *AerospikeClient_Get_Many(AerospikeClient *self, PyObject *args,
-                                   PyObject *kwds)
+PyObject *AerospikeClient_Get_Many(AerospikeClient *self, PyObject *const *args,
+                                   Py_ssize_t nargs, PyObject *kwnames)
 {
     // Python Function Arguments
     PyObject *py_keys = NULL;
     PyObject *py_policy = NULL;
 
     // Python Function Keyword Arguments
-    static char *kwlist[] = {"keys", "policy", NULL};
+    static const char *kwlist[] = {"keys", "policy", NULL};
+    static fastcall_parser parser = {"get_many", kwlist, 1};
 
     // Python Function Argument Parsing
-    if (PyArg_ParseTupleAndKeywords(args, kwds, "O|O:get_many", kwlist,
-                                    &py_keys, &py_policy) == false) {
+    if (fastcall_parse(&parser, self->state, args, nargs, kwnames, &py_keys,
+                       &py_policy) == false) {
         return NULL;
     }
 
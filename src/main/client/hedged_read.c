@@ -0,0 +1,540 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <aerospike/aerospike_key.h>
+#include <aerospike/as_bin.h>
+#include <aerospike/as_error.h>
+#include <aerospike/as_key.h>
+#include <aerospike/as_policy.h>
+#include <aerospike/as_record.h>
+
+#include "allocator.h"
+#include "client.h"
+#include "client_utils.h"
+#include "hedged_read.h"
+#include "latency_window.h"
+
+#define HEDGED_READ_DEFAULT_DELAY_US 10000
+#define HEDGED_READ_DEFAULT_MIN_DELAY_US 1000
+#define HEDGED_READ_DEFAULT_THREADS 8
+
+typedef struct hedged_read_call_s hedged_read_call;
+
+/*
+ * One of the two commands of a hedged read, queued for the workers.
+ */
+typedef struct hedged_read_job_s {
+    struct hedged_read_job_s *next;
+    hedged_read_call *call;
+    bool hedge;
+} hedged_read_job;
+
+/*
+ * A hedged read, shared by the caller and its jobs. The slower command
+ * keeps running after the caller returns, so the call holds copies of the
+ * key, policy and bins, and is freed by whichever of them is done last.
+ */
+struct hedged_read_call_s {
+    aerospike *as;
+    as_key key;
+    as_policy_read policy;
+    as_policy_read hedge_policy;
+    char **bins;
+    hedged_read_job jobs[2];
+    uint32_t refs;
+    // Commands queued or running.
+    uint32_t pending;
+    // Set once the outcome is known. Later responses are dropped.
+    bool done;
+    as_error err;
+    as_record *rec;
+};
+
+struct hedged_reader_s {
+    pthread_mutex_t lock;
+    // Signaled when jobs are queued.
+    pthread_cond_t work_cond;
+    // Signaled when calls are done.
+    pthread_cond_t done_cond;
+    hedged_read_job *head;
+    hedged_read_job *tail;
+    uint32_t queued;
+    pthread_t *threads;
+    uint32_t n_threads;
+    uint32_t max_threads;
+    // Workers waiting for a job.
+    uint32_t idle;
+    bool stopping;
+    uint32_t delay_us;
+    uint32_t min_delay_us;
+    uint32_t max_delay_us;
+    // Latencies of first attempts, for a percentile delay.
+    bool percentile_delay;
+    latency_window latencies;
+    // Workers inherited across fork() do not exist in the child.
+    pid_t pid;
+};
+
+/*******************************************************************************
+ * CALLS
+ ******************************************************************************/
+
+static as_status read_record(aerospike *as, as_error *err,
+                             as_policy_read *policy, as_key *key,
+                             const char **bins, as_record **rec)
+{
+    if (bins) {
+        return aerospike_key_select(as, err, policy, key, bins, rec);
+    }
+    return aerospike_key_get(as, err, policy, key, rec);
+}
+
+/*
+ * Errors which another node may not return. A read failing with one waits
+ * for the response to the other command, if it was sent.
+ */
+static bool is_transient(as_status status)
+{
+    switch (status) {
+    case AEROSPIKE_ERR_TIMEOUT:
+    case AEROSPIKE_ERR_CONNECTION:
+    case AEROSPIKE_ERR_NO_MORE_CONNECTIONS:
+    case AEROSPIKE_ERR_INVALID_NODE:
+    case AEROSPIKE_ERR_DEVICE_OVERLOAD:
+    case AEROSPIKE_ERR_CLUSTER_CHANGE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// NULL if out of memory, in which case the read is not hedged.
+static hedged_read_call *call_new(aerospike *as, as_policy_read *policy,
+                                  as_key *key, const char **bins)
+{
+    hedged_read_call *call = (hedged_read_call *)allocator_calloc(
+        ALLOCATOR_HEDGED_READ, 1, sizeof(hedged_read_call));
+    if (!call) {
+        return NULL;
+    }
+    call->as = as;
+    as_key_init_digest(&call->key, key->ns, key->set, key->digest.value);
+    as_error_init(&call->err);
+
+    // The copied key has no value to send.
+    call->policy = policy ? *policy : as->config.policies.read;
+    call->policy.key = AS_POLICY_KEY_DIGEST;
+    call->hedge_policy = call->policy;
+    call->hedge_policy.replica = AS_POLICY_REPLICA_ANY;
+
+    if (bins) {
+        size_t n_bins = 0;
+        while (bins[n_bins]) {
+            n_bins++;
+        }
+        call->bins = (char **)allocator_malloc(
+            ALLOCATOR_HEDGED_READ,
+            sizeof(char *) * (n_bins + 1) + AS_BIN_NAME_MAX_SIZE * n_bins);
+        if (!call->bins) {
+            as_key_destroy(&call->key);
+            allocator_free(call);
+            return NULL;
+        }
+        char *names = (char *)(call->bins + n_bins + 1);
+        for (size_t i = 0; i < n_bins; i++) {
+            call->bins[i] = names + i * AS_BIN_NAME_MAX_SIZE;
+            strncpy(call->bins[i], bins[i], AS_BIN_NAME_MAX_LEN);
+            call->bins[i][AS_BIN_NAME_MAX_LEN] = '\0';
+        }
+        call->bins[n_bins] = NULL;
+    }
+
+    for (int i = 0; i < 2; i++) {
+        call->jobs[i].call = call;
+        call->jobs[i].hedge = i == 1;
+    }
+    call->refs = 1;
+    return call;
+}
+
+// Called with the reader locked.
+static void call_release(hedged_read_call *call)
+{
+    if (--call->refs > 0) {
+        return;
+    }
+    as_key_destroy(&call->key);
+    if (call->rec) {
+        as_record_destroy(call->rec);
+    }
+    allocator_free(call->bins);
+    allocator_free(call);
+}
+
+// Called with the reader locked.
+static void call_submit(hedged_reader *reader, hedged_read_call *call,
+                        bool hedge)
+{
+    hedged_read_job *job = &call->jobs[hedge ? 1 : 0];
+    call->refs++;
+    call->pending++;
+
+    job->next = NULL;
+    if (reader->tail) {
+        reader->tail->next = job;
+    }
+    else {
+        reader->head = job;
+    }
+    reader->tail = job;
+    reader->queued++;
+    pthread_cond_signal(&reader->work_cond);
+}
+
+/*
+ * Records the response to one command of call. The first response decides
+ * the outcome, unless it is a transient error and the other command may
+ * still succeed. Called with the reader locked.
+ */
+static void call_complete(hedged_reader *reader, hedged_read_call *call,
+                          as_error *err, as_record *rec)
+{
+    call->pending--;
+    if (!call->done && (!is_transient(err->code) || call->pending == 0)) {
+        call->done = true;
+        as_error_copy(&call->err, err);
+        call->rec = rec;
+        rec = NULL;
+        pthread_cond_broadcast(&reader->done_cond);
+    }
+    if (rec) {
+        as_record_destroy(rec);
+    }
+    call_release(call);
+}
+
+/*******************************************************************************
+ * WORKERS
+ ******************************************************************************/
+
+// Called with the reader locked.
+static void add_sample(hedged_reader *reader, uint32_t latency_us)
+{
+    if (!reader->percentile_delay ||
+        !latency_window_add(&reader->latencies, latency_us)) {
+        return;
+    }
+
+    uint32_t delay_us = reader->latencies.value;
+    if (delay_us < reader->min_delay_us) {
+        delay_us = reader->min_delay_us;
+    }
+    if (delay_us > reader->max_delay_us) {
+        delay_us = reader->max_delay_us;
+    }
+    reader->delay_us = delay_us;
+}
+
+static void *hedged_read_worker(void *udata)
+{
+    hedged_reader *reader = (hedged_reader *)udata;
+
+    pthread_mutex_lock(&reader->lock);
+    while (true) {
+        while (!reader->head && !reader->stopping) {
+            reader->idle++;
+            pthread_cond_wait(&reader->work_cond, &reader->lock);
+            reader->idle--;
+        }
+        if (reader->stopping) {
+            break;
+        }
+
+        hedged_read_job *job = reader->head;
+        reader->head = job->next;
+        if (!reader->head) {
+            reader->tail = NULL;
+        }
+        reader->queued--;
+
+        hedged_read_call *call = job->call;
+        if (call->done) {
+            // The other command answered while this one was queued.
+            call->pending--;
+            call_release(call);
+            continue;
+        }
+        pthread_mutex_unlock(&reader->lock);
+
+        as_error err;
+        as_error_init(&err);
+        as_record *rec = NULL;
+        uint64_t start = client_now_us();
+        read_record(call->as, &err,
+                    job->hedge ? &call->hedge_policy : &call->policy,
+                    &call->key, (const char **)call->bins, &rec);
+        uint64_t latency_us = client_now_us() - start;
+
+        pthread_mutex_lock(&reader->lock);
+        if (!job->hedge && !is_transient(err.code)) {
+            add_sample(reader, latency_us < UINT32_MAX ? (uint32_t)latency_us
+                                                       : UINT32_MAX);
+        }
+        call_complete(reader, call, &err, rec);
+    }
+    pthread_mutex_unlock(&reader->lock);
+    return NULL;
+}
+
+// Called with the reader locked.
+static void hedged_reader_start(hedged_reader *reader)
+{
+    if (reader->n_threads > 0 || reader->stopping) {
+        return;
+    }
+    for (uint32_t i = 0; i < reader->max_threads; i++) {
+        if (pthread_create(&reader->threads[reader->n_threads], NULL,
+                           hedged_read_worker, reader) == 0) {
+            reader->n_threads++;
+        }
+    }
+}
+
+static void hedged_reader_fork_reset(void *udata)
+{
+    hedged_reader *reader = (hedged_reader *)udata;
+
+    // The workers and the callers of queued reads did not survive the fork.
+    pthread_mutex_init(&reader->lock, NULL);
+    pthread_cond_init(&reader->work_cond, NULL);
+    pthread_cond_init(&reader->done_cond, NULL);
+    reader->head = NULL;
+    reader->tail = NULL;
+    reader->queued = 0;
+    reader->n_threads = 0;
+    reader->idle = 0;
+    reader->stopping = false;
+}
+/*******************************************************************************
+ * CONFIG
+ ******************************************************************************/
+
+static bool config_get_percentile(PyObject *py_config, bool *enabled,
+                                  double *value, as_error *err)
+{
+    PyObject *py_value = PyDict_GetItemString(py_config, "percentile");
+    if (!py_value || py_value == Py_None) {
+        return true;
+    }
+
+    double temp = PyFloat_AsDouble(py_value);
+    if (PyErr_Occurred() || !(temp > 0 && temp < 100)) {
+        PyErr_Clear();
+        as_error_update(err, AEROSPIKE_ERR_PARAM,
+                        "hedged_reads percentile must be between 0 and 100");
+        return false;
+    }
+
+    *enabled = true;
+    *value = temp;
+    return true;
+}
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+hedged_reader *hedged_reader_new(PyObject *py_config, as_error *err)
+{
+    if (!PyDict_Check(py_config)) {
+        as_error_update(err, AEROSPIKE_ERR_PARAM,
+                        "hedged_reads must be a dict");
+        return NULL;
+    }
+
+    hedged_reader *reader = (hedged_reader *)allocator_calloc(
+        ALLOCATOR_CLIENT, 1, sizeof(hedged_reader));
+    if (!reader) {
+        as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                        "Failed to allocate memory for hedged_reads");
+        return NULL;
+    }
+    reader->delay_us = HEDGED_READ_DEFAULT_DELAY_US;
+    reader->min_delay_us = HEDGED_READ_DEFAULT_MIN_DELAY_US;
+    reader->max_delay_us = UINT32_MAX;
+    reader->max_threads = HEDGED_READ_DEFAULT_THREADS;
+    double percentile = 0;
+
+    if (!client_config_get_uint32(py_config, "hedged_reads", "delay", 1,
+                                  UINT32_MAX, &reader->delay_us, err) ||
+        !client_config_get_uint32(py_config, "hedged_reads", "min_delay", 0,
+                                  UINT32_MAX, &reader->min_delay_us, err) ||
+        !client_config_get_uint32(py_config, "hedged_reads", "max_delay", 1,
+                                  UINT32_MAX, &reader->max_delay_us, err) ||
+        !client_config_get_uint32(py_config, "hedged_reads", "threads", 1, 256,
+                                  &reader->max_threads, err) ||
+        !config_get_percentile(py_config, &reader->percentile_delay,
+                               &percentile, err)) {
+        allocator_free(reader);
+        return NULL;
+    }
+
+    if (reader->min_delay_us > reader->max_delay_us) {
+        as_error_update(err, AEROSPIKE_ERR_PARAM,
+                        "hedged_reads min_delay must not exceed max_delay");
+        allocator_free(reader);
+        return NULL;
+    }
+
+    latency_window_init(&reader->latencies, percentile);
+    reader->threads = (pthread_t *)allocator_malloc(
+        ALLOCATOR_CLIENT, sizeof(pthread_t) * reader->max_threads);
+    if (!reader->threads) {
+        as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                        "Failed to allocate memory for hedged_reads");
+        allocator_free(reader);
+        return NULL;
+    }
+    pthread_mutex_init(&reader->lock, NULL);
+    pthread_cond_init(&reader->work_cond, NULL);
+    pthread_cond_init(&reader->done_cond, NULL);
+    reader->pid = getpid();
+    return reader;
+}
+
+void hedged_reader_stop(hedged_reader *reader)
+{
+    client_check_fork(&reader->pid, hedged_reader_fork_reset, reader);
+
+    pthread_mutex_lock(&reader->lock);
+    if (reader->n_threads == 0) {
+        pthread_mutex_unlock(&reader->lock);
+        return;
+    }
+    reader->stopping = true;
+    pthread_cond_broadcast(&reader->work_cond);
+
+    // Queued commands are not sent.
+    while (reader->head) {
+        hedged_read_job *job = reader->head;
+        reader->head = job->next;
+        as_error err;
+        as_error_init(&err);
+        as_error_update(&err, AEROSPIKE_ERR_CLIENT, "Client is closing");
+        call_complete(reader, job->call, &err, NULL);
+    }
+    reader->tail = NULL;
+    reader->queued = 0;
+    uint32_t n_threads = reader->n_threads;
+    pthread_mutex_unlock(&reader->lock);
+
+    for (uint32_t i = 0; i < n_threads; i++) {
+        pthread_join(reader->threads[i], NULL);
+    }
+
+    pthread_mutex_lock(&reader->lock);
+    reader->n_threads = 0;
+    reader->idle = 0;
+    reader->stopping = false;
+    pthread_mutex_unlock(&reader->lock);
+}
+
+void hedged_reader_destroy(hedged_reader *reader)
+{
+    if (!reader) {
+        return;
+    }
+    hedged_reader_stop(reader);
+    pthread_mutex_destroy(&reader->lock);
+    pthread_cond_destroy(&reader->work_cond);
+    pthread_cond_destroy(&reader->done_cond);
+    allocator_free(reader->threads);
+    allocator_free(reader);
+}
+
+bool hedged_read_covers(AerospikeClient *self, as_policy_read *policy,
+                        bool has_filter)
+{
+    if (!self->hedged_reader || has_filter) {
+        return false;
+    }
+    if (!policy) {
+        policy = &self->as->config.policies.read;
+    }
+    // Reads pinned to the master are not sent to replicas.
+    return policy->replica != AS_POLICY_REPLICA_MASTER;
+}
+
+as_status hedged_read(hedged_reader *reader, aerospike *as,
+                      as_policy_read *policy, as_key *key, const char **bins,
+                      as_error *err, as_record **rec)
+{
+    client_check_fork(&reader->pid, hedged_reader_fork_reset, reader);
+
+    pthread_mutex_lock(&reader->lock);
+    hedged_reader_start(reader);
+
+    // With every worker busy, the read is made without a hedge.
+    if (reader->stopping || reader->idle <= reader->queued ||
+        !as_key_digest(key)) {
+        pthread_mutex_unlock(&reader->lock);
+        return read_record(as, err, policy, key, bins, rec);
+    }
+
+    hedged_read_call *call = call_new(as, policy, key, bins);
+    if (!call) {
+        pthread_mutex_unlock(&reader->lock);
+        return read_record(as, err, policy, key, bins, rec);
+    }
+    call_submit(reader, call, false);
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += reader->delay_us / 1000000;
+    deadline.tv_nsec += (long)(reader->delay_us % 1000000) * 1000;
+    deadline.tv_sec += deadline.tv_nsec / 1000000000;
+    deadline.tv_nsec %= 1000000000;
+
+    while (!call->done) {
+        if (pthread_cond_timedwait(&reader->done_cond, &reader->lock,
+                                   &deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+
+    if (!call->done && !reader->stopping && reader->idle > reader->queued) {
+        call_submit(reader, call, true);
+    }
+
+    while (!call->done) {
+        pthread_cond_wait(&reader->done_cond, &reader->lock);
+    }
+
+    as_error_copy(err, &call->err);
+    *rec = call->rec;
+    call->rec = NULL;
+    call_release(call);
+    pthread_mutex_unlock(&reader->lock);
+    return err->code;
+}
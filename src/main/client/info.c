@@ -29,6 +29,7 @@
 #include "policy.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "interpreter.h"
 #include <arpa/inet.h>
 
 #include "tls_info_host.h"
@@ -37,6 +38,7 @@ typedef struct foreach_callback_info_udata_t {
     PyObject *udata_p;
     PyObject *host_lookup_p;
     as_error error;
+    AerospikeClient *client;
 } foreach_callback_info_udata;
 
 static PyObject *AerospikeClient_InfoAll_Invoke(AerospikeClient *self,
@@ -73,7 +75,8 @@ static bool AerospikeClient_InfoAll_each(as_error *err, const as_node *node,
         (foreach_callback_info_udata *)udata;
 
     // Need to make sure we have the GIL since we're back in python land now
-    PyGILState_STATE gil_state = PyGILState_Ensure();
+    Aerospike_GIL_State gil_state =
+        Aerospike_GIL_Ensure(udata_ptr->client->interp);
 
     if (err && err->code != AEROSPIKE_OK) {
         as_error_update(err, err->code, NULL);
@@ -99,25 +102,17 @@ static bool AerospikeClient_InfoAll_each(as_error *err, const as_node *node,
 
 CLEANUP:
     if (udata_ptr->error.code != AEROSPIKE_OK) {
-        PyObject *py_err = NULL;
-        error_to_pyobject(&udata_ptr->error, &py_err);
-        PyObject *exception_type = raise_exception_old(&udata_ptr->error);
-        PyErr_SetObject(exception_type, py_err);
-        Py_DECREF(py_err);
-        PyGILState_Release(gil_state);
+        raise_exception(&udata_ptr->error);
+        Aerospike_GIL_Release(&gil_state);
         return false;
     }
     if (err->code != AEROSPIKE_OK) {
-        PyObject *py_err = NULL;
-        error_to_pyobject(err, &py_err);
-        PyObject *exception_type = raise_exception_old(err);
-        PyErr_SetObject(exception_type, py_err);
-        Py_DECREF(py_err);
-        PyGILState_Release(gil_state);
+        raise_exception(err);
+        Aerospike_GIL_Release(&gil_state);
         return false;
     }
 
-    PyGILState_Release(gil_state);
+    Aerospike_GIL_Release(&gil_state);
     return true;
 }
 
@@ -167,6 +162,7 @@ static PyObject *AerospikeClient_InfoAll_Invoke(AerospikeClient *self,
     py_nodes = PyDict_New();
     info_callback_udata.udata_p = py_nodes;
     info_callback_udata.host_lookup_p = NULL;
+    info_callback_udata.client = self;
     as_error_init(&info_callback_udata.error);
 
     if (!self || !self->as) {
@@ -212,12 +208,7 @@ CLEANUP:
         Py_DECREF(py_ustr);
     }
     if (info_callback_udata.error.code != AEROSPIKE_OK) {
-        PyObject *py_err = NULL;
-        error_to_pyobject(&info_callback_udata.error, &py_err);
-        PyObject *exception_type =
-            raise_exception_old(&info_callback_udata.error);
-        PyErr_SetObject(exception_type, py_err);
-        Py_DECREF(py_err);
+        raise_exception(&info_callback_udata.error);
         if (py_nodes) {
             Py_DECREF(py_nodes);
         }
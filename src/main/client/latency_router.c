@@ -0,0 +1,431 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <aerospike/aerospike.h>
+#include <aerospike/aerospike_info.h>
+#include <aerospike/as_cluster.h>
+#include <aerospike/as_error.h>
+#include <aerospike/as_node.h>
+#include <aerospike/as_policy.h>
+
+#include "allocator.h"
+#include "client.h"
+#include "client_utils.h"
+#include "latency_router.h"
+
+#define LATENCY_ROUTER_DEFAULT_INTERVAL_MS 1000
+#define LATENCY_ROUTER_DEFAULT_TIMEOUT_MS 1000
+#define LATENCY_ROUTER_DEFAULT_ALPHA 0.2
+#define LATENCY_ROUTER_DEFAULT_MAX_ERROR_RATE 0.5
+// Racks a node may be in, one per namespace.
+#define LATENCY_ROUTER_MAX_NODE_RACKS 32
+
+typedef struct {
+    char name[AS_NODE_NAME_SIZE];
+    // Exponentially weighted averages of the probes of the node.
+    double latency_us;
+    double error_rate;
+    bool measured;
+    bool seen;
+    int racks[LATENCY_ROUTER_MAX_NODE_RACKS];
+    uint32_t n_racks;
+} latency_node;
+
+struct latency_router_s {
+    pthread_mutex_t lock;
+    // Signaled to stop the thread.
+    pthread_cond_t cond;
+    pthread_t thread;
+    bool running;
+    bool stopping;
+    aerospike *as;
+    uint32_t interval_ms;
+    uint32_t timeout_ms;
+    double alpha;
+    double max_error_rate;
+    latency_node *nodes;
+    uint32_t n_nodes;
+    uint32_t capacity;
+    // The thread inherited across fork() does not exist in the child.
+    pid_t pid;
+};
+
+/*******************************************************************************
+ * MEASUREMENT
+ ******************************************************************************/
+
+// Called with the router locked. NULL if a new node cannot be added.
+static latency_node *find_node(latency_router *router, const char *name)
+{
+    for (uint32_t i = 0; i < router->n_nodes; i++) {
+        if (strcmp(router->nodes[i].name, name) == 0) {
+            return &router->nodes[i];
+        }
+    }
+
+    if (router->n_nodes == router->capacity) {
+        uint32_t capacity = router->capacity ? router->capacity * 2 : 8;
+        latency_node *nodes = (latency_node *)allocator_realloc(
+            ALLOCATOR_CLIENT, router->nodes, sizeof(latency_node) * capacity);
+        if (!nodes) {
+            return NULL;
+        }
+        router->nodes = nodes;
+        router->capacity = capacity;
+    }
+    latency_node *node = &router->nodes[router->n_nodes++];
+    memset(node, 0, sizeof(latency_node));
+    strncpy(node->name, name, AS_NODE_NAME_SIZE - 1);
+    return node;
+}
+
+/*
+ * Parses the response to the "rack-ids" info command, "<ns>:<rack>;..."
+ * after the echoed command.
+ */
+static void parse_racks(latency_node *node, const char *response)
+{
+    const char *p = strchr(response, '\t');
+    if (!p) {
+        return;
+    }
+
+    node->n_racks = 0;
+    while ((p = strchr(p, ':')) != NULL) {
+        char *end = NULL;
+        long rack = strtol(p + 1, &end, 10);
+        p = end;
+        if (end == NULL || (*end != ';' && *end != '\n' && *end != '\0')) {
+            continue;
+        }
+
+        bool known = false;
+        for (uint32_t i = 0; i < node->n_racks; i++) {
+            known = known || node->racks[i] == (int)rack;
+        }
+        if (!known && node->n_racks < LATENCY_ROUTER_MAX_NODE_RACKS) {
+            node->racks[node->n_racks++] = (int)rack;
+        }
+    }
+}
+
+// Called with the router locked.
+static void record_probe(latency_router *router, const char *name,
+                         bool ok, uint64_t latency_us, const char *response)
+{
+    latency_node *node = find_node(router, name);
+    double alpha = router->alpha;
+
+    // Without memory for a new node its probes are dropped.
+    if (!node) {
+        return;
+    }
+
+    node->seen = true;
+    node->error_rate = (1 - alpha) * node->error_rate + (ok ? 0 : alpha);
+    if (!ok) {
+        return;
+    }
+
+    if (node->measured) {
+        node->latency_us =
+            (1 - alpha) * node->latency_us + alpha * (double)latency_us;
+    }
+    else {
+        node->latency_us = (double)latency_us;
+        node->measured = true;
+    }
+    if (response) {
+        parse_racks(node, response);
+    }
+}
+
+static void probe_nodes(latency_router *router)
+{
+    as_cluster *cluster = router->as->cluster;
+    as_nodes *nodes = as_nodes_reserve(cluster);
+
+    as_policy_info policy;
+    as_policy_info_init(&policy);
+    policy.timeout = router->timeout_ms;
+
+    for (uint32_t i = 0; i < nodes->size; i++) {
+        as_node *node = nodes->array[i];
+        as_error err;
+        as_error_init(&err);
+        char *response = NULL;
+
+        uint64_t start = client_now_us();
+        aerospike_info_node(router->as, &err, &policy, node, "rack-ids",
+                            &response);
+        uint64_t latency_us = client_now_us() - start;
+
+        pthread_mutex_lock(&router->lock);
+        record_probe(router, node->name, err.code == AEROSPIKE_OK,
+                     latency_us, response);
+        pthread_mutex_unlock(&router->lock);
+
+        if (response) {
+            cf_free(response);
+        }
+    }
+    as_nodes_release(nodes);
+
+    pthread_mutex_lock(&router->lock);
+    // Forget nodes which left the cluster.
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < router->n_nodes; i++) {
+        if (router->nodes[i].seen) {
+            router->nodes[i].seen = false;
+            router->nodes[kept++] = router->nodes[i];
+        }
+    }
+    router->n_nodes = kept;
+    pthread_mutex_unlock(&router->lock);
+}
+
+static void *latency_router_run(void *udata)
+{
+    latency_router *router = (latency_router *)udata;
+
+    pthread_mutex_lock(&router->lock);
+    while (!router->stopping) {
+        pthread_mutex_unlock(&router->lock);
+        probe_nodes(router);
+        pthread_mutex_lock(&router->lock);
+
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += router->interval_ms / 1000;
+        deadline.tv_nsec += (long)(router->interval_ms % 1000) * 1000000;
+        deadline.tv_sec += deadline.tv_nsec / 1000000000;
+        deadline.tv_nsec %= 1000000000;
+
+        while (!router->stopping &&
+               pthread_cond_timedwait(&router->cond, &router->lock,
+                                      &deadline) != ETIMEDOUT) {
+        }
+    }
+    pthread_mutex_unlock(&router->lock);
+    return NULL;
+}
+
+static void latency_router_fork_reset(void *udata)
+{
+    latency_router *router = (latency_router *)udata;
+
+    pthread_mutex_init(&router->lock, NULL);
+    pthread_cond_init(&router->cond, NULL);
+    router->running = false;
+    router->stopping = false;
+}
+/*******************************************************************************
+ * CONFIG
+ ******************************************************************************/
+
+static bool config_get_fraction(PyObject *py_config, const char *name,
+                                double *value, as_error *err)
+{
+    PyObject *py_value = PyDict_GetItemString(py_config, name);
+    if (!py_value) {
+        return true;
+    }
+
+    double temp = PyFloat_AsDouble(py_value);
+    if (PyErr_Occurred() || !(temp > 0 && temp <= 1)) {
+        PyErr_Clear();
+        as_error_update(err, AEROSPIKE_ERR_PARAM,
+                        "latency_probes %s must be greater than 0 and at "
+                        "most 1",
+                        name);
+        return false;
+    }
+
+    *value = temp;
+    return true;
+}
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+latency_router *latency_router_new(PyObject *py_config, as_error *err)
+{
+    if (!PyDict_Check(py_config)) {
+        as_error_update(err, AEROSPIKE_ERR_PARAM,
+                        "latency_probes must be a dict");
+        return NULL;
+    }
+
+    latency_router *router = (latency_router *)allocator_calloc(
+        ALLOCATOR_CLIENT, 1, sizeof(latency_router));
+    if (!router) {
+        as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                        "Failed to allocate memory for latency_probes");
+        return NULL;
+    }
+    router->interval_ms = LATENCY_ROUTER_DEFAULT_INTERVAL_MS;
+    router->timeout_ms = LATENCY_ROUTER_DEFAULT_TIMEOUT_MS;
+    router->alpha = LATENCY_ROUTER_DEFAULT_ALPHA;
+    router->max_error_rate = LATENCY_ROUTER_DEFAULT_MAX_ERROR_RATE;
+
+    if (!client_config_get_uint32(py_config, "latency_probes", "interval", 10,
+                                  3600000, &router->interval_ms, err) ||
+        !client_config_get_uint32(py_config, "latency_probes", "timeout", 1,
+                                  3600000, &router->timeout_ms, err) ||
+        !config_get_fraction(py_config, "alpha", &router->alpha, err) ||
+        !config_get_fraction(py_config, "max_error_rate",
+                             &router->max_error_rate, err)) {
+        allocator_free(router);
+        return NULL;
+    }
+
+    pthread_mutex_init(&router->lock, NULL);
+    pthread_cond_init(&router->cond, NULL);
+    router->pid = getpid();
+    return router;
+}
+
+void latency_router_start(AerospikeClient *self)
+{
+    latency_router *router = self->latency_router;
+    if (!router || !self->as->cluster) {
+        return;
+    }
+
+    client_check_fork(&router->pid, latency_router_fork_reset, router);
+
+    pthread_mutex_lock(&router->lock);
+    if (!router->running) {
+        router->as = self->as;
+        router->n_nodes = 0;
+        router->running = pthread_create(&router->thread, NULL,
+                                         latency_router_run, router) == 0;
+    }
+    pthread_mutex_unlock(&router->lock);
+}
+
+void latency_router_stop(latency_router *router)
+{
+    client_check_fork(&router->pid, latency_router_fork_reset, router);
+
+    pthread_mutex_lock(&router->lock);
+    if (!router->running) {
+        pthread_mutex_unlock(&router->lock);
+        return;
+    }
+    router->stopping = true;
+    pthread_cond_signal(&router->cond);
+    pthread_mutex_unlock(&router->lock);
+
+    pthread_join(router->thread, NULL);
+
+    pthread_mutex_lock(&router->lock);
+    router->running = false;
+    router->stopping = false;
+    pthread_mutex_unlock(&router->lock);
+}
+
+void latency_router_destroy(latency_router *router)
+{
+    if (!router) {
+        return;
+    }
+    latency_router_stop(router);
+    pthread_mutex_destroy(&router->lock);
+    pthread_cond_destroy(&router->cond);
+    allocator_free(router->nodes);
+    allocator_free(router);
+}
+
+/**
+ *******************************************************************************************************
+ * Returns the measured latency and error rate of each node, whether it is
+ * healthy, and the racks it is in.
+ *
+ * @param self                  AerospikeClient object
+ *
+ * Returns a dict keyed by node name, or None if latency probes are not
+ * enabled.
+ *******************************************************************************************************
+ */
+PyObject *AerospikeClient_Get_Node_Latencies(AerospikeClient *self,
+                                             PyObject *args)
+{
+    latency_router *router = self->latency_router;
+    if (!router) {
+        Py_RETURN_NONE;
+    }
+
+    PyObject *py_nodes = PyDict_New();
+    if (!py_nodes) {
+        return NULL;
+    }
+
+    client_check_fork(&router->pid, latency_router_fork_reset, router);
+
+    pthread_mutex_lock(&router->lock);
+    for (uint32_t i = 0; i < router->n_nodes; i++) {
+        latency_node *node = &router->nodes[i];
+
+        PyObject *py_racks = PyList_New(node->n_racks);
+        for (uint32_t j = 0; py_racks && j < node->n_racks; j++) {
+            PyList_SET_ITEM(py_racks, j, PyLong_FromLong(node->racks[j]));
+        }
+
+        PyObject *py_latency = Py_None;
+        if (node->measured) {
+            py_latency = PyFloat_FromDouble(node->latency_us / 1000);
+        }
+        else {
+            Py_INCREF(Py_None);
+        }
+
+        bool healthy =
+            node->measured && node->error_rate <= router->max_error_rate;
+
+        PyObject *py_node = NULL;
+        if (py_racks && py_latency) {
+            py_node = Py_BuildValue("{s:N,s:d,s:O,s:N}", "latency", py_latency,
+                                    "error_rate", node->error_rate, "healthy",
+                                    healthy ? Py_True : Py_False, "racks",
+                                    py_racks);
+        }
+        else {
+            Py_XDECREF(py_latency);
+            Py_XDECREF(py_racks);
+        }
+        if (!py_node ||
+            PyDict_SetItemString(py_nodes, node->name, py_node) == -1) {
+            Py_XDECREF(py_node);
+            Py_CLEAR(py_nodes);
+            break;
+        }
+        Py_DECREF(py_node);
+    }
+    pthread_mutex_unlock(&router->lock);
+
+    return py_nodes;
+}
@@ -25,9 +25,13 @@
 #include <aerospike/as_operations.h>
 #include <aerospike/as_map_operations.h>
 #include <aerospike/aerospike_info.h>
+#include "adaptive_policy.h"
+#include "allocator.h"
 #include "client.h"
+#include "command_limits.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "fastcall.h"
 #include "policy.h"
 #include "serializer.h"
 #include "geo.h"
@@ -36,6 +40,7 @@
 #include "bit_operations.h"
 #include "hll_operations.h"
 #include "expression_operations.h"
+#include "read_cache.h"
 
 #include <aerospike/as_double.h>
 #include <aerospike/as_integer.h>
@@ -76,17 +81,7 @@ static inline bool isExprOp(int op);
 
 #define EXCEPTION_ON_ERROR()                                                   \
     if (err.code != AEROSPIKE_OK) {                                            \
-        PyObject *py_err = NULL;                                               \
-        error_to_pyobject(&err, &py_err);                                      \
-        PyObject *exception_type = raise_exception_old(&err);                  \
-        if (PyObject_HasAttrString(exception_type, "key")) {                   \
-            PyObject_SetAttrString(exception_type, "key", py_key);             \
-        }                                                                      \
-        if (PyObject_HasAttrString(exception_type, "bin")) {                   \
-            PyObject_SetAttrString(exception_type, "bin", py_bin);             \
-        }                                                                      \
-        PyErr_SetObject(exception_type, py_err);                               \
-        Py_DECREF(py_err);                                                     \
+        raise_exception_base(&err, py_key, py_bin, NULL, NULL, NULL);          \
         return NULL;                                                           \
     }
 
@@ -436,9 +431,15 @@ as_status add_op(AerospikeClient *self, as_error *err, PyObject *py_val,
     if (py_bin) {
         if (PyUnicode_Check(py_bin)) {
             py_ustr = PyUnicode_AsUTF8String(py_bin);
-            bin = strdup(PyBytes_AsString(py_ustr));
-            as_vector_append(unicodeStrVector, &bin);
+            bin = allocator_strdup(ALLOCATOR_OPERATIONS,
+                                   PyBytes_AsString(py_ustr));
             Py_DECREF(py_ustr);
+            if (!bin) {
+                as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                                "Failed to allocate memory for bin");
+                goto CLEANUP;
+            }
+            as_vector_append(unicodeStrVector, &bin);
         }
         else if (PyUnicode_Check(py_bin)) {
             bin = (char *)PyUnicode_AsUTF8(py_bin);
@@ -541,18 +542,24 @@ as_status add_op(AerospikeClient *self, as_error *err, PyObject *py_val,
     case AS_OPERATOR_APPEND:
         if (PyUnicode_Check(py_value)) {
             py_ustr1 = PyUnicode_AsUTF8String(py_value);
-            val = strdup(PyBytes_AsString(py_ustr1));
+            val = allocator_strdup(ALLOCATOR_OPERATIONS,
+                                   PyBytes_AsString(py_ustr1));
+            Py_DECREF(py_ustr1);
+            if (!val) {
+                as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                                "Failed to allocate memory for value");
+                goto CLEANUP;
+            }
             as_operations_add_append_str(ops, bin, val);
             as_vector_append(unicodeStrVector, &val);
-            Py_DECREF(py_ustr1);
         }
         else if (PyByteArray_Check(py_value) || PyBytes_Check(py_value)) {
             as_bytes *bytes;
             GET_BYTES_POOL(bytes, static_pool, err);
             if (err->code == AEROSPIKE_OK) {
                 if (serialize_based_on_serializer_policy(
-                        self, SERIALIZER_PYTHON, &bytes, py_value, err) !=
-                    AEROSPIKE_OK) {
+                        self, SERIALIZER_PYTHON, &bytes, py_value, NULL,
+                        err) != AEROSPIKE_OK) {
                     goto CLEANUP;
                 }
                 as_operations_add_append_rawp(ops, bin, bytes->value,
@@ -574,18 +581,24 @@ as_status add_op(AerospikeClient *self, as_error *err, PyObject *py_val,
     case AS_OPERATOR_PREPEND:
         if (PyUnicode_Check(py_value)) {
             py_ustr1 = PyUnicode_AsUTF8String(py_value);
-            val = strdup(PyBytes_AsString(py_ustr1));
+            val = allocator_strdup(ALLOCATOR_OPERATIONS,
+                                   PyBytes_AsString(py_ustr1));
+            Py_DECREF(py_ustr1);
+            if (!val) {
+                as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                                "Failed to allocate memory for value");
+                goto CLEANUP;
+            }
             as_operations_add_prepend_str(ops, bin, val);
             as_vector_append(unicodeStrVector, &val);
-            Py_DECREF(py_ustr1);
         }
         else if (PyByteArray_Check(py_value) || PyBytes_Check(py_value)) {
             as_bytes *bytes;
             GET_BYTES_POOL(bytes, static_pool, err);
             if (err->code == AEROSPIKE_OK) {
                 if (serialize_based_on_serializer_policy(
-                        self, SERIALIZER_PYTHON, &bytes, py_value, err) !=
-                    AEROSPIKE_OK) {
+                        self, SERIALIZER_PYTHON, &bytes, py_value, NULL,
+                        err) != AEROSPIKE_OK) {
                     goto CLEANUP;
                 }
                 as_operations_add_prepend_rawp(ops, bin, bytes->value,
@@ -875,9 +888,29 @@ static PyObject *AerospikeClient_Operate_Invoke(AerospikeClient *self,
         goto CLEANUP;
     }
 
+    command_permit permit;
+    if (!command_limits_acquire(self, COMMAND_LIMIT_WRITE, py_policy, key, 1,
+                                &permit, err)) {
+        goto CLEANUP;
+    }
+    uint64_t start = 0;
+    if (self->adaptive_policy) {
+        // Adaptive timeouts adjust a copy of the default policy.
+        if (!operate_policy_p) {
+            as_policy_operate_copy(&self->as->config.policies.operate,
+                                   &operate_policy);
+            operate_policy_p = &operate_policy;
+        }
+        start = adaptive_policy_begin(self, &operate_policy_p->base, false);
+    }
     Py_BEGIN_ALLOW_THREADS
     aerospike_key_operate(self->as, err, operate_policy_p, key, &ops, &rec);
     Py_END_ALLOW_THREADS
+    command_limits_release(self, &permit);
+    adaptive_policy_end(self, start, false, err);
+    if (self->read_cache) {
+        read_cache_invalidate(self->read_cache, key);
+    }
 
     if (err->code != AEROSPIKE_OK) {
         as_error_update(err, err->code, NULL);
@@ -892,7 +925,7 @@ static PyObject *AerospikeClient_Operate_Invoke(AerospikeClient *self,
 
 CLEANUP:
     for (unsigned int i = 0; i < unicodeStrVector->size; i++) {
-        free(as_vector_get_ptr(unicodeStrVector, i));
+        allocator_free(as_vector_get_ptr(unicodeStrVector, i));
     }
 
     if (exp_list_p) {
@@ -936,24 +969,24 @@ CLEANUP:
  * Otherwise returns 0 on success for other operations.
  *******************************************************************************************************
  */
-PyObject *AerospikeClient_Operate(AerospikeClient *self, PyObject *args,
-                                  PyObject *kwds)
+PyObject *AerospikeClient_Operate(AerospikeClient *self, PyObject *const *args,
+                                  Py_ssize_t nargs, PyObject *kwnames)
 {
     BASE_VARIABLES
     PyObject *py_list = NULL;
     PyObject *py_bin = NULL;
 
     // Python Function Keyword Arguments
-    static char *kwlist[] = {"key", "list", "meta", "policy", NULL};
-    if (PyArg_ParseTupleAndKeywords(args, kwds, "OO|OO:operate", kwlist,
-                                    &py_key, &py_list, &py_meta,
-                                    &py_policy) == false) {
+    static const char *kwlist[] = {"key", "list", "meta", "policy", NULL};
+    static fastcall_parser parser = {"operate", kwlist, 2};
+    if (fastcall_parse(&parser, self->state, args, nargs, kwnames, &py_key,
+                       &py_list, &py_meta, &py_policy) == false) {
         return NULL;
     }
 
     CHECK_CONNECTED(&err);
 
-    if (pyobject_to_key(&err, py_key, &key) != AEROSPIKE_OK) {
+    if (pyobject_to_key(self, &err, py_key, &key) != AEROSPIKE_OK) {
         goto CLEANUP;
     }
 
@@ -1057,9 +1090,29 @@ AerospikeClient_OperateOrdered_Invoke(AerospikeClient *self, as_error *err,
         goto CLEANUP;
     }
 
+    command_permit permit;
+    if (!command_limits_acquire(self, COMMAND_LIMIT_WRITE, py_policy, key, 1,
+                                &permit, err)) {
+        goto CLEANUP;
+    }
+    uint64_t start = 0;
+    if (self->adaptive_policy) {
+        // Adaptive timeouts adjust a copy of the default policy.
+        if (!operate_policy_p) {
+            as_policy_operate_copy(&self->as->config.policies.operate,
+                                   &operate_policy);
+            operate_policy_p = &operate_policy;
+        }
+        start = adaptive_policy_begin(self, &operate_policy_p->base, false);
+    }
     Py_BEGIN_ALLOW_THREADS
     aerospike_key_operate(self->as, err, operate_policy_p, key, &ops, &rec);
     Py_END_ALLOW_THREADS
+    command_limits_release(self, &permit);
+    adaptive_policy_end(self, start, false, err);
+    if (self->read_cache) {
+        read_cache_invalidate(self->read_cache, key);
+    }
 
     if (err->code != AEROSPIKE_OK) {
         as_error_update(err, err->code, NULL);
@@ -1069,7 +1122,7 @@ AerospikeClient_OperateOrdered_Invoke(AerospikeClient *self, as_error *err,
     operation_succeeded = true;
     if (rec) {
         /* Build the return tuple: (key, meta, bins) */
-        key_to_pyobject(err, key, &py_return_key);
+        key_to_pyobject(self, err, key, &py_return_key);
         if (err->code != AEROSPIKE_OK || !py_return_key) {
             goto CLEANUP;
         }
@@ -1106,7 +1159,7 @@ AerospikeClient_OperateOrdered_Invoke(AerospikeClient *self, as_error *err,
 
 CLEANUP:
     for (unsigned int i = 0; i < unicodeStrVector->size; i++) {
-        free(as_vector_get_ptr(unicodeStrVector, i));
+        allocator_free(as_vector_get_ptr(unicodeStrVector, i));
     }
 
     as_vector_destroy(unicodeStrVector);
@@ -1179,7 +1232,7 @@ PyObject *AerospikeClient_OperateOrdered(AerospikeClient *self, PyObject *args,
 
     CHECK_CONNECTED(&err);
 
-    if (pyobject_to_key(&err, py_key, &key) != AEROSPIKE_OK) {
+    if (pyobject_to_key(self, &err, py_key, &key) != AEROSPIKE_OK) {
         goto CLEANUP;
     }
 
@@ -1195,14 +1248,7 @@ PyObject *AerospikeClient_OperateOrdered(AerospikeClient *self, PyObject *args,
 
 CLEANUP:
     if (err.code != AEROSPIKE_OK) {
-        PyObject *py_err = NULL;
-        error_to_pyobject(&err, &py_err);
-        PyObject *exception_type = raise_exception_old(&err);
-        if (PyObject_HasAttrString(exception_type, "key")) {
-            PyObject_SetAttrString(exception_type, "key", py_key);
-        }
-        PyErr_SetObject(exception_type, py_err);
-        Py_DECREF(py_err);
+        raise_exception_base(&err, py_key, NULL, NULL, NULL, NULL);
         return NULL;
     }
     return py_result;
@@ -1238,7 +1284,7 @@ PyObject *AerospikeClient_Append(AerospikeClient *self, PyObject *args,
 
     CHECK_CONNECTED(&err);
 
-    if (pyobject_to_key(&err, py_key, &key) != AEROSPIKE_OK) {
+    if (pyobject_to_key(self, &err, py_key, &key) != AEROSPIKE_OK) {
         goto CLEANUP;
     }
 
@@ -1285,7 +1331,7 @@ PyObject *AerospikeClient_Prepend(AerospikeClient *self, PyObject *args,
 
     CHECK_CONNECTED(&err);
 
-    if (pyobject_to_key(&err, py_key, &key) != AEROSPIKE_OK) {
+    if (pyobject_to_key(self, &err, py_key, &key) != AEROSPIKE_OK) {
         goto CLEANUP;
     }
 
@@ -1316,24 +1362,27 @@ CLEANUP:
  * In case of error,appropriate exceptions will be raised.
  *******************************************************************************************************
  */
-PyObject *AerospikeClient_Increment(AerospikeClient *self, PyObject *args,
-                                    PyObject *kwds)
+PyObject *AerospikeClient_Increment(AerospikeClient *self,
+                                    PyObject *const *args, Py_ssize_t nargs,
+                                    PyObject *kwnames)
 {
     BASE_VARIABLES
     PyObject *py_bin = NULL;
     PyObject *py_offset_value = 0;
 
     // Python Function Keyword Arguments
-    static char *kwlist[] = {"key", "bin", "offset", "meta", "policy", NULL};
-    if (PyArg_ParseTupleAndKeywords(args, kwds, "OOO|OO:increment", kwlist,
-                                    &py_key, &py_bin, &py_offset_value,
-                                    &py_meta, &py_policy) == false) {
+    static const char *kwlist[] = {"key", "bin", "offset", "meta", "policy",
+                                   NULL};
+    static fastcall_parser parser = {"increment", kwlist, 3};
+    if (fastcall_parse(&parser, self->state, args, nargs, kwnames, &py_key,
+                       &py_bin, &py_offset_value, &py_meta,
+                       &py_policy) == false) {
         return NULL;
     }
 
     CHECK_CONNECTED(&err);
 
-    if (pyobject_to_key(&err, py_key, &key) != AEROSPIKE_OK) {
+    if (pyobject_to_key(self, &err, py_key, &key) != AEROSPIKE_OK) {
         goto CLEANUP;
     }
 
@@ -1380,7 +1429,7 @@ PyObject *AerospikeClient_Touch(AerospikeClient *self, PyObject *args,
 
     CHECK_CONNECTED(&err);
 
-    if (pyobject_to_key(&err, py_key, &key) != AEROSPIKE_OK) {
+    if (pyobject_to_key(self, &err, py_key, &key) != AEROSPIKE_OK) {
         goto CLEANUP;
     }
 
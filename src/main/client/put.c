@@ -22,10 +22,16 @@
 #include <aerospike/as_error.h>
 #include <aerospike/as_record.h>
 
+#include "adaptive_policy.h"
+#include "auto_batch.h"
 #include "client.h"
+#include "command_limits.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "fastcall.h"
 #include "policy.h"
+#include "serializer.h"
+#include "read_cache.h"
 
 /**
  *******************************************************************************************************
@@ -68,6 +74,7 @@ PyObject *AerospikeClient_Put_Invoke(AerospikeClient *self, PyObject *py_key,
 
     as_static_pool static_pool;
     memset(&static_pool, 0, sizeof(static_pool));
+    POOL_HOLD_BUFFERS(&static_pool);
 
     // Initialize error
     as_error_init(&err);
@@ -84,7 +91,7 @@ PyObject *AerospikeClient_Put_Invoke(AerospikeClient *self, PyObject *py_key,
     }
 
     // Convert python key object to as_key
-    pyobject_to_key(&err, py_key, &key);
+    pyobject_to_key(self, &err, py_key, &key);
     if (err.code != AEROSPIKE_OK) {
         goto CLEANUP;
     }
@@ -92,8 +99,10 @@ PyObject *AerospikeClient_Put_Invoke(AerospikeClient *self, PyObject *py_key,
     key_initialised = true;
 
     // Convert python bins and metadata objects to as_record
+    deferred_values deferred = {0};
     pyobject_to_record(self, &err, py_bins, py_meta, &rec, serializer_option,
-                       &static_pool);
+                       &static_pool, &deferred);
+    deferred_values_serialize(&deferred, &rec, &static_pool, &err);
     if (err.code != AEROSPIKE_OK) {
         goto CLEANUP;
     }
@@ -108,9 +117,27 @@ PyObject *AerospikeClient_Put_Invoke(AerospikeClient *self, PyObject *py_key,
     }
 
     // Invoke operation
-    Py_BEGIN_ALLOW_THREADS
-    aerospike_key_put(self->as, &err, write_policy_p, &key, &rec);
-    Py_END_ALLOW_THREADS
+    command_permit permit;
+    if (!command_limits_acquire(self, COMMAND_LIMIT_WRITE, py_policy, &key, 1,
+                                &permit, &err)) {
+        goto CLEANUP;
+    }
+    uint64_t start =
+        adaptive_policy_begin(self, &write_policy_p->base, false);
+    if (!exp_list_p && auto_batch_covers_put(self, py_policy, &key, &rec)) {
+        auto_batch_put(self, &key, &rec, &err);
+    }
+    else {
+        Py_BEGIN_ALLOW_THREADS
+        aerospike_key_put(self->as, &err, write_policy_p, &key, &rec);
+        Py_END_ALLOW_THREADS
+    }
+    command_limits_release(self, &permit);
+    adaptive_policy_end(self, start, false, &err);
+    // The record may have changed whatever the outcome of the write.
+    if (self->read_cache) {
+        read_cache_invalidate(self->read_cache, &key);
+    }
     if (err.code != AEROSPIKE_OK) {
         as_error_update(&err, err.code, NULL);
     }
@@ -133,17 +160,7 @@ CLEANUP:
 
     // If an error occurred, tell Python.
     if (err.code != AEROSPIKE_OK) {
-        PyObject *py_err = NULL;
-        error_to_pyobject(&err, &py_err);
-        PyObject *exception_type = raise_exception_old(&err);
-        if (PyObject_HasAttrString(exception_type, "key")) {
-            PyObject_SetAttrString(exception_type, "key", py_key);
-        }
-        if (PyObject_HasAttrString(exception_type, "bin")) {
-            PyObject_SetAttrString(exception_type, "bin", py_bins);
-        }
-        PyErr_SetObject(exception_type, py_err);
-        Py_DECREF(py_err);
+        raise_exception_base(&err, py_key, py_bins, NULL, NULL, NULL);
         return NULL;
     }
 
@@ -163,8 +180,8 @@ CLEANUP:
  * In case of error,appropriate exceptions will be raised.
  *******************************************************************************************************
  */
-PyObject *AerospikeClient_Put(AerospikeClient *self, PyObject *args,
-                              PyObject *kwds)
+PyObject *AerospikeClient_Put(AerospikeClient *self, PyObject *const *args,
+                              Py_ssize_t nargs, PyObject *kwnames)
 {
     // Python Function Arguments
     PyObject *py_key = NULL;
@@ -175,24 +192,25 @@ PyObject *AerospikeClient_Put(AerospikeClient *self, PyObject *args,
     long serializer_option = SERIALIZER_NONE;
 
     // Python Function Keyword Arguments
-    static char *kwlist[] = {"key",    "bins",       "meta",
-                             "policy", "serializer", NULL};
+    static const char *kwlist[] = {"key", "bins", "meta", "policy",
+                                   "serializer", NULL};
+    static fastcall_parser parser = {"put", kwlist, 2};
 
     // Python Function Argument Parsing
-    if (PyArg_ParseTupleAndKeywords(args, kwds, "OO|OOO:put", kwlist, &py_key,
-                                    &py_bins, &py_meta, &py_policy,
-                                    &py_serializer_option) == false) {
+    if (fastcall_parse(&parser, self->state, args, nargs, kwnames, &py_key,
+                       &py_bins, &py_meta, &py_policy,
+                       &py_serializer_option) == false) {
         return NULL;
     }
 
     if (py_serializer_option) {
         if (PyLong_Check(py_serializer_option)) {
-            self->is_client_put_serializer = true;
+            set_client_put_serializer(true);
             serializer_option = PyLong_AsLong(py_serializer_option);
         }
     }
     else {
-        self->is_client_put_serializer = false;
+        set_client_put_serializer(false);
     }
     // Invoke Operation
     return AerospikeClient_Put_Invoke(self, py_key, py_bins, py_meta, py_policy,
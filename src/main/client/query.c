@@ -22,6 +22,7 @@
 #include "conversions.h"
 #include "exceptions.h"
 #include "policy.h"
+#include "serializer.h"
 
 #include <aerospike/aerospike_query.h>
 #include <aerospike/as_job.h>
@@ -299,7 +300,7 @@ static PyObject *AerospikeClient_QueryApply_Invoke(
         goto CLEANUP;
     }
 
-    self->is_client_put_serializer = false;
+    set_client_put_serializer(false);
 
     if (!(namespace_p) || !(py_set) || !(py_predicate) || !(py_module) ||
         !(py_function)) {
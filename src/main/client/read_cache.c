@@ -0,0 +1,713 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <citrusleaf/cf_clock.h>
+#include <aerospike/aerospike_key.h>
+#include <aerospike/as_error.h>
+#include <aerospike/as_geojson.h>
+#include <aerospike/as_key.h>
+#include <aerospike/as_list.h>
+#include <aerospike/as_map.h>
+#include <aerospike/as_record.h>
+
+#include "allocator.h"
+#include "client.h"
+#include "client_utils.h"
+#include "conversions.h"
+#include "exceptions.h"
+#include "macros.h"
+#include "read_cache.h"
+
+#define READ_CACHE_DEFAULT_MAX_AGE 60
+#define READ_CACHE_ENTRY_CAPSULE "aerospike.read_cache_entry"
+// Namespace, separator and digest.
+#define READ_CACHE_KEY_SIZE (AS_NAMESPACE_MAX_SIZE + 1 + AS_DIGEST_VALUE_SIZE)
+
+typedef struct read_cache_entry_s {
+    // Doubly linked in least recently used order.
+    struct read_cache_entry_s *prev;
+    struct read_cache_entry_s *next;
+    PyObject *py_key;
+    // (key, meta, bins) owned by the cache.
+    PyObject *py_rec;
+    uint16_t gen;
+    uint32_t size;
+    // When the entry stops being served.
+    uint64_t expires_ms;
+    // When the record expires on the server, 0 if it never does.
+    uint64_t record_expires_ms;
+} read_cache_entry;
+
+typedef struct {
+    as_namespace ns;
+    as_set set;
+    // The scope is a whole namespace.
+    bool any_set;
+} read_cache_scope;
+
+struct read_cache_s {
+    // Cache key bytes to a capsule holding the read_cache_entry. Without the
+    // GIL, a critical section on it guards the whole cache.
+    PyObject *py_entries;
+    // Most and least recently used entries.
+    read_cache_entry *head;
+    read_cache_entry *tail;
+
+    uint32_t max_records;
+    uint64_t max_size;
+    uint32_t max_age;
+    // Records at least this large are validated, 0 disables validation.
+    uint32_t validate_size;
+
+    read_cache_scope *scopes;
+    uint32_t n_scopes;
+
+    // Incremented by every invalidation, so that reads which began before
+    // it do not cache what they read.
+    uint64_t epoch;
+
+    uint64_t size;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t validations;
+    uint64_t stale;
+    uint64_t evictions;
+};
+
+/*******************************************************************************
+ * RECORD SIZE
+ ******************************************************************************/
+
+static uint32_t val_size(const as_val *val);
+
+static bool list_size_each(as_val *val, void *udata)
+{
+    *(uint32_t *)udata += val_size(val);
+    return true;
+}
+
+static bool map_size_each(const as_val *key, const as_val *val, void *udata)
+{
+    *(uint32_t *)udata += val_size(key) + val_size(val);
+    return true;
+}
+
+/*
+ * Approximates the memory held by a value, which is what the size limit of
+ * the cache is about.
+ */
+static uint32_t val_size(const as_val *val)
+{
+    uint32_t size = 0;
+
+    if (!val) {
+        return 0;
+    }
+
+    switch (as_val_type(val)) {
+    case AS_STRING:
+        return (uint32_t)as_string_len((as_string *)val);
+    case AS_BYTES:
+        return as_bytes_size((as_bytes *)val);
+    case AS_GEOJSON:
+        return (uint32_t)as_geojson_len((as_geojson *)val);
+    case AS_LIST:
+        as_list_foreach((as_list *)val, list_size_each, &size);
+        return size;
+    case AS_MAP:
+        as_map_foreach((as_map *)val, map_size_each, &size);
+        return size;
+    default:
+        return sizeof(int64_t);
+    }
+}
+
+static uint32_t record_size(as_record *rec)
+{
+    uint32_t size = 0;
+
+    for (uint16_t i = 0; i < rec->bins.size; i++) {
+        as_bin *bin = &rec->bins.entries[i];
+        size += (uint32_t)strlen(bin->name) + val_size((as_val *)bin->valuep);
+    }
+    return size;
+}
+
+/*******************************************************************************
+ * ENTRIES
+ ******************************************************************************/
+
+static PyObject *cache_key_new(as_key *key)
+{
+    as_digest *digest = as_key_digest(key);
+    if (!digest) {
+        return NULL;
+    }
+
+    char buffer[READ_CACHE_KEY_SIZE];
+    size_t ns_len = strlen(key->ns);
+    memcpy(buffer, key->ns, ns_len);
+    buffer[ns_len] = ':';
+    memcpy(buffer + ns_len + 1, digest->value, AS_DIGEST_VALUE_SIZE);
+
+    return PyBytes_FromStringAndSize(buffer,
+                                     ns_len + 1 + AS_DIGEST_VALUE_SIZE);
+}
+
+static read_cache_entry *cache_find(read_cache *cache, PyObject *py_key)
+{
+    PyObject *py_capsule = PyDict_GetItem(cache->py_entries, py_key);
+    if (!py_capsule) {
+        return NULL;
+    }
+    return (read_cache_entry *)PyCapsule_GetPointer(py_capsule,
+                                                    READ_CACHE_ENTRY_CAPSULE);
+}
+
+static void cache_unlink(read_cache *cache, read_cache_entry *entry)
+{
+    if (entry->prev) {
+        entry->prev->next = entry->next;
+    }
+    else {
+        cache->head = entry->next;
+    }
+    if (entry->next) {
+        entry->next->prev = entry->prev;
+    }
+    else {
+        cache->tail = entry->prev;
+    }
+    entry->prev = NULL;
+    entry->next = NULL;
+}
+
+static void cache_push_front(read_cache *cache, read_cache_entry *entry)
+{
+    entry->prev = NULL;
+    entry->next = cache->head;
+    if (cache->head) {
+        cache->head->prev = entry;
+    }
+    cache->head = entry;
+    if (!cache->tail) {
+        cache->tail = entry;
+    }
+}
+
+static void cache_remove(read_cache *cache, read_cache_entry *entry)
+{
+    cache_unlink(cache, entry);
+    cache->size -= entry->size;
+
+    if (PyDict_DelItem(cache->py_entries, entry->py_key) != 0) {
+        PyErr_Clear();
+    }
+    Py_DECREF(entry->py_key);
+    Py_DECREF(entry->py_rec);
+    allocator_free(entry);
+}
+
+/*
+ * Copies a cached record, with its ttl brought up to date.
+ */
+static PyObject *record_copy(AerospikeClient *self, PyObject *py_rec,
+                             uint64_t record_expires_ms)
+{
+    PyObject *py_copy = record_tuple_copy(self, py_rec);
+    PyObject *py_meta = py_copy ? PyTuple_GetItem(py_copy, 1) : NULL;
+    if (!py_meta || !PyDict_Check(py_meta) || py_copy == py_rec) {
+        return py_copy;
+    }
+
+    // The ttl reported when the record was read is out of date by now.
+    if (record_expires_ms) {
+        uint64_t now = cf_getms();
+        uint64_t ttl = record_expires_ms > now
+                           ? (record_expires_ms - now + 999) / 1000
+                           : 0;
+        PyObject *py_ttl = PyLong_FromUnsignedLongLong(ttl);
+        if (!py_ttl || PyDict_SetItemString(py_meta, "ttl", py_ttl) != 0) {
+            PyErr_Clear();
+        }
+        Py_XDECREF(py_ttl);
+    }
+
+    return py_copy;
+}
+
+/*
+ * Entries are served until the record expires on the server or max_age
+ * passes, whichever comes first.
+ */
+static void entry_set_expiry(read_cache *cache, read_cache_entry *entry,
+                             uint32_t ttl)
+{
+    uint64_t now = cf_getms();
+    uint64_t max_age_ms = (uint64_t)cache->max_age * 1000;
+
+    if (ttl == 0 || ttl == AS_RECORD_NO_EXPIRE_TTL) {
+        entry->record_expires_ms = 0;
+        entry->expires_ms = now + max_age_ms;
+        return;
+    }
+
+    uint64_t ttl_ms = (uint64_t)ttl * 1000;
+    entry->record_expires_ms = now + ttl_ms;
+    entry->expires_ms = now + (ttl_ms < max_age_ms ? ttl_ms : max_age_ms);
+}
+
+/*******************************************************************************
+ * CONFIG
+ ******************************************************************************/
+
+static bool config_get_scopes(read_cache *cache, PyObject *py_config,
+                              as_error *err)
+{
+    PyObject *py_sets = PyDict_GetItemString(py_config, "sets");
+    if (!py_sets || py_sets == Py_None) {
+        return true;
+    }
+
+    if (!PyList_Check(py_sets)) {
+        as_error_update(err, AEROSPIKE_ERR_PARAM,
+                        "read_cache sets must be a list");
+        return false;
+    }
+
+    Py_ssize_t size = PyList_Size(py_sets);
+    cache->scopes = (read_cache_scope *)allocator_calloc(
+        ALLOCATOR_CLIENT, size ? size : 1, sizeof(read_cache_scope));
+    if (!cache->scopes) {
+        as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                        "Failed to allocate memory for read_cache sets");
+        return false;
+    }
+    cache->n_scopes = (uint32_t)size;
+
+    for (Py_ssize_t i = 0; i < size; i++) {
+        PyObject *py_scope = PyList_GetItem(py_sets, i);
+        read_cache_scope *scope = &cache->scopes[i];
+        const char *ns = NULL;
+        const char *set = NULL;
+
+        if (PyUnicode_Check(py_scope)) {
+            ns = PyUnicode_AsUTF8(py_scope);
+            scope->any_set = true;
+        }
+        else if (PyTuple_Check(py_scope) && PyTuple_Size(py_scope) == 2 &&
+                 PyUnicode_Check(PyTuple_GetItem(py_scope, 0)) &&
+                 PyUnicode_Check(PyTuple_GetItem(py_scope, 1))) {
+            ns = PyUnicode_AsUTF8(PyTuple_GetItem(py_scope, 0));
+            set = PyUnicode_AsUTF8(PyTuple_GetItem(py_scope, 1));
+        }
+
+        if (!ns || strlen(ns) >= AS_NAMESPACE_MAX_SIZE ||
+            (set && strlen(set) >= AS_SET_MAX_SIZE)) {
+            as_error_update(err, AEROSPIKE_ERR_PARAM,
+                            "read_cache sets must hold namespace names or "
+                            "(namespace, set) tuples");
+            return false;
+        }
+
+        strcpy(scope->ns, ns);
+        if (set) {
+            strcpy(scope->set, set);
+        }
+    }
+    return true;
+}
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+read_cache *read_cache_new(PyObject *py_config, as_error *err)
+{
+    if (!PyDict_Check(py_config)) {
+        as_error_update(err, AEROSPIKE_ERR_PARAM,
+                        "read_cache must be a dict");
+        return NULL;
+    }
+
+    read_cache *cache =
+        (read_cache *)allocator_calloc(ALLOCATOR_CLIENT, 1, sizeof(read_cache));
+    if (!cache) {
+        as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                        "Failed to allocate memory for read_cache");
+        return NULL;
+    }
+    uint64_t max_records = 0;
+    uint64_t max_age = READ_CACHE_DEFAULT_MAX_AGE;
+    uint64_t validate_size = 0;
+
+    if (!client_config_get_uint(py_config, "read_cache", "max_records", 0,
+                                UINT32_MAX, &max_records, err) ||
+        !client_config_get_uint(py_config, "read_cache", "max_size", 0,
+                                UINT64_MAX, &cache->max_size, err) ||
+        !client_config_get_uint(py_config, "read_cache", "max_age", 0,
+                                UINT32_MAX / 1000, &max_age, err) ||
+        !client_config_get_uint(py_config, "read_cache", "validate_size", 0,
+                                UINT32_MAX, &validate_size, err) ||
+        !config_get_scopes(cache, py_config, err)) {
+        read_cache_destroy(cache);
+        return NULL;
+    }
+
+    if (max_records == 0) {
+        as_error_update(err, AEROSPIKE_ERR_PARAM,
+                        "read_cache max_records must be set");
+        read_cache_destroy(cache);
+        return NULL;
+    }
+
+    cache->max_records = (uint32_t)max_records;
+    cache->max_age = (uint32_t)max_age;
+    cache->validate_size = (uint32_t)validate_size;
+    cache->py_entries = PyDict_New();
+    return cache;
+}
+
+void read_cache_destroy(read_cache *cache)
+{
+    if (!cache) {
+        return;
+    }
+    if (cache->py_entries) {
+        cache_clear(cache);
+        Py_DECREF(cache->py_entries);
+    }
+    if (cache->scopes) {
+        allocator_free(cache->scopes);
+    }
+    allocator_free(cache);
+}
+
+bool read_cache_covers(AerospikeClient *self, const as_policy_read *policy,
+                       const as_key *key)
+{
+    read_cache *cache = self->read_cache;
+    const as_policy_read *defaults = &self->as->config.policies.read;
+
+    if (policy && policy != defaults &&
+        (policy->key != defaults->key || policy->replica != defaults->replica ||
+         policy->read_mode_ap != defaults->read_mode_ap ||
+         policy->read_mode_sc != defaults->read_mode_sc ||
+         policy->deserialize != defaults->deserialize)) {
+        return false;
+    }
+
+    if (cache->n_scopes == 0) {
+        return true;
+    }
+
+    for (uint32_t i = 0; i < cache->n_scopes; i++) {
+        read_cache_scope *scope = &cache->scopes[i];
+        if (strcmp(scope->ns, key->ns) == 0 &&
+            (scope->any_set || strcmp(scope->set, key->set) == 0)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static PyObject *cache_lookup(AerospikeClient *self, as_policy_read *policy,
+                              as_key *key)
+{
+    read_cache *cache = self->read_cache;
+    PyObject *py_key = cache_key_new(key);
+    if (!py_key) {
+        PyErr_Clear();
+        return NULL;
+    }
+
+    read_cache_entry *entry = cache_find(cache, py_key);
+    Py_DECREF(py_key);
+
+    if (!entry || entry->expires_ms <= cf_getms()) {
+        if (entry) {
+            cache_remove(cache, entry);
+        }
+        cache->misses++;
+        return NULL;
+    }
+
+    if (cache->validate_size && entry->size >= cache->validate_size) {
+        // A header read is enough to tell whether the record changed.
+        as_error err;
+        as_error_init(&err);
+        as_record *rec = NULL;
+        uint16_t gen = entry->gen;
+
+        cache->validations++;
+
+        Py_BEGIN_ALLOW_THREADS
+        aerospike_key_exists(self->as, &err, policy, key, &rec);
+        Py_END_ALLOW_THREADS
+
+        // The entry may have been dropped while the GIL was released.
+        py_key = cache_key_new(key);
+        entry = py_key ? cache_find(cache, py_key) : NULL;
+        Py_XDECREF(py_key);
+        PyErr_Clear();
+
+        bool fresh = err.code == AEROSPIKE_OK && rec && entry &&
+                     rec->gen == gen && entry->gen == gen;
+        if (fresh) {
+            entry_set_expiry(cache, entry, rec->ttl);
+        }
+        if (rec) {
+            as_record_destroy(rec);
+        }
+        if (!fresh) {
+            if (entry) {
+                cache_remove(cache, entry);
+            }
+            cache->stale++;
+            cache->misses++;
+            return NULL;
+        }
+    }
+
+    cache_unlink(cache, entry);
+    cache_push_front(cache, entry);
+    cache->hits++;
+
+    PyObject *py_rec =
+        record_copy(self, entry->py_rec, entry->record_expires_ms);
+    if (!py_rec) {
+        PyErr_Clear();
+    }
+    return py_rec;
+}
+
+static void cache_put(AerospikeClient *self, uint64_t epoch, as_key *key,
+                      as_record *rec, PyObject *py_rec)
+{
+    read_cache *cache = self->read_cache;
+
+    if (cache->epoch != epoch) {
+        return;
+    }
+
+    uint32_t size = record_size(rec);
+    if (cache->max_size && size > cache->max_size) {
+        cache_invalidate(cache, key);
+        return;
+    }
+
+    PyObject *py_key = cache_key_new(key);
+    PyObject *py_copy = record_copy(self, py_rec, 0);
+    PyObject *py_capsule = NULL;
+    read_cache_entry *entry = NULL;
+
+    if (!py_key || !py_copy) {
+        goto CLEANUP;
+    }
+
+    entry = cache_find(cache, py_key);
+    if (entry) {
+        cache_remove(cache, entry);
+    }
+
+    entry = (read_cache_entry *)allocator_calloc(ALLOCATOR_READ_CACHE, 1,
+                                                 sizeof(read_cache_entry));
+    if (!entry) {
+        // The record is not cached, which only costs a later read.
+        goto CLEANUP;
+    }
+    py_capsule = PyCapsule_New(entry, READ_CACHE_ENTRY_CAPSULE, NULL);
+    if (!py_capsule ||
+        PyDict_SetItem(cache->py_entries, py_key, py_capsule) != 0) {
+        allocator_free(entry);
+        goto CLEANUP;
+    }
+
+    entry->py_key = py_key;
+    entry->py_rec = py_copy;
+    entry->gen = rec->gen;
+    entry->size = size;
+    entry_set_expiry(cache, entry, rec->ttl);
+    py_key = NULL;
+    py_copy = NULL;
+
+    cache_push_front(cache, entry);
+    cache->size += size;
+
+    while (cache->tail && (PyDict_Size(cache->py_entries) > cache->max_records ||
+                           (cache->max_size && cache->size > cache->max_size))) {
+        cache_remove(cache, cache->tail);
+        cache->evictions++;
+    }
+
+CLEANUP:
+    Py_XDECREF(py_key);
+    Py_XDECREF(py_copy);
+    Py_XDECREF(py_capsule);
+    PyErr_Clear();
+}
+
+static void cache_invalidate(read_cache *cache, as_key *key)
+{
+    PyObject *py_key = cache_key_new(key);
+    if (!py_key) {
+        PyErr_Clear();
+        return;
+    }
+
+    read_cache_entry *entry = cache_find(cache, py_key);
+    if (entry) {
+        cache_remove(cache, entry);
+    }
+    Py_DECREF(py_key);
+}
+
+static void cache_clear(read_cache *cache)
+{
+    cache->epoch++;
+    while (cache->head) {
+        cache_remove(cache, cache->head);
+    }
+}
+
+PyObject *read_cache_lookup(AerospikeClient *self, as_policy_read *policy,
+                            as_key *key)
+{
+    PyObject *py_rec = NULL;
+
+    Py_BEGIN_CRITICAL_SECTION(self->read_cache->py_entries);
+    py_rec = cache_lookup(self, policy, key);
+    Py_END_CRITICAL_SECTION();
+
+    return py_rec;
+}
+
+uint64_t read_cache_epoch(read_cache *cache)
+{
+    uint64_t epoch = 0;
+
+    Py_BEGIN_CRITICAL_SECTION(cache->py_entries);
+    epoch = cache->epoch;
+    Py_END_CRITICAL_SECTION();
+
+    return epoch;
+}
+
+void read_cache_put(AerospikeClient *self, uint64_t epoch, as_key *key,
+                    as_record *rec, PyObject *py_rec)
+{
+    Py_BEGIN_CRITICAL_SECTION(self->read_cache->py_entries);
+    cache_put(self, epoch, key, rec, py_rec);
+    Py_END_CRITICAL_SECTION();
+}
+
+void read_cache_invalidate(read_cache *cache, as_key *key)
+{
+    Py_BEGIN_CRITICAL_SECTION(cache->py_entries);
+    cache->epoch++;
+    cache_invalidate(cache, key);
+    Py_END_CRITICAL_SECTION();
+}
+
+void read_cache_clear(read_cache *cache)
+{
+    Py_BEGIN_CRITICAL_SECTION(cache->py_entries);
+    cache_clear(cache);
+    Py_END_CRITICAL_SECTION();
+}
+
+PyObject *read_cache_project(PyObject *py_rec, char **bins)
+{
+    PyObject *py_bins = PyTuple_GetItem(py_rec, 2);
+    PyObject *py_selected = PyDict_New();
+    if (!py_selected) {
+        return NULL;
+    }
+
+    for (int i = 0; bins[i]; i++) {
+        PyObject *py_value =
+            PyDict_Check(py_bins) ? PyDict_GetItemString(py_bins, bins[i])
+                                  : NULL;
+        if (py_value &&
+            PyDict_SetItemString(py_selected, bins[i], py_value) != 0) {
+            Py_DECREF(py_selected);
+            return NULL;
+        }
+    }
+
+    PyObject *py_projected = PyTuple_Pack(3, PyTuple_GetItem(py_rec, 0),
+                                          PyTuple_GetItem(py_rec, 1),
+                                          py_selected);
+    Py_DECREF(py_selected);
+    return py_projected;
+}
+
+/**
+ *******************************************************************************************************
+ * Returns the counters of the client's read cache.
+ *
+ * @param self                  AerospikeClient object
+ *
+ * Returns a dict, or None if the client has no read cache.
+ *******************************************************************************************************
+ */
+PyObject *AerospikeClient_Get_Read_Cache_Stats(AerospikeClient *self,
+                                               PyObject *args)
+{
+    read_cache *cache = self->read_cache;
+    if (!cache) {
+        Py_RETURN_NONE;
+    }
+
+    PyObject *py_stats = NULL;
+
+    Py_BEGIN_CRITICAL_SECTION(cache->py_entries);
+    py_stats = Py_BuildValue(
+        "{s:n,s:K,s:K,s:K,s:K,s:K,s:K}", "records",
+        PyDict_Size(cache->py_entries), "size",
+        (unsigned long long)cache->size, "hits",
+        (unsigned long long)cache->hits, "misses",
+        (unsigned long long)cache->misses, "validations",
+        (unsigned long long)cache->validations, "stale",
+        (unsigned long long)cache->stale, "evictions",
+        (unsigned long long)cache->evictions);
+    Py_END_CRITICAL_SECTION();
+
+    return py_stats;
+}
+
+/**
+ *******************************************************************************************************
+ * Drops all records from the client's read cache.
+ *
+ * @param self                  AerospikeClient object
+ *
+ * Returns None.
+ *******************************************************************************************************
+ */
+PyObject *AerospikeClient_Clear_Read_Cache(AerospikeClient *self,
+                                           PyObject *args)
+{
+    if (self->read_cache) {
+        read_cache_clear(self->read_cache);
+    }
+    Py_RETURN_NONE;
+}
@@ -22,10 +22,14 @@
 #include <aerospike/as_error.h>
 #include <aerospike/as_record.h>
 
+#include "adaptive_policy.h"
 #include "client.h"
+#include "command_limits.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "fastcall.h"
 #include "policy.h"
+#include "read_cache.h"
 
 /**
  *******************************************************************************************************
@@ -72,7 +76,7 @@ PyObject *AerospikeClient_Remove_Invoke(AerospikeClient *self, PyObject *py_key,
     }
 
     // Convert python key object to as_key
-    pyobject_to_key(&err, py_key, &key);
+    pyobject_to_key(self, &err, py_key, &key);
     if (err.code != AEROSPIKE_OK) {
         goto CLEANUP;
     }
@@ -117,9 +121,29 @@ PyObject *AerospikeClient_Remove_Invoke(AerospikeClient *self, PyObject *py_key,
     }
 
     // Invoke operation
+    command_permit permit;
+    if (!command_limits_acquire(self, COMMAND_LIMIT_WRITE, py_policy, &key, 1,
+                                &permit, &err)) {
+        goto CLEANUP;
+    }
+    uint64_t start = 0;
+    if (self->adaptive_policy) {
+        // Adaptive timeouts adjust a copy of the default policy.
+        if (!remove_policy_p) {
+            as_policy_remove_copy(&self->as->config.policies.remove,
+                                  &remove_policy);
+            remove_policy_p = &remove_policy;
+        }
+        start = adaptive_policy_begin(self, &remove_policy_p->base, false);
+    }
     Py_BEGIN_ALLOW_THREADS
     aerospike_key_remove(self->as, &err, remove_policy_p, &key);
     Py_END_ALLOW_THREADS
+    command_limits_release(self, &permit);
+    adaptive_policy_end(self, start, false, &err);
+    if (self->read_cache) {
+        read_cache_invalidate(self->read_cache, &key);
+    }
     if (err.code != AEROSPIKE_OK) {
         as_error_update(&err, err.code, NULL);
     }
@@ -136,17 +160,7 @@ CLEANUP:
     }
 
     if (err.code != AEROSPIKE_OK) {
-        PyObject *py_err = NULL;
-        error_to_pyobject(&err, &py_err);
-        PyObject *exception_type = raise_exception_old(&err);
-        if (PyObject_HasAttrString(exception_type, "key")) {
-            PyObject_SetAttrString(exception_type, "key", py_key);
-        }
-        if (PyObject_HasAttrString(exception_type, "bin")) {
-            PyObject_SetAttrString(exception_type, "bin", Py_None);
-        }
-        PyErr_SetObject(exception_type, py_err);
-        Py_DECREF(py_err);
+        raise_exception_base(&err, py_key, Py_None, NULL, NULL, NULL);
         return NULL;
     }
 
@@ -166,8 +180,8 @@ CLEANUP:
  * In case of error,appropriate exceptions will be raised.
  *******************************************************************************************************
  */
-PyObject *AerospikeClient_Remove(AerospikeClient *self, PyObject *args,
-                                 PyObject *kwds)
+PyObject *AerospikeClient_Remove(AerospikeClient *self, PyObject *const *args,
+                                 Py_ssize_t nargs, PyObject *kwnames)
 {
     // Python Function Arguments
     PyObject *py_key = NULL;
@@ -175,11 +189,12 @@ PyObject *AerospikeClient_Remove(AerospikeClient *self, PyObject *args,
     PyObject *py_meta = NULL;
 
     // Python Function Keyword Arguments
-    static char *kwlist[] = {"key", "meta", "policy", NULL};
+    static const char *kwlist[] = {"key", "meta", "policy", NULL};
+    static fastcall_parser parser = {"remove", kwlist, 1};
 
     // Python Function Argument Parsing
-    if (PyArg_ParseTupleAndKeywords(args, kwds, "O|OO:remove", kwlist, &py_key,
-                                    &py_meta, &py_policy) == false) {
+    if (fastcall_parse(&parser, self->state, args, nargs, kwnames, &py_key,
+                       &py_meta, &py_policy) == false) {
         return NULL;
     }
 
@@ -22,10 +22,13 @@
 #include <aerospike/as_error.h>
 #include <aerospike/as_record.h>
 
+#include "adaptive_policy.h"
 #include "client.h"
+#include "command_limits.h"
 #include "conversions.h"
 #include "exceptions.h"
 #include "policy.h"
+#include "read_cache.h"
 
 /**
  ******************************************************************************************************
@@ -67,7 +70,7 @@ AerospikeClient_RemoveBin_Invoke(AerospikeClient *self, PyObject *py_key,
     as_record_inita(&rec, size);
 
     // Convert python key object to as_key
-    pyobject_to_key(err, py_key, &key);
+    pyobject_to_key(self, err, py_key, &key);
     if (err->code != AEROSPIKE_OK) {
         goto CLEANUP;
     }
@@ -143,9 +146,21 @@ AerospikeClient_RemoveBin_Invoke(AerospikeClient *self, PyObject *py_key,
         }
     }
 
+    command_permit permit;
+    if (!command_limits_acquire(self, COMMAND_LIMIT_WRITE, py_policy, &key, 1,
+                                &permit, err)) {
+        goto CLEANUP;
+    }
+    uint64_t start =
+        adaptive_policy_begin(self, &write_policy_p->base, false);
     Py_BEGIN_ALLOW_THREADS
     aerospike_key_put(self->as, err, write_policy_p, &key, &rec);
     Py_END_ALLOW_THREADS
+    command_limits_release(self, &permit);
+    adaptive_policy_end(self, start, false, err);
+    if (self->read_cache) {
+        read_cache_invalidate(self->read_cache, &key);
+    }
     if (err->code != AEROSPIKE_OK) {
         as_error_update(err, err->code, NULL);
         goto CLEANUP;
@@ -164,17 +179,7 @@ CLEANUP:
     }
 
     if (err->code != AEROSPIKE_OK) {
-        PyObject *py_err = NULL;
-        error_to_pyobject(err, &py_err);
-        PyObject *exception_type = raise_exception_old(err);
-        if (PyObject_HasAttrString(exception_type, "key")) {
-            PyObject_SetAttrString(exception_type, "key", py_key);
-        }
-        if (PyObject_HasAttrString(exception_type, "bin")) {
-            PyObject_SetAttrString(exception_type, "bin", Py_None);
-        }
-        PyErr_SetObject(exception_type, py_err);
-        Py_DECREF(py_err);
+        raise_exception_base(err, py_key, Py_None, NULL, NULL, NULL);
         return NULL;
     }
     return PyLong_FromLong(0);
@@ -240,17 +245,7 @@ PyObject *AerospikeClient_RemoveBin(AerospikeClient *self, PyObject *args,
 CLEANUP:
 
     if (err.code != AEROSPIKE_OK || !py_result) {
-        PyObject *py_err = NULL;
-        error_to_pyobject(&err, &py_err);
-        PyObject *exception_type = raise_exception_old(&err);
-        if (PyObject_HasAttrString(exception_type, "key")) {
-            PyObject_SetAttrString(exception_type, "key", py_key);
-        }
-        if (PyObject_HasAttrString(exception_type, "bin")) {
-            PyObject_SetAttrString(exception_type, "bin", Py_None);
-        }
-        PyErr_SetObject(exception_type, py_err);
-        Py_DECREF(py_err);
+        raise_exception_base(&err, py_key, Py_None, NULL, NULL, NULL);
         return NULL;
     }
     return NULL;
@@ -22,6 +22,7 @@
 #include "policy.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "serializer.h"
 #include <aerospike/aerospike_scan.h>
 #include <aerospike/as_arraylist.h>
 #include <aerospike/as_scan.h>
@@ -103,7 +104,7 @@ static PyObject *AerospikeClient_ScanApply_Invoke(
         goto CLEANUP;
     }
 
-    self->is_client_put_serializer = false;
+    set_client_put_serializer(false);
 
     if (!(namespace_p) || !(py_set) || !(py_module) || !(py_function)) {
         as_error_update(&err, AEROSPIKE_ERR_PARAM,
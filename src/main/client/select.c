@@ -22,10 +22,17 @@
 #include <aerospike/as_error.h>
 #include <aerospike/as_record.h>
 
+#include "adaptive_policy.h"
 #include "client.h"
+#include "command_limits.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "fastcall.h"
+#include "hedged_read.h"
 #include "policy.h"
+#include "read_cache.h"
+#include "serializer.h"
+#include "single_flight.h"
 
 /**
  *******************************************************************************************************
@@ -55,6 +62,7 @@ PyObject *AerospikeClient_Select_Invoke(AerospikeClient *self, PyObject *py_key,
     // It's only safe to free the record if this succeeded.
     bool select_succeeded = false;
     char **bins = NULL;
+    single_flight *flight = NULL;
 
     // For converting expressions.
     as_exp exp_list;
@@ -78,7 +86,7 @@ PyObject *AerospikeClient_Select_Invoke(AerospikeClient *self, PyObject *py_key,
     }
 
     // Convert python key object to as_key
-    pyobject_to_key(&err, py_key, &key);
+    pyobject_to_key(self, &err, py_key, &key);
     if (err.code != AEROSPIKE_OK) {
         goto CLEANUP;
     }
@@ -151,21 +159,65 @@ PyObject *AerospikeClient_Select_Invoke(AerospikeClient *self, PyObject *py_key,
         goto CLEANUP;
     }
 
+    // Records cached by get() hold every bin, so they can serve any select.
+    if (self->read_cache && !exp_list_p &&
+        read_cache_covers(self, read_policy_p, &key)) {
+        PyObject *py_cached = read_cache_lookup(self, read_policy_p, &key);
+        if (py_cached) {
+            py_rec = read_cache_project(py_cached, bins);
+            Py_DECREF(py_cached);
+            if (py_rec) {
+                goto CLEANUP;
+            }
+            PyErr_Clear();
+        }
+    }
+
+    // Concurrent identical reads share one command.
+    if (self->py_flights && !exp_list_p &&
+        single_flight_join(self, &key, read_policy_p, bins, &flight, &err,
+                           &py_rec)) {
+        goto CLEANUP;
+    }
+
     // Invoke operation
-    Py_BEGIN_ALLOW_THREADS
-    aerospike_key_select(self->as, &err, read_policy_p, &key,
-                         (const char **)bins, &rec);
-    Py_END_ALLOW_THREADS
+    command_permit permit;
+    if (!command_limits_acquire(self, COMMAND_LIMIT_READ, py_policy, &key, 1,
+                                &permit, &err)) {
+        goto CLEANUP;
+    }
+    uint64_t start = adaptive_policy_begin(self, &read_policy_p->base, true);
+    if (hedged_read_covers(self, read_policy_p, exp_list_p != NULL)) {
+        Py_BEGIN_ALLOW_THREADS
+        hedged_read(self->hedged_reader, self->as, read_policy_p, &key,
+                    (const char **)bins, &err, &rec);
+        Py_END_ALLOW_THREADS
+    }
+    else {
+        Py_BEGIN_ALLOW_THREADS
+        aerospike_key_select(self->as, &err, read_policy_p, &key,
+                             (const char **)bins, &rec);
+        Py_END_ALLOW_THREADS
+    }
+    command_limits_release(self, &permit);
+    adaptive_policy_end(self, start, true, &err);
 
     if (err.code == AEROSPIKE_OK) {
         select_succeeded = true;
-        record_to_pyobject(self, &err, rec, &key, &py_rec);
+        deferred_values deferred;
+        deferred_values_init(self, &deferred);
+        record_to_pyobject_deferred(self, &err, rec, &key, &deferred, &py_rec);
+        deferred_values_deserialize(&deferred, err.code == AEROSPIKE_OK);
     }
     else {
         as_error_update(&err, err.code, NULL);
     }
 
 CLEANUP:
+    if (flight) {
+        single_flight_land(self, flight, &err, py_rec);
+    }
+
     if (exp_list_p) {
         as_exp_destroy(exp_list_p);
         ;
@@ -185,17 +237,7 @@ CLEANUP:
     }
 
     if (err.code != AEROSPIKE_OK) {
-        PyObject *py_err = NULL;
-        error_to_pyobject(&err, &py_err);
-        PyObject *exception_type = raise_exception_old(&err);
-        if (PyObject_HasAttrString(exception_type, "key")) {
-            PyObject_SetAttrString(exception_type, "key", py_key);
-        }
-        if (PyObject_HasAttrString(exception_type, "bin")) {
-            PyObject_SetAttrString(exception_type, "bin", Py_None);
-        }
-        PyErr_SetObject(exception_type, py_err);
-        Py_DECREF(py_err);
+        raise_exception_base(&err, py_key, Py_None, NULL, NULL, NULL);
         return NULL;
     }
 
@@ -215,8 +257,8 @@ CLEANUP:
  * In case of error,appropriate exceptions will be raised.
  *******************************************************************************************************
  */
-PyObject *AerospikeClient_Select(AerospikeClient *self, PyObject *args,
-                                 PyObject *kwds)
+PyObject *AerospikeClient_Select(AerospikeClient *self, PyObject *const *args,
+                                 Py_ssize_t nargs, PyObject *kwnames)
 {
     // Python Function Arguments
     PyObject *py_key = NULL;
@@ -224,11 +266,12 @@ PyObject *AerospikeClient_Select(AerospikeClient *self, PyObject *args,
     PyObject *py_policy = NULL;
 
     // Python Function Keyword Arguments
-    static char *kwlist[] = {"key", "bins", "policy", NULL};
+    static const char *kwlist[] = {"key", "bins", "policy", NULL};
+    static fastcall_parser parser = {"select", kwlist, 2};
 
     // Python Function Argument Parsing
-    if (PyArg_ParseTupleAndKeywords(args, kwds, "OO|O:select", kwlist, &py_key,
-                                    &py_bins, &py_policy) == false) {
+    if (fastcall_parse(&parser, self->state, args, nargs, kwnames, &py_key,
+                       &py_bins, &py_policy) == false) {
         return NULL;
     }
 
@@ -0,0 +1,228 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <aerospike/as_error.h>
+#include <aerospike/as_key.h>
+#include <aerospike/as_policy.h>
+
+#include "allocator.h"
+#include "client.h"
+#include "conversions.h"
+#include "macros.h"
+#include "single_flight.h"
+
+#define SINGLE_FLIGHT_CAPSULE "aerospike.single_flight"
+
+struct single_flight_s {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    bool done;
+    // The leader and the threads waiting for it. Only incremented while the
+    // flight is in py_flights, inside a critical section on it.
+    uint32_t refs;
+    // Flights inherited across fork() have no leader.
+    pid_t pid;
+    PyObject *py_key;
+    as_error err;
+    PyObject *py_rec;
+};
+
+static void single_flight_release(single_flight *flight)
+{
+    if (__atomic_sub_fetch(&flight->refs, 1, __ATOMIC_ACQ_REL) > 0) {
+        return;
+    }
+
+    pthread_mutex_destroy(&flight->lock);
+    pthread_cond_destroy(&flight->cond);
+    Py_XDECREF(flight->py_key);
+    Py_XDECREF(flight->py_rec);
+    allocator_free(flight);
+}
+
+/*
+ * Reads are identical if they are for the same namespace, digest, policy and
+ * bins. Policies are compared by value.
+ */
+static PyObject *single_flight_key(as_key *key, as_policy_read *policy,
+                                   char **bins)
+{
+    as_digest *digest = as_key_digest(key);
+    if (!digest) {
+        return NULL;
+    }
+
+    size_t size = strlen(key->ns) + 1 + AS_DIGEST_VALUE_SIZE + 1;
+    if (policy) {
+        size += sizeof(as_policy_read);
+    }
+    for (int i = 0; bins && bins[i]; i++) {
+        size += strlen(bins[i]) + 1;
+    }
+
+    PyObject *py_key = PyBytes_FromStringAndSize(NULL, size);
+    if (!py_key) {
+        return NULL;
+    }
+
+    char *pos = PyBytes_AS_STRING(py_key);
+    size_t len = strlen(key->ns) + 1;
+    memcpy(pos, key->ns, len);
+    pos += len;
+    memcpy(pos, digest->value, AS_DIGEST_VALUE_SIZE);
+    pos += AS_DIGEST_VALUE_SIZE;
+    *pos++ = policy ? 'p' : 'd';
+    if (policy) {
+        memcpy(pos, policy, sizeof(as_policy_read));
+        pos += sizeof(as_policy_read);
+    }
+    for (int i = 0; bins && bins[i]; i++) {
+        len = strlen(bins[i]) + 1;
+        memcpy(pos, bins[i], len);
+        pos += len;
+    }
+
+    return py_key;
+}
+
+bool single_flight_join(AerospikeClient *self, as_key *key,
+                        as_policy_read *policy, char **bins,
+                        single_flight **leader, as_error *err,
+                        PyObject **py_rec)
+{
+    *leader = NULL;
+
+    PyObject *py_key = single_flight_key(key, policy, bins);
+    if (!py_key) {
+        PyErr_Clear();
+        return false;
+    }
+
+    single_flight *flight = NULL;
+    bool joined = false;
+
+    Py_BEGIN_CRITICAL_SECTION(self->py_flights);
+    PyObject *py_capsule = PyDict_GetItem(self->py_flights, py_key);
+    flight = py_capsule ? (single_flight *)PyCapsule_GetPointer(
+                              py_capsule, SINGLE_FLIGHT_CAPSULE)
+                        : NULL;
+
+    if (flight && flight->pid == getpid()) {
+        __atomic_add_fetch(&flight->refs, 1, __ATOMIC_ACQ_REL);
+        joined = true;
+    }
+    else {
+        flight = (single_flight *)allocator_calloc(ALLOCATOR_READ_CACHE, 1,
+                                                   sizeof(single_flight));
+    }
+
+    // Without memory for the flight, read without coalescing.
+    if (flight && !joined) {
+        pthread_mutex_init(&flight->lock, NULL);
+        pthread_cond_init(&flight->cond, NULL);
+        flight->refs = 1;
+        flight->pid = getpid();
+        as_error_init(&flight->err);
+
+        flight->py_key = py_key;
+        py_key = NULL;
+
+        py_capsule = PyCapsule_New(flight, SINGLE_FLIGHT_CAPSULE, NULL);
+        if (!py_capsule ||
+            PyDict_SetItem(self->py_flights, flight->py_key, py_capsule)) {
+            // Read without coalescing.
+            PyErr_Clear();
+            single_flight_release(flight);
+            flight = NULL;
+        }
+        Py_XDECREF(py_capsule);
+    }
+    Py_END_CRITICAL_SECTION();
+
+    if (!joined) {
+        Py_XDECREF(py_key);
+        *leader = flight;
+        return false;
+    }
+
+    Py_DECREF(py_key);
+
+    Py_BEGIN_ALLOW_THREADS
+    pthread_mutex_lock(&flight->lock);
+    while (!flight->done) {
+        pthread_cond_wait(&flight->cond, &flight->lock);
+    }
+    pthread_mutex_unlock(&flight->lock);
+    Py_END_ALLOW_THREADS
+
+    if (flight->err.code != AEROSPIKE_OK) {
+        as_error_copy(err, &flight->err);
+    }
+    else if (flight->py_rec) {
+        *py_rec = record_tuple_copy(self, flight->py_rec);
+        if (!*py_rec) {
+            PyErr_Clear();
+            as_error_update(err, AEROSPIKE_ERR_CLIENT, "Unable to copy record");
+        }
+    }
+    single_flight_release(flight);
+    return true;
+}
+
+void single_flight_land(AerospikeClient *self, single_flight *flight,
+                        as_error *err, PyObject *py_rec)
+{
+    uint32_t refs = 0;
+
+    // Drop the flight so that later reads go to the server again. No thread
+    // can join it once it is gone.
+    Py_BEGIN_CRITICAL_SECTION(self->py_flights);
+    PyObject *py_capsule = PyDict_GetItem(self->py_flights, flight->py_key);
+    if (py_capsule && PyCapsule_GetPointer(py_capsule, SINGLE_FLIGHT_CAPSULE) ==
+                          flight) {
+        PyDict_DelItem(self->py_flights, flight->py_key);
+    }
+    PyErr_Clear();
+    refs = __atomic_load_n(&flight->refs, __ATOMIC_ACQUIRE);
+    Py_END_CRITICAL_SECTION();
+
+    if (refs > 1) {
+        as_error_copy(&flight->err, err);
+        if (err->code == AEROSPIKE_OK && py_rec) {
+            // Waiters deep-copy from a record the caller cannot modify, so no
+            // two callers share a nested bin value.
+            flight->py_rec = record_tuple_copy(self, py_rec);
+            if (!flight->py_rec) {
+                PyErr_Clear();
+                as_error_update(&flight->err, AEROSPIKE_ERR_CLIENT,
+                                "Unable to copy record");
+            }
+        }
+    }
+
+    pthread_mutex_lock(&flight->lock);
+    flight->done = true;
+    pthread_cond_broadcast(&flight->cond);
+    pthread_mutex_unlock(&flight->lock);
+
+    single_flight_release(flight);
+}
@@ -19,6 +19,7 @@
 
 #include <aerospike/as_error.h>
 #include <aerospike/aerospike.h>
+#include "allocator.h"
 #include "client.h"
 #include "conversions.h"
 #include "exceptions.h"
@@ -84,7 +85,8 @@ PyObject *AerospikeClient_Truncate(AerospikeClient *self, PyObject *args,
 
     // Start conversion of the namespace parameter
     if (PyUnicode_Check(py_ns)) {
-        namespace = strdup((char *)PyUnicode_AsUTF8(py_ns));
+        namespace = allocator_strdup(ALLOCATOR_OPERATIONS,
+                                     (char *)PyUnicode_AsUTF8(py_ns));
         // If we failed to copy the string, exit
         if (!namespace) {
             as_error_update(&err, AEROSPIKE_ERR_CLIENT,
@@ -100,7 +102,8 @@ PyObject *AerospikeClient_Truncate(AerospikeClient *self, PyObject *args,
 
     // Start conversion of the set parameter
     if (PyUnicode_Check(py_set)) {
-        set = strdup((char *)PyUnicode_AsUTF8(py_set));
+        set = allocator_strdup(ALLOCATOR_OPERATIONS,
+                               (char *)PyUnicode_AsUTF8(py_set));
         // If we called strdup, and it failed we need to exit
         if (!set) {
             as_error_update(&err, AEROSPIKE_ERR_CLIENT,
@@ -146,11 +149,11 @@ PyObject *AerospikeClient_Truncate(AerospikeClient *self, PyObject *args,
 
 CLEANUP:
     if (namespace) {
-        free(namespace);
+        allocator_free(namespace);
     }
 
     if (set) {
-        free(set);
+        allocator_free(set);
     }
 
     if (err.code != AEROSPIKE_OK) {
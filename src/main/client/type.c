@@ -16,6 +16,7 @@
 
 #include <Python.h>
 #include <structmember.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <unistd.h>
 
@@ -30,8 +31,17 @@
 #include "policy.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "global_hosts.h"
+#include "interpreter.h"
+#include "module_state.h"
 #include "tls_config.h"
 #include "policy_config.h"
+#include "read_cache.h"
+#include "adaptive_policy.h"
+#include "auto_batch.h"
+#include "command_limits.h"
+#include "hedged_read.h"
+#include "latency_router.h"
 
 static int set_rack_aware_config(as_config *conf, PyObject *config_dict);
 static int set_use_services_alternate(as_config *conf, PyObject *config_dict);
@@ -56,10 +66,37 @@ enum {
  * PYTHON DOC METHODS
  ******************************************************************************/
 
-PyDoc_STRVAR(connect_doc, "connect([username, password])\n\
+PyDoc_STRVAR(connect_doc, "connect([username, password], *, lazy=False, \
+snapshot=None)\n\
 \n\
 Connect to the cluster. The optional username and password only apply when \
-connecting to the Enterprise Edition of Aerospike.");
+connecting to the Enterprise Edition of Aerospike. With lazy set, the \
+connection is established in the background and the first operation waits \
+for it. snapshot is the result of export_cluster_snapshot(), whose nodes are \
+used as additional seeds.");
+
+PyDoc_STRVAR(get_read_cache_stats_doc, "get_read_cache_stats() -> dict\n\
+\n\
+Return the counters of the read cache, or None if it is not enabled.");
+
+PyDoc_STRVAR(clear_read_cache_doc, "clear_read_cache()\n\
+\n\
+Drop all records from the read cache.");
+
+PyDoc_STRVAR(get_node_latencies_doc, "get_node_latencies() -> dict\n\
+\n\
+Return the latency and error rate measured for each node, or None if latency \
+probes are not enabled.");
+
+PyDoc_STRVAR(get_command_limit_stats_doc,
+             "get_command_limit_stats() -> list\n\
+\n\
+Return the counters of each command limit, or None if no command limits are \
+configured.");
+
+PyDoc_STRVAR(export_cluster_snapshot_doc, "export_cluster_snapshot() -> bytes\n\
+\n\
+Return the nodes of the cluster, to be passed to connect() later.");
 
 PyDoc_STRVAR(exists_doc, "exists(key[, policy]) -> (key, meta)\n\
 \n\
@@ -339,6 +376,18 @@ static PyMethodDef AerospikeClient_Type_Methods[] = {
      METH_VARARGS | METH_KEYWORDS, "Checks current connection state."},
     {"shm_key", (PyCFunction)AerospikeClient_shm_key,
      METH_VARARGS | METH_KEYWORDS, "Get the shm key of the cluster"},
+    {"get_read_cache_stats", (PyCFunction)AerospikeClient_Get_Read_Cache_Stats,
+     METH_NOARGS, get_read_cache_stats_doc},
+    {"clear_read_cache", (PyCFunction)AerospikeClient_Clear_Read_Cache,
+     METH_NOARGS, clear_read_cache_doc},
+    {"get_node_latencies", (PyCFunction)AerospikeClient_Get_Node_Latencies,
+     METH_NOARGS, get_node_latencies_doc},
+    {"get_command_limit_stats",
+     (PyCFunction)AerospikeClient_Get_Command_Limit_Stats, METH_NOARGS,
+     get_command_limit_stats_doc},
+    {"export_cluster_snapshot",
+     (PyCFunction)AerospikeClient_Export_Cluster_Snapshot, METH_NOARGS,
+     export_cluster_snapshot_doc},
 
     // ADMIN OPERATIONS
 
@@ -395,17 +444,17 @@ static PyMethodDef AerospikeClient_Type_Methods[] = {
     // KVS OPERATIONS
 
     {"exists", (PyCFunction)AerospikeClient_Exists,
-     METH_VARARGS | METH_KEYWORDS, exists_doc},
-    {"get", (PyCFunction)AerospikeClient_Get, METH_VARARGS | METH_KEYWORDS,
+     METH_FASTCALL | METH_KEYWORDS, exists_doc},
+    {"get", (PyCFunction)AerospikeClient_Get, METH_FASTCALL | METH_KEYWORDS,
      get_doc},
     {"select", (PyCFunction)AerospikeClient_Select,
-     METH_VARARGS | METH_KEYWORDS, select_doc},
-    {"put", (PyCFunction)AerospikeClient_Put, METH_VARARGS | METH_KEYWORDS,
+     METH_FASTCALL | METH_KEYWORDS, select_doc},
+    {"put", (PyCFunction)AerospikeClient_Put, METH_FASTCALL | METH_KEYWORDS,
      put_doc},
     {"get_key_partition_id", (PyCFunction)AerospikeClient_Get_Key_PartitionID,
      METH_VARARGS | METH_KEYWORDS, get_key_partition_id_doc},
     {"remove", (PyCFunction)AerospikeClient_Remove,
-     METH_VARARGS | METH_KEYWORDS, remove_doc},
+     METH_FASTCALL | METH_KEYWORDS, remove_doc},
     {"apply", (PyCFunction)AerospikeClient_Apply, METH_VARARGS | METH_KEYWORDS,
      apply_doc},
     {"remove_bin", (PyCFunction)AerospikeClient_RemoveBin,
@@ -417,9 +466,9 @@ static PyMethodDef AerospikeClient_Type_Methods[] = {
     {"touch", (PyCFunction)AerospikeClient_Touch, METH_VARARGS | METH_KEYWORDS,
      touch_doc},
     {"increment", (PyCFunction)AerospikeClient_Increment,
-     METH_VARARGS | METH_KEYWORDS, increment_doc},
+     METH_FASTCALL | METH_KEYWORDS, increment_doc},
     {"operate", (PyCFunction)AerospikeClient_Operate,
-     METH_VARARGS | METH_KEYWORDS, operate_doc},
+     METH_FASTCALL | METH_KEYWORDS, operate_doc},
     {"operate_ordered", (PyCFunction)AerospikeClient_OperateOrdered,
      METH_VARARGS | METH_KEYWORDS, operate_ordered_doc},
 
@@ -493,23 +542,23 @@ static PyMethodDef AerospikeClient_Type_Methods[] = {
     // BATCH OPERATIONS
 
     {"get_many", (PyCFunction)AerospikeClient_Get_Many,
-     METH_VARARGS | METH_KEYWORDS, get_many_doc},
+     METH_FASTCALL | METH_KEYWORDS, get_many_doc},
     {"batch_get_ops", (PyCFunction)AerospikeClient_Batch_GetOps,
-     METH_VARARGS | METH_KEYWORDS, batch_get_ops_doc},
+     METH_FASTCALL | METH_KEYWORDS, batch_get_ops_doc},
     {"select_many", (PyCFunction)AerospikeClient_Select_Many,
-     METH_VARARGS | METH_KEYWORDS, select_many_doc},
+     METH_FASTCALL | METH_KEYWORDS, select_many_doc},
     {"exists_many", (PyCFunction)AerospikeClient_Exists_Many,
-     METH_VARARGS | METH_KEYWORDS, exists_many_doc},
+     METH_FASTCALL | METH_KEYWORDS, exists_many_doc},
     {"batch_write", (PyCFunction)AerospikeClient_BatchWrite,
-     METH_VARARGS | METH_KEYWORDS, batch_write_doc},
+     METH_FASTCALL | METH_KEYWORDS, batch_write_doc},
     {"batch_operate", (PyCFunction)AerospikeClient_Batch_Operate,
-     METH_VARARGS | METH_KEYWORDS, batch_operate_doc},
+     METH_FASTCALL | METH_KEYWORDS, batch_operate_doc},
     {"batch_remove", (PyCFunction)AerospikeClient_Batch_Remove,
-     METH_VARARGS | METH_KEYWORDS, batch_remove_doc},
+     METH_FASTCALL | METH_KEYWORDS, batch_remove_doc},
     {"batch_apply", (PyCFunction)AerospikeClient_Batch_Apply,
-     METH_VARARGS | METH_KEYWORDS, batch_apply_doc},
+     METH_FASTCALL | METH_KEYWORDS, batch_apply_doc},
     {"batch_read", (PyCFunction)AerospikeClient_BatchRead,
-     METH_VARARGS | METH_KEYWORDS, "Read multiple keys."},
+     METH_FASTCALL | METH_KEYWORDS, "Read multiple keys."},
 
     // TRUNCATE OPERATIONS
     {"truncate", (PyCFunction)AerospikeClient_Truncate,
@@ -527,6 +576,19 @@ static PyObject *AerospikeClient_Type_New(PyTypeObject *type, PyObject *args,
     AerospikeClient *self = NULL;
 
     self = (AerospikeClient *)type->tp_alloc(type, 0);
+    if (self) {
+        // Commands call back into the interpreter the client belongs to.
+        self->interp = Aerospike_Current_Interpreter();
+        pthread_mutex_init(&self->reconnect_lock, NULL);
+        pthread_mutex_init(&self->connect_lock, NULL);
+        pthread_cond_init(&self->connect_cond, NULL);
+        // Looked up once, as results create module types for every record.
+        self->state = Aerospike_Get_Type_State(type);
+        if (!self->state) {
+            Py_DECREF(self);
+            return NULL;
+        }
+    }
 
     return (PyObject *)self;
 }
@@ -542,8 +604,26 @@ static int AerospikeClient_Type_Init(AerospikeClient *self, PyObject *args,
 
     self->has_connected = false;
     self->use_shared_connection = false;
+    self->user_shm_key = false;
     self->as = NULL;
     self->send_bool_as = SEND_BOOL_AS_AS_BOOL;
+    self->direct_cdt_decode = false;
+    self->direct_cdt_encode = false;
+    self->reconnect_after_fork = false;
+    self->connect_pending = false;
+    read_cache_destroy(self->read_cache);
+    self->read_cache = NULL;
+    Py_CLEAR(self->py_flights);
+    auto_batcher_destroy(self->auto_batcher);
+    self->auto_batcher = NULL;
+    hedged_reader_destroy(self->hedged_reader);
+    self->hedged_reader = NULL;
+    latency_router_destroy(self->latency_router);
+    self->latency_router = NULL;
+    adaptive_policy_destroy(self->adaptive_policy);
+    self->adaptive_policy = NULL;
+    command_limiter_destroy(self->command_limiter);
+    self->command_limiter = NULL;
 
     if (PyArg_ParseTupleAndKeywords(args, kwds, "O:client", kwlist,
                                     &py_config) == false) {
@@ -707,12 +787,11 @@ static int AerospikeClient_Type_Init(AerospikeClient *self, PyObject *args,
 
         PyObject *py_shm_cluster_key = PyDict_GetItemString(py_shm, "shm_key");
         if (py_shm_cluster_key && PyLong_Check(py_shm_cluster_key)) {
-            user_shm_key = true;
+            self->user_shm_key = true;
             config.shm_key = PyLong_AsLong(py_shm_cluster_key);
         }
     }
 
-    self->is_client_put_serializer = false;
     self->user_serializer_call_info.callback = NULL;
     self->user_deserializer_call_info.callback = NULL;
     PyObject *py_serializer_option =
@@ -738,6 +817,12 @@ static int AerospikeClient_Type_Init(AerospikeClient *self, PyObject *args,
                    sizeof(self->user_deserializer_call_info));
             self->user_deserializer_call_info.callback = py_deserializer;
         }
+        if (PyTuple_Size(py_serializer_option) > 2) {
+            PyObject *py_batch = PyTuple_GetItem(py_serializer_option, 2);
+            bool batch = py_batch && PyObject_IsTrue(py_batch) == 1;
+            self->user_serializer_call_info.batch = batch;
+            self->user_deserializer_call_info.batch = batch;
+        }
     }
 
     as_policies_init(&config.policies);
@@ -975,6 +1060,25 @@ static int AerospikeClient_Type_Init(AerospikeClient *self, PyObject *args,
         }
     }
 
+    // Have the C client hand back list and map bins as raw msgpack, which is
+    // then decoded straight into Python objects. Scan policies have no
+    // deserialize flag, so queries are left alone as well and both keep
+    // decoding through the C client.
+    PyObject *py_direct_cdt_decode =
+        PyDict_GetItemString(py_config, "direct_cdt_decode");
+    if (py_direct_cdt_decode && PyObject_IsTrue(py_direct_cdt_decode)) {
+        self->direct_cdt_decode = true;
+        config.policies.read.deserialize = false;
+        config.policies.operate.deserialize = false;
+        config.policies.batch.deserialize = false;
+    }
+
+    PyObject *py_direct_cdt_encode =
+        PyDict_GetItemString(py_config, "direct_cdt_encode");
+    if (py_direct_cdt_encode) {
+        self->direct_cdt_encode = PyObject_IsTrue(py_direct_cdt_encode);
+    }
+
     //compression_threshold
     PyObject *py_compression_threshold =
         PyDict_GetItemString(py_config, "compression_threshold");
@@ -1044,12 +1148,112 @@ static int AerospikeClient_Type_Init(AerospikeClient *self, PyObject *args,
         as_config_set_user(&config, username, password);
     }
 
+    // Seeds from a cluster snapshot are tried after the configured ones. The
+    // seeds of shared connections key the global host entries, so those are
+    // left alone.
+    PyObject *py_snapshot = PyDict_GetItemString(py_config, "cluster_snapshot");
+    if (py_snapshot && py_snapshot != Py_None &&
+        !self->use_shared_connection &&
+        apply_cluster_snapshot(&config, py_snapshot, &constructor_err) !=
+            AEROSPIKE_OK) {
+        as_config_destroy(&config);
+        raise_exception(&constructor_err);
+        return -1;
+    }
+
+    PyObject *py_read_cache = PyDict_GetItemString(py_config, "read_cache");
+    if (py_read_cache && py_read_cache != Py_None) {
+        self->read_cache = read_cache_new(py_read_cache, &constructor_err);
+        if (!self->read_cache) {
+            as_config_destroy(&config);
+            raise_exception(&constructor_err);
+            return -1;
+        }
+    }
+
+    PyObject *py_coalesce_reads =
+        PyDict_GetItemString(py_config, "coalesce_reads");
+    if (py_coalesce_reads && PyObject_IsTrue(py_coalesce_reads) == 1) {
+        self->py_flights = PyDict_New();
+    }
+
+    PyObject *py_auto_batch = PyDict_GetItemString(py_config, "auto_batch");
+    if (py_auto_batch && py_auto_batch != Py_None) {
+        self->auto_batcher = auto_batcher_new(py_auto_batch, &constructor_err);
+        if (!self->auto_batcher) {
+            as_config_destroy(&config);
+            raise_exception(&constructor_err);
+            return -1;
+        }
+    }
+
+    PyObject *py_hedged_reads = PyDict_GetItemString(py_config, "hedged_reads");
+    if (py_hedged_reads && py_hedged_reads != Py_None) {
+        self->hedged_reader =
+            hedged_reader_new(py_hedged_reads, &constructor_err);
+        if (!self->hedged_reader) {
+            as_config_destroy(&config);
+            raise_exception(&constructor_err);
+            return -1;
+        }
+    }
+
+    PyObject *py_latency_probes =
+        PyDict_GetItemString(py_config, "latency_probes");
+    if (py_latency_probes && py_latency_probes != Py_None) {
+        self->latency_router =
+            latency_router_new(py_latency_probes, &constructor_err);
+        if (!self->latency_router) {
+            as_config_destroy(&config);
+            raise_exception(&constructor_err);
+            return -1;
+        }
+    }
+
+    PyObject *py_adaptive_timeouts =
+        PyDict_GetItemString(py_config, "adaptive_timeouts");
+    PyObject *py_retry_budget = PyDict_GetItemString(py_config, "retry_budget");
+    if (py_adaptive_timeouts == Py_None) {
+        py_adaptive_timeouts = NULL;
+    }
+    if (py_retry_budget == Py_None) {
+        py_retry_budget = NULL;
+    }
+    if (py_adaptive_timeouts || py_retry_budget) {
+        self->adaptive_policy = adaptive_policy_new(
+            py_adaptive_timeouts, py_retry_budget, &constructor_err);
+        if (!self->adaptive_policy) {
+            as_config_destroy(&config);
+            raise_exception(&constructor_err);
+            return -1;
+        }
+    }
+
+    PyObject *py_command_limits =
+        PyDict_GetItemString(py_config, "command_limits");
+    if (py_command_limits && py_command_limits != Py_None) {
+        self->command_limiter =
+            command_limiter_new(py_command_limits, &constructor_err);
+        if (!self->command_limiter) {
+            as_config_destroy(&config);
+            raise_exception(&constructor_err);
+            return -1;
+        }
+    }
+
+    bool lazy_connect = false;
+    PyObject *py_lazy_connect = PyDict_GetItemString(py_config, "lazy_connect");
+    if (py_lazy_connect && PyBool_Check(py_lazy_connect)) {
+        lazy_connect = PyObject_IsTrue(py_lazy_connect);
+    }
+
     self->as = aerospike_new(&config);
 
-    if (AerospikeClientConnect(self) == -1) {
+    if (AerospikeClientConnect(self, lazy_connect) == -1) {
         aerospike_destroy(self->as);
         return -1;
     }
+    AerospikeClient_Fork_Track(self);
 
     return 0;
 
@@ -1225,15 +1429,71 @@ static int set_use_services_alternate(as_config *conf, PyObject *config_dict)
     return INIT_SUCCESS;
 }
 
+static PyObject *AerospikeClient_Type_GetAttro(AerospikeClient *self,
+                                               PyObject *py_name)
+{
+    // is_connected() reports on a lazy connect without waiting for it.
+    if (__atomic_load_n(&self->connect_pending, __ATOMIC_ACQUIRE) &&
+        !(PyUnicode_Check(py_name) &&
+          PyUnicode_CompareWithASCIIString(py_name, "is_connected") == 0) &&
+        AerospikeClient_Await_Connect(self, true) == -1) {
+        return NULL;
+    }
+
+    // First use of a client inherited across fork() connects it again.
+    if (__atomic_load_n(&self->reconnect_after_fork, __ATOMIC_ACQUIRE)) {
+        // Closing it in the child should not connect it first.
+        if (PyUnicode_Check(py_name) &&
+            PyUnicode_CompareWithASCIIString(py_name, "close") == 0) {
+            __atomic_store_n(&self->reconnect_after_fork, false,
+                             __ATOMIC_RELEASE);
+        }
+        else if (AerospikeClient_Reconnect_After_Fork(self) == -1) {
+            return NULL;
+        }
+    }
+
+    return PyObject_GenericGetAttr((PyObject *)self, py_name);
+}
+
 static void AerospikeClient_Type_Dealloc(PyObject *self)
 {
 
     as_error err;
     char *alias_to_search = NULL;
-    PyObject *py_persistent_item = NULL;
-    AerospikeGlobalHosts *global_host = NULL;
     AerospikeClient *client = (AerospikeClient *)self;
 
+    AerospikeClient_Fork_Untrack(client);
+    read_cache_destroy(client->read_cache);
+    Py_CLEAR(client->py_flights);
+    auto_batcher_destroy(client->auto_batcher);
+    client->auto_batcher = NULL;
+    if (client->hedged_reader) {
+        // Reads still running use the aerospike object.
+        Py_BEGIN_ALLOW_THREADS
+        hedged_reader_destroy(client->hedged_reader);
+        Py_END_ALLOW_THREADS
+        client->hedged_reader = NULL;
+    }
+    if (client->latency_router) {
+        Py_BEGIN_ALLOW_THREADS
+        latency_router_destroy(client->latency_router);
+        Py_END_ALLOW_THREADS
+        client->latency_router = NULL;
+    }
+    adaptive_policy_destroy(client->adaptive_policy);
+    client->adaptive_policy = NULL;
+    command_limiter_destroy(client->command_limiter);
+    client->command_limiter = NULL;
+
+    // A lazy connect still running uses the aerospike object.
+    if (client->connect_pending) {
+        Py_BEGIN_ALLOW_THREADS
+        pthread_join(client->connect_thread, NULL);
+        Py_END_ALLOW_THREADS
+        client->connect_pending = false;
+    }
+
     // If the client has never connected
     // It is safe to destroy the aerospike structure
     if (client->as) {
@@ -1247,18 +1507,8 @@ static void AerospikeClient_Type_Dealloc(PyObject *self)
                 // If this client was still connected, deal with the global host object
                 if (client->is_conn_16) {
                     alias_to_search = return_search_string(client->as);
-                    py_persistent_item =
-                        PyDict_GetItemString(py_global_hosts, alias_to_search);
-                    if (py_persistent_item) {
-                        global_host =
-                            (AerospikeGlobalHosts *)py_persistent_item;
-                        // Only modify the global as object if the client points to it
-                        if (client->as == global_host->as) {
-                            close_aerospike_object(client->as, &err,
-                                                   alias_to_search,
-                                                   py_persistent_item, false);
-                        }
-                    }
+                    close_aerospike_object(client->as, &err, alias_to_search);
+                    PyMem_Free(alias_to_search);
                 }
                 // Connection is not shared, so it is safe to destroy the as object
             }
@@ -1270,78 +1520,54 @@ static void AerospikeClient_Type_Dealloc(PyObject *self)
             }
         }
     }
-    self->ob_type->tp_free((PyObject *)self);
+    pthread_mutex_destroy(&client->reconnect_lock);
+    pthread_mutex_destroy(&client->connect_lock);
+    pthread_cond_destroy(&client->connect_cond);
+    PyTypeObject *type = Py_TYPE(self);
+    type->tp_free(self);
+    Py_DECREF(type);
 }
 
 /*******************************************************************************
  * PYTHON TYPE DESCRIPTOR
  ******************************************************************************/
 
-static PyTypeObject AerospikeClient_Type = {
-    PyVarObject_HEAD_INIT(NULL, 0) "aerospike.Client", // tp_name
-    sizeof(AerospikeClient),                           // tp_basicsize
-    0,                                                 // tp_itemsize
-    (destructor)AerospikeClient_Type_Dealloc,          // tp_dealloc
-    0,                                                 // tp_print
-    0,                                                 // tp_getattr
-    0,                                                 // tp_setattr
-    0,                                                 // tp_compare
-    0,                                                 // tp_repr
-    0,                                                 // tp_as_number
-    0,                                                 // tp_as_sequence
-    0,                                                 // tp_as_mapping
-    0,                                                 // tp_hash
-    0,                                                 // tp_call
-    0,                                                 // tp_str
-    0,                                                 // tp_getattro
-    0,                                                 // tp_setattro
-    0,                                                 // tp_as_buffer
-    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
-    // tp_flags
-    "The Client class manages the connections and trasactions against\n"
-    "an Aerospike cluster.\n",
-    // tp_doc
-    0,                            // tp_traverse
-    0,                            // tp_clear
-    0,                            // tp_richcompare
-    0,                            // tp_weaklistoffset
-    0,                            // tp_iter
-    0,                            // tp_iternext
-    AerospikeClient_Type_Methods, // tp_methods
-    0,                            // tp_members
-    0,                            // tp_getset
-    0,                            // tp_base
-    0,                            // tp_dict
-    0,                            // tp_descr_get
-    0,                            // tp_descr_set
-    0,                            // tp_dictoffset
-    (initproc)AerospikeClient_Type_Init,
-    // tp_init
-    0,                        // tp_alloc
-    AerospikeClient_Type_New, // tp_new
-    0,                        // tp_free
-    0,                        // tp_is_gc
-    0                         // tp_bases
-};
+static PyType_Slot AerospikeClient_Type_Slots[] = {
+    {Py_tp_dealloc, (destructor)AerospikeClient_Type_Dealloc},
+    {Py_tp_getattro, (getattrofunc)AerospikeClient_Type_GetAttro},
+    {Py_tp_doc,
+     "The Client class manages the connections and trasactions against\n"
+     "an Aerospike cluster.\n"},
+    {Py_tp_methods, AerospikeClient_Type_Methods},
+    {Py_tp_init, (initproc)AerospikeClient_Type_Init},
+    {Py_tp_new, AerospikeClient_Type_New},
+    {0, NULL}};
+
+static PyType_Spec AerospikeClient_Type_Spec = {
+    .name = "aerospike.Client",
+    .basicsize = sizeof(AerospikeClient),
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+    .slots = AerospikeClient_Type_Slots};
 
 /*******************************************************************************
  * PUBLIC FUNCTIONS
  ******************************************************************************/
 
-PyTypeObject *AerospikeClient_Ready()
+PyTypeObject *AerospikeClient_Ready(PyObject *module)
 {
-    return PyType_Ready(&AerospikeClient_Type) == 0 ? &AerospikeClient_Type
-                                                    : NULL;
+    return Aerospike_New_Type(module, &AerospikeClient_Type_Spec, NULL);
 }
 
 AerospikeClient *AerospikeClient_New(PyObject *parent, PyObject *args,
                                      PyObject *kwds)
 {
-    AerospikeClient *self = (AerospikeClient *)AerospikeClient_Type.tp_new(
-        &AerospikeClient_Type, args, kwds);
+    PyTypeObject *type = Aerospike_State(parent)->client;
+    AerospikeClient *self = (AerospikeClient *)type->tp_new(type, args, kwds);
+    if (!self) {
+        return NULL;
+    }
 
-    int return_code =
-        AerospikeClient_Type.tp_init((PyObject *)self, args, kwds);
+    int return_code = type->tp_init((PyObject *)self, args, kwds);
     if (return_code == 0) {
         return self;
     }
@@ -1355,6 +1581,7 @@ AerospikeClient *AerospikeClient_New(PyObject *parent, PyObject *args,
     raise_exception(&err);
 
 CLEANUP:
-    AerospikeClient_Type.tp_free(self);
+    type->tp_free(self);
+    Py_DECREF(type);
     return NULL;
 }
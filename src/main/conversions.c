@@ -27,6 +27,7 @@
 
 #include <aerospike/as_arraylist.h>
 #include <aerospike/as_hashmap.h>
+#include <aerospike/as_orderedmap.h>
 #include <aerospike/as_list.h>
 #include <aerospike/as_map.h>
 #include <aerospike/as_nil.h>
@@ -45,7 +46,9 @@
 #include "exceptions.h"
 #include "cdt_types.h"
 #include "cdt_operation_utils.h"
+#include "key_object.h"
 #include "key_ordered_dict.h"
+#include "msgpack_conversions.h"
 
 #define PY_KEYT_NAMESPACE 0
 #define PY_KEYT_SET 1
@@ -63,6 +66,10 @@
 #define CDT_CTX_PAD_KEY "pad_key"
 
 static bool requires_int(uint64_t op);
+static as_status do_bins_to_pyobject(AerospikeClient *self, as_error *err,
+                                     const as_record *rec, PyObject **py_bins,
+                                     bool cnvt_list_to_map,
+                                     deferred_values *deferred);
 
 static as_status py_bool_to_as_integer(as_error *err, PyObject *py_bool,
                                        as_integer **target);
@@ -440,6 +447,107 @@ END:
     return err->code;
 }
 
+// creates a python list of n partition_filter dicts that together cover the
+// partitions tracked by parts_status, or all partitions if parts_status == NULL
+// EX: [{"begin": 0, "count": 2048}, {"begin": 2048, "count": 2048}]
+as_status as_partitions_status_split_to_pyobject(
+    as_error *err, const as_partitions_status *parts_status, long n,
+    PyObject **py_list)
+{
+    as_error_reset(err);
+
+    uint16_t range_begin = 0;
+    uint16_t range_count = CLUSTER_NPARTITIONS;
+    if (parts_status) {
+        range_begin = parts_status->part_begin;
+        range_count = parts_status->part_count;
+    }
+
+    if (n < 1 || n > range_count) {
+        return as_error_update(err, AEROSPIKE_ERR_PARAM,
+                               "n must be an int between 1 and %u inclusive",
+                               range_count);
+    }
+
+    PyObject *new_list = PyList_New((Py_ssize_t)n);
+    if (new_list == NULL) {
+        return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                               "failed to create new_list");
+    }
+
+    uint16_t begin = range_begin;
+    for (long i = 0; i < n; i++) {
+        // Spread the remainder over the first ranges so sizes differ by at
+        // most one.
+        uint16_t count = range_count / n + (i < range_count % n ? 1 : 0);
+
+        PyObject *py_filter = Py_BuildValue("{s:H,s:H}", "begin", begin,
+                                            "count", count);
+        if (py_filter == NULL) {
+            as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                            "failed to create partition filter");
+            goto ERROR;
+        }
+        PyList_SET_ITEM(new_list, i, py_filter);
+
+        if (parts_status) {
+            // Carry over progress so each range resumes where the scan/query
+            // left off.
+            as_partitions_status range_status = *parts_status;
+            PyObject *py_parts = NULL;
+
+            // Only done and retry are converted, the partitions of the
+            // range are added below.
+            range_status.part_count = 0;
+            if (as_partitions_status_to_pyobject(err, &range_status,
+                                                 &py_parts) != AEROSPIKE_OK) {
+                goto ERROR;
+            }
+
+            for (uint16_t j = 0; j < count; j++) {
+                const as_partition_status *part =
+                    &parts_status->parts[begin - range_begin + j];
+                PyObject *py_tuple = NULL;
+                if (as_partition_status_to_pyobject(err, part, &py_tuple) !=
+                    AEROSPIKE_OK) {
+                    Py_DECREF(py_parts);
+                    goto ERROR;
+                }
+
+                PyObject *py_id =
+                    PyLong_FromUnsignedLong((unsigned long)part->part_id);
+                int rc = PyDict_SetItem(py_parts, py_id, py_tuple);
+                Py_XDECREF(py_id);
+                Py_DECREF(py_tuple);
+                if (rc != 0) {
+                    as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                                    "failed set item in partition_status");
+                    Py_DECREF(py_parts);
+                    goto ERROR;
+                }
+            }
+
+            int rc = PyDict_SetItemString(py_filter, "partition_status",
+                                          py_parts);
+            Py_DECREF(py_parts);
+            if (rc != 0) {
+                as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                                "failed set partition_status");
+                goto ERROR;
+            }
+        }
+
+        begin += count;
+    }
+
+    *py_list = new_list;
+    return err->code;
+
+ERROR:
+    Py_DECREF(new_list);
+    return err->code;
+}
+
 as_status as_user_to_pyobject(as_error *err, as_user *user,
                               PyObject **py_as_user)
 {
@@ -731,15 +839,7 @@ as_status pyobject_to_map(AerospikeClient *self, as_error *err,
     Py_ssize_t size = PyDict_Size(py_dict);
 
     if (*map == NULL) {
-        int is_pydict_keyordered =
-            PyObject_IsInstance(py_dict, AerospikeKeyOrderedDict_Get_Type());
-        if (PyErr_Occurred()) {
-            return as_error_update(
-                err, AEROSPIKE_ERR_CLIENT,
-                "Unable to check if dictionary is key ordered or not");
-        }
-
-        if (is_pydict_keyordered) {
+        if (AerospikeKeyOrderedDict_Check(py_dict)) {
             *map = (as_map *)as_orderedmap_new((uint32_t)size);
         }
         else {
@@ -829,15 +929,14 @@ as_status pyobject_to_val(AerospikeClient *self, as_error *err,
         *val = (as_val *)as_bytes_new_wrap(b, b_len, false);
     }
     else if (!strcmp(py_obj->ob_type->tp_name, "aerospike.Geospatial")) {
-        PyObject *py_parameter = PyUnicode_FromString("geo_data");
-        PyObject *py_data = PyObject_GenericGetAttr(py_obj, py_parameter);
-        Py_DECREF(py_parameter);
-
-        PyObject *geospatial_dump = AerospikeGeospatial_DoDumps(py_data, err);
+        PyObject *geospatial_dump =
+            AerospikeGeospatial_GetGeoJSON(py_obj, err);
+        if (!geospatial_dump) {
+            return err->code;
+        }
         char *geo_value = PyUnicode_AsUTF8(geospatial_dump);
         char *geo_value_cpy = strdup(geo_value);
 
-        Py_DECREF(py_data);
         Py_DECREF(geospatial_dump);
 
         *val = (as_val *)as_geojson_new(geo_value_cpy, true);
@@ -887,9 +986,9 @@ as_status pyobject_to_val(AerospikeClient *self, as_error *err,
             as_bytes *bytes;
             GET_BYTES_POOL(bytes, static_pool, err);
             if (err->code == AEROSPIKE_OK) {
-                if (serialize_based_on_serializer_policy(self, serializer_type,
-                                                         &bytes, py_obj,
-                                                         err) != AEROSPIKE_OK) {
+                if (serialize_based_on_serializer_policy(
+                        self, serializer_type, &bytes, py_obj, static_pool,
+                        err) != AEROSPIKE_OK) {
                     return err->code;
                 }
                 *val = (as_val *)bytes;
@@ -907,7 +1006,8 @@ as_status pyobject_to_val(AerospikeClient *self, as_error *err,
 as_status pyobject_to_record(AerospikeClient *self, as_error *err,
                              PyObject *py_rec, PyObject *py_meta,
                              as_record *rec, int serializer_type,
-                             as_static_pool *static_pool)
+                             as_static_pool *static_pool,
+                             deferred_values *deferred)
 {
     as_error_reset(err);
 
@@ -986,11 +1086,11 @@ as_status pyobject_to_record(AerospikeClient *self, as_error *err,
                 ret_val = as_record_set_int64(rec, name, val);
             }
             else if (!strcmp(value->ob_type->tp_name, "aerospike.Geospatial")) {
-                PyObject *py_geo_string = PyUnicode_FromString("geo_data");
-                PyObject *py_data =
-                    PyObject_GenericGetAttr(value, py_geo_string);
-                Py_DECREF(py_geo_string);
-                PyObject *py_dumps = AerospikeGeospatial_DoDumps(py_data, err);
+                PyObject *py_dumps =
+                    AerospikeGeospatial_GetGeoJSON(value, err);
+                if (!py_dumps) {
+                    return err->code;
+                }
                 PyObject *py_ustr = NULL;
                 char *geo_value = NULL;
 
@@ -1012,7 +1112,6 @@ as_status pyobject_to_record(AerospikeClient *self, as_error *err,
                 if (py_ustr != NULL) {
                     Py_DECREF(py_ustr);
                 }
-                Py_DECREF(py_data);
                 Py_DECREF(py_dumps);
             }
             else if (PyUnicode_Check(value)) {
@@ -1044,6 +1143,17 @@ as_status pyobject_to_record(AerospikeClient *self, as_error *err,
 
                 ret_val = as_record_set_bytes(rec, name, bytes);
             }
+            else if (self->direct_cdt_encode &&
+                     (PyList_Check(value) || PyDict_Check(value))) {
+                // Pack straight to msgpack, skipping the as_val tree.
+                as_bytes *bytes = NULL;
+                pyobject_to_msgpack_bytes(self, err, value, &bytes, static_pool,
+                                          serializer_type);
+                if (err->code != AEROSPIKE_OK) {
+                    break;
+                }
+                ret_val = as_record_set_bytes(rec, name, bytes);
+            }
             else if (PyList_Check(value)) {
                 // as_list
                 as_list *list = NULL;
@@ -1072,13 +1182,20 @@ as_status pyobject_to_record(AerospikeClient *self, as_error *err,
                     double val = PyFloat_AsDouble(value);
                     ret_val = as_record_set_double(rec, name, val);
                 }
+                else if (deferred &&
+                         deferred_values_add_value(self, deferred,
+                                                   serializer_type, value,
+                                                   key)) {
+                    // Added by deferred_values_serialize().
+                    continue;
+                }
                 else {
                     as_bytes *bytes;
                     GET_BYTES_POOL(bytes, static_pool, err);
                     if (err->code == AEROSPIKE_OK) {
                         if (serialize_based_on_serializer_policy(
-                                self, serializer_type, &bytes, value, err) !=
-                            AEROSPIKE_OK) {
+                                self, serializer_type, &bytes, value,
+                                static_pool, err) != AEROSPIKE_OK) {
                             return err->code;
                         }
                         ret_val = as_record_set_bytes(rec, name, bytes);
@@ -1151,10 +1268,79 @@ as_status pyobject_to_record(AerospikeClient *self, as_error *err,
     return err->code;
 }
 
-as_status pyobject_to_key(as_error *err, PyObject *py_keytuple, as_key *key)
+/*
+ * An aerospike.Key is a tuple subclass, so it cannot hold an as_key of its
+ * own. Its items were checked and its digest computed when it was created,
+ * though, so they are used as they are: the namespace, set and key strings
+ * come from the UTF-8 the str objects cache, and the digest is copied rather
+ * than computed again.
+ */
+static as_status key_object_to_key(as_error *err, PyObject *py_keyobj,
+                                   as_key *key)
+{
+    PyObject *py_ns = PyTuple_GET_ITEM(py_keyobj, 0);
+    PyObject *py_set = PyTuple_GET_ITEM(py_keyobj, 1);
+    PyObject *py_key = PyTuple_GET_ITEM(py_keyobj, 2);
+    PyObject *py_digest = PyTuple_GET_ITEM(py_keyobj, 3);
+
+    const char *ns = PyUnicode_AsUTF8(py_ns);
+    const char *set = py_set == Py_None ? NULL : PyUnicode_AsUTF8(py_set);
+    if (!ns || (py_set != Py_None && !set)) {
+        PyErr_Clear();
+        return as_error_update(err, AEROSPIKE_ERR_PARAM, "key is invalid");
+    }
+
+    as_key *result = NULL;
+    if (py_key == Py_None) {
+        result = as_key_init_digest(key, ns, set,
+                                    (uint8_t *)PyBytes_AS_STRING(py_digest));
+    }
+    else if (PyUnicode_Check(py_key) || PyBytes_Check(py_key)) {
+        const char *k = PyUnicode_Check(py_key) ? PyUnicode_AsUTF8(py_key)
+                                                : PyBytes_AS_STRING(py_key);
+        char *copy = k ? strdup(k) : NULL;
+        if (copy) {
+            // as_key_destroy() frees the copy.
+            result = as_key_init_strp(key, ns, set, copy, true);
+        }
+        PyErr_Clear();
+    }
+    else if (PyLong_Check(py_key)) {
+        int64_t k = (int64_t)PyLong_AsLongLong(py_key);
+        if (k == -1 && PyErr_Occurred()) {
+            PyErr_Clear();
+            return as_error_update(err, AEROSPIKE_ERR_PARAM,
+                                   "integer value for KEY exceeds sys.maxsize");
+        }
+        result = as_key_init_int64(key, ns, set, k);
+    }
+    else if (PyByteArray_Check(py_key) && PyByteArray_GET_SIZE(py_key) > 0) {
+        result = as_key_init_raw(key, ns, set,
+                                 (uint8_t *)PyByteArray_AS_STRING(py_key),
+                                 (uint32_t)PyByteArray_GET_SIZE(py_key));
+    }
+
+    if (!result) {
+        return as_error_update(err, AEROSPIKE_ERR_PARAM, "key is invalid");
+    }
+
+    // So the C client does not hash the key again.
+    memcpy(key->digest.value, PyBytes_AS_STRING(py_digest),
+           AS_DIGEST_VALUE_SIZE);
+    key->digest.init = true;
+    return err->code;
+}
+
+as_status pyobject_to_key(AerospikeClient *self, as_error *err,
+                          PyObject *py_keytuple, as_key *key)
 {
     as_error_reset(err);
 
+    if (py_keytuple && AerospikeKey_Check(self ? self->state : NULL,
+                                          py_keytuple)) {
+        return key_object_to_key(err, py_keytuple, key);
+    }
+
     Py_ssize_t size = 0;
     PyObject *py_ns = NULL;
     PyObject *py_set = NULL;
@@ -1296,6 +1482,8 @@ typedef struct {
     uint32_t count;
     AerospikeClient *client;
     void *udata;
+    // Where bin values for a batch deserializer are set aside, or NULL.
+    deferred_values *deferred;
 } conversion_data;
 
 as_status do_val_to_pyobject(AerospikeClient *self, as_error *err,
@@ -1405,16 +1593,7 @@ as_status do_val_to_pyobject(AerospikeClient *self, as_error *err,
     case AS_GEOJSON: {
         as_geojson *gp = as_geojson_fromval(val);
         char *locstr = as_geojson_get(gp);
-        PyObject *py_locstr = PyUnicode_FromString(locstr);
-        PyObject *py_loads = AerospikeGeospatial_DoLoads(py_locstr, err);
-        Py_DECREF(py_locstr);
-        if (err->code != AEROSPIKE_OK) {
-            break;
-        }
-        *py_val = AerospikeGeospatial_New(err, py_loads);
-        if (py_loads) {
-            Py_DECREF(py_loads);
-        }
+        geojson_to_pyobject(err, locstr, strlen(locstr), py_val);
         break;
     }
     default: {
@@ -1426,6 +1605,26 @@ as_status do_val_to_pyobject(AerospikeClient *self, as_error *err,
     return err->code;
 }
 
+/*
+ * Converts a GeoJSON string read from the server into an aerospike.GeoJSON
+ * object.
+ */
+as_status geojson_to_pyobject(as_error *err, const char *locstr,
+                              Py_ssize_t len, PyObject **py_geo)
+{
+    PyObject *py_locstr = PyUnicode_FromStringAndSize(locstr, len);
+    if (!py_locstr) {
+        return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                               "Unable to decode GeoJSON string");
+    }
+
+    // Parsing is deferred until the geo_data is actually used.
+    *py_geo = AerospikeGeospatial_NewFromGeoJSON(err, py_locstr);
+    Py_DECREF(py_locstr);
+
+    return err->code;
+}
+
 as_status val_to_pyobject(AerospikeClient *self, as_error *err,
                           const as_val *val, PyObject **py_val)
 {
@@ -1525,6 +1724,32 @@ static bool list_to_pyobject_each(as_val *val, void *udata)
     return true;
 }
 
+/*
+ * Fills a preallocated python list straight from the element array of an
+ * as_arraylist, which is what the C client unpacks every list bin into.
+ */
+static as_status arraylist_to_pyobject(AerospikeClient *self, as_error *err,
+                                       const as_arraylist *list,
+                                       PyObject *py_list)
+{
+    for (uint32_t i = 0; i < list->size; i++) {
+        as_val *val = list->elements[i];
+        if (!val) {
+            return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                                   "Null object found in returned list");
+        }
+
+        PyObject *py_val = NULL;
+        if (val_to_pyobject(self, err, val, &py_val) != AEROSPIKE_OK) {
+            return err->code;
+        }
+
+        PyList_SET_ITEM(py_list, i, py_val);
+    }
+
+    return err->code;
+}
+
 as_status list_to_pyobject(AerospikeClient *self, as_error *err,
                            const as_list *list, PyObject **py_list)
 {
@@ -1535,10 +1760,16 @@ as_status list_to_pyobject(AerospikeClient *self, as_error *err,
                                "Failed to allocate memory for list");
     }
 
-    conversion_data convd = {
-        .err = err, .count = 0, .client = self, .udata = *py_list};
+    if (list->hooks == &as_arraylist_list_hooks) {
+        arraylist_to_pyobject(self, err, (const as_arraylist *)list,
+                              *py_list);
+    }
+    else {
+        conversion_data convd = {
+            .err = err, .count = 0, .client = self, .udata = *py_list};
 
-    as_list_foreach(list, list_to_pyobject_each, &convd);
+        as_list_foreach(list, list_to_pyobject_each, &convd);
+    }
 
     if (err->code != AEROSPIKE_OK) {
         Py_CLEAR(*py_list);
@@ -1548,34 +1779,38 @@ as_status list_to_pyobject(AerospikeClient *self, as_error *err,
     return err->code;
 }
 
-static bool map_to_pyobject_each(const as_val *key, const as_val *val,
-                                 void *udata)
+/*
+ * CPython only exposes dict presizing through a private API, so fall back to
+ * an empty dict on versions where it is no longer exported.
+ */
+PyObject *new_presized_dict(Py_ssize_t size)
 {
+#if PY_VERSION_HEX < 0x030D0000
+    return _PyDict_NewPresized(size);
+#else
+    return PyDict_New();
+#endif
+}
 
-    conversion_data *convd = (conversion_data *)udata;
-    as_error *err = convd->err;
-
+static as_status map_entry_to_pyobject(AerospikeClient *self, as_error *err,
+                                       PyObject *py_dict, const as_val *key,
+                                       const as_val *val)
+{
     if (!key || !val) {
-        as_error_update(err, AEROSPIKE_ERR_CLIENT,
-                        "Received null key or value");
-        return false;
+        return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                               "Received null key or value");
     }
 
-    PyObject *py_dict = (PyObject *)convd->udata;
-
     PyObject *py_key = NULL;
-    val_to_pyobject(convd->client, convd->err, key, &py_key);
-
+    val_to_pyobject(self, err, key, &py_key);
     if (err->code != AEROSPIKE_OK) {
-        return false;
+        return err->code;
     }
 
     PyObject *py_val = NULL;
-    val_to_pyobject(convd->client, convd->err, val, &py_val);
-
-    if (err->code != AEROSPIKE_OK) {
+    if (val_to_pyobject(self, err, val, &py_val) != AEROSPIKE_OK) {
         Py_DECREF(py_key);
-        return false;
+        return err->code;
     }
 
     /* We failed to set a dictionary item. This is probably
@@ -1591,32 +1826,70 @@ static bool map_to_pyobject_each(const as_val *key, const as_val *val,
             as_error_update(err, AEROSPIKE_ERR_CLIENT,
                             "Unable to add dictionary item");
         }
-        Py_CLEAR(py_key);
-        Py_CLEAR(py_val);
-        return false;
     }
 
     Py_DECREF(py_key);
     Py_DECREF(py_val);
 
+    return err->code;
+}
+
+static bool map_to_pyobject_each(const as_val *key, const as_val *val,
+                                 void *udata)
+{
+    conversion_data *convd = (conversion_data *)udata;
+
+    if (map_entry_to_pyobject(convd->client, convd->err,
+                              (PyObject *)convd->udata, key,
+                              val) != AEROSPIKE_OK) {
+        return false;
+    }
+
     convd->count++;
     return true;
 }
 
+/*
+ * Walks the sorted entry table of an as_orderedmap directly. Entries that are
+ * still held for a deferred merge are only visible through as_map_foreach(),
+ * so those maps are left to the generic path.
+ */
+static as_status orderedmap_to_pyobject(AerospikeClient *self, as_error *err,
+                                        const as_orderedmap *map,
+                                        PyObject *py_dict)
+{
+    for (uint32_t i = 0; i < map->count; i++) {
+        const map_entry *entry = &map->table[i];
+        if (map_entry_to_pyobject(self, err, py_dict, entry->key,
+                                  entry->value) != AEROSPIKE_OK) {
+            break;
+        }
+    }
+
+    return err->code;
+}
+
 as_status map_to_pyobject(AerospikeClient *self, as_error *err,
                           const as_map *map, PyObject **py_map)
 {
-    *py_map = PyDict_New();
+    *py_map = new_presized_dict((Py_ssize_t)as_map_size((as_map *)map));
 
     if (!*py_map) {
         return as_error_update(err, AEROSPIKE_ERR_CLIENT,
                                "Failed to allocate memory for dictionary.");
     }
 
-    conversion_data convd = {
-        .err = err, .count = 0, .client = self, .udata = *py_map};
+    if (map->hooks == &as_orderedmap_map_hooks &&
+        ((const as_orderedmap *)map)->hold_count == 0) {
+        orderedmap_to_pyobject(self, err, (const as_orderedmap *)map,
+                               *py_map);
+    }
+    else {
+        conversion_data convd = {
+            .err = err, .count = 0, .client = self, .udata = *py_map};
 
-    as_map_foreach(map, map_to_pyobject_each, &convd);
+        as_map_foreach(map, map_to_pyobject_each, &convd);
+    }
 
     if (err->code != AEROSPIKE_OK) {
         Py_DECREF(*py_map);
@@ -1628,7 +1901,8 @@ as_status map_to_pyobject(AerospikeClient *self, as_error *err,
 
 as_status do_record_to_pyobject(AerospikeClient *self, as_error *err,
                                 const as_record *rec, const as_key *key,
-                                PyObject **obj, bool cnvt_list_to_map)
+                                PyObject **obj, bool cnvt_list_to_map,
+                                deferred_values *deferred)
 {
     as_error_reset(err);
     *obj = NULL;
@@ -1642,7 +1916,7 @@ as_status do_record_to_pyobject(AerospikeClient *self, as_error *err,
     PyObject *py_rec_meta = NULL;
     PyObject *py_rec_bins = NULL;
 
-    if (key_to_pyobject(err, key ? key : &rec->key, &py_rec_key) !=
+    if (key_to_pyobject(self, err, key ? key : &rec->key, &py_rec_key) !=
         AEROSPIKE_OK) {
         return err->code;
     }
@@ -1652,8 +1926,8 @@ as_status do_record_to_pyobject(AerospikeClient *self, as_error *err,
         return err->code;
     }
 
-    if (bins_to_pyobject(self, err, rec, &py_rec_bins, cnvt_list_to_map) !=
-        AEROSPIKE_OK) {
+    if (do_bins_to_pyobject(self, err, rec, &py_rec_bins, cnvt_list_to_map,
+                            deferred) != AEROSPIKE_OK) {
         Py_CLEAR(py_rec_key);
         Py_CLEAR(py_rec_meta);
         return err->code;
@@ -1724,11 +1998,123 @@ as_status record_to_resultpyobject(AerospikeClient *self, as_error *err,
     return err->code;
 }
 
+/*
+ * Copies a value read from the server, so that changes made to one copy are
+ * not seen through another. The containers records are built from are copied
+ * here; anything else mutable, such as the result of a deserializer, goes
+ * through copy.deepcopy().
+ */
+static PyObject *value_deep_copy(AerospikeClient *self, PyObject *py_value)
+{
+    if (py_value == Py_None || PyLong_CheckExact(py_value) ||
+        PyFloat_CheckExact(py_value) || PyUnicode_CheckExact(py_value) ||
+        PyBytes_CheckExact(py_value) || PyBool_Check(py_value)) {
+        Py_INCREF(py_value);
+        return py_value;
+    }
+
+    // Keys are immutable unless made from a bytearray.
+    if (AerospikeKey_Check(self->state, py_value)) {
+        bool immutable = true;
+        for (Py_ssize_t i = 0; i < PyTuple_GET_SIZE(py_value); i++) {
+            immutable &= !PyByteArray_Check(PyTuple_GET_ITEM(py_value, i));
+        }
+        if (immutable) {
+            Py_INCREF(py_value);
+            return py_value;
+        }
+    }
+
+    if (PyByteArray_CheckExact(py_value)) {
+        return PyByteArray_FromStringAndSize(PyByteArray_AS_STRING(py_value),
+                                             PyByteArray_GET_SIZE(py_value));
+    }
+
+    if (PyList_CheckExact(py_value)) {
+        Py_ssize_t size = PyList_GET_SIZE(py_value);
+        PyObject *py_copy = PyList_New(size);
+        for (Py_ssize_t i = 0; py_copy && i < size; i++) {
+            PyObject *py_item =
+                value_deep_copy(self, PyList_GET_ITEM(py_value, i));
+            if (!py_item) {
+                Py_CLEAR(py_copy);
+                break;
+            }
+            PyList_SET_ITEM(py_copy, i, py_item);
+        }
+        return py_copy;
+    }
+
+    if (PyTuple_CheckExact(py_value)) {
+        Py_ssize_t size = PyTuple_GET_SIZE(py_value);
+        PyObject *py_copy = PyTuple_New(size);
+        for (Py_ssize_t i = 0; py_copy && i < size; i++) {
+            PyObject *py_item =
+                value_deep_copy(self, PyTuple_GET_ITEM(py_value, i));
+            if (!py_item) {
+                Py_CLEAR(py_copy);
+                break;
+            }
+            PyTuple_SET_ITEM(py_copy, i, py_item);
+        }
+        return py_copy;
+    }
+
+    if (PyDict_CheckExact(py_value)) {
+        PyObject *py_copy = PyDict_New();
+        PyObject *py_key = NULL;
+        PyObject *py_item = NULL;
+        Py_ssize_t pos = 0;
+        while (py_copy && PyDict_Next(py_value, &pos, &py_key, &py_item)) {
+            // Map keys are immutable, or they could not be dict keys.
+            PyObject *py_item_copy = value_deep_copy(self, py_item);
+            if (!py_item_copy ||
+                PyDict_SetItem(py_copy, py_key, py_item_copy) != 0) {
+                Py_XDECREF(py_item_copy);
+                Py_CLEAR(py_copy);
+                break;
+            }
+            Py_DECREF(py_item_copy);
+        }
+        return py_copy;
+    }
+
+    PyObject *py_copy_module = PyImport_ImportModule("copy");
+    if (!py_copy_module) {
+        return NULL;
+    }
+    PyObject *py_copy =
+        PyObject_CallMethod(py_copy_module, "deepcopy", "O", py_value);
+    Py_DECREF(py_copy_module);
+    return py_copy;
+}
+
+/*
+ * Copies a (key, meta, bins) record tuple, bin values included, so the copy
+ * can be handed out while the original is kept.
+ */
+PyObject *record_tuple_copy(AerospikeClient *self, PyObject *py_rec)
+{
+    if (!PyTuple_CheckExact(py_rec)) {
+        Py_INCREF(py_rec);
+        return py_rec;
+    }
+    return value_deep_copy(self, py_rec);
+}
+
 as_status record_to_pyobject(AerospikeClient *self, as_error *err,
                              const as_record *rec, const as_key *key,
                              PyObject **obj)
 {
-    return do_record_to_pyobject(self, err, rec, key, obj, false);
+    return do_record_to_pyobject(self, err, rec, key, obj, false, NULL);
+}
+
+as_status record_to_pyobject_deferred(AerospikeClient *self, as_error *err,
+                                      const as_record *rec, const as_key *key,
+                                      deferred_values *deferred,
+                                      PyObject **obj)
+{
+    return do_record_to_pyobject(self, err, rec, key, obj, false, deferred);
 }
 
 as_status record_to_pyobject_cnvt_list_to_map(AerospikeClient *self,
@@ -1736,10 +2122,11 @@ as_status record_to_pyobject_cnvt_list_to_map(AerospikeClient *self,
                                               const as_record *rec,
                                               const as_key *key, PyObject **obj)
 {
-    return do_record_to_pyobject(self, err, rec, key, obj, true);
+    return do_record_to_pyobject(self, err, rec, key, obj, true, NULL);
 }
 
-as_status key_to_pyobject(as_error *err, const as_key *key, PyObject **obj)
+as_status key_to_pyobject(AerospikeClient *self, as_error *err,
+                          const as_key *key, PyObject **obj)
 {
     as_error_reset(err);
 
@@ -1806,11 +2193,6 @@ as_status key_to_pyobject(as_error *err, const as_key *key, PyObject **obj)
         }
     }
 
-    if (key->digest.init) {
-        py_digest = PyByteArray_FromStringAndSize((char *)key->digest.value,
-                                                  AS_DIGEST_VALUE_SIZE);
-    }
-
     if (!py_namespace) {
         Py_INCREF(Py_None);
         py_namespace = Py_None;
@@ -1826,11 +2208,23 @@ as_status key_to_pyobject(as_error *err, const as_key *key, PyObject **obj)
         py_key = Py_None;
     }
 
-    if (!py_digest) {
-        Py_INCREF(Py_None);
-        py_digest = Py_None;
+    if (key->digest.init) {
+        // Returned keys can be passed back in without hashing them again.
+        *obj = AerospikeKey_New(self->state, py_namespace, py_set, py_key,
+                                &key->digest);
+        Py_DECREF(py_namespace);
+        Py_DECREF(py_set);
+        Py_DECREF(py_key);
+        if (!*obj) {
+            PyErr_Clear();
+            as_error_update(err, AEROSPIKE_ERR_CLIENT, "Unable to create key");
+        }
+        return err->code;
     }
 
+    Py_INCREF(Py_None);
+    py_digest = Py_None;
+
     PyObject *py_keyobj = PyTuple_New(4);
     PyTuple_SetItem(py_keyobj, PY_KEYT_NAMESPACE, py_namespace);
     PyTuple_SetItem(py_keyobj, PY_KEYT_SET, py_set);
@@ -1851,12 +2245,15 @@ static bool do_bins_to_pyobject_each(const char *name, const as_val *val,
     conversion_data *convd = (conversion_data *)udata;
     as_error *err = convd->err;
     PyObject *py_bins = (PyObject *)convd->udata;
-    PyObject *py_val = NULL;
+    // A value set aside holds its raw bytes until the batch deserializer has
+    // run.
+    PyObject *py_val =
+        deferred_values_add_bytes(convd->deferred, val, py_bins, name);
 
-    if (cnvt_list_to_map) {
+    if (!py_val && cnvt_list_to_map) {
         val_to_pyobject_cnvt_list_to_map(convd->client, err, val, &py_val);
     }
-    else {
+    else if (!py_val) {
         val_to_pyobject(convd->client, err, val, &py_val);
     }
 
@@ -1885,9 +2282,10 @@ static bool bins_to_pyobject_each(const char *name, const as_val *val,
     return do_bins_to_pyobject_each(name, val, udata, false);
 }
 
-as_status bins_to_pyobject(AerospikeClient *self, as_error *err,
-                           const as_record *rec, PyObject **py_bins,
-                           bool cnvt_list_to_map)
+static as_status do_bins_to_pyobject(AerospikeClient *self, as_error *err,
+                                     const as_record *rec, PyObject **py_bins,
+                                     bool cnvt_list_to_map,
+                                     deferred_values *deferred)
 {
     as_error_reset(err);
 
@@ -1898,8 +2296,11 @@ as_status bins_to_pyobject(AerospikeClient *self, as_error *err,
 
     *py_bins = PyDict_New();
 
-    conversion_data convd = {
-        .err = err, .count = 0, .client = self, .udata = *py_bins};
+    conversion_data convd = {.err = err,
+                             .count = 0,
+                             .client = self,
+                             .udata = *py_bins,
+                             .deferred = deferred};
 
     as_record_foreach(rec,
                       cnvt_list_to_map ? bins_to_pyobject_each_cnvt_list_to_map
@@ -1914,6 +2315,14 @@ as_status bins_to_pyobject(AerospikeClient *self, as_error *err,
     return err->code;
 }
 
+as_status bins_to_pyobject(AerospikeClient *self, as_error *err,
+                           const as_record *rec, PyObject **py_bins,
+                           bool cnvt_list_to_map)
+{
+    return do_bins_to_pyobject(self, err, rec, py_bins, cnvt_list_to_map,
+                               NULL);
+}
+
 /*
  * operate_bins_to_pyobject
  *
@@ -2072,8 +2481,11 @@ void initialize_bin_for_strictypes(AerospikeClient *self, as_error *err,
         binop_bin->valuep = (as_bin_value *)map;
     }
     else if (!strcmp(py_value->ob_type->tp_name, "aerospike.Geospatial")) {
-        PyObject *geo_data = PyObject_GetAttrString(py_value, "geo_data");
-        PyObject *geo_data_py_str = AerospikeGeospatial_DoDumps(geo_data, err);
+        PyObject *geo_data_py_str =
+            AerospikeGeospatial_GetGeoJSON(py_value, err);
+        if (!geo_data_py_str) {
+            return;
+        }
         const char *geo_data_str = PyUnicode_AsUTF8(geo_data_py_str);
 
         // Make a copy of the encoding since the utf8 encoding points to a buffer in the PyUnicode object
@@ -2086,7 +2498,6 @@ void initialize_bin_for_strictypes(AerospikeClient *self, as_error *err,
 
         // Cleanup
         Py_XDECREF(geo_data_py_str);
-        Py_XDECREF(geo_data);
     }
     else if (!strcmp(py_value->ob_type->tp_name, "aerospike.null")) {
         ((as_val *)&binop_bin->value)->type = AS_UNKNOWN;
@@ -2096,7 +2507,7 @@ void initialize_bin_for_strictypes(AerospikeClient *self, as_error *err,
         as_bytes *bytes;
         GET_BYTES_POOL(bytes, static_pool, err);
         serialize_based_on_serializer_policy(self, SERIALIZER_PYTHON, &bytes,
-                                             py_value, err);
+                                             py_value, NULL, err);
         as_bytes_init_wrap((as_bytes *)&binop_bin->value, bytes->value,
                            bytes->size, true);
         binop_bin->valuep = &binop_bin->value;
@@ -2105,7 +2516,7 @@ void initialize_bin_for_strictypes(AerospikeClient *self, as_error *err,
         as_bytes *bytes;
         GET_BYTES_POOL(bytes, static_pool, err);
         serialize_based_on_serializer_policy(self, SERIALIZER_PYTHON, &bytes,
-                                             py_value, err);
+                                             py_value, NULL, err);
         ((as_val *)&binop_bin->value)->type = AS_UNKNOWN;
         binop_bin->valuep = (as_bin_value *)bytes;
     }
@@ -2258,7 +2669,7 @@ as_status as_batch_read_results_to_pyobject(as_error *err,
             /* The record wasn't found, build a (key, None, None) tuple */
         }
         else {
-            key_to_pyobject(err, results[i].key, &py_key);
+            key_to_pyobject(client, err, results[i].key, &py_key);
             if (!py_key || err->code != AEROSPIKE_OK) {
                 Py_XDECREF(temp_py_recs);
                 return err->code;
@@ -2291,6 +2702,7 @@ as_status as_batch_read_results_to_pyobject(as_error *err,
 
 as_status batch_read_records_to_pyobject(AerospikeClient *self, as_error *err,
                                          as_batch_read_records *records,
+                                         deferred_values *deferred,
                                          PyObject **py_recs)
 {
     *py_recs = PyList_New(0);
@@ -2308,7 +2720,8 @@ as_status batch_read_records_to_pyobject(AerospikeClient *self, as_error *err,
 
         /* There should be a record, so convert it to a tuple */
         if (batch->result == AEROSPIKE_OK) {
-            record_to_pyobject(self, err, &batch->record, &batch->key, &py_rec);
+            record_to_pyobject_deferred(self, err, &batch->record,
+                                        &batch->key, deferred, &py_rec);
             if (!py_rec || err->code != AEROSPIKE_OK) {
                 Py_CLEAR(*py_recs);
                 return err->code;
@@ -2316,7 +2729,7 @@ as_status batch_read_records_to_pyobject(AerospikeClient *self, as_error *err,
             /* No record, convert to (key, None, None) */
         }
         else {
-            key_to_pyobject(err, &batch->key, &py_key);
+            key_to_pyobject(self, err, &batch->key, &py_key);
             if (!py_key || err->code != AEROSPIKE_OK) {
                 Py_CLEAR(*py_recs);
                 return err->code;
@@ -2594,7 +3007,8 @@ as_status get_int_from_py_int(as_error *err, PyObject *py_long,
 as_status as_batch_result_to_BatchRecord(AerospikeClient *self, as_error *err,
                                          as_batch_result *bres,
                                          PyObject *py_batch_record,
-                                         bool checking_if_records_exist)
+                                         bool checking_if_records_exist,
+                                         deferred_values *deferred)
 {
     as_status *result_code = &(bres->result);
     as_record *result_rec = &(bres->record);
@@ -2612,13 +3026,14 @@ as_status as_batch_result_to_BatchRecord(AerospikeClient *self, as_error *err,
     if (*result_code == AEROSPIKE_OK) {
         PyObject *rec = NULL;
         if (!checking_if_records_exist) {
-            record_to_pyobject(self, err, result_rec, bres->key, &rec);
+            record_to_pyobject_deferred(self, err, result_rec, bres->key,
+                                        deferred, &rec);
         }
         else {
             PyObject *py_result_key = NULL;
             PyObject *py_result_meta = NULL;
 
-            key_to_pyobject(err, bres->key, &py_result_key);
+            key_to_pyobject(self, err, bres->key, &py_result_key);
             metadata_to_pyobject(err, &(bres->record), &py_result_meta);
 
             rec = PyTuple_New(2);
@@ -497,22 +497,31 @@ get_exp_val_from_pyval(AerospikeClient *self, as_static_pool *static_pool,
         *new_entry = tmp_entry;
     }
     else if (!strcmp(py_obj->ob_type->tp_name, "aerospike.Geospatial")) {
-        PyObject *py_parameter = PyUnicode_FromString("geo_data");
-        PyObject *py_data = PyObject_GenericGetAttr(py_obj, py_parameter);
-        Py_DECREF(py_parameter);
-        char *geo_value =
-            (char *)PyUnicode_AsUTF8(AerospikeGeospatial_DoDumps(py_data, err));
-        Py_DECREF(py_data);
-        as_exp_entry tmp_entry = as_exp_geo(geo_value);
+        PyObject *py_geojson = AerospikeGeospatial_GetGeoJSON(py_obj, err);
+        if (!py_geojson) {
+            return err->code;
+        }
+        const char *geo_value = PyUnicode_AsUTF8(py_geojson);
+        if (!geo_value) {
+            Py_DECREF(py_geojson);
+            PyErr_Clear();
+            return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                                   "Unable to get GeoJSON string");
+        }
+        // The entry borrows the string until the expression is compiled.
+        temp_expr->val.val_string_p = strdup(geo_value);
+        temp_expr->val_flag = VAL_STRING_P_ACTIVE;
+        Py_DECREF(py_geojson);
+        as_exp_entry tmp_entry = as_exp_geo(temp_expr->val.val_string_p);
         *new_entry = tmp_entry;
     }
     else if (PyByteArray_Check(py_obj)) {
         as_bytes *bytes;
         GET_BYTES_POOL(bytes, static_pool, err);
         if (err->code == AEROSPIKE_OK) {
-            if (serialize_based_on_serializer_policy(self, serializer_type,
-                                                     &bytes, py_obj,
-                                                     err) != AEROSPIKE_OK) {
+            if (serialize_based_on_serializer_policy(
+                    self, serializer_type, &bytes, py_obj, static_pool, err) !=
+                AEROSPIKE_OK) {
                 return err->code;
             }
             as_exp_entry tmp_entry = as_exp_val(
@@ -570,9 +579,9 @@ get_exp_val_from_pyval(AerospikeClient *self, as_static_pool *static_pool,
             as_bytes *bytes;
             GET_BYTES_POOL(bytes, static_pool, err);
             if (err->code == AEROSPIKE_OK) {
-                if (serialize_based_on_serializer_policy(self, serializer_type,
-                                                         &bytes, py_obj,
-                                                         err) != AEROSPIKE_OK) {
+                if (serialize_based_on_serializer_policy(
+                        self, serializer_type, &bytes, py_obj, static_pool,
+                        err) != AEROSPIKE_OK) {
                     return err->code;
                 }
 
@@ -15,6 +15,7 @@
  ******************************************************************************/
 #include <Python.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #include <aerospike/aerospike_index.h>
 #include <aerospike/aerospike_key.h>
@@ -306,3 +307,202 @@ ERROR_CLEANUP:
 
     return err->code;
 }
+
+/*
+ * Checkpoint format, all integers big endian:
+ *
+ *   "ASPS" | version:u8 | flags:u8 | part_begin:u16 | part_count:u16
+ *   then for each partition:
+ *   flags:u8 | [digest:20 bytes if init] | [bval:u64 if non zero]
+ *
+ * Partition ids are implied by part_begin and the partition's position.
+ */
+#define CHECKPOINT_MAGIC "ASPS"
+#define CHECKPOINT_MAGIC_SIZE 4
+#define CHECKPOINT_VERSION 1
+#define CHECKPOINT_HEADER_SIZE (CHECKPOINT_MAGIC_SIZE + 6)
+
+#define CHECKPOINT_DONE 0x01
+#define CHECKPOINT_RETRY 0x02
+#define CHECKPOINT_DIGEST_INIT 0x04
+#define CHECKPOINT_BVAL 0x08
+
+static uint8_t *checkpoint_put_uint(uint8_t *p, uint64_t value, uint32_t width)
+{
+    for (uint32_t i = width; i > 0; i--) {
+        p[i - 1] = (uint8_t)value;
+        value >>= 8;
+    }
+    return p + width;
+}
+
+static uint64_t checkpoint_get_uint(const uint8_t **p, uint32_t width)
+{
+    uint64_t value = 0;
+    for (uint32_t i = 0; i < width; i++) {
+        value = (value << 8) | (*p)[i];
+    }
+    *p += width;
+    return value;
+}
+
+/*
+* as_partitions_status_to_checkpoint
+* Serializes partition progress into a compact bytes object that can be
+* persisted and later restored with checkpoint_to_as_partitions_status.
+*/
+as_status as_partitions_status_to_checkpoint(
+    as_error *err, const as_partitions_status *parts_all, PyObject **py_bytes)
+{
+    as_error_reset(err);
+
+    if (!parts_all) {
+        return as_error_update(
+            err, AEROSPIKE_ERR_PARAM,
+            "No partition status to checkpoint, paginate() must be called and "
+            "a page read first");
+    }
+
+    size_t size = CHECKPOINT_HEADER_SIZE;
+    for (uint16_t i = 0; i < parts_all->part_count; i++) {
+        const as_partition_status *ps = &parts_all->parts[i];
+        size += 1;
+        size += ps->digest.init ? AS_DIGEST_VALUE_SIZE : 0;
+        size += ps->bval ? sizeof(uint64_t) : 0;
+    }
+
+    PyObject *py_checkpoint = PyBytes_FromStringAndSize(NULL, size);
+    if (!py_checkpoint) {
+        return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                               "Failed to allocate checkpoint");
+    }
+
+    uint8_t *p = (uint8_t *)PyBytes_AS_STRING(py_checkpoint);
+    memcpy(p, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_SIZE);
+    p += CHECKPOINT_MAGIC_SIZE;
+    *p++ = CHECKPOINT_VERSION;
+    *p++ = (parts_all->done ? CHECKPOINT_DONE : 0) |
+           (parts_all->retry ? CHECKPOINT_RETRY : 0);
+    p = checkpoint_put_uint(p, parts_all->part_begin, 2);
+    p = checkpoint_put_uint(p, parts_all->part_count, 2);
+
+    for (uint16_t i = 0; i < parts_all->part_count; i++) {
+        const as_partition_status *ps = &parts_all->parts[i];
+
+        *p++ = (ps->retry ? CHECKPOINT_RETRY : 0) |
+               (ps->digest.init ? CHECKPOINT_DIGEST_INIT : 0) |
+               (ps->bval ? CHECKPOINT_BVAL : 0);
+
+        if (ps->digest.init) {
+            memcpy(p, ps->digest.value, AS_DIGEST_VALUE_SIZE);
+            p += AS_DIGEST_VALUE_SIZE;
+        }
+
+        if (ps->bval) {
+            p = checkpoint_put_uint(p, ps->bval, sizeof(uint64_t));
+        }
+    }
+
+    *py_bytes = py_checkpoint;
+    return err->code;
+}
+
+/*
+* checkpoint_to_as_partitions_status
+* Restores partition progress saved by as_partitions_status_to_checkpoint.
+* The caller owns the returned as_partitions_status.
+*/
+as_status checkpoint_to_as_partitions_status(as_error *err,
+                                             PyObject *py_checkpoint,
+                                             as_partitions_status **pss)
+{
+    as_error_reset(err);
+
+    Py_buffer view;
+    if (PyObject_GetBuffer(py_checkpoint, &view, PyBUF_SIMPLE) != 0) {
+        PyErr_Clear();
+        return as_error_update(err, AEROSPIKE_ERR_PARAM,
+                               "checkpoint must be a bytes-like object");
+    }
+
+    as_partitions_status *parts_all = NULL;
+    const uint8_t *p = view.buf;
+    const uint8_t *end = p + view.len;
+
+    if (view.len < CHECKPOINT_HEADER_SIZE ||
+        memcmp(p, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_SIZE) != 0) {
+        as_error_update(err, AEROSPIKE_ERR_PARAM, "Invalid checkpoint");
+        goto CLEANUP;
+    }
+    p += CHECKPOINT_MAGIC_SIZE;
+
+    uint8_t version = *p++;
+    if (version != CHECKPOINT_VERSION) {
+        as_error_update(err, AEROSPIKE_ERR_PARAM,
+                        "Unsupported checkpoint version %u", version);
+        goto CLEANUP;
+    }
+
+    uint8_t flags = *p++;
+    uint16_t part_begin = (uint16_t)checkpoint_get_uint(&p, 2);
+    uint16_t part_count = (uint16_t)checkpoint_get_uint(&p, 2);
+
+    if (part_count < 1 || part_begin + part_count > CLUSTER_NPARTITIONS) {
+        as_error_update(err, AEROSPIKE_ERR_PARAM,
+                        "Invalid checkpoint partition range, begin: %u "
+                        "count: %u",
+                        part_begin, part_count);
+        goto CLEANUP;
+    }
+
+    parts_all = parts_setup(part_begin, part_count, NULL);
+    parts_all->done = flags & CHECKPOINT_DONE;
+    parts_all->retry = flags & CHECKPOINT_RETRY;
+
+    for (uint16_t i = 0; i < part_count; i++) {
+        as_partition_status *ps = &parts_all->parts[i];
+
+        if (end - p < 1) {
+            goto TRUNCATED;
+        }
+        uint8_t part_flags = *p++;
+        ps->retry = part_flags & CHECKPOINT_RETRY;
+
+        if (part_flags & CHECKPOINT_DIGEST_INIT) {
+            if (end - p < AS_DIGEST_VALUE_SIZE) {
+                goto TRUNCATED;
+            }
+            ps->digest.init = true;
+            memcpy(ps->digest.value, p, AS_DIGEST_VALUE_SIZE);
+            p += AS_DIGEST_VALUE_SIZE;
+        }
+
+        if (part_flags & CHECKPOINT_BVAL) {
+            if (end - p < (ptrdiff_t)sizeof(uint64_t)) {
+                goto TRUNCATED;
+            }
+            ps->bval = checkpoint_get_uint(&p, sizeof(uint64_t));
+        }
+    }
+
+    if (p != end) {
+        as_error_update(err, AEROSPIKE_ERR_PARAM,
+                        "Invalid checkpoint, unexpected trailing data");
+        goto CLEANUP;
+    }
+
+    *pss = parts_all;
+    parts_all = NULL;
+    goto CLEANUP;
+
+TRUNCATED:
+    as_error_update(err, AEROSPIKE_ERR_PARAM, "Invalid checkpoint, truncated");
+
+CLEANUP:
+    if (parts_all) {
+        as_partitions_status_release(parts_all);
+    }
+    PyBuffer_Release(&view);
+
+    return err->code;
+}
@@ -20,13 +20,13 @@
 #include <aerospike/as_status.h>
 
 #include "conversions.h"
+#include <stdbool.h>
 #include <string.h>
 #include <stdlib.h>
 #include "exceptions.h"
 #include "exception_types.h"
 #include "macros.h"
-
-static PyObject *module;
+#include "module_state.h"
 
 PyObject *AerospikeException_New(void)
 {
@@ -38,7 +38,13 @@ PyObject *AerospikeException_New(void)
                                            NULL,
                                            NULL,
                                            NULL};
-    module = PyModule_Create(&moduledef);
+    PyObject *module = PyModule_Create(&moduledef);
+    if (!module) {
+        return NULL;
+    }
+#ifdef Py_GIL_DISABLED
+    PyUnstable_Module_SetGIL(module, Py_MOD_GIL_NOT_USED);
+#endif
 
     struct exceptions exceptions_array;
 
@@ -554,142 +560,102 @@ PyObject *AerospikeException_New(void)
     return module;
 }
 
-void remove_exception(as_error *err)
+/*
+ * Returns a borrowed reference to the exception class for code, from the
+ * aerospike module of the current interpreter. NULL with an exception set if
+ * the module can't be found.
+ */
+static PyObject *get_exception_type(as_status code)
 {
-    PyObject *py_key = NULL, *py_value = NULL;
-    Py_ssize_t pos = 0;
-    PyObject *py_module_dict = PyModule_GetDict(module);
-
-    while (PyDict_Next(py_module_dict, &pos, &py_key, &py_value)) {
-        Py_DECREF(py_value);
+    struct Aerospike_State *state = Aerospike_Get_State();
+    if (!state) {
+        return NULL;
     }
-}
 
-void raise_exception(as_error *err)
-{
     PyObject *py_key = NULL, *py_value = NULL;
     Py_ssize_t pos = 0;
-    PyObject *py_module_dict = PyModule_GetDict(module);
-    bool found = false;
+    PyObject *py_module_dict = PyModule_GetDict(state->exception);
 
     while (PyDict_Next(py_module_dict, &pos, &py_key, &py_value)) {
         if (PyObject_HasAttrString(py_value, "code")) {
             PyObject *py_code = PyObject_GetAttrString(py_value, "code");
-            if (py_code == Py_None) {
-                continue;
-            }
-            if (err->code == PyLong_AsLong(py_code)) {
-                found = true;
-                PyObject *py_attr = NULL;
-                py_attr = PyUnicode_FromString(err->message);
-                PyObject_SetAttrString(py_value, "msg", py_attr);
-                Py_DECREF(py_attr);
-
-                // as_error.file is a char* so this may be null
-                if (err->file) {
-                    py_attr = PyUnicode_FromString(err->file);
-                    PyObject_SetAttrString(py_value, "file", py_attr);
-                    Py_DECREF(py_attr);
-                }
-                else {
-                    PyObject_SetAttrString(py_value, "file", Py_None);
-                }
-                // If the line is 0, set it as None
-                if (err->line > 0) {
-                    py_attr = PyLong_FromLong(err->line);
-                    PyObject_SetAttrString(py_value, "line", py_attr);
-                    Py_DECREF(py_attr);
-                }
-                else {
-                    PyObject_SetAttrString(py_value, "line", Py_None);
-                }
-
-                py_attr = PyBool_FromLong(err->in_doubt);
-                PyObject_SetAttrString(py_value, "in_doubt", py_attr);
-                Py_DECREF(py_attr);
-
-                break;
-            }
+            bool found = py_code != Py_None && code == PyLong_AsLong(py_code);
             Py_DECREF(py_code);
+            if (found) {
+                return py_value;
+            }
         }
     }
     // We haven't found the right exception, just use AerospikeError
-    if (!found) {
-        PyObject *base_exception =
-            PyDict_GetItemString(py_module_dict, "AerospikeError");
-        if (base_exception) {
-            py_value = base_exception;
-        }
+    return PyDict_GetItemString(py_module_dict, "AerospikeError");
+}
+
+static void set_exception_attr(PyObject *py_exc, const char *name,
+                               PyObject *py_value)
+{
+    if (py_value && PyObject_HasAttrString(py_exc, name)) {
+        PyObject_SetAttrString(py_exc, name, py_value);
     }
+}
 
-    // Convert borrowed reference of exception class to strong reference
-    Py_INCREF(py_value);
+static PyObject *new_exception(as_error *err, PyObject *py_key,
+                               PyObject *py_bin, PyObject *py_module,
+                               PyObject *py_func, PyObject *py_name)
+{
+    PyObject *py_type = get_exception_type(err->code);
+    if (!py_type) {
+        return NULL;
+    }
 
     // Convert C error to Python exception
     PyObject *py_err = NULL;
     error_to_pyobject(err, &py_err);
 
-    // Raise exception
-    PyErr_SetObject(py_value, py_err);
+    // The details go on the exception rather than its class, which is
+    // shared by threads raising it concurrently.
+    PyObject *py_exc = PyObject_CallObject(py_type, py_err);
+    if (!py_exc) {
+        Py_DECREF(py_err);
+        return NULL;
+    }
+    // py_err is (code, msg, file, line, in_doubt).
+    PyObject_SetAttrString(py_exc, "msg", PyTuple_GetItem(py_err, 1));
+    PyObject_SetAttrString(py_exc, "file", PyTuple_GetItem(py_err, 2));
+    PyObject_SetAttrString(py_exc, "line", PyTuple_GetItem(py_err, 3));
+    PyObject_SetAttrString(py_exc, "in_doubt", PyTuple_GetItem(py_err, 4));
+    set_exception_attr(py_exc, "key", py_key);
+    set_exception_attr(py_exc, "bin", py_bin);
+    set_exception_attr(py_exc, "module", py_module);
+    set_exception_attr(py_exc, "func", py_func);
+    set_exception_attr(py_exc, "name", py_name);
 
-    Py_DECREF(py_value);
     Py_DECREF(py_err);
+    return py_exc;
 }
 
-PyObject *raise_exception_old(as_error *err)
+PyObject *exception_from_error(as_error *err)
 {
-    PyObject *py_key = NULL, *py_value = NULL;
-    Py_ssize_t pos = 0;
-    PyObject *py_module_dict = PyModule_GetDict(module);
-    bool found = false;
+    return new_exception(err, NULL, NULL, NULL, NULL, NULL);
+}
 
-    while (PyDict_Next(py_module_dict, &pos, &py_key, &py_value)) {
-        if (PyObject_HasAttrString(py_value, "code")) {
-            PyObject *py_code = PyObject_GetAttrString(py_value, "code");
-            if (py_code == Py_None) {
-                continue;
-            }
-            if (err->code == PyLong_AsLong(py_code)) {
-                found = true;
-                PyObject *py_attr = NULL;
-                py_attr = PyUnicode_FromString(err->message);
-                PyObject_SetAttrString(py_value, "msg", py_attr);
-                Py_DECREF(py_attr);
-
-                // as_error.file is a char* so this may be null
-                if (err->file) {
-                    py_attr = PyUnicode_FromString(err->file);
-                    PyObject_SetAttrString(py_value, "file", py_attr);
-                    Py_DECREF(py_attr);
-                }
-                else {
-                    PyObject_SetAttrString(py_value, "file", Py_None);
-                }
-                // If the line is 0, set it as None
-                if (err->line > 0) {
-                    py_attr = PyLong_FromLong(err->line);
-                    PyObject_SetAttrString(py_value, "line", py_attr);
-                    Py_DECREF(py_attr);
-                }
-                else {
-                    PyObject_SetAttrString(py_value, "line", Py_None);
-                }
-
-                PyObject_SetAttrString(py_value, "in_doubt",
-                                       PyBool_FromLong(err->in_doubt));
-
-                break;
-            }
-            Py_DECREF(py_code);
-        }
-    }
-    // We haven't found the right exception, just use AerospikeError
-    if (!found) {
-        PyObject *base_exception =
-            PyDict_GetItemString(py_module_dict, "AerospikeError");
-        if (base_exception) {
-            py_value = base_exception;
-        }
+void raise_exception_base(as_error *err, PyObject *py_key, PyObject *py_bin,
+                          PyObject *py_module, PyObject *py_func,
+                          PyObject *py_name)
+{
+    PyObject *py_exc =
+        new_exception(err, py_key, py_bin, py_module, py_func, py_name);
+    if (!py_exc) {
+        // The error creating the exception, for example a missing aerospike
+        // module, is raised instead.
+        return;
     }
-    return py_value;
+
+    // Raise exception
+    PyErr_SetObject((PyObject *)Py_TYPE(py_exc), py_exc);
+    Py_DECREF(py_exc);
+}
+
+void raise_exception(as_error *err)
+{
+    raise_exception_base(err, NULL, NULL, NULL, NULL, NULL);
 }
@@ -0,0 +1,194 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <stdarg.h>
+#include <stdbool.h>
+
+#include "fastcall.h"
+#include "module_state.h"
+
+// Slots handed out to parsers so far.
+static Py_ssize_t fastcall_slots;
+
+static Py_ssize_t fastcall_count_keywords(fastcall_parser *parser)
+{
+    Py_ssize_t nkeywords =
+        __atomic_load_n(&parser->nkeywords, __ATOMIC_RELAXED);
+    if (nkeywords) {
+        return nkeywords;
+    }
+
+    while (parser->keywords[nkeywords]) {
+        nkeywords++;
+    }
+    // Threads racing here store the same count.
+    __atomic_store_n(&parser->nkeywords, nkeywords, __ATOMIC_RELAXED);
+    return nkeywords;
+}
+
+static Py_ssize_t fastcall_slot(fastcall_parser *parser)
+{
+    Py_ssize_t slot = __atomic_load_n(&parser->slot, __ATOMIC_ACQUIRE);
+    if (slot) {
+        return slot;
+    }
+
+    // A slot lost to a racing thread is wasted, which only matters once
+    // FASTCALL_MAX_PARSERS is reached.
+    Py_ssize_t new_slot =
+        __atomic_add_fetch(&fastcall_slots, 1, __ATOMIC_RELAXED);
+    if (__atomic_compare_exchange_n(&parser->slot, &slot, new_slot, false,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        slot = new_slot;
+    }
+    return slot;
+}
+
+/*
+ * Returns a borrowed tuple of the interned keyword names of parser, kept in
+ * state. NULL, with no exception set, if they cannot be kept, in which case
+ * keywords are compared by value.
+ */
+static PyObject *fastcall_keywords(fastcall_parser *parser,
+                                   struct Aerospike_State *state,
+                                   Py_ssize_t nkeywords)
+{
+    Py_ssize_t slot = fastcall_slot(parser);
+    if (!state || slot > FASTCALL_MAX_PARSERS) {
+        return NULL;
+    }
+
+    PyObject **cached = &state->fastcall_keywords[slot - 1];
+    PyObject *py_keywords = __atomic_load_n(cached, __ATOMIC_ACQUIRE);
+    if (py_keywords) {
+        return py_keywords;
+    }
+
+    py_keywords = PyTuple_New(nkeywords);
+    if (!py_keywords) {
+        PyErr_Clear();
+        return NULL;
+    }
+    for (Py_ssize_t i = 0; i < nkeywords; i++) {
+        PyObject *py_name = PyUnicode_InternFromString(parser->keywords[i]);
+        if (!py_name) {
+            PyErr_Clear();
+            Py_DECREF(py_keywords);
+            return NULL;
+        }
+        PyTuple_SET_ITEM(py_keywords, i, py_name);
+    }
+
+    // Without the GIL another thread may have stored them first.
+    PyObject *py_stored = NULL;
+    if (!__atomic_compare_exchange_n(cached, &py_stored, py_keywords, false,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        Py_DECREF(py_keywords);
+        return py_stored;
+    }
+    return py_keywords;
+}
+
+static Py_ssize_t fastcall_find_keyword(fastcall_parser *parser,
+                                        PyObject *py_keywords,
+                                        Py_ssize_t nkeywords, PyObject *py_name)
+{
+    if (py_keywords) {
+        for (Py_ssize_t i = 0; i < nkeywords; i++) {
+            if (PyTuple_GET_ITEM(py_keywords, i) == py_name) {
+                return i;
+            }
+        }
+    }
+
+    // Keywords built at runtime, e.g. from a ** dict, are not interned.
+    for (Py_ssize_t i = 0; i < nkeywords; i++) {
+        if (PyUnicode_CompareWithASCIIString(py_name, parser->keywords[i]) ==
+            0) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+bool fastcall_parse(fastcall_parser *parser, struct Aerospike_State *state,
+                    PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames,
+                    ...)
+{
+    PyObject *values[FASTCALL_MAX_ARGS] = {NULL};
+    PyObject *py_keywords = NULL;
+
+    Py_ssize_t nkeywords = fastcall_count_keywords(parser);
+    Py_ssize_t nkwargs = kwnames ? PyTuple_GET_SIZE(kwnames) : 0;
+    if (nargs + nkwargs > nkeywords) {
+        PyErr_Format(PyExc_TypeError,
+                     "%s() takes at most %zd argument%s (%zd given)",
+                     parser->fname, nkeywords, nkeywords == 1 ? "" : "s",
+                     nargs + nkwargs);
+        return false;
+    }
+
+    for (Py_ssize_t i = 0; i < nargs; i++) {
+        values[i] = args[i];
+    }
+
+    if (nkwargs) {
+        py_keywords = fastcall_keywords(parser, state, nkeywords);
+    }
+
+    for (Py_ssize_t i = 0; i < nkwargs; i++) {
+        PyObject *py_name = PyTuple_GET_ITEM(kwnames, i);
+        Py_ssize_t pos =
+            fastcall_find_keyword(parser, py_keywords, nkeywords, py_name);
+        if (pos < 0) {
+            PyErr_Format(PyExc_TypeError,
+                         "'%U' is an invalid keyword argument for %s()",
+                         py_name, parser->fname);
+            return false;
+        }
+        if (values[pos]) {
+            PyErr_Format(PyExc_TypeError,
+                         "argument for %s() given by name ('%s') and position "
+                         "(%zd)",
+                         parser->fname, parser->keywords[pos], pos + 1);
+            return false;
+        }
+        values[pos] = args[nargs + i];
+    }
+
+    for (Py_ssize_t i = 0; i < parser->required; i++) {
+        if (!values[i]) {
+            PyErr_Format(PyExc_TypeError,
+                         "%s() missing required argument '%s' (pos %zd)",
+                         parser->fname, parser->keywords[i], i + 1);
+            return false;
+        }
+    }
+
+    va_list outs;
+    va_start(outs, kwnames);
+    for (Py_ssize_t i = 0; i < nkeywords; i++) {
+        PyObject **out = va_arg(outs, PyObject **);
+        if (values[i]) {
+            *out = values[i];
+        }
+    }
+    va_end(outs);
+
+    return true;
+}
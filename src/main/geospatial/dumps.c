@@ -28,7 +28,10 @@
 
 PyObject *AerospikeGeospatial_DoDumps(PyObject *geo_data, as_error *err)
 {
-    PyObject *initresult = NULL;
+    PyObject *initresult = geojson_dumps(geo_data);
+    if (initresult) {
+        return initresult;
+    }
 
     PyObject *sysmodules = PyImport_GetModuleDict();
     PyObject *json_module = NULL;
@@ -70,7 +73,7 @@ PyObject *AerospikeGeospatial_Dumps(AerospikeGeospatial *self, PyObject *args,
         goto CLEANUP;
     }
 
-    initresult = AerospikeGeospatial_DoDumps(self->geo_data, &err);
+    initresult = AerospikeGeospatial_GetGeoJSON((PyObject *)self, &err);
     if (!initresult) {
         as_error_update(&err, AEROSPIKE_ERR_CLIENT,
                         "Unable to call dumps function");
@@ -0,0 +1,591 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "geo.h"
+
+/*
+ * A minimal JSON codec for GeoJSON values, so reading and writing geo bins
+ * does not have to go through the Python json module for every value.
+ *
+ * Both directions return NULL without setting a Python error when the input is
+ * outside what they handle (e.g. NaN literals, non string dict keys); callers
+ * then fall back to the json module, which keeps its exact behaviour.
+ */
+
+/*******************************************************************************
+ * DECODING
+ ******************************************************************************/
+
+#define GEOJSON_MAX_DEPTH 64
+
+typedef struct {
+    const char *p;
+    const char *end;
+    int depth;
+} geojson_parser;
+
+static PyObject *parse_value(geojson_parser *parser);
+
+static void skip_whitespace(geojson_parser *parser)
+{
+    while (parser->p < parser->end &&
+           (*parser->p == ' ' || *parser->p == '\t' || *parser->p == '\n' ||
+            *parser->p == '\r')) {
+        parser->p++;
+    }
+}
+
+static bool consume_literal(geojson_parser *parser, const char *literal)
+{
+    size_t len = strlen(literal);
+    if ((size_t)(parser->end - parser->p) < len ||
+        memcmp(parser->p, literal, len) != 0) {
+        return false;
+    }
+    parser->p += len;
+    return true;
+}
+
+static PyObject *parse_string(geojson_parser *parser)
+{
+    // Opening quote already consumed.
+    const char *start = parser->p;
+    bool has_escapes = false;
+
+    while (parser->p < parser->end && *parser->p != '"') {
+        unsigned char c = (unsigned char)*parser->p;
+        if (c < 0x20) {
+            return NULL;
+        }
+        if (c == '\\') {
+            has_escapes = true;
+            parser->p++;
+        }
+        parser->p++;
+    }
+    if (parser->p >= parser->end) {
+        return NULL;
+    }
+
+    const char *stop = parser->p++;
+    if (has_escapes) {
+        // Escapes do not show up in the GeoJSON the server hands back; let
+        // the json module deal with them.
+        return NULL;
+    }
+
+    PyObject *py_str = PyUnicode_DecodeUTF8(start, stop - start, NULL);
+    if (!py_str) {
+        PyErr_Clear();
+    }
+    return py_str;
+}
+
+static PyObject *parse_number(geojson_parser *parser)
+{
+    const char *start = parser->p;
+    bool is_float = false;
+
+    if (parser->p < parser->end && *parser->p == '-') {
+        parser->p++;
+    }
+    if (parser->p >= parser->end || *parser->p < '0' || *parser->p > '9') {
+        return NULL;
+    }
+    if (*parser->p == '0') {
+        parser->p++;
+    }
+    else {
+        while (parser->p < parser->end && *parser->p >= '0' &&
+               *parser->p <= '9') {
+            parser->p++;
+        }
+    }
+    if (parser->p < parser->end && *parser->p == '.') {
+        is_float = true;
+        parser->p++;
+        if (parser->p >= parser->end || *parser->p < '0' || *parser->p > '9') {
+            return NULL;
+        }
+        while (parser->p < parser->end && *parser->p >= '0' &&
+               *parser->p <= '9') {
+            parser->p++;
+        }
+    }
+    if (parser->p < parser->end && (*parser->p == 'e' || *parser->p == 'E')) {
+        is_float = true;
+        parser->p++;
+        if (parser->p < parser->end &&
+            (*parser->p == '+' || *parser->p == '-')) {
+            parser->p++;
+        }
+        if (parser->p >= parser->end || *parser->p < '0' || *parser->p > '9') {
+            return NULL;
+        }
+        while (parser->p < parser->end && *parser->p >= '0' &&
+               *parser->p <= '9') {
+            parser->p++;
+        }
+    }
+
+    // Copy out so the conversion functions see a terminated string.
+    char buf[64];
+    size_t len = parser->p - start;
+    if (len >= sizeof(buf)) {
+        return NULL;
+    }
+    memcpy(buf, start, len);
+    buf[len] = '\0';
+
+    PyObject *py_num = NULL;
+    if (is_float) {
+        double d = PyOS_string_to_double(buf, NULL, NULL);
+        if (d == -1.0 && PyErr_Occurred()) {
+            PyErr_Clear();
+            return NULL;
+        }
+        py_num = PyFloat_FromDouble(d);
+    }
+    else {
+        py_num = PyLong_FromString(buf, NULL, 10);
+    }
+    if (!py_num) {
+        PyErr_Clear();
+    }
+    return py_num;
+}
+
+static PyObject *parse_array(geojson_parser *parser)
+{
+    PyObject *py_list = PyList_New(0);
+    if (!py_list) {
+        PyErr_Clear();
+        return NULL;
+    }
+
+    skip_whitespace(parser);
+    if (parser->p < parser->end && *parser->p == ']') {
+        parser->p++;
+        return py_list;
+    }
+
+    while (true) {
+        PyObject *py_item = parse_value(parser);
+        if (!py_item) {
+            break;
+        }
+        int rc = PyList_Append(py_list, py_item);
+        Py_DECREF(py_item);
+        if (rc != 0) {
+            PyErr_Clear();
+            break;
+        }
+
+        skip_whitespace(parser);
+        if (parser->p >= parser->end) {
+            break;
+        }
+        if (*parser->p == ',') {
+            parser->p++;
+            continue;
+        }
+        if (*parser->p == ']') {
+            parser->p++;
+            return py_list;
+        }
+        break;
+    }
+
+    Py_DECREF(py_list);
+    return NULL;
+}
+
+static PyObject *parse_object(geojson_parser *parser)
+{
+    PyObject *py_dict = PyDict_New();
+    if (!py_dict) {
+        PyErr_Clear();
+        return NULL;
+    }
+
+    skip_whitespace(parser);
+    if (parser->p < parser->end && *parser->p == '}') {
+        parser->p++;
+        return py_dict;
+    }
+
+    while (true) {
+        skip_whitespace(parser);
+        if (parser->p >= parser->end || *parser->p != '"') {
+            break;
+        }
+        parser->p++;
+        PyObject *py_key = parse_string(parser);
+        if (!py_key) {
+            break;
+        }
+
+        skip_whitespace(parser);
+        if (parser->p >= parser->end || *parser->p != ':') {
+            Py_DECREF(py_key);
+            break;
+        }
+        parser->p++;
+
+        PyObject *py_val = parse_value(parser);
+        if (!py_val) {
+            Py_DECREF(py_key);
+            break;
+        }
+        int rc = PyDict_SetItem(py_dict, py_key, py_val);
+        Py_DECREF(py_key);
+        Py_DECREF(py_val);
+        if (rc != 0) {
+            PyErr_Clear();
+            break;
+        }
+
+        skip_whitespace(parser);
+        if (parser->p >= parser->end) {
+            break;
+        }
+        if (*parser->p == ',') {
+            parser->p++;
+            continue;
+        }
+        if (*parser->p == '}') {
+            parser->p++;
+            return py_dict;
+        }
+        break;
+    }
+
+    Py_DECREF(py_dict);
+    return NULL;
+}
+
+static PyObject *parse_value(geojson_parser *parser)
+{
+    skip_whitespace(parser);
+    if (parser->p >= parser->end) {
+        return NULL;
+    }
+
+    PyObject *py_val = NULL;
+    switch (*parser->p) {
+    case '{':
+    case '[':
+        if (parser->depth >= GEOJSON_MAX_DEPTH) {
+            return NULL;
+        }
+        parser->depth++;
+        if (*parser->p++ == '{') {
+            py_val = parse_object(parser);
+        }
+        else {
+            py_val = parse_array(parser);
+        }
+        parser->depth--;
+        return py_val;
+    case '"':
+        parser->p++;
+        return parse_string(parser);
+    case 't':
+        if (consume_literal(parser, "true")) {
+            Py_RETURN_TRUE;
+        }
+        return NULL;
+    case 'f':
+        if (consume_literal(parser, "false")) {
+            Py_RETURN_FALSE;
+        }
+        return NULL;
+    case 'n':
+        if (consume_literal(parser, "null")) {
+            Py_RETURN_NONE;
+        }
+        return NULL;
+    default:
+        return parse_number(parser);
+    }
+}
+
+PyObject *geojson_loads(const char *str, Py_ssize_t len)
+{
+    geojson_parser parser = {.p = str, .end = str + len, .depth = 0};
+
+    PyObject *py_val = parse_value(&parser);
+    if (!py_val) {
+        return NULL;
+    }
+
+    skip_whitespace(&parser);
+    if (parser.p != parser.end) {
+        Py_DECREF(py_val);
+        return NULL;
+    }
+    return py_val;
+}
+
+/*******************************************************************************
+ * ENCODING
+ ******************************************************************************/
+
+// Output matches json.dumps() with its default arguments.
+
+typedef struct {
+    char *buffer;
+    size_t size;
+    size_t capacity;
+    int depth;
+} geojson_writer;
+
+static bool write_bytes(geojson_writer *writer, const char *bytes, size_t len)
+{
+    if (writer->capacity - writer->size < len) {
+        size_t capacity = writer->capacity ? writer->capacity : 128;
+        while (capacity - writer->size < len) {
+            capacity *= 2;
+        }
+        char *buffer = PyMem_Realloc(writer->buffer, capacity);
+        if (!buffer) {
+            return false;
+        }
+        writer->buffer = buffer;
+        writer->capacity = capacity;
+    }
+    memcpy(writer->buffer + writer->size, bytes, len);
+    writer->size += len;
+    return true;
+}
+
+static bool write_str(geojson_writer *writer, const char *str)
+{
+    return write_bytes(writer, str, strlen(str));
+}
+
+static bool write_string(geojson_writer *writer, PyObject *py_str)
+{
+    static const char hex[] = "0123456789abcdef";
+
+#if PY_VERSION_HEX < 0x030C0000
+    // Strings made with the legacy wchar_t API are only ready once used.
+    if (PyUnicode_READY(py_str) != 0) {
+        PyErr_Clear();
+        return false;
+    }
+#endif
+
+    int kind = PyUnicode_KIND(py_str);
+    const void *data = PyUnicode_DATA(py_str);
+    Py_ssize_t len = PyUnicode_GET_LENGTH(py_str);
+
+    if (!write_bytes(writer, "\"", 1)) {
+        return false;
+    }
+
+    for (Py_ssize_t i = 0; i < len; i++) {
+        Py_UCS4 c = PyUnicode_READ(kind, data, i);
+        char esc[12];
+        size_t esc_len = 0;
+
+        switch (c) {
+        case '"':
+            memcpy(esc, "\\\"", esc_len = 2);
+            break;
+        case '\\':
+            memcpy(esc, "\\\\", esc_len = 2);
+            break;
+        case '\n':
+            memcpy(esc, "\\n", esc_len = 2);
+            break;
+        case '\r':
+            memcpy(esc, "\\r", esc_len = 2);
+            break;
+        case '\t':
+            memcpy(esc, "\\t", esc_len = 2);
+            break;
+        case '\b':
+            memcpy(esc, "\\b", esc_len = 2);
+            break;
+        case '\f':
+            memcpy(esc, "\\f", esc_len = 2);
+            break;
+        default:
+            if (c >= 0x20 && c < 0x7f) {
+                esc[0] = (char)c;
+                esc_len = 1;
+            }
+            else {
+                // ensure_ascii: non ASCII characters become \uXXXX escapes,
+                // using a surrogate pair outside the BMP.
+                Py_UCS4 units[2] = {c, 0};
+                int count = 1;
+                if (c > 0xffff) {
+                    c -= 0x10000;
+                    units[0] = 0xd800 | ((c >> 10) & 0x3ff);
+                    units[1] = 0xdc00 | (c & 0x3ff);
+                    count = 2;
+                }
+                for (int u = 0; u < count; u++) {
+                    esc[esc_len++] = '\\';
+                    esc[esc_len++] = 'u';
+                    esc[esc_len++] = hex[(units[u] >> 12) & 0xf];
+                    esc[esc_len++] = hex[(units[u] >> 8) & 0xf];
+                    esc[esc_len++] = hex[(units[u] >> 4) & 0xf];
+                    esc[esc_len++] = hex[units[u] & 0xf];
+                }
+            }
+            break;
+        }
+
+        if (!write_bytes(writer, esc, esc_len)) {
+            return false;
+        }
+    }
+
+    return write_bytes(writer, "\"", 1);
+}
+
+static bool write_value(geojson_writer *writer, PyObject *py_obj);
+
+static bool write_sequence(geojson_writer *writer, PyObject *py_seq)
+{
+    Py_ssize_t size = PySequence_Fast_GET_SIZE(py_seq);
+    PyObject **items = PySequence_Fast_ITEMS(py_seq);
+
+    if (!write_bytes(writer, "[", 1)) {
+        return false;
+    }
+    for (Py_ssize_t i = 0; i < size; i++) {
+        if (i > 0 && !write_bytes(writer, ", ", 2)) {
+            return false;
+        }
+        if (!write_value(writer, items[i])) {
+            return false;
+        }
+    }
+    return write_bytes(writer, "]", 1);
+}
+
+static bool write_dict(geojson_writer *writer, PyObject *py_dict)
+{
+    PyObject *py_key = NULL;
+    PyObject *py_val = NULL;
+    Py_ssize_t pos = 0;
+    bool first = true;
+
+    if (!write_bytes(writer, "{", 1)) {
+        return false;
+    }
+    while (PyDict_Next(py_dict, &pos, &py_key, &py_val)) {
+        // json.dumps coerces other key types; leave that to it.
+        if (!PyUnicode_Check(py_key)) {
+            return false;
+        }
+        if (!first && !write_bytes(writer, ", ", 2)) {
+            return false;
+        }
+        first = false;
+        if (!write_string(writer, py_key) || !write_bytes(writer, ": ", 2) ||
+            !write_value(writer, py_val)) {
+            return false;
+        }
+    }
+    return write_bytes(writer, "}", 1);
+}
+
+static bool write_value(geojson_writer *writer, PyObject *py_obj)
+{
+    if (py_obj == Py_None) {
+        return write_str(writer, "null");
+    }
+    if (py_obj == Py_True) {
+        return write_str(writer, "true");
+    }
+    if (py_obj == Py_False) {
+        return write_str(writer, "false");
+    }
+    if (PyUnicode_Check(py_obj)) {
+        return write_string(writer, py_obj);
+    }
+    if (PyLong_CheckExact(py_obj)) {
+        PyObject *py_repr = PyObject_Str(py_obj);
+        if (!py_repr) {
+            PyErr_Clear();
+            return false;
+        }
+        Py_ssize_t len = 0;
+        const char *repr = PyUnicode_AsUTF8AndSize(py_repr, &len);
+        bool ok = repr && write_bytes(writer, repr, (size_t)len);
+        Py_DECREF(py_repr);
+        return ok;
+    }
+    if (PyFloat_CheckExact(py_obj)) {
+        double d = PyFloat_AS_DOUBLE(py_obj);
+        if (Py_IS_NAN(d)) {
+            return write_str(writer, "NaN");
+        }
+        if (Py_IS_INFINITY(d)) {
+            return write_str(writer, d > 0 ? "Infinity" : "-Infinity");
+        }
+        char *repr = PyOS_double_to_string(d, 'r', 0, Py_DTSF_ADD_DOT_0, NULL);
+        if (!repr) {
+            PyErr_Clear();
+            return false;
+        }
+        bool ok = write_str(writer, repr);
+        PyMem_Free(repr);
+        return ok;
+    }
+
+    if (writer->depth >= GEOJSON_MAX_DEPTH) {
+        return false;
+    }
+
+    bool ok = false;
+    writer->depth++;
+    if (PyList_Check(py_obj) || PyTuple_Check(py_obj)) {
+        ok = write_sequence(writer, py_obj);
+    }
+    else if (PyDict_Check(py_obj)) {
+        ok = write_dict(writer, py_obj);
+    }
+    writer->depth--;
+
+    return ok;
+}
+
+PyObject *geojson_dumps(PyObject *py_obj)
+{
+    geojson_writer writer = {
+        .buffer = NULL, .size = 0, .capacity = 0, .depth = 0};
+
+    PyObject *py_str = NULL;
+    if (write_value(&writer, py_obj)) {
+        py_str = PyUnicode_DecodeASCII(writer.buffer, writer.size, NULL);
+        if (!py_str) {
+            PyErr_Clear();
+        }
+    }
+
+    PyMem_Free(writer.buffer);
+    return py_str;
+}
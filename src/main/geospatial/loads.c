@@ -28,6 +28,20 @@
 
 PyObject *AerospikeGeospatial_DoLoads(PyObject *py_geodata, as_error *err)
 {
+    if (PyUnicode_Check(py_geodata)) {
+        Py_ssize_t len = 0;
+        const char *str = PyUnicode_AsUTF8AndSize(py_geodata, &len);
+        if (str) {
+            PyObject *py_loaded = geojson_loads(str, len);
+            if (py_loaded) {
+                return py_loaded;
+            }
+        }
+        else {
+            PyErr_Clear();
+        }
+    }
+
     PyObject *sysmodules = PyImport_GetModuleDict();
     PyObject *json_module = NULL;
     if (PyMapping_HasKeyString(sysmodules, "json")) {
@@ -28,13 +28,50 @@
 #include "geo.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "macros.h"
+#include "module_state.h"
 
 /*******************************************************************************
  * PYTHON TYPE METHODS
  ******************************************************************************/
-static PyMemberDef AerospikeGeospatial_Type_Members[] = {
-    {"geo_data", T_OBJECT, offsetof(AerospikeGeospatial, geo_data), 0,
-     "The aerospike.GeoJSON object"},
+static PyObject *AerospikeGeospatial_Get_Geo_Data(AerospikeGeospatial *self,
+                                                  void *closure)
+{
+    as_error err;
+    as_error_init(&err);
+
+    PyObject *py_geodata = AerospikeGeospatial_GetGeoData(self, &err);
+    if (!py_geodata) {
+        raise_exception(&err);
+        return NULL;
+    }
+    return py_geodata;
+}
+
+static int AerospikeGeospatial_Set_Geo_Data(AerospikeGeospatial *self,
+                                            PyObject *py_geodata,
+                                            void *closure)
+{
+    PyObject *py_old_geodata = NULL;
+    PyObject *py_old_geojson = NULL;
+
+    Py_XINCREF(py_geodata);
+    Py_BEGIN_CRITICAL_SECTION(self);
+    py_old_geodata = self->geo_data;
+    py_old_geojson = self->geo_json;
+    self->geo_data = py_geodata;
+    self->geo_json = NULL;
+    Py_END_CRITICAL_SECTION();
+
+    Py_XDECREF(py_old_geodata);
+    Py_XDECREF(py_old_geojson);
+    return 0;
+}
+
+static PyGetSetDef AerospikeGeospatial_Type_GetSet[] = {
+    {"geo_data", (getter)AerospikeGeospatial_Get_Geo_Data,
+     (setter)AerospikeGeospatial_Set_Geo_Data, "The aerospike.GeoJSON object",
+     NULL},
     {NULL}};
 static PyMethodDef AerospikeGeospatial_Type_Methods[] = {
 
@@ -66,10 +103,18 @@ void store_geodata(AerospikeGeospatial *self, as_error *err,
                    PyObject *py_geodata)
 {
     if (PyDict_Check(py_geodata)) {
-        if (self->geo_data) {
-            Py_DECREF(self->geo_data);
-        }
+        PyObject *py_old_geodata = NULL;
+        PyObject *py_old_geojson = NULL;
+
+        Py_BEGIN_CRITICAL_SECTION(self);
+        py_old_geodata = self->geo_data;
+        py_old_geojson = self->geo_json;
         self->geo_data = py_geodata;
+        self->geo_json = NULL;
+        Py_END_CRITICAL_SECTION();
+
+        Py_XDECREF(py_old_geodata);
+        Py_XDECREF(py_old_geojson);
     }
     else {
         as_error_update(
@@ -148,7 +193,7 @@ AerospikeGeospatial *self;
         goto CLEANUP;
     }
 
-    initresult = AerospikeGeospatial_DoDumps(self->geo_data, &err);
+    initresult = AerospikeGeospatial_GetGeoJSON((PyObject *)self, &err);
     if (!initresult) {
         as_error_update(&err, AEROSPIKE_ERR_CLIENT,
                         "Unable to call get data in str format");
@@ -191,7 +236,7 @@ AerospikeGeospatial *self;
         goto CLEANUP;
     }
 
-    initresult = AerospikeGeospatial_DoDumps(self->geo_data, &err);
+    initresult = AerospikeGeospatial_GetGeoJSON((PyObject *)self, &err);
     if (!initresult) {
         as_error_update(&err, AEROSPIKE_ERR_CLIENT,
                         "Unable to call get data in str format");
@@ -212,69 +257,57 @@ static void AerospikeGeospatial_Type_Dealloc(AerospikeGeospatial *self)
     if (self->geo_data) {
         Py_DECREF(self->geo_data);
     }
-    Py_TYPE(self)->tp_free((PyObject *)self);
+    Py_XDECREF(self->geo_json);
+    PyTypeObject *type = Py_TYPE(self);
+    type->tp_free((PyObject *)self);
+    Py_DECREF(type);
 }
 
 /*******************************************************************************
  * PYTHON TYPE DESCRIPTOR
  ******************************************************************************/
-static PyTypeObject AerospikeGeospatial_Type = {
-    PyVarObject_HEAD_INIT(NULL, 0) "aerospike.Geospatial", // tp_name
-    sizeof(AerospikeGeospatial),                           // tp_basicsize
-    0,                                                     // tp_itemsize
-    (destructor)AerospikeGeospatial_Type_Dealloc,
-    // tp_dealloc
-    0,                             // tp_print
-    0,                             // tp_getattr
-    0,                             // tp_setattr
-    0,                             // tp_compare
-    AerospikeGeospatial_Type_Repr, // tp_repr
-    0,                             // tp_as_number
-    0,                             // tp_as_sequence
-    0,                             // tp_as_mapping
-    0,                             // tp_hash
-    0,                             // tp_call
-    AerospikeGeospatial_Type_Str,  // tp_str
-    0,                             // tp_getattro
-    0,                             // tp_setattro
-    0,                             // tp_as_buffer
-    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
-    // tp_flags
-    "The GeoJSON class casts geospatial data to and from the server's\n"
-    "as_geojson type.\n",
-    // tp_doc
-    0,                                // tp_traverse
-    0,                                // tp_clear
-    0,                                // tp_richcompare
-    0,                                // tp_weaklistoffset
-    0,                                // tp_iter
-    0,                                // tp_iternext
-    AerospikeGeospatial_Type_Methods, // tp_methods
-    AerospikeGeospatial_Type_Members, // tp_members
-    0,                                // tp_getset
-    0,                                // tp_base
-    0,                                // tp_dict
-    0,                                // tp_descr_get
-    0,                                // tp_descr_set
-    0,                                // tp_dictoffset
-    (initproc)AerospikeGeospatial_Type_Init,
-    // tp_init
-    0,                            // tp_alloc
-    AerospikeGeospatial_Type_New, // tp_new
-    0,                            // tp_free
-    0,                            // tp_is_gc
-    0                             // tp_bases
-};
+
+static PyType_Slot AerospikeGeospatial_Type_Slots[] = {
+    {Py_tp_dealloc, (destructor)AerospikeGeospatial_Type_Dealloc},
+    {Py_tp_repr, AerospikeGeospatial_Type_Repr},
+    {Py_tp_str, AerospikeGeospatial_Type_Str},
+    {Py_tp_doc,
+     "The GeoJSON class casts geospatial data to and from the server's\n"
+     "as_geojson type.\n"},
+    {Py_tp_methods, AerospikeGeospatial_Type_Methods},
+    {Py_tp_getset, AerospikeGeospatial_Type_GetSet},
+    {Py_tp_init, (initproc)AerospikeGeospatial_Type_Init},
+    {Py_tp_new, AerospikeGeospatial_Type_New},
+    {0, NULL}};
+
+static PyType_Spec AerospikeGeospatial_Type_Spec = {
+    .name = "aerospike.Geospatial",
+    .basicsize = sizeof(AerospikeGeospatial),
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+    .slots = AerospikeGeospatial_Type_Slots};
+
+/*
+ * Returns the GeoJSON type of the current interpreter's aerospike module.
+ */
+static PyTypeObject *geospatial_type(as_error *err)
+{
+    struct Aerospike_State *state = Aerospike_Get_State();
+    if (!state) {
+        PyErr_Clear();
+        as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                        "Unable to find the aerospike module");
+        return NULL;
+    }
+    return state->geospatial;
+}
 
 /*******************************************************************************
  * PUBLIC FUNCTIONS
  ******************************************************************************/
 
-PyTypeObject *AerospikeGeospatial_Ready()
+PyTypeObject *AerospikeGeospatial_Ready(PyObject *module)
 {
-    return PyType_Ready(&AerospikeGeospatial_Type) == 0
-               ? &AerospikeGeospatial_Type
-               : NULL;
+    return Aerospike_New_Type(module, &AerospikeGeospatial_Type_Spec, NULL);
 }
 
 AerospikeGeospatial *Aerospike_Set_Geo_Data(PyObject *parent, PyObject *args,
@@ -293,14 +326,17 @@ AerospikeGeospatial *Aerospike_Set_Geo_Data(PyObject *parent, PyObject *args,
     }
 
     if (PyDict_Check(py_geodata)) {
+        PyTypeObject *type = Aerospike_State(parent)->geospatial;
         AerospikeGeospatial *self =
-            (AerospikeGeospatial *)AerospikeGeospatial_Type.tp_new(
-                &AerospikeGeospatial_Type, args, kwds);
-        if (AerospikeGeospatial_Type.tp_init((PyObject *)self, args, kwds) ==
-            0) {
+            (AerospikeGeospatial *)type->tp_new(type, args, kwds);
+        if (!self) {
+            return NULL;
+        }
+        if (type->tp_init((PyObject *)self, args, kwds) == 0) {
             return self;
         }
         else {
+            Py_DECREF(self);
             return NULL;
         }
     }
@@ -331,14 +367,17 @@ AerospikeGeospatial *Aerospike_Set_Geo_Json(PyObject *parent, PyObject *args,
     }
 
     if (PyUnicode_Check(py_geodata)) {
+        PyTypeObject *type = Aerospike_State(parent)->geospatial;
         AerospikeGeospatial *self =
-            (AerospikeGeospatial *)AerospikeGeospatial_Type.tp_new(
-                &AerospikeGeospatial_Type, args, kwds);
-        if (AerospikeGeospatial_Type.tp_init((PyObject *)self, args, kwds) ==
-            0) {
+            (AerospikeGeospatial *)type->tp_new(type, args, kwds);
+        if (!self) {
+            return NULL;
+        }
+        if (type->tp_init((PyObject *)self, args, kwds) == 0) {
             return self;
         }
         else {
+            Py_DECREF(self);
             return NULL;
         }
     }
@@ -355,10 +394,95 @@ AerospikeGeospatial *Aerospike_Set_Geo_Json(PyObject *parent, PyObject *args,
 
 PyObject *AerospikeGeospatial_New(as_error *err, PyObject *value)
 {
+    PyTypeObject *type = geospatial_type(err);
+    if (!type) {
+        return NULL;
+    }
+
     AerospikeGeospatial *self =
-        (AerospikeGeospatial *)AerospikeGeospatial_Type.tp_new(
-            &AerospikeGeospatial_Type, Py_None, Py_None);
+        (AerospikeGeospatial *)type->tp_new(type, Py_None, Py_None);
+    if (!self) {
+        as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                        "Unable to create Geospatial object");
+        return NULL;
+    }
     store_geodata(self, err, value);
     Py_XINCREF(self->geo_data);
     return (PyObject *)self;
 }
+
+PyObject *AerospikeGeospatial_NewFromGeoJSON(as_error *err,
+                                             PyObject *py_geojson)
+{
+    PyTypeObject *type = geospatial_type(err);
+    if (!type) {
+        return NULL;
+    }
+
+    AerospikeGeospatial *self =
+        (AerospikeGeospatial *)type->tp_new(type, Py_None, Py_None);
+    if (!self) {
+        as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                        "Unable to create Geospatial object");
+        return NULL;
+    }
+
+    Py_INCREF(py_geojson);
+    self->geo_json = py_geojson;
+    return (PyObject *)self;
+}
+
+PyObject *AerospikeGeospatial_GetGeoData(AerospikeGeospatial *self,
+                                         as_error *err)
+{
+    PyObject *py_geodata = NULL;
+    PyObject *py_geojson = NULL;
+
+    // Threads of free-threaded builds may fill geo_data at the same time.
+    Py_BEGIN_CRITICAL_SECTION(self);
+    if (!self->geo_data && self->geo_json) {
+        self->geo_data = AerospikeGeospatial_DoLoads(self->geo_json, err);
+        if (self->geo_data) {
+            // geo_data may be changed in place from now on, so the raw
+            // string can no longer be trusted.
+            py_geojson = self->geo_json;
+            self->geo_json = NULL;
+        }
+        else if (err->code == AEROSPIKE_OK) {
+            as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                            "Unable to load GeoJSON");
+        }
+    }
+    py_geodata = self->geo_data;
+    Py_XINCREF(py_geodata);
+    Py_END_CRITICAL_SECTION();
+
+    Py_XDECREF(py_geojson);
+    if (!py_geodata && err->code == AEROSPIKE_OK) {
+        as_error_update(err, AEROSPIKE_ERR_PARAM, "Invalid geospatial object");
+    }
+    return py_geodata;
+}
+
+PyObject *AerospikeGeospatial_GetGeoJSON(PyObject *py_geo, as_error *err)
+{
+    AerospikeGeospatial *self = (AerospikeGeospatial *)py_geo;
+    PyObject *py_geojson = NULL;
+
+    Py_BEGIN_CRITICAL_SECTION(self);
+    py_geojson = self->geo_json;
+    Py_XINCREF(py_geojson);
+    Py_END_CRITICAL_SECTION();
+
+    if (py_geojson) {
+        return py_geojson;
+    }
+
+    PyObject *py_geodata = AerospikeGeospatial_GetGeoData(self, err);
+    if (!py_geodata) {
+        return NULL;
+    }
+    py_geojson = AerospikeGeospatial_DoDumps(py_geodata, err);
+    Py_DECREF(py_geodata);
+    return py_geojson;
+}
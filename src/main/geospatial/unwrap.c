@@ -43,11 +43,15 @@ PyObject *AerospikeGeospatial_Unwrap(AerospikeGeospatial *self, PyObject *args,
     // Initialize error object
     as_error_init(&err);
 
+    PyObject *py_geodata = NULL;
+
     if (!self) {
         as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid geospatial object");
         goto CLEANUP;
     }
 
+    py_geodata = AerospikeGeospatial_GetGeoData(self, &err);
+
 CLEANUP:
 
     // If an error occurred, tell Python.
@@ -55,6 +59,5 @@ CLEANUP:
         raise_exception(&err);
         return NULL;
     }
-    Py_INCREF(self->geo_data);
-    return self->geo_data;
+    return py_geodata;
 }
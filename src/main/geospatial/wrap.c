@@ -50,7 +50,13 @@ PyObject *AerospikeGeospatial_Wrap(AerospikeGeospatial *self, PyObject *args,
         goto CLEANUP;
     }
 
+    // store_geodata() takes the reference if it succeeds. Taken first, as
+    // another thread may replace geo_data as soon as it is stored.
+    Py_INCREF(py_geodata);
     store_geodata(self, &err, py_geodata);
+    if (err.code != AEROSPIKE_OK) {
+        Py_DECREF(py_geodata);
+    }
 
 CLEANUP:
 
@@ -60,6 +66,5 @@ CLEANUP:
         return NULL;
     }
 
-    Py_INCREF(self->geo_data);
     return PyLong_FromLong(0);
 }
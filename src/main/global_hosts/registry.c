@@ -0,0 +1,269 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+
+#include <Python.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <aerospike/aerospike.h>
+#include <aerospike/as_config.h>
+#include <aerospike/as_error.h>
+#include <citrusleaf/alloc.h>
+
+#include "client.h"
+#include "global_hosts.h"
+
+typedef struct global_host_s {
+    char *alias;
+    aerospike *as;
+    int shm_key;
+    // Number of connected clients using as.
+    int ref_cnt;
+    // Process that connected as. Entries inherited across fork() are stale.
+    pid_t pid;
+    // Set while a thread connects as again without holding the lock.
+    bool reconnecting;
+    // Signalled when reconnecting is cleared.
+    pthread_cond_t reconnected;
+    // Threads using the entry across a wait for the lock. An entry unlinked
+    // meanwhile is freed by the last of them.
+    int users;
+    bool unlinked;
+    struct global_host_s *next;
+} global_host;
+
+static global_host *global_hosts = NULL;
+static pthread_mutex_t global_hosts_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Finds the entry for alias, and as unless it is NULL. Called with the lock
+ * held.
+ */
+static global_host **find_global_host(const char *alias, aerospike *as)
+{
+    for (global_host **link = &global_hosts; *link; link = &(*link)->next) {
+        if (strcmp((*link)->alias, alias) == 0 && (!as || (*link)->as == as)) {
+            return link;
+        }
+    }
+    return NULL;
+}
+
+static void free_global_host(global_host *host)
+{
+    pthread_cond_destroy(&host->reconnected);
+    cf_free(host->alias);
+    cf_free(host);
+}
+
+static void unlink_global_host(global_host **link)
+{
+    global_host *host = *link;
+    *link = host->next;
+    if (host->users) {
+        host->unlinked = true;
+    }
+    else {
+        free_global_host(host);
+    }
+}
+
+/*
+ * Ends the use of an entry revalidate_global_host() started. Called with the
+ * lock held.
+ */
+static void put_global_host(global_host *host)
+{
+    if (--host->users == 0 && host->unlinked) {
+        free_global_host(host);
+    }
+}
+
+/*
+ * Connects an entry inherited from a parent process again. Its cluster
+ * belongs to the parent, whose tend thread does not exist here, so it is
+ * dropped rather than closed. Called with the lock held, which is released
+ * while connecting because fork() waits for it. Other threads wait for that
+ * connect meanwhile. The caller ends its use with put_global_host().
+ */
+static as_status revalidate_global_host(global_host *host, as_error *err)
+{
+    host->users++;
+    while (host->reconnecting) {
+        pthread_cond_wait(&host->reconnected, &global_hosts_lock);
+    }
+    if (host->pid == getpid()) {
+        return err->code;
+    }
+
+    host->reconnecting = true;
+    // Keeps clients releasing the entry meanwhile from closing as.
+    host->ref_cnt++;
+    pthread_mutex_unlock(&global_hosts_lock);
+
+    host->as->cluster = NULL;
+    aerospike_connect(host->as, err);
+
+    pthread_mutex_lock(&global_hosts_lock);
+    host->ref_cnt--;
+    host->reconnecting = false;
+    if (err->code == AEROSPIKE_OK) {
+        host->pid = getpid();
+    }
+    pthread_cond_broadcast(&host->reconnected);
+    return err->code;
+}
+
+bool AerospikeGlobalHosts_Share(AerospikeClient *self, const char *alias,
+                                as_error *err)
+{
+    pthread_mutex_lock(&global_hosts_lock);
+
+    global_host **link = find_global_host(alias, NULL);
+    global_host *host = link ? *link : NULL;
+    if (host && revalidate_global_host(host, err) == AEROSPIKE_OK) {
+        //Destroy the initial aerospike object as it has to point to the one in
+        //the persistent list now
+        if (host->as != self->as) {
+            // If the client has previously connected
+            // Other clients may share its aerospike* pointer
+            // So it is not safe to destroy it
+            if (!self->has_connected) {
+                aerospike_destroy(self->as);
+            }
+            self->as = host->as;
+            self->as->config.shm_key = host->shm_key;
+
+            //Increase ref count of global host entry
+            host->ref_cnt++;
+        }
+        else if (!self->is_conn_16) {
+            // This client was disconnected from the entry it points to. If it
+            // is still connected, there is nothing to do.
+            host->ref_cnt++;
+        }
+    }
+    if (host) {
+        put_global_host(host);
+    }
+
+    pthread_mutex_unlock(&global_hosts_lock);
+    return host != NULL;
+}
+
+void AerospikeGlobalHosts_Add(const char *alias, aerospike *as)
+{
+    global_host *host = (global_host *)cf_malloc(sizeof(global_host));
+    host->alias = cf_strdup(alias);
+    host->as = as;
+    host->shm_key = as->config.shm_key;
+    host->ref_cnt = 1;
+    host->pid = getpid();
+    host->reconnecting = false;
+    pthread_cond_init(&host->reconnected, NULL);
+    host->users = 0;
+    host->unlinked = false;
+
+    pthread_mutex_lock(&global_hosts_lock);
+    // Newer entries are found first.
+    host->next = global_hosts;
+    global_hosts = host;
+    pthread_mutex_unlock(&global_hosts_lock);
+}
+
+bool AerospikeGlobalHosts_Release(const char *alias, aerospike *as)
+{
+    bool last = false;
+
+    pthread_mutex_lock(&global_hosts_lock);
+    global_host **link = find_global_host(alias, as);
+    if (link) {
+        last = --(*link)->ref_cnt == 0;
+        if (last) {
+            unlink_global_host(link);
+        }
+    }
+    pthread_mutex_unlock(&global_hosts_lock);
+
+    return last;
+}
+
+void AerospikeGlobalHosts_Remove(const char *alias)
+{
+    pthread_mutex_lock(&global_hosts_lock);
+    global_host **link = NULL;
+    while ((link = find_global_host(alias, NULL))) {
+        unlink_global_host(link);
+    }
+    pthread_mutex_unlock(&global_hosts_lock);
+}
+
+bool AerospikeGlobalHosts_Revalidate(const char *alias, aerospike *as,
+                                     as_error *err)
+{
+    pthread_mutex_lock(&global_hosts_lock);
+    global_host **link = find_global_host(alias, as);
+    global_host *host = link ? *link : NULL;
+    if (host) {
+        revalidate_global_host(host, err);
+        put_global_host(host);
+    }
+    pthread_mutex_unlock(&global_hosts_lock);
+
+    return host != NULL;
+}
+
+int AerospikeGlobalHosts_Unique_Shm_Key(int shm_key)
+{
+    pthread_mutex_lock(&global_hosts_lock);
+    global_host *host = global_hosts;
+    while (host) {
+        if (host->as->config.use_shm && host->shm_key == shm_key) {
+            shm_key++;
+            host = global_hosts;
+        }
+        else {
+            host = host->next;
+        }
+    }
+    pthread_mutex_unlock(&global_hosts_lock);
+
+    return shm_key;
+}
+
+void AerospikeGlobalHosts_Lock(void)
+{
+    pthread_mutex_lock(&global_hosts_lock);
+}
+
+void AerospikeGlobalHosts_Unlock(void)
+{
+    pthread_mutex_unlock(&global_hosts_lock);
+}
+
+void AerospikeGlobalHosts_Fork_Child(void)
+{
+    // Threads connecting or waiting in the parent do not exist here. Entries
+    // unlinked while they were in use are lost with them.
+    for (global_host *host = global_hosts; host; host = host->next) {
+        host->reconnecting = false;
+        host->users = 0;
+        pthread_cond_init(&host->reconnected, NULL);
+    }
+}
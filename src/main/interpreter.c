@@ -0,0 +1,56 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+
+#include <Python.h>
+
+#include "interpreter.h"
+
+PyInterpreterState *Aerospike_Current_Interpreter(void)
+{
+#if PY_VERSION_HEX >= 0x03090000
+    return PyInterpreterState_Get();
+#else
+    return PyThreadState_Get()->interp;
+#endif
+}
+
+Aerospike_GIL_State Aerospike_GIL_Ensure(PyInterpreterState *interp)
+{
+    Aerospike_GIL_State state = {PyGILState_UNLOCKED, NULL};
+
+    if (!interp || interp == PyInterpreterState_Main()) {
+        state.gstate = PyGILState_Ensure();
+        return state;
+    }
+
+    state.tstate = PyThreadState_New(interp);
+    PyEval_RestoreThread(state.tstate);
+    return state;
+}
+
+void Aerospike_GIL_Release(Aerospike_GIL_State *state)
+{
+    if (!state->tstate) {
+        PyGILState_Release(state->gstate);
+        return;
+    }
+
+    PyThreadState_Clear(state->tstate);
+    // Releases the GIL along with the thread state.
+    PyThreadState_DeleteCurrent();
+    state->tstate = NULL;
+}
@@ -0,0 +1,231 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+
+#include <Python.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <aerospike/as_error.h>
+#include <aerospike/as_key.h>
+
+#include "conversions.h"
+#include "exceptions.h"
+#include "key_object.h"
+#include "macros.h"
+#include "module_state.h"
+
+/*
+ * aerospike.Key is a tuple of (namespace, set, key, digest), so it compares
+ * equal to the key tuples returned by earlier versions and is accepted
+ * wherever one is. The digest is computed once, when the Key is created, and
+ * stored as bytes so the Key is immutable.
+ */
+
+#define KEY_NAMESPACE 0
+#define KEY_SET 1
+#define KEY_KEY 2
+#define KEY_DIGEST 3
+#define KEY_SIZE 4
+
+static PyObject *key_object_new(PyTypeObject *type, PyObject *py_ns,
+                                PyObject *py_set, PyObject *py_key,
+                                const as_digest *digest)
+{
+    PyObject *py_digest = PyBytes_FromStringAndSize(
+        (const char *)digest->value, AS_DIGEST_VALUE_SIZE);
+    if (!py_digest) {
+        return NULL;
+    }
+
+    PyObject *self = type->tp_alloc(type, KEY_SIZE);
+    if (!self) {
+        Py_DECREF(py_digest);
+        return NULL;
+    }
+
+    Py_INCREF(py_ns);
+    PyTuple_SET_ITEM(self, KEY_NAMESPACE, py_ns);
+    Py_INCREF(py_set);
+    PyTuple_SET_ITEM(self, KEY_SET, py_set);
+    Py_INCREF(py_key);
+    PyTuple_SET_ITEM(self, KEY_KEY, py_key);
+    PyTuple_SET_ITEM(self, KEY_DIGEST, py_digest);
+
+    return self;
+}
+
+/*******************************************************************************
+ * PYTHON TYPE METHODS
+ ******************************************************************************/
+
+static PyObject *AerospikeKey_GetNewArgs(PyObject *self, PyObject *unused)
+{
+    // tuple.__getnewargs__() passes the items as one argument.
+    return PyTuple_GetSlice(self, 0, KEY_SIZE);
+}
+
+static PyMethodDef AerospikeKey_Type_Methods[] = {
+    {"__getnewargs__", (PyCFunction)AerospikeKey_GetNewArgs, METH_NOARGS,
+     NULL},
+    {NULL}};
+
+static PyObject *AerospikeKey_Get_Item(PyObject *self, void *closure)
+{
+    PyObject *py_item = PyTuple_GET_ITEM(self, (Py_ssize_t)closure);
+    Py_INCREF(py_item);
+    return py_item;
+}
+
+static PyGetSetDef AerospikeKey_Type_GetSet[] = {
+    {"namespace", (getter)AerospikeKey_Get_Item, NULL, "The namespace.",
+     (void *)KEY_NAMESPACE},
+    {"set", (getter)AerospikeKey_Get_Item, NULL, "The set, or None.",
+     (void *)KEY_SET},
+    {"key", (getter)AerospikeKey_Get_Item, NULL,
+     "The primary key, or None if the Key was created from a digest.",
+     (void *)KEY_KEY},
+    {"digest", (getter)AerospikeKey_Get_Item, NULL,
+     "The RIPEMD-160 digest of the key, as bytes.", (void *)KEY_DIGEST},
+    {NULL}};
+
+/*******************************************************************************
+ * PYTHON TYPE HOOKS
+ ******************************************************************************/
+
+static PyObject *AerospikeKey_Type_New(PyTypeObject *type, PyObject *args,
+                                       PyObject *kwds)
+{
+    PyObject *py_ns = NULL;
+    PyObject *py_set = NULL;
+    PyObject *py_key = Py_None;
+    PyObject *py_digest = Py_None;
+    PyObject *py_keytuple = NULL;
+    PyObject *py_self = NULL;
+    bool key_initialised = false;
+
+    as_key key;
+    as_error err;
+    as_error_init(&err);
+
+    static char *kwlist[] = {"namespace", "set", "key", "digest", NULL};
+
+    if (PyArg_ParseTupleAndKeywords(args, kwds, "OO|OO:Key", kwlist, &py_ns,
+                                    &py_set, &py_key, &py_digest) == false) {
+        return NULL;
+    }
+
+    if (py_key == Py_None && PyBytes_Check(py_digest)) {
+        // Key tuples carry their digest as a bytearray.
+        py_digest = PyByteArray_FromObject(py_digest);
+    }
+    else {
+        Py_INCREF(py_digest);
+    }
+    if (!py_digest) {
+        return NULL;
+    }
+
+    py_keytuple = PyTuple_Pack(KEY_SIZE, py_ns, py_set, py_key, py_digest);
+    if (!py_keytuple) {
+        goto CLEANUP;
+    }
+
+    if (pyobject_to_key(NULL, &err, py_keytuple, &key) != AEROSPIKE_OK) {
+        goto CLEANUP;
+    }
+    key_initialised = true;
+
+    as_digest *digest = as_key_digest(&key);
+    if (!digest) {
+        as_error_update(&err, AEROSPIKE_ERR_PARAM,
+                        "Unable to compute the key's digest");
+        goto CLEANUP;
+    }
+
+    // A digest passed along with the key, e.g. when unpickling, must match.
+    if (py_key != Py_None && py_digest != Py_None) {
+        Py_buffer view;
+        if (PyObject_GetBuffer(py_digest, &view, PyBUF_SIMPLE) == -1) {
+            goto CLEANUP;
+        }
+        bool matches =
+            view.len == AS_DIGEST_VALUE_SIZE &&
+            memcmp(view.buf, digest->value, AS_DIGEST_VALUE_SIZE) == 0;
+        PyBuffer_Release(&view);
+        if (!matches) {
+            as_error_update(&err, AEROSPIKE_ERR_PARAM,
+                            "digest does not match the key");
+            goto CLEANUP;
+        }
+    }
+
+    py_self = key_object_new(type, py_ns, py_set, py_key, digest);
+
+CLEANUP:
+    if (key_initialised) {
+        as_key_destroy(&key);
+    }
+    Py_XDECREF(py_keytuple);
+    Py_DECREF(py_digest);
+
+    if (err.code != AEROSPIKE_OK) {
+        raise_exception(&err);
+        return NULL;
+    }
+    return py_self;
+}
+
+/*******************************************************************************
+ * PYTHON TYPE DESCRIPTOR
+ ******************************************************************************/
+
+static PyType_Slot AerospikeKey_Type_Slots[] = {
+    {Py_tp_doc,
+     "Key(namespace, set, key=None, digest=None)\n\n"
+     "An immutable key tuple of (namespace, set, key, digest) whose digest\n"
+     "is computed once, when the Key is created.\n"},
+    {Py_tp_methods, AerospikeKey_Type_Methods},
+    {Py_tp_getset, AerospikeKey_Type_GetSet},
+    {Py_tp_new, AerospikeKey_Type_New},
+    {0, NULL}};
+
+static PyType_Spec AerospikeKey_Type_Spec = {
+    .name = AEROSPIKE_KEY_NAME,
+    .flags = Py_TPFLAGS_DEFAULT,
+    .slots = AerospikeKey_Type_Slots};
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+PyTypeObject *AerospikeKey_Ready(PyObject *module)
+{
+    return Aerospike_New_Type(module, &AerospikeKey_Type_Spec, &PyTuple_Type);
+}
+
+bool AerospikeKey_Check(struct Aerospike_State *state, PyObject *py_obj)
+{
+    // The type can't be subclassed.
+    return state && Py_TYPE(py_obj) == state->key;
+}
+
+PyObject *AerospikeKey_New(struct Aerospike_State *state, PyObject *py_ns,
+                           PyObject *py_set, PyObject *py_key,
+                           const as_digest *digest)
+{
+    return key_object_new(state->key, py_ns, py_set, py_key, digest);
+}
@@ -16,8 +16,11 @@
 
 #include <Python.h>
 #include <structmember.h>
+#include <stdbool.h>
+#include <string.h>
 
 #include "key_ordered_dict.h"
+#include "module_state.h"
 
 /*******************************************************************************
  * PYTHON TYPE METHODS
@@ -39,26 +42,43 @@ static int AerospikeKeyOrderedDict_Type_Init(AerospikeQuery *self,
  * PYTHON TYPE DESCRIPTOR
  ******************************************************************************/
 
-static PyTypeObject AerospikeKeyOrderedDict_Type = {
-    PyVarObject_HEAD_INIT(NULL, 0).tp_name = "aerospike.KeyOrderedDict",
-    .tp_basicsize = sizeof(AerospikeKeyOrderedDict),
-    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
-    .tp_doc = "The KeyOrderedDict class is a dictionary that directly maps\n"
-              "to a key ordered map on the Aerospike server.\n"
-              "This assists in matching key ordered maps\n"
-              "through various read operations.\n",
-    .tp_methods = AerospikeKeyOrderedDict_Type_Methods,
-    .tp_init = (initproc)AerospikeKeyOrderedDict_Type_Init};
+#define AEROSPIKE_KEY_ORDERED_DICT_NAME "aerospike.KeyOrderedDict"
 
-PyTypeObject *AerospikeKeyOrderedDict_Ready()
+static PyType_Slot AerospikeKeyOrderedDict_Type_Slots[] = {
+    {Py_tp_doc, "The KeyOrderedDict class is a dictionary that directly maps\n"
+                "to a key ordered map on the Aerospike server.\n"
+                "This assists in matching key ordered maps\n"
+                "through various read operations.\n"},
+    {Py_tp_methods, AerospikeKeyOrderedDict_Type_Methods},
+    {Py_tp_init, (initproc)AerospikeKeyOrderedDict_Type_Init},
+    {0, NULL}};
+
+static PyType_Spec AerospikeKeyOrderedDict_Type_Spec = {
+    .name = AEROSPIKE_KEY_ORDERED_DICT_NAME,
+    .basicsize = sizeof(AerospikeKeyOrderedDict),
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+    .slots = AerospikeKeyOrderedDict_Type_Slots};
+
+PyTypeObject *AerospikeKeyOrderedDict_Ready(PyObject *module)
 {
-    AerospikeKeyOrderedDict_Type.tp_base = &PyDict_Type;
-    return PyType_Ready(&AerospikeKeyOrderedDict_Type) == 0
-               ? &AerospikeKeyOrderedDict_Type
-               : NULL;
+    return Aerospike_New_Type(module, &AerospikeKeyOrderedDict_Type_Spec,
+                              &PyDict_Type);
 }
 
-PyObject *AerospikeKeyOrderedDict_Get_Type()
+bool AerospikeKeyOrderedDict_Check(PyObject *py_obj)
 {
-    return (PyObject *)&AerospikeKeyOrderedDict_Type;
+    // Each interpreter has a type of its own, so it is matched by name rather
+    // than looking up the module on every conversion.
+    PyObject *py_mro = Py_TYPE(py_obj)->tp_mro;
+    if (!py_mro) {
+        return false;
+    }
+
+    for (Py_ssize_t i = 0; i < PyTuple_GET_SIZE(py_mro); i++) {
+        PyTypeObject *type = (PyTypeObject *)PyTuple_GET_ITEM(py_mro, i);
+        if (strcmp(type->tp_name, AEROSPIKE_KEY_ORDERED_DICT_NAME) == 0) {
+            return true;
+        }
+    }
+    return false;
 }
@@ -0,0 +1,57 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "latency_window.h"
+
+static int compare_latency(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+void latency_window_init(latency_window *window, double percentile)
+{
+    memset(window, 0, sizeof(latency_window));
+    window->percentile = percentile;
+}
+
+bool latency_window_add(latency_window *window, uint32_t latency)
+{
+    window->samples[window->next] = latency;
+    window->next = (window->next + 1) % LATENCY_WINDOW_SIZE;
+    if (window->size < LATENCY_WINDOW_SIZE) {
+        window->size++;
+    }
+    if (++window->new_samples < LATENCY_WINDOW_RECOMPUTE) {
+        return false;
+    }
+    window->new_samples = 0;
+
+    uint32_t sorted[LATENCY_WINDOW_SIZE];
+    uint32_t n = window->size;
+    memcpy(sorted, window->samples, sizeof(uint32_t) * n);
+    qsort(sorted, n, sizeof(uint32_t), compare_latency);
+
+    uint32_t index = (uint32_t)(window->percentile / 100 * n);
+    window->value = sorted[index < n ? index : n - 1];
+    return true;
+}
@@ -15,7 +15,9 @@
  ******************************************************************************/
 
 #include <Python.h>
+#include <pthread.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #include <aerospike/as_error.h>
 #include <aerospike/as_log.h>
@@ -26,6 +28,35 @@
 #include "log.h"
 
 static AerospikeLogCallback user_callback;
+static pthread_once_t default_logging_once = PTHREAD_ONCE_INIT;
+
+/*
+ * The log handler is a Python callable run by a thread of the main
+ * interpreter, so it can only be set from there.
+ */
+static bool in_main_interpreter(void)
+{
+#if PY_VERSION_HEX >= 0x03090000
+    PyInterpreterState *interp = PyInterpreterState_Get();
+#else
+    PyInterpreterState *interp = PyThreadState_Get()->interp;
+#endif
+    return interp == PyInterpreterState_Main();
+}
+
+static bool check_main_interpreter(const char *fname)
+{
+    if (in_main_interpreter()) {
+        return true;
+    }
+
+    as_error err;
+    as_error_init(&err);
+    as_error_update(&err, AEROSPIKE_ERR_PARAM,
+                    "%s() can only be called from the main interpreter", fname);
+    raise_exception(&err);
+    return false;
+}
 
 /*
  * Declare's log level constants.
@@ -124,51 +155,327 @@ bool console_log_cb(as_log_level level, const char *func, const char *file,
     return true;
 }
 
+/*
+ * Log records from C client threads are pushed onto a bounded lock-free queue
+ * (Vyukov's MPMC ring, with a single consumer at a time) and delivered to the
+ * Python handler in batches by a dispatcher thread, so the tend and I/O
+ * threads never wait on the GIL. Records are dropped and counted when the
+ * queue is full. The dispatcher sleeps while the queue is empty and is woken
+ * by the producer of the next record.
+ */
+
+// Must be a power of two.
+#define LOG_QUEUE_CAPACITY 1024
+#define LOG_MESSAGE_SIZE 1024
+#define LOG_BATCH_SIZE 64
+
+typedef struct {
+    size_t seq;
+    as_log_level level;
+    // func and file point to string literals in the C client.
+    const char *func;
+    const char *file;
+    uint32_t line;
+    char msg[LOG_MESSAGE_SIZE];
+} log_record;
+
+static log_record log_queue[LOG_QUEUE_CAPACITY];
+static size_t log_queue_tail;
+static size_t log_queue_head;
+static pthread_once_t log_queue_once = PTHREAD_ONCE_INIT;
+
+static uint64_t log_dropped;
+static uint64_t log_delivered;
+
+// Serializes consumers, the dispatcher thread and drain_logs(), while they
+// pop records. It is not held while records are delivered, so a handler may
+// call drain_logs().
+static pthread_mutex_t log_consumer_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Records published and not yet popped. A consumer may pop a record before
+// its producer counts it, so this can briefly be negative.
+static int64_t log_ready;
+// Signaled by the producer which makes log_ready positive, and on stop.
+static pthread_mutex_t log_wakeup_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t log_wakeup = PTHREAD_COND_INITIALIZER;
+// Only used by the dispatcher thread.
+static log_record log_dispatcher_batch[LOG_BATCH_SIZE];
+
+static pthread_t log_dispatcher;
+static bool log_dispatcher_running = false;
+static bool log_dispatcher_stop = false;
+// Set in a forked child whose parent was running the dispatcher.
+static bool log_dispatcher_restart = false;
+
+static void log_queue_init(void)
+{
+    for (size_t i = 0; i < LOG_QUEUE_CAPACITY; i++) {
+        log_queue[i].seq = i;
+    }
+}
+
 static bool log_cb(as_log_level level, const char *func, const char *file,
                    uint32_t line, const char *fmt, ...)
 {
+    size_t pos = __atomic_load_n(&log_queue_tail, __ATOMIC_RELAXED);
+    log_record *record = NULL;
+
+    while (true) {
+        record = &log_queue[pos & (LOG_QUEUE_CAPACITY - 1)];
+        size_t seq = __atomic_load_n(&record->seq, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&log_queue_tail, &pos, pos + 1,
+                                            true, __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            // Full, the consumer has not caught up.
+            __atomic_fetch_add(&log_dropped, 1, __ATOMIC_RELAXED);
+            return true;
+        }
+        else {
+            pos = __atomic_load_n(&log_queue_tail, __ATOMIC_RELAXED);
+        }
+    }
+
+    record->level = level;
+    record->func = func;
+    record->file = file;
+    record->line = line;
 
-    char msg[1024];
     va_list ap;
     va_start(ap, fmt);
-    vsnprintf(msg, 1024, fmt, ap);
+    vsnprintf(record->msg, LOG_MESSAGE_SIZE, fmt, ap);
     va_end(ap);
 
-    // Extract pyhton user callback
+    __atomic_store_n(&record->seq, pos + 1, __ATOMIC_RELEASE);
+
+    if (__atomic_fetch_add(&log_ready, 1, __ATOMIC_SEQ_CST) == 0) {
+        pthread_mutex_lock(&log_wakeup_lock);
+        pthread_cond_signal(&log_wakeup);
+        pthread_mutex_unlock(&log_wakeup_lock);
+    }
+
+    return true;
+}
+
+/*
+ * Moves up to LOG_BATCH_SIZE records into batch, freeing their slots for
+ * producers right away.
+ */
+static int log_queue_pop_batch(log_record *batch)
+{
+    int count = 0;
+
+    pthread_mutex_lock(&log_consumer_lock);
+    while (count < LOG_BATCH_SIZE) {
+        log_record *record =
+            &log_queue[log_queue_head & (LOG_QUEUE_CAPACITY - 1)];
+        size_t seq = __atomic_load_n(&record->seq, __ATOMIC_ACQUIRE);
+        if (seq != log_queue_head + 1) {
+            break;
+        }
+
+        batch[count++] = *record;
+        __atomic_store_n(&record->seq, log_queue_head + LOG_QUEUE_CAPACITY,
+                         __ATOMIC_RELEASE);
+        log_queue_head++;
+    }
+    pthread_mutex_unlock(&log_consumer_lock);
+
+    __atomic_fetch_sub(&log_ready, count, __ATOMIC_SEQ_CST);
+    return count;
+}
+
+/*
+ * Calls the Python log handler for each record in batch. Must be called with
+ * the GIL held.
+ */
+static void log_batch_deliver(const log_record *batch, int count)
+{
     PyObject *py_callback = user_callback.callback;
-    // User callback's argument list
-    PyObject *py_arglist = NULL;
+    if (!py_callback) {
+        return;
+    }
+    // The handler may replace itself while we are calling it.
+    Py_INCREF(py_callback);
+
+    for (int i = 0; i < count; i++) {
+        const log_record *record = &batch[i];
+
+        PyObject *py_arglist =
+            Py_BuildValue("(lssls)", (long)record->level, record->func,
+                          record->file, (long)record->line, record->msg);
+        if (!py_arglist) {
+            PyErr_Clear();
+            continue;
+        }
+
+        // Invoke user callback, passing in argument's list
+        PyObject *py_result = PyObject_Call(py_callback, py_arglist, NULL);
+        if (py_result) {
+            Py_DECREF(py_result);
+        }
+        else {
+            PyErr_WriteUnraisable(py_callback);
+        }
+        Py_DECREF(py_arglist);
+    }
+
+    __atomic_fetch_add(&log_delivered, count, __ATOMIC_RELAXED);
+    Py_DECREF(py_callback);
+}
+
+/*
+ * Waits until a record is ready or the dispatcher is stopped. Returns false
+ * once it is stopped.
+ */
+static bool log_dispatcher_wait(void)
+{
+    pthread_mutex_lock(&log_wakeup_lock);
+    while (!log_dispatcher_stop &&
+           __atomic_load_n(&log_ready, __ATOMIC_SEQ_CST) <= 0) {
+        pthread_cond_wait(&log_wakeup, &log_wakeup_lock);
+    }
+    bool stop = log_dispatcher_stop;
+    pthread_mutex_unlock(&log_wakeup_lock);
+
+    return !stop;
+}
 
-    // Lock python state
-    PyGILState_STATE gstate;
-    gstate = PyGILState_Ensure();
+static void *log_dispatcher_run(void *udata)
+{
+    while (log_dispatcher_wait()) {
+        int count = log_queue_pop_batch(log_dispatcher_batch);
+        if (count > 0) {
+            // One GIL acquisition per batch rather than per log line.
+            PyGILState_STATE gstate = PyGILState_Ensure();
+            log_batch_deliver(log_dispatcher_batch, count);
+            PyGILState_Release(gstate);
+        }
+    }
 
-    // Create a tuple of argument list
-    py_arglist = PyTuple_New(5);
+    return NULL;
+}
 
-    // Initialise argument variables
-    PyObject *log_level = PyLong_FromLong((long)level);
-    PyObject *func_name = PyUnicode_FromString(func);
-    PyObject *file_name = PyUnicode_FromString(file);
-    PyObject *line_no = PyLong_FromLong((long)line);
-    PyObject *message = PyUnicode_FromString(msg);
+/*
+ * Delivers all pending log records on the calling thread, which must hold the
+ * GIL. Returns the number of records delivered. While the dispatcher delivers
+ * a batch of its own, records may reach the handler out of order.
+ */
+static uint64_t log_queue_drain(void)
+{
+    uint64_t total = 0;
+    int count = 0;
 
-    // Set argument list
-    PyTuple_SetItem(py_arglist, 0, log_level);
-    PyTuple_SetItem(py_arglist, 1, func_name);
-    PyTuple_SetItem(py_arglist, 2, file_name);
-    PyTuple_SetItem(py_arglist, 3, line_no);
-    PyTuple_SetItem(py_arglist, 4, message);
+    log_record *batch = PyMem_Malloc(sizeof(log_record) * LOG_BATCH_SIZE);
+    if (!batch) {
+        return 0;
+    }
 
-    // Invoke user callback, passing in argument's list
-    PyObject_Call(py_callback, py_arglist, NULL);
+    while ((count = log_queue_pop_batch(batch)) > 0) {
+        log_batch_deliver(batch, count);
+        total += count;
+    }
 
-    Py_DECREF(py_arglist);
+    PyMem_Free(batch);
+    return total;
+}
 
-    // Release python state
-    PyGILState_Release(gstate);
+static PyObject *Aerospike_Stop_Log_Dispatcher(PyObject *self,
+                                               PyObject *unused)
+{
+    if (log_dispatcher_running) {
+        pthread_mutex_lock(&log_wakeup_lock);
+        log_dispatcher_stop = true;
+        pthread_cond_signal(&log_wakeup);
+        pthread_mutex_unlock(&log_wakeup_lock);
 
-    return true;
+        Py_BEGIN_ALLOW_THREADS
+        pthread_join(log_dispatcher, NULL);
+        Py_END_ALLOW_THREADS
+
+        log_dispatcher_running = false;
+    }
+
+    // Flush whatever is left before the interpreter goes away.
+    log_queue_drain();
+
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef log_dispatcher_stop_def = {
+    "_stop_log_dispatcher", (PyCFunction)Aerospike_Stop_Log_Dispatcher,
+    METH_NOARGS, NULL};
+
+static as_status log_dispatcher_spawn(as_error *err)
+{
+    log_dispatcher_stop = false;
+    log_dispatcher_restart = false;
+    if (pthread_create(&log_dispatcher, NULL, log_dispatcher_run, NULL) != 0) {
+        return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                               "Unable to start log dispatcher thread");
+    }
+    log_dispatcher_running = true;
+
+    return err->code;
+}
+
+static as_status log_dispatcher_start(as_error *err)
+{
+    if (log_dispatcher_running) {
+        return err->code;
+    }
+
+    // The dispatcher must be stopped before the interpreter is finalized, or
+    // it would try to take the GIL of a dead interpreter.
+    PyObject *py_atexit = PyImport_ImportModule("atexit");
+    PyObject *py_stop = PyCFunction_New(&log_dispatcher_stop_def, NULL);
+    PyObject *py_result = NULL;
+    if (py_atexit && py_stop) {
+        py_result = PyObject_CallMethod(py_atexit, "register", "O", py_stop);
+    }
+    Py_XDECREF(py_atexit);
+    Py_XDECREF(py_stop);
+    if (!py_result) {
+        PyErr_Clear();
+        return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                               "Unable to register log dispatcher shutdown");
+    }
+    Py_DECREF(py_result);
+
+    return log_dispatcher_spawn(err);
+}
+
+void log_fork_child(void)
+{
+    // Only the forking thread survives. The dispatcher may have held the
+    // locks and a producer may have left a record half written, so start
+    // over with fresh locks and an empty queue.
+    pthread_mutex_init(&log_consumer_lock, NULL);
+    pthread_mutex_init(&log_wakeup_lock, NULL);
+    pthread_cond_init(&log_wakeup, NULL);
+    log_queue_head = 0;
+    log_queue_tail = 0;
+    log_ready = 0;
+    log_queue_init();
+
+    log_dispatcher_restart = log_dispatcher_running;
+    log_dispatcher_running = false;
+}
+
+as_status log_dispatcher_resume(as_error *err)
+{
+    if (!log_dispatcher_restart || log_dispatcher_running) {
+        return err->code;
+    }
+
+    // The shutdown hook registered by the parent is inherited by the child.
+    return log_dispatcher_spawn(err);
 }
 
 PyObject *Aerospike_Set_Log_Handler(PyObject *parent, PyObject *args,
@@ -185,10 +492,21 @@ PyObject *Aerospike_Set_Log_Handler(PyObject *parent, PyObject *args,
     PyArg_ParseTupleAndKeywords(args, kwds, "|O:setLogHandler", kwlist,
                                 &py_callback);
 
+    if (!check_main_interpreter("set_log_handler")) {
+        return NULL;
+    }
+
     if (py_callback && PyCallable_Check(py_callback)) {
+        pthread_once(&log_queue_once, log_queue_init);
+
+        if (log_dispatcher_start(&err) != AEROSPIKE_OK) {
+            raise_exception(&err);
+            return NULL;
+        }
+
         // Store user callback
         Py_INCREF(py_callback);
-        user_callback.callback = py_callback;
+        Py_XSETREF(user_callback.callback, py_callback);
 
         // Register callback to C-SDK
         as_log_set_callback((as_log_callback)log_cb);
@@ -201,12 +519,43 @@ PyObject *Aerospike_Set_Log_Handler(PyObject *parent, PyObject *args,
     return PyLong_FromLong(0);
 }
 
-void Aerospike_Enable_Default_Logging()
+PyObject *Aerospike_Drain_Logs(PyObject *parent, PyObject *args)
+{
+    if (!check_main_interpreter("drain_logs")) {
+        return NULL;
+    }
+
+    if (!user_callback.callback) {
+        return PyLong_FromLong(0);
+    }
+
+    return PyLong_FromUnsignedLongLong(log_queue_drain());
+}
+
+PyObject *Aerospike_Get_Log_Stats(PyObject *parent, PyObject *args)
+{
+    size_t tail = __atomic_load_n(&log_queue_tail, __ATOMIC_RELAXED);
+    size_t head = __atomic_load_n(&log_queue_head, __ATOMIC_RELAXED);
+
+    return Py_BuildValue(
+        "{s:K,s:K,s:n}", "delivered",
+        (unsigned long long)__atomic_load_n(&log_delivered, __ATOMIC_RELAXED),
+        "dropped",
+        (unsigned long long)__atomic_load_n(&log_dropped, __ATOMIC_RELAXED),
+        "pending", (Py_ssize_t)(tail - head));
+}
+
+static void enable_default_logging(void)
 {
     // Invoke C API to set log level
     as_log_set_level((as_log_level)LOG_LEVEL_ERROR);
     // Register callback to C-SDK
     as_log_set_callback((as_log_callback)console_log_cb);
+}
 
-    return;
+void Aerospike_Enable_Default_Logging()
+{
+    // Every interpreter importing the module calls this. Only the first may
+    // set the level, or a handler set in the meantime would be replaced.
+    pthread_once(&default_logging_once, enable_default_logging);
 }
@@ -0,0 +1,748 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <aerospike/as_bytes.h>
+#include <aerospike/as_error.h>
+#include <aerospike/as_msgpack.h>
+#include <aerospike/as_serializer.h>
+#include <citrusleaf/alloc.h>
+
+#include "cdt_types.h"
+#include "conversions.h"
+#include "geo.h"
+#include "key_ordered_dict.h"
+#include "macros.h"
+#include "msgpack_conversions.h"
+#include "msgpack_writer.h"
+#include "policy.h"
+#include "serializer.h"
+
+/*
+ * Aerospike packs strings, blobs and GeoJSON as msgpack str/bin values whose
+ * first byte is the as_bytes type of the payload. Lists and maps may carry a
+ * leading ext element holding their order flags, which is not user data.
+ */
+
+// Lists and maps nested deeper than this are rejected rather than risking the
+// C stack of the calling thread.
+#define MSGPACK_MAX_DEPTH 256
+
+typedef struct {
+    const uint8_t *buffer;
+    uint32_t size;
+    uint32_t offset;
+    uint32_t depth;
+} msgpack_reader;
+
+static as_status unpack_value(AerospikeClient *self, as_error *err,
+                              msgpack_reader *reader, PyObject **py_obj);
+
+static as_status unpack_truncated(as_error *err)
+{
+    return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                           "Truncated msgpack buffer");
+}
+
+static bool read_bytes(msgpack_reader *reader, uint32_t count,
+                       const uint8_t **bytes)
+{
+    if (reader->size - reader->offset < count) {
+        return false;
+    }
+    *bytes = reader->buffer + reader->offset;
+    reader->offset += count;
+    return true;
+}
+
+static bool read_uint(msgpack_reader *reader, uint32_t width, uint64_t *value)
+{
+    const uint8_t *bytes = NULL;
+    if (!read_bytes(reader, width, &bytes)) {
+        return false;
+    }
+
+    uint64_t result = 0;
+    for (uint32_t i = 0; i < width; i++) {
+        result = (result << 8) | bytes[i];
+    }
+    *value = result;
+    return true;
+}
+
+static bool is_ext_header(uint8_t header)
+{
+    return (header >= 0xc7 && header <= 0xc9) ||
+           (header >= 0xd4 && header <= 0xd8);
+}
+
+static bool skip_ext(msgpack_reader *reader, uint8_t header)
+{
+    uint64_t len = 0;
+    const uint8_t *data = NULL;
+
+    switch (header) {
+    case 0xd4:
+    case 0xd5:
+    case 0xd6:
+    case 0xd7:
+    case 0xd8:
+        len = (uint64_t)1 << (header - 0xd4);
+        break;
+    case 0xc7:
+        if (!read_uint(reader, 1, &len)) {
+            return false;
+        }
+        break;
+    case 0xc8:
+        if (!read_uint(reader, 2, &len)) {
+            return false;
+        }
+        break;
+    case 0xc9:
+        if (!read_uint(reader, 4, &len)) {
+            return false;
+        }
+        break;
+    default:
+        return false;
+    }
+
+    // The ext type byte precedes the ext data.
+    return read_bytes(reader, 1, &data) &&
+           read_bytes(reader, (uint32_t)len, &data);
+}
+
+static bool peek_ext(msgpack_reader *reader)
+{
+    return reader->offset < reader->size &&
+           is_ext_header(reader->buffer[reader->offset]);
+}
+
+static as_status unpack_raw(AerospikeClient *self, as_error *err,
+                            const uint8_t *data, uint32_t len,
+                            PyObject **py_obj)
+{
+    if (len == 0) {
+        *py_obj = PyUnicode_FromStringAndSize(NULL, 0);
+        return err->code;
+    }
+
+    uint8_t type = data[0];
+    data++;
+    len--;
+
+    switch (type) {
+    case AS_BYTES_STRING:
+        *py_obj = PyUnicode_DecodeUTF8((const char *)data, len, NULL);
+        if (!*py_obj) {
+            PyErr_Clear();
+            return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                                   "Invalid UTF-8 string in msgpack buffer");
+        }
+        break;
+    case AS_BYTES_GEOJSON:
+        geojson_to_pyobject(err, (const char *)data, len, py_obj);
+        break;
+    case AS_BYTES_LIST:
+    case AS_BYTES_MAP:
+        // Returned as is, like an undecoded CDT bin, so that a crafted value
+        // can't restart decoding without the depth limit.
+        *py_obj = PyBytes_FromStringAndSize((const char *)data, len);
+        break;
+    default: {
+        // Blobs go through the same (de)serializer rules as top level bins.
+        as_bytes bytes;
+        as_bytes_init_wrap(&bytes, (uint8_t *)data, len, false);
+        as_bytes_set_type(&bytes, (as_bytes_type)type);
+        deserialize_based_on_as_bytes_type(self, &bytes, py_obj, err);
+        as_bytes_destroy(&bytes);
+        break;
+    }
+    }
+
+    return err->code;
+}
+
+static as_status unpack_list(AerospikeClient *self, as_error *err,
+                             msgpack_reader *reader, uint32_t count,
+                             PyObject **py_obj)
+{
+    if (count > 0 && peek_ext(reader)) {
+        if (!skip_ext(reader, reader->buffer[reader->offset++])) {
+            return unpack_truncated(err);
+        }
+        count--;
+    }
+
+    // Every element takes at least one byte.
+    if (count > reader->size - reader->offset) {
+        return unpack_truncated(err);
+    }
+
+    PyObject *py_list = PyList_New(count);
+    if (!py_list) {
+        return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                               "Failed to allocate memory for list");
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        PyObject *py_val = NULL;
+        if (unpack_value(self, err, reader, &py_val) != AEROSPIKE_OK) {
+            Py_DECREF(py_list);
+            return err->code;
+        }
+        PyList_SET_ITEM(py_list, i, py_val);
+    }
+
+    *py_obj = py_list;
+    return err->code;
+}
+
+static as_status unpack_map(AerospikeClient *self, as_error *err,
+                            msgpack_reader *reader, uint32_t count,
+                            PyObject **py_obj)
+{
+    if (count > 0 && peek_ext(reader)) {
+        // Skip the flags entry: an ext key paired with a nil value.
+        PyObject *py_nil = NULL;
+        if (!skip_ext(reader, reader->buffer[reader->offset++])) {
+            return unpack_truncated(err);
+        }
+        if (unpack_value(self, err, reader, &py_nil) != AEROSPIKE_OK) {
+            return err->code;
+        }
+        Py_DECREF(py_nil);
+        count--;
+    }
+
+    // Every key and value takes at least one byte.
+    if (count > (reader->size - reader->offset) / 2) {
+        return unpack_truncated(err);
+    }
+
+    PyObject *py_dict = new_presized_dict((Py_ssize_t)count);
+    if (!py_dict) {
+        return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                               "Failed to allocate memory for dictionary.");
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        PyObject *py_key = NULL;
+        PyObject *py_val = NULL;
+
+        unpack_value(self, err, reader, &py_key);
+        if (err->code != AEROSPIKE_OK) {
+            break;
+        }
+        if (unpack_value(self, err, reader, &py_val) != AEROSPIKE_OK) {
+            Py_DECREF(py_key);
+            break;
+        }
+
+        if (PyDict_SetItem(py_dict, py_key, py_val) == -1) {
+            if (PyErr_Occurred() && PyErr_ExceptionMatches(PyExc_TypeError)) {
+                as_error_update(
+                    err, AEROSPIKE_ERR_CLIENT,
+                    "Unable to use unhashable type as a dictionary key");
+            }
+            else {
+                as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                                "Unable to add dictionary item");
+            }
+        }
+        Py_DECREF(py_key);
+        Py_DECREF(py_val);
+
+        if (err->code != AEROSPIKE_OK) {
+            break;
+        }
+    }
+
+    if (err->code != AEROSPIKE_OK) {
+        Py_DECREF(py_dict);
+        return err->code;
+    }
+
+    *py_obj = py_dict;
+    return err->code;
+}
+
+static as_status unpack_next(AerospikeClient *self, as_error *err,
+                             msgpack_reader *reader, PyObject **py_obj)
+{
+    const uint8_t *bytes = NULL;
+    uint64_t value = 0;
+
+    if (!read_bytes(reader, 1, &bytes)) {
+        return unpack_truncated(err);
+    }
+    uint8_t header = bytes[0];
+
+    // positive fixint
+    if (header <= 0x7f) {
+        *py_obj = PyLong_FromLong((long)header);
+        return err->code;
+    }
+    // negative fixint
+    if (header >= 0xe0) {
+        *py_obj = PyLong_FromLong((long)(int8_t)header);
+        return err->code;
+    }
+    // fixmap
+    if (header >= 0x80 && header <= 0x8f) {
+        return unpack_map(self, err, reader, header & 0x0f, py_obj);
+    }
+    // fixarray
+    if (header >= 0x90 && header <= 0x9f) {
+        return unpack_list(self, err, reader, header & 0x0f, py_obj);
+    }
+    // fixstr
+    if (header >= 0xa0 && header <= 0xbf) {
+        uint32_t len = header & 0x1f;
+        if (!read_bytes(reader, len, &bytes)) {
+            return unpack_truncated(err);
+        }
+        return unpack_raw(self, err, bytes, len, py_obj);
+    }
+
+    switch (header) {
+    case 0xc0:
+        Py_INCREF(Py_None);
+        *py_obj = Py_None;
+        return err->code;
+    case 0xc2:
+        *py_obj = PyBool_FromLong(0);
+        return err->code;
+    case 0xc3:
+        *py_obj = PyBool_FromLong(1);
+        return err->code;
+
+    // bin 8/16/32 and str 8/16/32
+    case 0xc4:
+    case 0xc5:
+    case 0xc6:
+    case 0xd9:
+    case 0xda:
+    case 0xdb: {
+        uint32_t width = 1;
+        if (header == 0xc5 || header == 0xda) {
+            width = 2;
+        }
+        else if (header == 0xc6 || header == 0xdb) {
+            width = 4;
+        }
+        if (!read_uint(reader, width, &value) ||
+            !read_bytes(reader, (uint32_t)value, &bytes)) {
+            return unpack_truncated(err);
+        }
+        return unpack_raw(self, err, bytes, (uint32_t)value, py_obj);
+    }
+
+    case 0xca: {
+        if (!read_uint(reader, 4, &value)) {
+            return unpack_truncated(err);
+        }
+        uint32_t bits = (uint32_t)value;
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        *py_obj = PyFloat_FromDouble((double)f);
+        return err->code;
+    }
+    case 0xcb: {
+        if (!read_uint(reader, 8, &value)) {
+            return unpack_truncated(err);
+        }
+        double d;
+        memcpy(&d, &value, sizeof(d));
+        *py_obj = PyFloat_FromDouble(d);
+        return err->code;
+    }
+
+    // uint 8/16/32/64
+    case 0xcc:
+    case 0xcd:
+    case 0xce:
+    case 0xcf:
+        if (!read_uint(reader, 1 << (header - 0xcc), &value)) {
+            return unpack_truncated(err);
+        }
+        // Matches as_integer, which stores every integer as int64_t.
+        *py_obj = PyLong_FromLongLong((long long)(int64_t)value);
+        return err->code;
+
+    // int 8/16/32/64
+    case 0xd0:
+    case 0xd1:
+    case 0xd2:
+    case 0xd3: {
+        uint32_t width = 1 << (header - 0xd0);
+        if (!read_uint(reader, width, &value)) {
+            return unpack_truncated(err);
+        }
+        int64_t i;
+        if (width == 1) {
+            i = (int8_t)value;
+        }
+        else if (width == 2) {
+            i = (int16_t)value;
+        }
+        else if (width == 4) {
+            i = (int32_t)value;
+        }
+        else {
+            i = (int64_t)value;
+        }
+        *py_obj = PyLong_FromLongLong((long long)i);
+        return err->code;
+    }
+
+    // array 16/32
+    case 0xdc:
+    case 0xdd:
+        if (!read_uint(reader, header == 0xdc ? 2 : 4, &value)) {
+            return unpack_truncated(err);
+        }
+        return unpack_list(self, err, reader, (uint32_t)value, py_obj);
+
+    // map 16/32
+    case 0xde:
+    case 0xdf:
+        if (!read_uint(reader, header == 0xde ? 2 : 4, &value)) {
+            return unpack_truncated(err);
+        }
+        return unpack_map(self, err, reader, (uint32_t)value, py_obj);
+
+    default:
+        break;
+    }
+
+    if (is_ext_header(header)) {
+        // Ext values (wildcard, infinity) are only used in operations and have
+        // no stored representation.
+        if (!skip_ext(reader, header)) {
+            return unpack_truncated(err);
+        }
+        Py_INCREF(Py_None);
+        *py_obj = Py_None;
+        return err->code;
+    }
+
+    return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                           "Unknown msgpack type 0x%02x", header);
+}
+
+static as_status unpack_value(AerospikeClient *self, as_error *err,
+                              msgpack_reader *reader, PyObject **py_obj)
+{
+    if (reader->depth >= MSGPACK_MAX_DEPTH) {
+        return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                               "msgpack value nested more than %d levels deep",
+                               MSGPACK_MAX_DEPTH);
+    }
+
+    *py_obj = NULL;
+    reader->depth++;
+    unpack_next(self, err, reader, py_obj);
+    reader->depth--;
+
+    if (err->code != AEROSPIKE_OK) {
+        Py_CLEAR(*py_obj);
+    }
+    else if (!*py_obj) {
+        PyErr_Clear();
+        as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                        "Unable to create Python object from msgpack value");
+    }
+    return err->code;
+}
+
+as_status msgpack_to_pyobject(AerospikeClient *self, as_error *err,
+                              const uint8_t *buffer, uint32_t size,
+                              PyObject **py_obj)
+{
+    as_error_reset(err);
+
+    msgpack_reader reader = {
+        .buffer = buffer, .size = size, .offset = 0, .depth = 0};
+
+    if (unpack_value(self, err, &reader, py_obj) == AEROSPIKE_OK &&
+        reader.offset != reader.size) {
+        Py_CLEAR(*py_obj);
+        as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                        "Trailing bytes after msgpack value");
+    }
+    return err->code;
+}
+
+/*
+ * Encoding. Values are packed the same way the C client's msgpack serializer
+ * packs the equivalent as_val, so the server sees identical bin contents.
+ */
+
+static as_status pack_value(AerospikeClient *self, as_error *err,
+                            msgpack_writer *writer, PyObject *py_obj,
+                            as_static_pool *static_pool, int serializer_type);
+
+static as_status pack_raw(as_error *err, msgpack_writer *writer,
+                          as_bytes_type type, const uint8_t *data,
+                          Py_ssize_t len)
+{
+    if ((uint64_t)len >= UINT32_MAX) {
+        return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                               "Value is too large to be packed");
+    }
+
+    // The payload is prefixed by its particle type.
+    uint32_t size = (uint32_t)len + 1;
+
+    if (size < 32) {
+        msgpack_write_header(err, writer, (uint8_t)(0xa0 | size), 0, 0);
+    }
+    else if (size <= UINT8_MAX) {
+        msgpack_write_header(err, writer, 0xd9, size, 1);
+    }
+    else if (size <= UINT16_MAX) {
+        msgpack_write_header(err, writer, 0xda, size, 2);
+    }
+    else {
+        msgpack_write_header(err, writer, 0xdb, size, 4);
+    }
+    if (err->code != AEROSPIKE_OK) {
+        return err->code;
+    }
+
+    uint8_t *bytes = msgpack_reserve(err, writer, size);
+    if (!bytes) {
+        return err->code;
+    }
+    bytes[0] = (uint8_t)type;
+    if (len > 0) {
+        memcpy(bytes + 1, data, (size_t)len);
+    }
+    return err->code;
+}
+
+/*
+ * Values with no direct msgpack form of their own (key ordered maps, CDT
+ * wildcard/infinity markers) are built as an as_val and packed by the C client
+ * serializer, so their encoding stays in one place.
+ */
+static as_status pack_as_val(AerospikeClient *self, as_error *err,
+                             msgpack_writer *writer, PyObject *py_obj,
+                             as_static_pool *static_pool, int serializer_type)
+{
+    as_val *val = NULL;
+    if (pyobject_to_val(self, err, py_obj, &val, static_pool,
+                        serializer_type) != AEROSPIKE_OK) {
+        return err->code;
+    }
+
+    as_serializer serializer;
+    as_msgpack_init(&serializer);
+
+    uint32_t size = as_serializer_serialize_getsize(&serializer, val);
+    uint8_t *bytes = msgpack_reserve(err, writer, size);
+    if (bytes) {
+        as_serializer_serialize_presized(&serializer, val, bytes);
+    }
+
+    as_serializer_destroy(&serializer);
+    as_val_destroy(val);
+    return err->code;
+}
+
+static as_status pack_list(AerospikeClient *self, as_error *err,
+                           msgpack_writer *writer, PyObject *py_list,
+                           as_static_pool *static_pool, int serializer_type)
+{
+    Py_ssize_t size = PyList_GET_SIZE(py_list);
+
+    if (msgpack_pack_container_header(err, writer, false, size) !=
+        AEROSPIKE_OK) {
+        return err->code;
+    }
+
+    for (Py_ssize_t i = 0; i < size; i++) {
+        if (pack_value(self, err, writer, PyList_GET_ITEM(py_list, i),
+                       static_pool, serializer_type) != AEROSPIKE_OK) {
+            break;
+        }
+    }
+    return err->code;
+}
+
+static as_status pack_map(AerospikeClient *self, as_error *err,
+                          msgpack_writer *writer, PyObject *py_dict,
+                          as_static_pool *static_pool, int serializer_type)
+{
+    PyObject *py_key = NULL;
+    PyObject *py_val = NULL;
+    Py_ssize_t pos = 0;
+
+    if (msgpack_pack_container_header(err, writer, true,
+                                      PyDict_Size(py_dict)) != AEROSPIKE_OK) {
+        return err->code;
+    }
+
+    while (PyDict_Next(py_dict, &pos, &py_key, &py_val)) {
+        if (pack_value(self, err, writer, py_key, static_pool,
+                       serializer_type) != AEROSPIKE_OK) {
+            break;
+        }
+        if (pack_value(self, err, writer, py_val, static_pool,
+                       serializer_type) != AEROSPIKE_OK) {
+            break;
+        }
+    }
+    return err->code;
+}
+
+static as_status pack_value(AerospikeClient *self, as_error *err,
+                            msgpack_writer *writer, PyObject *py_obj,
+                            as_static_pool *static_pool, int serializer_type)
+{
+    if (!py_obj) {
+        // this should never happen, but if it did...
+        return as_error_update(err, AEROSPIKE_ERR_CLIENT, "value is null");
+    }
+    else if (PyBool_Check(py_obj)) {
+        switch (self->send_bool_as) {
+        case SEND_BOOL_AS_AS_BOOL:
+            return msgpack_write_header(
+                err, writer, py_obj == Py_True ? 0xc3 : 0xc2, 0, 0);
+        case SEND_BOOL_AS_INTEGER:
+            return msgpack_pack_int64(err, writer, py_obj == Py_True ? 1 : 0);
+        default:
+            return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                                   "Unknown value for send_bool_as.");
+        }
+    }
+    else if (PyLong_Check(py_obj)) {
+        int64_t i = (int64_t)PyLong_AsLongLong(py_obj);
+        if (i == -1 && PyErr_Occurred()) {
+            if (PyErr_ExceptionMatches(PyExc_OverflowError)) {
+                return as_error_update(err, AEROSPIKE_ERR_PARAM,
+                                       "integer value exceeds sys.maxsize");
+            }
+        }
+        return msgpack_pack_int64(err, writer, i);
+    }
+    else if (PyUnicode_Check(py_obj)) {
+        Py_ssize_t len = 0;
+        const char *str = PyUnicode_AsUTF8AndSize(py_obj, &len);
+        if (!str) {
+            return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                                   "Unicode value not encoded in utf-8.");
+        }
+        return pack_raw(err, writer, AS_BYTES_STRING, (const uint8_t *)str,
+                        len);
+    }
+    else if (PyBytes_Check(py_obj)) {
+        return pack_raw(err, writer, AS_BYTES_BLOB,
+                        (const uint8_t *)PyBytes_AS_STRING(py_obj),
+                        PyBytes_GET_SIZE(py_obj));
+    }
+    else if (!strcmp(py_obj->ob_type->tp_name, "aerospike.Geospatial")) {
+        PyObject *geospatial_dump =
+            AerospikeGeospatial_GetGeoJSON(py_obj, err);
+        if (!geospatial_dump) {
+            return err->code;
+        }
+
+        Py_ssize_t len = 0;
+        const char *geo_value = PyUnicode_AsUTF8AndSize(geospatial_dump, &len);
+        if (geo_value) {
+            pack_raw(err, writer, AS_BYTES_GEOJSON,
+                     (const uint8_t *)geo_value, len);
+        }
+        else {
+            as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                            "Unicode value not encoded in utf-8.");
+        }
+        Py_DECREF(geospatial_dump);
+        return err->code;
+    }
+    else if (PyByteArray_Check(py_obj)) {
+        return pack_raw(err, writer, AS_BYTES_BLOB,
+                        (const uint8_t *)PyByteArray_AS_STRING(py_obj),
+                        PyByteArray_GET_SIZE(py_obj));
+    }
+    else if (PyList_Check(py_obj)) {
+        return pack_list(self, err, writer, py_obj, static_pool,
+                         serializer_type);
+    }
+    else if (PyDict_Check(py_obj)) {
+        if (AerospikeKeyOrderedDict_Check(py_obj)) {
+            // Key ordered maps must be packed sorted, with an order ext key.
+            return pack_as_val(self, err, writer, py_obj, static_pool,
+                               serializer_type);
+        }
+        return pack_map(self, err, writer, py_obj, static_pool,
+                        serializer_type);
+    }
+    else if (Py_None == py_obj ||
+             !strcmp(py_obj->ob_type->tp_name, "aerospike.null")) {
+        return msgpack_write_header(err, writer, 0xc0, 0, 0);
+    }
+    else if (AS_Matches_Classname(py_obj, AS_CDT_WILDCARD_NAME) ||
+             AS_Matches_Classname(py_obj, AS_CDT_INFINITE_NAME)) {
+        return pack_as_val(self, err, writer, py_obj, static_pool,
+                           serializer_type);
+    }
+    else if (PyFloat_Check(py_obj)) {
+        return msgpack_pack_double(err, writer, PyFloat_AsDouble(py_obj));
+    }
+
+    as_bytes *bytes;
+    GET_BYTES_POOL(bytes, static_pool, err);
+    if (err->code != AEROSPIKE_OK) {
+        return err->code;
+    }
+    if (serialize_based_on_serializer_policy(self, serializer_type, &bytes,
+                                             py_obj, static_pool,
+                                             err) != AEROSPIKE_OK) {
+        return err->code;
+    }
+    return pack_raw(err, writer, as_bytes_get_type(bytes),
+                    as_bytes_get(bytes), as_bytes_size(bytes));
+}
+
+as_status pyobject_to_msgpack_bytes(AerospikeClient *self, as_error *err,
+                                    PyObject *py_obj, as_bytes **bytes,
+                                    as_static_pool *static_pool,
+                                    int serializer_type)
+{
+    as_error_reset(err);
+
+    msgpack_writer writer = MSGPACK_WRITER_INIT;
+    as_bytes_type type = PyList_Check(py_obj) ? AS_BYTES_LIST : AS_BYTES_MAP;
+
+    pack_value(self, err, &writer, py_obj, static_pool, serializer_type);
+    if (err->code != AEROSPIKE_OK) {
+        cf_free(writer.buffer);
+        return err->code;
+    }
+
+    *bytes = as_bytes_new_wrap(writer.buffer, writer.size, true);
+    as_bytes_set_type(*bytes, type);
+
+    return err->code;
+}
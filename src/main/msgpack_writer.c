@@ -0,0 +1,156 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <aerospike/as_error.h>
+#include <citrusleaf/alloc.h>
+
+#include "msgpack_writer.h"
+
+#define MSGPACK_WRITER_INITIAL_CAPACITY 64
+
+uint8_t *msgpack_reserve(as_error *err, msgpack_writer *writer,
+                         uint32_t count)
+{
+    if (writer->capacity - writer->size < count) {
+        uint64_t capacity = writer->capacity ? writer->capacity
+                                             : MSGPACK_WRITER_INITIAL_CAPACITY;
+        while (capacity - writer->size < count) {
+            capacity *= 2;
+        }
+        if (capacity > UINT32_MAX) {
+            as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                            "Value is too large to be packed");
+            return NULL;
+        }
+
+        uint8_t *buffer = cf_realloc(writer->buffer, (size_t)capacity);
+        if (!buffer) {
+            as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                            "Failed to allocate memory for packed value");
+            return NULL;
+        }
+        writer->buffer = buffer;
+        writer->capacity = (uint32_t)capacity;
+    }
+
+    uint8_t *bytes = writer->buffer + writer->size;
+    writer->size += count;
+    return bytes;
+}
+
+void msgpack_put_uint(uint8_t *bytes, uint64_t value, uint32_t width)
+{
+    for (uint32_t i = width; i > 0; i--) {
+        bytes[i - 1] = (uint8_t)value;
+        value >>= 8;
+    }
+}
+
+as_status msgpack_write_header(as_error *err, msgpack_writer *writer,
+                               uint8_t header, uint64_t value, uint32_t width)
+{
+    uint8_t *bytes = msgpack_reserve(err, writer, width + 1);
+    if (bytes) {
+        bytes[0] = header;
+        msgpack_put_uint(bytes + 1, value, width);
+    }
+    return err->code;
+}
+
+as_status msgpack_write_data(as_error *err, msgpack_writer *writer,
+                             const void *data, Py_ssize_t len)
+{
+    if (msgpack_check_size(err, len) != AEROSPIKE_OK) {
+        return err->code;
+    }
+    uint8_t *bytes = msgpack_reserve(err, writer, (uint32_t)len);
+    if (bytes && len > 0) {
+        memcpy(bytes, data, (size_t)len);
+    }
+    return err->code;
+}
+
+as_status msgpack_check_size(as_error *err, Py_ssize_t len)
+{
+    if ((uint64_t)len > UINT32_MAX) {
+        return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                               "Value is too large to be packed");
+    }
+    return err->code;
+}
+
+as_status msgpack_pack_int64(as_error *err, msgpack_writer *writer, int64_t i)
+{
+    if (i >= 0) {
+        uint64_t u = (uint64_t)i;
+        if (u < 128) {
+            return msgpack_write_header(err, writer, (uint8_t)u, 0, 0);
+        }
+        if (u <= UINT8_MAX) {
+            return msgpack_write_header(err, writer, 0xcc, u, 1);
+        }
+        if (u <= UINT16_MAX) {
+            return msgpack_write_header(err, writer, 0xcd, u, 2);
+        }
+        if (u <= UINT32_MAX) {
+            return msgpack_write_header(err, writer, 0xce, u, 4);
+        }
+        return msgpack_write_header(err, writer, 0xcf, u, 8);
+    }
+
+    if (i >= -32) {
+        return msgpack_write_header(err, writer, (uint8_t)(int8_t)i, 0, 0);
+    }
+    if (i >= INT8_MIN) {
+        return msgpack_write_header(err, writer, 0xd0, (uint64_t)i, 1);
+    }
+    if (i >= INT16_MIN) {
+        return msgpack_write_header(err, writer, 0xd1, (uint64_t)i, 2);
+    }
+    if (i >= INT32_MIN) {
+        return msgpack_write_header(err, writer, 0xd2, (uint64_t)i, 4);
+    }
+    return msgpack_write_header(err, writer, 0xd3, (uint64_t)i, 8);
+}
+
+as_status msgpack_pack_double(as_error *err, msgpack_writer *writer, double d)
+{
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    return msgpack_write_header(err, writer, 0xcb, bits, 8);
+}
+
+as_status msgpack_pack_container_header(as_error *err, msgpack_writer *writer,
+                                        bool is_map, Py_ssize_t count)
+{
+    if (msgpack_check_size(err, count) != AEROSPIKE_OK) {
+        return err->code;
+    }
+    if (count < 16) {
+        return msgpack_write_header(
+            err, writer, (uint8_t)((is_map ? 0x80 : 0x90) | count), 0, 0);
+    }
+    if (count <= UINT16_MAX) {
+        return msgpack_write_header(err, writer, is_map ? 0xde : 0xdc, count,
+                                    2);
+    }
+    return msgpack_write_header(err, writer, is_map ? 0xdf : 0xdd, count, 4);
+}
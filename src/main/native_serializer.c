@@ -0,0 +1,949 @@
+/*******************************************************************************
+ * Copyright 2013-2021 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <datetime.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <aerospike/as_bytes.h>
+#include <aerospike/as_error.h>
+#include <citrusleaf/alloc.h>
+
+#include "module_state.h"
+#include "msgpack_writer.h"
+#include "native_serializer.h"
+
+/*
+ * Values are stored as a single msgpack value behind a 4 byte header. Python
+ * types msgpack has no notion of are written as ext values whose payload is
+ * described next to each type below. The header starts with a byte that is not
+ * a pickle opcode, so blobs written by older clients with SERIALIZER_PYTHON
+ * are told apart from these.
+ */
+static const uint8_t NATIVE_MAGIC[] = {0x00, 'A', 'S', 0x01};
+
+#define NATIVE_MAGIC_SIZE sizeof(NATIVE_MAGIC)
+
+enum native_ext_type {
+    // Array of the items.
+    NATIVE_EXT_TUPLE = 1,
+    NATIVE_EXT_SET = 2,
+    NATIVE_EXT_FROZENSET = 3,
+    // Raw bytes.
+    NATIVE_EXT_BYTEARRAY = 4,
+    // year u16, month, day, hour, minute, second u8, microsecond u32, then
+    // for aware values the UTC offset as seconds and microseconds i32, then
+    // a byte set to 1 if the fold is set.
+    NATIVE_EXT_DATETIME = 5,
+    // year u16, month, day u8.
+    NATIVE_EXT_DATE = 6,
+    // days, seconds, microseconds i32.
+    NATIVE_EXT_TIMEDELTA = 7,
+    // ASCII str() of the value.
+    NATIVE_EXT_DECIMAL = 8,
+    // The 16 bytes of the UUID.
+    NATIVE_EXT_UUID = 9,
+    // ASCII decimal digits, for integers that do not fit in 64 bits.
+    NATIVE_EXT_BIGINT = 10,
+};
+
+static PyObject *import_type(PyObject **py_type, const char *module,
+                             const char *name)
+{
+    if (!*py_type) {
+        PyObject *py_module = PyImport_ImportModule(module);
+        if (!py_module) {
+            return NULL;
+        }
+        *py_type = PyObject_GetAttrString(py_module, name);
+        Py_DECREF(py_module);
+    }
+    return *py_type;
+}
+
+/*
+ * Decimal and UUID are imported once per interpreter and kept in the state of
+ * its aerospike module.
+ */
+static PyObject *decimal_type(void)
+{
+    struct Aerospike_State *state = Aerospike_Get_State();
+    if (!state) {
+        return NULL;
+    }
+    return import_type(&state->py_decimal_type, "decimal", "Decimal");
+}
+
+static PyObject *uuid_type(void)
+{
+    struct Aerospike_State *state = Aerospike_Get_State();
+    if (!state) {
+        return NULL;
+    }
+    return import_type(&state->py_uuid_type, "uuid", "UUID");
+}
+
+static bool init_datetime_api(as_error *err)
+{
+    if (!PyDateTimeAPI) {
+        PyDateTime_IMPORT;
+        if (!PyDateTimeAPI) {
+            as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                            "Unable to import the datetime module");
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Encoding.
+ */
+
+static as_status pack_value(as_error *err, msgpack_writer *writer,
+                            PyObject *py_obj);
+
+static as_status pack_str(as_error *err, msgpack_writer *writer,
+                          const char *str, Py_ssize_t len)
+{
+    if (msgpack_check_size(err, len) != AEROSPIKE_OK) {
+        return err->code;
+    }
+    if (len < 32) {
+        msgpack_write_header(err, writer, (uint8_t)(0xa0 | len), 0, 0);
+    }
+    else if (len <= UINT8_MAX) {
+        msgpack_write_header(err, writer, 0xd9, len, 1);
+    }
+    else if (len <= UINT16_MAX) {
+        msgpack_write_header(err, writer, 0xda, len, 2);
+    }
+    else {
+        msgpack_write_header(err, writer, 0xdb, len, 4);
+    }
+    if (err->code != AEROSPIKE_OK) {
+        return err->code;
+    }
+    return msgpack_write_data(err, writer, str, len);
+}
+
+static as_status pack_bin(as_error *err, msgpack_writer *writer,
+                          const char *data, Py_ssize_t len)
+{
+    if (msgpack_check_size(err, len) != AEROSPIKE_OK) {
+        return err->code;
+    }
+    if (len <= UINT8_MAX) {
+        msgpack_write_header(err, writer, 0xc4, len, 1);
+    }
+    else if (len <= UINT16_MAX) {
+        msgpack_write_header(err, writer, 0xc5, len, 2);
+    }
+    else {
+        msgpack_write_header(err, writer, 0xc6, len, 4);
+    }
+    if (err->code != AEROSPIKE_OK) {
+        return err->code;
+    }
+    return msgpack_write_data(err, writer, data, len);
+}
+
+static as_status pack_ext(as_error *err, msgpack_writer *writer, uint8_t type,
+                          const void *data, Py_ssize_t len)
+{
+    if (msgpack_check_size(err, len) != AEROSPIKE_OK) {
+        return err->code;
+    }
+    if (len <= UINT8_MAX) {
+        msgpack_write_header(err, writer, 0xc7, len, 1);
+    }
+    else if (len <= UINT16_MAX) {
+        msgpack_write_header(err, writer, 0xc8, len, 2);
+    }
+    else {
+        msgpack_write_header(err, writer, 0xc9, len, 4);
+    }
+    if (err->code != AEROSPIKE_OK) {
+        return err->code;
+    }
+    if (msgpack_write_header(err, writer, type, 0, 0) != AEROSPIKE_OK) {
+        return err->code;
+    }
+    return msgpack_write_data(err, writer, data, len);
+}
+
+static as_status pack_items(as_error *err, msgpack_writer *writer,
+                            PyObject *py_iterable, Py_ssize_t count)
+{
+    if (msgpack_pack_container_header(err, writer, false, count) !=
+        AEROSPIKE_OK) {
+        return err->code;
+    }
+
+    PyObject *py_iter = PyObject_GetIter(py_iterable);
+    if (!py_iter) {
+        return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                               "Unable to iterate over value");
+    }
+    PyObject *py_item = NULL;
+    while ((py_item = PyIter_Next(py_iter))) {
+        pack_value(err, writer, py_item);
+        Py_DECREF(py_item);
+        if (err->code != AEROSPIKE_OK) {
+            break;
+        }
+    }
+    Py_DECREF(py_iter);
+    return err->code;
+}
+
+/*
+ * Containers are written as an ext32 whose length is filled in once the items
+ * have been packed.
+ */
+static as_status pack_collection(as_error *err, msgpack_writer *writer,
+                                 uint8_t type, PyObject *py_obj)
+{
+    uint32_t start = writer->size;
+    if (!msgpack_reserve(err, writer, 6)) {
+        return err->code;
+    }
+
+    if (pack_items(err, writer, py_obj, PyObject_Size(py_obj)) !=
+        AEROSPIKE_OK) {
+        return err->code;
+    }
+
+    uint8_t *header = writer->buffer + start;
+    header[0] = 0xc9;
+    msgpack_put_uint(header + 1, writer->size - start - 6, 4);
+    header[5] = type;
+    return err->code;
+}
+
+static as_status pack_map(as_error *err, msgpack_writer *writer,
+                          PyObject *py_dict)
+{
+    PyObject *py_key = NULL;
+    PyObject *py_val = NULL;
+    Py_ssize_t pos = 0;
+
+    if (msgpack_pack_container_header(err, writer, true,
+                                      PyDict_Size(py_dict)) != AEROSPIKE_OK) {
+        return err->code;
+    }
+
+    while (PyDict_Next(py_dict, &pos, &py_key, &py_val)) {
+        if (pack_value(err, writer, py_key) != AEROSPIKE_OK ||
+            pack_value(err, writer, py_val) != AEROSPIKE_OK) {
+            break;
+        }
+    }
+    return err->code;
+}
+
+static as_status pack_ascii(as_error *err, msgpack_writer *writer,
+                            uint8_t type, PyObject *py_obj)
+{
+    PyObject *py_str = PyObject_Str(py_obj);
+    if (!py_str) {
+        return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                               "Unable to convert value to a string");
+    }
+    Py_ssize_t len = 0;
+    const char *str = PyUnicode_AsUTF8AndSize(py_str, &len);
+    if (str) {
+        pack_ext(err, writer, type, str, len);
+    }
+    else {
+        as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                        "Unable to convert value to a string");
+    }
+    Py_DECREF(py_str);
+    return err->code;
+}
+
+static as_status pack_datetime(as_error *err, msgpack_writer *writer,
+                               PyObject *py_obj)
+{
+    uint8_t data[20];
+    uint32_t len = 11;
+
+    msgpack_put_uint(data, PyDateTime_GET_YEAR(py_obj), 2);
+    data[2] = PyDateTime_GET_MONTH(py_obj);
+    data[3] = PyDateTime_GET_DAY(py_obj);
+    data[4] = PyDateTime_DATE_GET_HOUR(py_obj);
+    data[5] = PyDateTime_DATE_GET_MINUTE(py_obj);
+    data[6] = PyDateTime_DATE_GET_SECOND(py_obj);
+    msgpack_put_uint(data + 7, PyDateTime_DATE_GET_MICROSECOND(py_obj), 4);
+
+    PyObject *py_offset = PyObject_CallMethod(py_obj, "utcoffset", NULL);
+    if (!py_offset) {
+        PyErr_Clear();
+        return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                               "Unable to get the UTC offset of a datetime");
+    }
+    if (PyDelta_Check(py_offset)) {
+        int64_t seconds =
+            (int64_t)PyDateTime_DELTA_GET_DAYS(py_offset) * 86400 +
+            PyDateTime_DELTA_GET_SECONDS(py_offset);
+        msgpack_put_uint(data + 11, (uint32_t)(int32_t)seconds, 4);
+        msgpack_put_uint(
+            data + 15, (uint32_t)PyDateTime_DELTA_GET_MICROSECONDS(py_offset),
+            4);
+        len = 19;
+    }
+    else if (py_offset != Py_None) {
+        Py_DECREF(py_offset);
+        return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                               "Unable to get the UTC offset of a datetime");
+    }
+    Py_DECREF(py_offset);
+
+    // The fold of a repeated wall time is only written when set.
+    if (PyDateTime_DATE_GET_FOLD(py_obj)) {
+        data[len++] = 1;
+    }
+
+    return pack_ext(err, writer, NATIVE_EXT_DATETIME, data, len);
+}
+
+/*
+ * Only the exact types are written, since reading a value back builds the
+ * base type: a namedtuple, IntEnum or OrderedDict would silently come back as
+ * a tuple, int or dict. Subclasses need a Python serializer.
+ */
+static as_status pack_value(as_error *err, msgpack_writer *writer,
+                            PyObject *py_obj)
+{
+    if (Py_EnterRecursiveCall(" while serializing a value")) {
+        PyErr_Clear();
+        return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                               "Value is nested too deeply to be serialized");
+    }
+
+    PyTypeObject *type = Py_TYPE(py_obj);
+    PyObject *py_decimal = NULL;
+    PyObject *py_uuid = NULL;
+
+    if (py_obj == Py_None) {
+        msgpack_write_header(err, writer, 0xc0, 0, 0);
+    }
+    else if (PyBool_Check(py_obj)) {
+        msgpack_write_header(err, writer, py_obj == Py_True ? 0xc3 : 0xc2, 0,
+                             0);
+    }
+    else if (PyLong_CheckExact(py_obj)) {
+        int overflow = 0;
+        long long i = PyLong_AsLongLongAndOverflow(py_obj, &overflow);
+        if (overflow) {
+            pack_ascii(err, writer, NATIVE_EXT_BIGINT, py_obj);
+        }
+        else {
+            msgpack_pack_int64(err, writer, (int64_t)i);
+        }
+    }
+    else if (PyFloat_CheckExact(py_obj)) {
+        msgpack_pack_double(err, writer, PyFloat_AS_DOUBLE(py_obj));
+    }
+    else if (PyUnicode_CheckExact(py_obj)) {
+        Py_ssize_t len = 0;
+        const char *str = PyUnicode_AsUTF8AndSize(py_obj, &len);
+        if (str) {
+            pack_str(err, writer, str, len);
+        }
+        else {
+            PyErr_Clear();
+            as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                            "Unicode value not encoded in utf-8.");
+        }
+    }
+    else if (PyBytes_CheckExact(py_obj)) {
+        pack_bin(err, writer, PyBytes_AS_STRING(py_obj),
+                 PyBytes_GET_SIZE(py_obj));
+    }
+    else if (PyByteArray_CheckExact(py_obj)) {
+        pack_ext(err, writer, NATIVE_EXT_BYTEARRAY,
+                 PyByteArray_AS_STRING(py_obj), PyByteArray_GET_SIZE(py_obj));
+    }
+    else if (PyList_CheckExact(py_obj)) {
+        pack_items(err, writer, py_obj, PyList_GET_SIZE(py_obj));
+    }
+    else if (PyDict_CheckExact(py_obj)) {
+        pack_map(err, writer, py_obj);
+    }
+    else if (PyTuple_CheckExact(py_obj)) {
+        pack_collection(err, writer, NATIVE_EXT_TUPLE, py_obj);
+    }
+    else if (PyFrozenSet_CheckExact(py_obj)) {
+        pack_collection(err, writer, NATIVE_EXT_FROZENSET, py_obj);
+    }
+    else if (type == &PySet_Type) {
+        pack_collection(err, writer, NATIVE_EXT_SET, py_obj);
+    }
+    else if (PyDateTime_CheckExact(py_obj)) {
+        pack_datetime(err, writer, py_obj);
+    }
+    else if (PyDate_CheckExact(py_obj)) {
+        uint8_t data[4];
+        msgpack_put_uint(data, PyDateTime_GET_YEAR(py_obj), 2);
+        data[2] = PyDateTime_GET_MONTH(py_obj);
+        data[3] = PyDateTime_GET_DAY(py_obj);
+        pack_ext(err, writer, NATIVE_EXT_DATE, data, sizeof(data));
+    }
+    else if (PyDelta_CheckExact(py_obj)) {
+        uint8_t data[12];
+        msgpack_put_uint(data, (uint32_t)PyDateTime_DELTA_GET_DAYS(py_obj), 4);
+        msgpack_put_uint(data + 4,
+                         (uint32_t)PyDateTime_DELTA_GET_SECONDS(py_obj), 4);
+        msgpack_put_uint(data + 8,
+                         (uint32_t)PyDateTime_DELTA_GET_MICROSECONDS(py_obj),
+                         4);
+        pack_ext(err, writer, NATIVE_EXT_TIMEDELTA, data, sizeof(data));
+    }
+    else if (!(py_decimal = decimal_type()) || !(py_uuid = uuid_type())) {
+        PyErr_Clear();
+        as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                        "Unable to import the decimal and uuid modules");
+    }
+    else if (type == (PyTypeObject *)py_decimal) {
+        pack_ascii(err, writer, NATIVE_EXT_DECIMAL, py_obj);
+    }
+    else if (type == (PyTypeObject *)py_uuid) {
+        PyObject *py_bytes = PyObject_GetAttrString(py_obj, "bytes");
+        if (py_bytes && PyBytes_Check(py_bytes) &&
+            PyBytes_GET_SIZE(py_bytes) == 16) {
+            pack_ext(err, writer, NATIVE_EXT_UUID, PyBytes_AS_STRING(py_bytes),
+                     16);
+        }
+        else {
+            PyErr_Clear();
+            as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                            "Unable to get the bytes of a UUID");
+        }
+        Py_XDECREF(py_bytes);
+    }
+    else {
+        as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                        "Unable to serialize value of type %s",
+                        type->tp_name);
+    }
+
+    Py_LeaveRecursiveCall();
+    return err->code;
+}
+
+as_status pyobject_to_native_bytes(as_error *err, PyObject *py_obj,
+                                   as_bytes **bytes)
+{
+    if (!init_datetime_api(err)) {
+        return err->code;
+    }
+
+    msgpack_writer writer = MSGPACK_WRITER_INIT;
+
+    if (msgpack_write_data(err, &writer, NATIVE_MAGIC, NATIVE_MAGIC_SIZE) !=
+            AEROSPIKE_OK ||
+        pack_value(err, &writer, py_obj) != AEROSPIKE_OK) {
+        cf_free(writer.buffer);
+        PyErr_Clear();
+        return err->code;
+    }
+
+    as_bytes_init_wrap(*bytes, writer.buffer, writer.size, true);
+    as_bytes_set_type(*bytes, AS_BYTES_PYTHON);
+    return err->code;
+}
+
+/*
+ * Decoding.
+ */
+
+typedef struct {
+    const uint8_t *buffer;
+    uint32_t size;
+    uint32_t offset;
+} native_reader;
+
+static as_status unpack_value(as_error *err, native_reader *reader,
+                              PyObject **py_obj);
+
+static as_status unpack_truncated(as_error *err)
+{
+    return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                           "Truncated serialized value");
+}
+
+static bool read_bytes(native_reader *reader, uint32_t count,
+                       const uint8_t **bytes)
+{
+    if (reader->size - reader->offset < count) {
+        return false;
+    }
+    *bytes = reader->buffer + reader->offset;
+    reader->offset += count;
+    return true;
+}
+
+static uint64_t get_uint(const uint8_t *bytes, uint32_t width)
+{
+    uint64_t result = 0;
+    for (uint32_t i = 0; i < width; i++) {
+        result = (result << 8) | bytes[i];
+    }
+    return result;
+}
+
+static bool read_uint(native_reader *reader, uint32_t width, uint64_t *value)
+{
+    const uint8_t *bytes = NULL;
+    if (!read_bytes(reader, width, &bytes)) {
+        return false;
+    }
+    *value = get_uint(bytes, width);
+    return true;
+}
+
+static as_status unpack_list(as_error *err, native_reader *reader,
+                             uint32_t count, PyObject **py_obj)
+{
+    // Every item takes at least one byte.
+    if (count > reader->size - reader->offset) {
+        return unpack_truncated(err);
+    }
+
+    PyObject *py_list = PyList_New((Py_ssize_t)count);
+    if (!py_list) {
+        return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                               "Failed to allocate memory for list.");
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        PyObject *py_item = NULL;
+        if (unpack_value(err, reader, &py_item) != AEROSPIKE_OK) {
+            Py_DECREF(py_list);
+            return err->code;
+        }
+        PyList_SET_ITEM(py_list, i, py_item);
+    }
+
+    *py_obj = py_list;
+    return err->code;
+}
+
+static as_status unpack_map(as_error *err, native_reader *reader,
+                            uint32_t count, PyObject **py_obj)
+{
+    PyObject *py_dict = PyDict_New();
+    if (!py_dict) {
+        return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                               "Failed to allocate memory for dictionary.");
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        PyObject *py_key = NULL;
+        PyObject *py_val = NULL;
+
+        if (unpack_value(err, reader, &py_key) != AEROSPIKE_OK) {
+            break;
+        }
+        if (unpack_value(err, reader, &py_val) != AEROSPIKE_OK) {
+            Py_DECREF(py_key);
+            break;
+        }
+        if (PyDict_SetItem(py_dict, py_key, py_val) == -1) {
+            as_error_update(
+                err, AEROSPIKE_ERR_CLIENT,
+                "Unable to use unhashable type as a dictionary key");
+        }
+        Py_DECREF(py_key);
+        Py_DECREF(py_val);
+        if (err->code != AEROSPIKE_OK) {
+            break;
+        }
+    }
+
+    if (err->code != AEROSPIKE_OK) {
+        Py_DECREF(py_dict);
+        return err->code;
+    }
+    *py_obj = py_dict;
+    return err->code;
+}
+
+static PyObject *unpack_ascii(const uint8_t *data, uint32_t len,
+                              PyObject *py_type)
+{
+    PyObject *py_str =
+        PyUnicode_DecodeASCII((const char *)data, (Py_ssize_t)len, NULL);
+    if (!py_str) {
+        return NULL;
+    }
+    PyObject *py_obj = py_type ? PyObject_CallFunctionObjArgs(py_type, py_str,
+                                                              NULL)
+                               : PyLong_FromUnicodeObject(py_str, 10);
+    Py_DECREF(py_str);
+    return py_obj;
+}
+
+static PyObject *unpack_datetime(const uint8_t *data, uint32_t len)
+{
+    // A trailing byte holds the fold.
+    int fold = len == 12 || len == 20 ? data[len - 1] : 0;
+    if (fold) {
+        len--;
+    }
+    if ((len != 11 && len != 19) || fold > 1) {
+        return NULL;
+    }
+
+    PyObject *py_tz = Py_None;
+    Py_INCREF(py_tz);
+    if (len == 19) {
+        int32_t seconds = (int32_t)(uint32_t)get_uint(data + 11, 4);
+        int32_t micros = (int32_t)(uint32_t)get_uint(data + 15, 4);
+        PyObject *py_offset = PyDelta_FromDSU(0, seconds, micros);
+        Py_DECREF(py_tz);
+        py_tz = py_offset ? PyTimeZone_FromOffset(py_offset) : NULL;
+        Py_XDECREF(py_offset);
+        if (!py_tz) {
+            return NULL;
+        }
+    }
+
+    PyObject *py_obj = PyDateTimeAPI->DateTime_FromDateAndTimeAndFold(
+        (int)get_uint(data, 2), data[2], data[3], data[4], data[5], data[6],
+        (int)get_uint(data + 7, 4), py_tz, fold, PyDateTimeAPI->DateTimeType);
+    Py_DECREF(py_tz);
+    return py_obj;
+}
+
+static as_status unpack_ext(as_error *err, native_reader *reader,
+                            uint32_t len, PyObject **py_obj)
+{
+    const uint8_t *type = NULL;
+    const uint8_t *data = NULL;
+    if (!read_bytes(reader, 1, &type) || !read_bytes(reader, len, &data)) {
+        return unpack_truncated(err);
+    }
+
+    PyObject *py_result = NULL;
+
+    switch (type[0]) {
+    case NATIVE_EXT_TUPLE:
+    case NATIVE_EXT_SET:
+    case NATIVE_EXT_FROZENSET: {
+        native_reader items = {.buffer = data, .size = len, .offset = 0};
+        PyObject *py_list = NULL;
+        if (unpack_value(err, &items, &py_list) != AEROSPIKE_OK) {
+            return err->code;
+        }
+        if (!PyList_Check(py_list) || items.offset != items.size) {
+            Py_DECREF(py_list);
+            break;
+        }
+        if (type[0] == NATIVE_EXT_TUPLE) {
+            py_result = PyList_AsTuple(py_list);
+        }
+        else if (type[0] == NATIVE_EXT_SET) {
+            py_result = PySet_New(py_list);
+        }
+        else {
+            py_result = PyFrozenSet_New(py_list);
+        }
+        Py_DECREF(py_list);
+        break;
+    }
+    case NATIVE_EXT_BYTEARRAY:
+        py_result =
+            PyByteArray_FromStringAndSize((const char *)data, (Py_ssize_t)len);
+        break;
+    case NATIVE_EXT_DATETIME:
+        py_result = unpack_datetime(data, len);
+        break;
+    case NATIVE_EXT_DATE:
+        if (len == 4) {
+            py_result = PyDate_FromDate((int)get_uint(data, 2), data[2],
+                                        data[3]);
+        }
+        break;
+    case NATIVE_EXT_TIMEDELTA:
+        if (len == 12) {
+            py_result = PyDelta_FromDSU(
+                (int32_t)(uint32_t)get_uint(data, 4),
+                (int32_t)(uint32_t)get_uint(data + 4, 4),
+                (int32_t)(uint32_t)get_uint(data + 8, 4));
+        }
+        break;
+    case NATIVE_EXT_DECIMAL: {
+        PyObject *py_decimal = decimal_type();
+        if (py_decimal) {
+            py_result = unpack_ascii(data, len, py_decimal);
+        }
+        break;
+    }
+    case NATIVE_EXT_UUID: {
+        PyObject *py_uuid = uuid_type();
+        if (py_uuid && len == 16) {
+            PyObject *py_bytes =
+                PyBytes_FromStringAndSize((const char *)data, 16);
+            PyObject *py_kwargs =
+                py_bytes ? Py_BuildValue("{s:O}", "bytes", py_bytes) : NULL;
+            PyObject *py_args = py_kwargs ? PyTuple_New(0) : NULL;
+            if (py_args) {
+                py_result = PyObject_Call(py_uuid, py_args, py_kwargs);
+            }
+            Py_XDECREF(py_args);
+            Py_XDECREF(py_kwargs);
+            Py_XDECREF(py_bytes);
+        }
+        break;
+    }
+    case NATIVE_EXT_BIGINT:
+        py_result = unpack_ascii(data, len, NULL);
+        break;
+    default:
+        break;
+    }
+
+    if (!py_result) {
+        PyErr_Clear();
+        return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                               "Invalid serialized value of ext type %d",
+                               type[0]);
+    }
+    *py_obj = py_result;
+    return err->code;
+}
+
+static as_status unpack_value(as_error *err, native_reader *reader,
+                              PyObject **py_obj)
+{
+    const uint8_t *bytes = NULL;
+    uint64_t value = 0;
+
+    if (!read_bytes(reader, 1, &bytes)) {
+        return unpack_truncated(err);
+    }
+    uint8_t header = bytes[0];
+
+    if (Py_EnterRecursiveCall(" while deserializing a value")) {
+        PyErr_Clear();
+        return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                               "Value is nested too deeply");
+    }
+
+    // positive fixint
+    if (header <= 0x7f) {
+        *py_obj = PyLong_FromLong((long)header);
+    }
+    // negative fixint
+    else if (header >= 0xe0) {
+        *py_obj = PyLong_FromLong((long)(int8_t)header);
+    }
+    // fixmap
+    else if (header <= 0x8f) {
+        unpack_map(err, reader, header & 0x0f, py_obj);
+    }
+    // fixarray
+    else if (header <= 0x9f) {
+        unpack_list(err, reader, header & 0x0f, py_obj);
+    }
+    // fixstr
+    else if (header <= 0xbf) {
+        uint32_t len = header & 0x1f;
+        if (!read_bytes(reader, len, &bytes)) {
+            unpack_truncated(err);
+        }
+        else {
+            *py_obj = PyUnicode_DecodeUTF8((const char *)bytes, len, NULL);
+        }
+    }
+    else {
+        switch (header) {
+        case 0xc0:
+            Py_INCREF(Py_None);
+            *py_obj = Py_None;
+            break;
+        case 0xc2:
+        case 0xc3:
+            *py_obj = PyBool_FromLong(header == 0xc3);
+            break;
+
+        // bin 8/16/32 and str 8/16/32
+        case 0xc4:
+        case 0xc5:
+        case 0xc6:
+        case 0xd9:
+        case 0xda:
+        case 0xdb: {
+            uint32_t width = 1;
+            if (header == 0xc5 || header == 0xda) {
+                width = 2;
+            }
+            else if (header == 0xc6 || header == 0xdb) {
+                width = 4;
+            }
+            if (!read_uint(reader, width, &value) ||
+                !read_bytes(reader, (uint32_t)value, &bytes)) {
+                unpack_truncated(err);
+            }
+            else if (header <= 0xc6) {
+                *py_obj = PyBytes_FromStringAndSize((const char *)bytes,
+                                                    (Py_ssize_t)value);
+            }
+            else {
+                *py_obj = PyUnicode_DecodeUTF8((const char *)bytes,
+                                               (Py_ssize_t)value, NULL);
+            }
+            break;
+        }
+
+        // ext 8/16/32
+        case 0xc7:
+        case 0xc8:
+        case 0xc9:
+            if (!read_uint(reader, 1 << (header - 0xc7), &value)) {
+                unpack_truncated(err);
+            }
+            else {
+                unpack_ext(err, reader, (uint32_t)value, py_obj);
+            }
+            break;
+
+        case 0xca: {
+            if (!read_uint(reader, 4, &value)) {
+                unpack_truncated(err);
+                break;
+            }
+            uint32_t bits = (uint32_t)value;
+            float f;
+            memcpy(&f, &bits, sizeof(f));
+            *py_obj = PyFloat_FromDouble((double)f);
+            break;
+        }
+        case 0xcb: {
+            if (!read_uint(reader, 8, &value)) {
+                unpack_truncated(err);
+                break;
+            }
+            double d;
+            memcpy(&d, &value, sizeof(d));
+            *py_obj = PyFloat_FromDouble(d);
+            break;
+        }
+
+        // uint 8/16/32/64
+        case 0xcc:
+        case 0xcd:
+        case 0xce:
+        case 0xcf:
+            if (!read_uint(reader, 1 << (header - 0xcc), &value)) {
+                unpack_truncated(err);
+            }
+            else {
+                *py_obj = PyLong_FromUnsignedLongLong(value);
+            }
+            break;
+
+        // int 8/16/32/64
+        case 0xd0:
+        case 0xd1:
+        case 0xd2:
+        case 0xd3: {
+            uint32_t width = 1 << (header - 0xd0);
+            if (!read_uint(reader, width, &value)) {
+                unpack_truncated(err);
+                break;
+            }
+            // Sign extend from the encoded width.
+            uint32_t shift = 64 - width * 8;
+            int64_t i = (int64_t)(value << shift) >> shift;
+            *py_obj = PyLong_FromLongLong((long long)i);
+            break;
+        }
+
+        // array 16/32
+        case 0xdc:
+        case 0xdd:
+            if (!read_uint(reader, header == 0xdc ? 2 : 4, &value)) {
+                unpack_truncated(err);
+            }
+            else {
+                unpack_list(err, reader, (uint32_t)value, py_obj);
+            }
+            break;
+
+        // map 16/32
+        case 0xde:
+        case 0xdf:
+            if (!read_uint(reader, header == 0xde ? 2 : 4, &value)) {
+                unpack_truncated(err);
+            }
+            else {
+                unpack_map(err, reader, (uint32_t)value, py_obj);
+            }
+            break;
+
+        default:
+            as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                            "Unknown serialized type 0x%02x", header);
+            break;
+        }
+    }
+
+    Py_LeaveRecursiveCall();
+
+    if (err->code == AEROSPIKE_OK && !*py_obj) {
+        PyErr_Clear();
+        as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                        "Unable to deserialize value");
+    }
+    return err->code;
+}
+
+bool is_native_bytes(as_bytes *bytes)
+{
+    return as_bytes_size(bytes) > NATIVE_MAGIC_SIZE &&
+           memcmp(as_bytes_get(bytes), NATIVE_MAGIC, NATIVE_MAGIC_SIZE) == 0;
+}
+
+as_status native_bytes_to_pyobject(as_error *err, as_bytes *bytes,
+                                   PyObject **py_obj)
+{
+    if (!init_datetime_api(err)) {
+        return err->code;
+    }
+
+    native_reader reader = {.buffer = as_bytes_get(bytes),
+                            .size = as_bytes_size(bytes),
+                            .offset = NATIVE_MAGIC_SIZE};
+    PyObject *py_value = NULL;
+
+    if (unpack_value(err, &reader, &py_value) != AEROSPIKE_OK) {
+        return err->code;
+    }
+    if (reader.offset != reader.size) {
+        Py_DECREF(py_value);
+        return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+                               "Trailing data after serialized value");
+    }
+
+    *py_obj = py_value;
+    return err->code;
+}
@@ -19,81 +19,45 @@
 #include <stdbool.h>
 #include <unistd.h>
 
+#include "module_state.h"
 #include "nullobject.h"
 
-static PyObject *AerospikeNullObject_Type_New(PyTypeObject *parent,
-                                              PyObject *args, PyObject *kwds);
+/*******************************************************************************
+ * PYTHON TYPE HOOKS
+ ******************************************************************************/
 
-static void AerospikeNullObject_Type_Dealloc(AerospikeNullObject *self)
+static PyObject *AerospikeNullObject_Type_New(PyTypeObject *type,
+                                              PyObject *args, PyObject *kwds)
 {
-    PyObject_Del(self);
+    return type->tp_alloc(type, 0);
 }
 
 /*******************************************************************************
  * PYTHON TYPE DESCRIPTOR
  ******************************************************************************/
 
-static PyTypeObject AerospikeNullObject_Type = {
-    PyVarObject_HEAD_INIT(NULL, 0) "aerospike.null", // tp_name
-    sizeof(AerospikeNullObject),                     // tp_basicsize
-    0,                                               // tp_itemsize
-    (destructor)AerospikeNullObject_Type_Dealloc,
-    // tp_dealloc
-    0, // tp_print
-    0, // tp_getattr
-    0, // tp_setattr
-    0, // tp_compare
-    0, // tp_repr
-    0, // tp_as_number
-    0, // tp_as_sequence
-    0, // tp_as_mapping
-    0, // tp_hash
-    0, // tp_call
-    0, // tp_str
-    0, // tp_getattro
-    0, // tp_setattro
-    0, // tp_as_buffer
-    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
-    // tp_flags
-    "The nullobject when used with put() works as a removebin()\n",
-    // tp_doc
-    0,                            // tp_traverse
-    0,                            // tp_clear
-    0,                            // tp_richcompare
-    0,                            // tp_weaklistoffset
-    0,                            // tp_iter
-    0,                            // tp_iternext
-    0,                            // tp_methods
-    0,                            // tp_members
-    0,                            // tp_getset
-    0,                            // tp_base
-    0,                            // tp_dict
-    0,                            // tp_descr_get
-    0,                            // tp_descr_set
-    0,                            // tp_dictoffset
-    0,                            // tp_init
-    0,                            // tp_alloc
-    AerospikeNullObject_Type_New, // tp_new
-    0,                            // tp_free
-    0,                            // tp_is_gc
-    0                             // tp_bases
-};
+static PyType_Slot AerospikeNullObject_Type_Slots[] = {
+    {Py_tp_doc,
+     "The nullobject when used with put() works as a removebin()\n"},
+    {Py_tp_new, AerospikeNullObject_Type_New},
+    {0, NULL}};
 
-static PyObject *AerospikeNullObject_Type_New(PyTypeObject *parent,
-                                              PyObject *args, PyObject *kwds)
-{
-    return (PyObject *)PyObject_New(AerospikeNullObject, parent);
-}
+static PyType_Spec AerospikeNullObject_Type_Spec = {
+    .name = "aerospike.null",
+    .basicsize = sizeof(AerospikeNullObject),
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+    .slots = AerospikeNullObject_Type_Slots};
 
 PyObject *AerospikeNullObject_New()
 {
-    return AerospikeNullObject_Type_New(&AerospikeNullObject_Type, Py_None,
-                                        Py_None);
+    struct Aerospike_State *state = Aerospike_Get_State();
+    if (!state) {
+        return NULL;
+    }
+    return AerospikeNullObject_Type_New(state->null_object, Py_None, Py_None);
 }
 
-PyTypeObject *AerospikeNullObject_Ready()
+PyTypeObject *AerospikeNullObject_Ready(PyObject *module)
 {
-    return PyType_Ready(&AerospikeNullObject_Type) == 0
-               ? &AerospikeNullObject_Type
-               : NULL;
+    return Aerospike_New_Type(module, &AerospikeNullObject_Type_Spec, NULL);
 }
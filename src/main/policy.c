@@ -45,6 +45,10 @@
         return as_error_update(err, AEROSPIKE_ERR_PARAM,                       \
                                "policy must be a dict");                       \
     }                                                                          \
+    if (!policy_priority_valid(py_policy)) {                                   \
+        return as_error_update(err, AEROSPIKE_ERR_PARAM,                       \
+                               "priority is invalid");                         \
+    }                                                                          \
     __policy##_init(policy);
 
 #define POLICY_UPDATE() *policy_p = policy;
@@ -119,6 +123,22 @@
         }                                                                      \
     }
 
+/*
+ * The priority selects a lane of the command limits, see command_limits.h.
+ */
+static bool policy_priority_valid(PyObject *py_policy)
+{
+    PyObject *py_priority = PyDict_GetItemString(py_policy, "priority");
+    if (!py_priority) {
+        return true;
+    }
+
+    long priority = PyLong_Check(py_priority) ? PyLong_AsLong(py_priority) : -1;
+    return priority == POLICY_PRIORITY_DEFAULT ||
+           priority == POLICY_PRIORITY_INTERACTIVE ||
+           priority == POLICY_PRIORITY_BULK;
+}
+
 /*
  *******************************************************************************************************
  * Mapping of constant number to constant name string.
@@ -152,6 +172,9 @@ static AerospikeConstants aerospike_constants[] = {
     {SERIALIZER_NONE, "SERIALIZER_NONE"},
     {SEND_BOOL_AS_INTEGER, "INTEGER"},
     {SEND_BOOL_AS_AS_BOOL, "AS_BOOL"},
+    {POLICY_PRIORITY_DEFAULT, "POLICY_PRIORITY_DEFAULT"},
+    {POLICY_PRIORITY_INTERACTIVE, "POLICY_PRIORITY_INTERACTIVE"},
+    {POLICY_PRIORITY_BULK, "POLICY_PRIORITY_BULK"},
     {AS_INDEX_STRING, "INDEX_STRING"},
     {AS_INDEX_NUMERIC, "INDEX_NUMERIC"},
     {AS_INDEX_GEO2DSPHERE, "INDEX_GEO2DSPHERE"},
@@ -383,5 +383,8 @@ PyObject *AerospikePredicates_New(void)
                                            NULL};
 
     PyObject *module = PyModule_Create(&moduledef);
+#ifdef Py_GIL_DISABLED
+    PyUnstable_Module_SetGIL(module, Py_MOD_GIL_NOT_USED);
+#endif
     return module;
 }
@@ -23,10 +23,12 @@
 #include <aerospike/as_arraylist.h>
 
 #include "client.h"
+#include "command_limits.h"
 #include "conversions.h"
 #include "exceptions.h"
 #include "query.h"
 #include "policy.h"
+#include "interpreter.h"
 
 // Struct for Python User-Data for the Callback
 typedef struct {
@@ -55,8 +57,7 @@ static bool each_result(const as_val *val, void *udata)
     PyObject *py_return = NULL;
 
     // Lock Python State
-    PyGILState_STATE gstate;
-    gstate = PyGILState_Ensure();
+    Aerospike_GIL_State gstate = Aerospike_GIL_Ensure(data->client->interp);
 
     // Convert as_val to a Python Object
     val_to_pyobject(data->client, err, val, &py_result);
@@ -65,7 +66,7 @@ static bool each_result(const as_val *val, void *udata)
     if (!py_result) {
         //TBD set error here
         // Must release the interpreter lock before returning
-        PyGILState_Release(gstate);
+        Aerospike_GIL_Release(&gstate);
         return true;
     }
 
@@ -92,7 +93,9 @@ static bool each_result(const as_val *val, void *udata)
     }
 
     // Invoke Python Callback
+    command_limits_callback_begin();
     py_return = PyObject_Call(py_callback, py_arglist, NULL);
+    command_limits_callback_end();
 
     // Release Python Function Arguments
     Py_DECREF(py_arglist);
@@ -119,7 +122,7 @@ static bool each_result(const as_val *val, void *udata)
     }
 
     // Release Python State
-    PyGILState_Release(gstate);
+    Aerospike_GIL_Release(&gstate);
 
     return rval;
 }
@@ -205,6 +208,17 @@ PyObject *AerospikeQuery_Foreach(AerospikeQuery *self, PyObject *args,
         goto CLEANUP;
     }
 
+    // Held until the query completes. Commands sent by the callback are not
+    // held to max_concurrent, so they cannot wait for this slot.
+    command_permit permit;
+    if (!command_limits_acquire_set(self->client, COMMAND_LIMIT_QUERY,
+                                    py_policy, self->query.ns, self->query.set,
+                                    &permit, &data.error)) {
+        if (ps) {
+            as_partitions_status_release(ps);
+        }
+        goto CLEANUP;
+    }
     Py_BEGIN_ALLOW_THREADS
 
     // Invoke operation
@@ -227,6 +241,7 @@ PyObject *AerospikeQuery_Foreach(AerospikeQuery *self, PyObject *args,
     }
 
     Py_END_ALLOW_THREADS
+    command_limits_release(self->client, &permit);
 
     if (data.error.code != AEROSPIKE_OK) {
         as_error_update(&data.error, data.error.code, NULL);
@@ -244,21 +259,10 @@ CLEANUP:
     self->query.apply.arglist = NULL;
 
     if (err.code != AEROSPIKE_OK || data.error.code != AEROSPIKE_OK) {
-        PyObject *py_err = NULL;
-        PyObject *exception_type = NULL;
-        if (err.code != AEROSPIKE_OK) {
-            error_to_pyobject(&err, &py_err);
-            exception_type = raise_exception_old(&err);
-        }
-        if (data.error.code != AEROSPIKE_OK) {
-            error_to_pyobject(&data.error, &py_err);
-            exception_type = raise_exception_old(&data.error);
-        }
-        if (PyObject_HasAttrString(exception_type, "name")) {
-            PyObject_SetAttrString(exception_type, "name", Py_None);
-        }
-        PyErr_SetObject(exception_type, py_err);
-        Py_DECREF(py_err);
+        // An error from the callback takes precedence.
+        as_error *error_p =
+            data.error.code != AEROSPIKE_OK ? &data.error : &err;
+        raise_exception_base(error_p, NULL, NULL, NULL, NULL, Py_None);
         return NULL;
     }
 
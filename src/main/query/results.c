@@ -24,10 +24,12 @@
 #include <aerospike/as_arraylist.h>
 
 #include "client.h"
+#include "command_limits.h"
 #include "conversions.h"
 #include "exceptions.h"
 #include "query.h"
 #include "policy.h"
+#include "interpreter.h"
 
 #undef TRACE
 #define TRACE()
@@ -50,8 +52,7 @@ static bool each_result(const as_val *val, void *udata)
 
     as_error err;
 
-    PyGILState_STATE gstate;
-    gstate = PyGILState_Ensure();
+    Aerospike_GIL_State gstate = Aerospike_GIL_Ensure(data->client->interp);
 
     val_to_pyobject(data->client, &err, val, &py_result);
 
@@ -59,7 +60,7 @@ static bool each_result(const as_val *val, void *udata)
         PyList_Append(py_results, py_result);
         Py_DECREF(py_result);
     }
-    PyGILState_Release(gstate);
+    Aerospike_GIL_Release(&gstate);
 
     return true;
 }
@@ -137,6 +138,15 @@ PyObject *AerospikeQuery_Results(AerospikeQuery *self, PyObject *args,
     py_results = PyList_New(0);
     data.py_results = py_results;
 
+    command_permit permit;
+    if (!command_limits_acquire_set(self->client, COMMAND_LIMIT_QUERY,
+                                    py_policy, self->query.ns, self->query.set,
+                                    &permit, &err)) {
+        if (ps) {
+            as_partitions_status_release(ps);
+        }
+        goto CLEANUP;
+    }
     Py_BEGIN_ALLOW_THREADS
 
     if (partition_filter_p) {
@@ -158,6 +168,7 @@ PyObject *AerospikeQuery_Results(AerospikeQuery *self, PyObject *args,
     }
 
     Py_END_ALLOW_THREADS
+    command_limits_release(self->client, &permit);
 
 CLEANUP: /*??trace()*/
     if (exp_list_p) {
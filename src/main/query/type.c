@@ -24,10 +24,12 @@
 #include <aerospike/as_policy.h>
 #include <aerospike/as_query.h>
 
+#include "allocator.h"
 #include "client.h"
 #include "query.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "module_state.h"
 
 /*******************************************************************************
  * PYTHON DOC METHODS
@@ -83,6 +85,20 @@ PyDoc_STRVAR(get_parts_doc,
 Gets the complete partition status of the query. \
 Returns a dictionary of the form {id:(id, init, done, digest), ...}.");
 
+PyDoc_STRVAR(split_doc, "split(n) -> list of partition filters\n\
+\n\
+Splits the partitions of the query into n contiguous ranges. \
+Returns a list of partition_filter dicts that can each be passed in a query policy.");
+
+PyDoc_STRVAR(checkpoint_doc, "checkpoint() -> bytes\n\
+\n\
+Serializes the partition status of the query into a compact bytes object.");
+
+PyDoc_STRVAR(resume_doc, "resume(checkpoint)\n\
+\n\
+Restores the partition status saved by checkpoint(). \
+The next results() or foreach() call continues from where the query left off.");
+
 /*******************************************************************************
  * PYTHON TYPE METHODS
  ******************************************************************************/
@@ -117,6 +133,15 @@ static PyMethodDef AerospikeQuery_Type_Methods[] = {
     {"get_partitions_status", (PyCFunction)AerospikeQuery_Get_Partitions_status,
      METH_NOARGS, get_parts_doc},
 
+    {"split", (PyCFunction)AerospikeQuery_Split, METH_VARARGS | METH_KEYWORDS,
+     split_doc},
+
+    {"checkpoint", (PyCFunction)AerospikeQuery_Checkpoint, METH_NOARGS,
+     checkpoint_doc},
+
+    {"resume", (PyCFunction)AerospikeQuery_Resume,
+     METH_VARARGS | METH_KEYWORDS, resume_doc},
+
     {NULL}};
 
 /*******************************************************************************
@@ -220,6 +245,18 @@ CLEANUP:
     return 0;
 }
 
+static PyObject *AerospikeQuery_Type_GetAttro(AerospikeQuery *self,
+                                              PyObject *py_name)
+{
+    // The query may be used before its client finished connecting, or after
+    // a fork() without its client being touched.
+    if (self->client && AerospikeClient_Ensure_Connected(self->client) == -1) {
+        return NULL;
+    }
+
+    return PyObject_GenericGetAttr((PyObject *)self, py_name);
+}
+
 static void AerospikeQuery_Type_Dealloc(AerospikeQuery *self)
 {
     int i;
@@ -231,90 +268,72 @@ static void AerospikeQuery_Type_Dealloc(AerospikeQuery *self)
 
     if (self->unicodeStrVector != NULL) {
         for (unsigned int i = 0; i < self->unicodeStrVector->size; ++i) {
-            free(as_vector_get_ptr(self->unicodeStrVector, i));
+            allocator_free(as_vector_get_ptr(self->unicodeStrVector, i));
         }
 
         as_vector_destroy(self->unicodeStrVector);
     }
 
     Py_CLEAR(self->client);
-    Py_TYPE(self)->tp_free((PyObject *)self);
+    PyTypeObject *type = Py_TYPE(self);
+    type->tp_free((PyObject *)self);
+    Py_DECREF(type);
 }
 
 /*******************************************************************************
  * PYTHON TYPE DESCRIPTOR
  ******************************************************************************/
-static PyTypeObject AerospikeQuery_Type = {
-    PyVarObject_HEAD_INIT(NULL, 0) "aerospike.Query", // tp_name
-    sizeof(AerospikeQuery),                           // tp_basicsize
-    0,                                                // tp_itemsize
-    (destructor)AerospikeQuery_Type_Dealloc,
-    // tp_dealloc
-    0, // tp_print
-    0, // tp_getattr
-    0, // tp_setattr
-    0, // tp_compare
-    0, // tp_repr
-    0, // tp_as_number
-    0, // tp_as_sequence
-    0, // tp_as_mapping
-    0, // tp_hash
-    0, // tp_call
-    0, // tp_str
-    0, // tp_getattro
-    0, // tp_setattro
-    0, // tp_as_buffer
-    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
-    // tp_flags
-    "The Query class assists in populating the parameters of a query\n"
-    "operation. To create a new instance of the Query class, call the\n"
-    "query() method on an instance of a Client class.\n",
-    // tp_doc
-    0,                                  // tp_traverse
-    0,                                  // tp_clear
-    0,                                  // tp_richcompare
-    0,                                  // tp_weaklistoffset
-    0,                                  // tp_iter
-    0,                                  // tp_iternext
-    AerospikeQuery_Type_Methods,        // tp_methods
-    AerospikeQuery_Type_custom_members, // tp_members
-    0,                                  // tp_getset
-    0,                                  // tp_base
-    0,                                  // tp_dict
-    0,                                  // tp_descr_get
-    0,                                  // tp_descr_set
-    0,                                  // tp_dictoffset
-    (initproc)AerospikeQuery_Type_Init, // tp_init
-    0,                                  // tp_alloc
-    AerospikeQuery_Type_New,            // tp_new
-    0,                                  // tp_free
-    0,                                  // tp_is_gc
-    0                                   // tp_bases
-};
+
+static PyType_Slot AerospikeQuery_Type_Slots[] = {
+    {Py_tp_dealloc, (destructor)AerospikeQuery_Type_Dealloc},
+    {Py_tp_getattro, (getattrofunc)AerospikeQuery_Type_GetAttro},
+    {Py_tp_doc,
+     "The Query class assists in populating the parameters of a query\n"
+     "operation. To create a new instance of the Query class, call the\n"
+     "query() method on an instance of a Client class.\n"},
+    {Py_tp_methods, AerospikeQuery_Type_Methods},
+    {Py_tp_members, AerospikeQuery_Type_custom_members},
+    {Py_tp_init, (initproc)AerospikeQuery_Type_Init},
+    {Py_tp_new, AerospikeQuery_Type_New},
+    {0, NULL}};
+
+static PyType_Spec AerospikeQuery_Type_Spec = {
+    .name = "aerospike.Query",
+    .basicsize = sizeof(AerospikeQuery),
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+    .slots = AerospikeQuery_Type_Slots};
 
 /*******************************************************************************
  * PUBLIC FUNCTIONS
  ******************************************************************************/
 
-PyTypeObject *AerospikeQuery_Ready()
+PyTypeObject *AerospikeQuery_Ready(PyObject *module)
 {
-    return PyType_Ready(&AerospikeQuery_Type) == 0 ? &AerospikeQuery_Type
-                                                   : NULL;
+    return Aerospike_New_Type(module, &AerospikeQuery_Type_Spec, NULL);
 }
 
 AerospikeQuery *AerospikeQuery_New(AerospikeClient *client, PyObject *args,
                                    PyObject *kwds)
 {
-    AerospikeQuery *self = (AerospikeQuery *)AerospikeQuery_Type.tp_new(
-        &AerospikeQuery_Type, args, kwds);
+    struct Aerospike_State *state = Aerospike_Get_Type_State(Py_TYPE(client));
+    if (!state) {
+        return NULL;
+    }
+
+    PyTypeObject *type = state->query;
+    AerospikeQuery *self = (AerospikeQuery *)type->tp_new(type, args, kwds);
+    if (!self) {
+        return NULL;
+    }
     self->client = client;
 
-    if (AerospikeQuery_Type.tp_init((PyObject *)self, args, kwds) == 0) {
+    if (type->tp_init((PyObject *)self, args, kwds) == 0) {
         Py_INCREF(client);
         return self;
     }
 
-    AerospikeQuery_Type.tp_free(self);
+    type->tp_free(self);
+    Py_DECREF(type);
     return NULL;
 }
 
@@ -26,6 +26,7 @@
 #include "exceptions.h"
 #include "scan.h"
 #include "policy.h"
+#include "serializer.h"
 
 bool Scan_Illegal_UDF_Args_Check(PyObject *py_args);
 
@@ -67,7 +68,7 @@ AerospikeScan *AerospikeScan_Apply(AerospikeScan *self, PyObject *args,
         goto CLEANUP;
     }
 
-    self->client->is_client_put_serializer = false;
+    set_client_put_serializer(false);
 
     // Aerospike API Arguments.
     char *module = NULL;
@@ -145,17 +146,7 @@ CLEANUP:
     }
 
     if (err.code != AEROSPIKE_OK) {
-        PyObject *py_err = NULL;
-        error_to_pyobject(&err, &py_err);
-        PyObject *exception_type = raise_exception_old(&err);
-        if (PyObject_HasAttrString(exception_type, "module")) {
-            PyObject_SetAttrString(exception_type, "module", py_module);
-        }
-        if (PyObject_HasAttrString(exception_type, "func")) {
-            PyObject_SetAttrString(exception_type, "func", py_function);
-        }
-        PyErr_SetObject(exception_type, py_err);
-        Py_DECREF(py_err);
+        raise_exception_base(&err, NULL, NULL, py_module, py_function, NULL);
         return NULL;
     }
 
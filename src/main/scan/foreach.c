@@ -23,10 +23,12 @@
 #include <aerospike/as_partition.h>
 
 #include "client.h"
+#include "command_limits.h"
 #include "conversions.h"
 #include "exceptions.h"
 #include "scan.h"
 #include "policy.h"
+#include "interpreter.h"
 
 // Struct for Python User-Data for the Callback
 typedef struct {
@@ -64,14 +66,13 @@ static bool each_result(const as_val *val, void *udata)
     PyObject *py_return = NULL;
 
     // Lock Python State
-    PyGILState_STATE gstate;
-    gstate = PyGILState_Ensure();
+    Aerospike_GIL_State gstate = Aerospike_GIL_Ensure(data->client->interp);
 
     // Convert as_val to a Python Object
     val_to_pyobject(data->client, err, val, &py_result);
 
     if (!py_result) {
-        PyGILState_Release(gstate);
+        Aerospike_GIL_Release(&gstate);
         return true;
     }
 
@@ -87,7 +88,9 @@ static bool each_result(const as_val *val, void *udata)
         PyTuple_SetItem(py_arglist, 0, py_result);
     }
     // Invoke Python Callback
+    command_limits_callback_begin();
     py_return = PyObject_Call(py_callback, py_arglist, NULL);
+    command_limits_callback_end();
 
     // Release Python Function Arguments
     Py_DECREF(py_arglist);
@@ -115,7 +118,7 @@ static bool each_result(const as_val *val, void *udata)
     }
 
     // Release Python State
-    PyGILState_Release(gstate);
+    Aerospike_GIL_Release(&gstate);
 
     return rval;
 }
@@ -213,6 +216,18 @@ PyObject *AerospikeScan_Foreach(AerospikeScan *self, PyObject *args,
         }
     }
 
+    // Held until the scan completes. Commands sent by the callback are not
+    // held to max_concurrent, so they cannot wait for this slot.
+    command_permit permit;
+    if (!command_limits_acquire_set(self->client, COMMAND_LIMIT_SCAN,
+                                    py_policy, self->scan.ns, self->scan.set,
+                                    &permit, &data.error)) {
+        if (ps) {
+            as_partitions_status_release(ps);
+        }
+        goto CLEANUP;
+    }
+
     // We are spawning multiple threads
     Py_BEGIN_ALLOW_THREADS
     // Invoke operation
@@ -237,6 +252,7 @@ PyObject *AerospikeScan_Foreach(AerospikeScan *self, PyObject *args,
     }
     // We are done using multiple threads
     Py_END_ALLOW_THREADS
+    command_limits_release(self->client, &permit);
 
     if (data.error.code != AEROSPIKE_OK) {
         goto CLEANUP;
@@ -47,3 +47,102 @@ CLEANUP:
 
     return py_parts;
 }
+
+PyObject *AerospikeScan_Split(AerospikeScan *self, PyObject *args,
+                               PyObject *kwds)
+{
+    PyObject *py_filters = NULL;
+    long n = 0;
+    as_error err;
+    as_error_init(&err);
+
+    static char *kwlist[] = {"n", NULL};
+
+    if (PyArg_ParseTupleAndKeywords(args, kwds, "l:split", kwlist, &n) ==
+        false) {
+        return NULL;
+    }
+
+    if (!self || !self->client->as) {
+        as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid scan object.");
+        goto CLEANUP;
+    }
+
+    as_partitions_status_split_to_pyobject(&err, self->scan.parts_all, n,
+                                           &py_filters);
+
+CLEANUP:
+    if (err.code != AEROSPIKE_OK) {
+        raise_exception(&err);
+        return NULL;
+    }
+
+    return py_filters;
+}
+
+PyObject *AerospikeScan_Checkpoint(AerospikeScan *self)
+{
+    PyObject *py_checkpoint = NULL;
+    as_error err;
+    as_error_init(&err);
+
+    if (!self || !self->client->as) {
+        as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid scan object.");
+        goto CLEANUP;
+    }
+
+    as_partitions_status_to_checkpoint(&err, self->scan.parts_all,
+                                       &py_checkpoint);
+
+CLEANUP:
+    if (err.code != AEROSPIKE_OK) {
+        raise_exception(&err);
+        return NULL;
+    }
+
+    return py_checkpoint;
+}
+
+PyObject *AerospikeScan_Resume(AerospikeScan *self, PyObject *args,
+                                PyObject *kwds)
+{
+    PyObject *py_checkpoint = NULL;
+    as_partitions_status *parts_all = NULL;
+    as_error err;
+    as_error_init(&err);
+
+    static char *kwlist[] = {"checkpoint", NULL};
+
+    if (PyArg_ParseTupleAndKeywords(args, kwds, "O:resume", kwlist,
+                                    &py_checkpoint) == false) {
+        return NULL;
+    }
+
+    if (!self || !self->client->as) {
+        as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid scan object.");
+        goto CLEANUP;
+    }
+
+    if (checkpoint_to_as_partitions_status(&err, py_checkpoint, &parts_all) !=
+        AEROSPIKE_OK) {
+        goto CLEANUP;
+    }
+
+    if (self->scan.parts_all) {
+        as_partitions_status_release(self->scan.parts_all);
+    }
+
+    // The scan keeps its own reference; keep tracking progress so it can be
+    // checkpointed again.
+    as_scan_set_partitions(&self->scan, parts_all);
+    as_scan_set_paginate(&self->scan, true);
+    as_partitions_status_release(parts_all);
+
+CLEANUP:
+    if (err.code != AEROSPIKE_OK) {
+        raise_exception(&err);
+        return NULL;
+    }
+
+    Py_RETURN_NONE;
+}
@@ -24,10 +24,12 @@
 #include <aerospike/as_partition.h>
 
 #include "client.h"
+#include "command_limits.h"
 #include "conversions.h"
 #include "exceptions.h"
 #include "policy.h"
 #include "scan.h"
+#include "interpreter.h"
 
 #undef TRACE
 #define TRACE()
@@ -50,8 +52,7 @@ static bool each_result(const as_val *val, void *udata)
 
     as_error err;
 
-    PyGILState_STATE gstate;
-    gstate = PyGILState_Ensure();
+    Aerospike_GIL_State gstate = Aerospike_GIL_Ensure(data->client->interp);
 
     val_to_pyobject(data->client, &err, val, &py_result);
 
@@ -60,7 +61,7 @@ static bool each_result(const as_val *val, void *udata)
         Py_DECREF(py_result);
     }
 
-    PyGILState_Release(gstate);
+    Aerospike_GIL_Release(&gstate);
 
     return true;
 }
@@ -148,6 +149,15 @@ PyObject *AerospikeScan_Results(AerospikeScan *self, PyObject *args,
     py_results = PyList_New(0);
     data.py_results = py_results;
 
+    command_permit permit;
+    if (!command_limits_acquire_set(self->client, COMMAND_LIMIT_SCAN,
+                                    py_policy, self->scan.ns, self->scan.set,
+                                    &permit, &err)) {
+        if (ps) {
+            as_partitions_status_release(ps);
+        }
+        goto CLEANUP;
+    }
     Py_BEGIN_ALLOW_THREADS
 
     if (partition_filter_p) {
@@ -171,6 +181,7 @@ PyObject *AerospikeScan_Results(AerospikeScan *self, PyObject *args,
     }
 
     Py_END_ALLOW_THREADS
+    command_limits_release(self->client, &permit);
 
 CLEANUP:
 
@@ -24,11 +24,13 @@
 #include <aerospike/as_policy.h>
 #include <aerospike/as_scan.h>
 
+#include "allocator.h"
 #include "client.h"
 #include "scan.h"
 #include "conversions.h"
 #include "exceptions.h"
 #include "macros.h"
+#include "module_state.h"
 
 /*******************************************************************************
  * PYTHON DOC METHODS
@@ -64,6 +66,20 @@ PyDoc_STRVAR(get_parts_doc,
 Gets the complete partition status of the scan. \
 Returns a dictionary of the form {id:(id, init, done, digest), ...}.");
 
+PyDoc_STRVAR(split_doc, "split(n) -> list of partition filters\n\
+\n\
+Splits the partitions of the scan into n contiguous ranges. \
+Returns a list of partition_filter dicts that can each be passed in a scan policy.");
+
+PyDoc_STRVAR(checkpoint_doc, "checkpoint() -> bytes\n\
+\n\
+Serializes the partition status of the scan into a compact bytes object.");
+
+PyDoc_STRVAR(resume_doc, "resume(checkpoint)\n\
+\n\
+Restores the partition status saved by checkpoint(). \
+The next results() or foreach() call continues from where the scan left off.");
+
 /*******************************************************************************
  * PYTHON TYPE METHODS
  ******************************************************************************/
@@ -97,6 +113,15 @@ static PyMethodDef AerospikeScan_Type_Methods[] = {
     {"get_partitions_status", (PyCFunction)AerospikeScan_Get_Partitions_status,
      METH_NOARGS, get_parts_doc},
 
+    {"split", (PyCFunction)AerospikeScan_Split, METH_VARARGS | METH_KEYWORDS,
+     split_doc},
+
+    {"checkpoint", (PyCFunction)AerospikeScan_Checkpoint, METH_NOARGS,
+     checkpoint_doc},
+
+    {"resume", (PyCFunction)AerospikeScan_Resume,
+     METH_VARARGS | METH_KEYWORDS, resume_doc},
+
     {NULL}};
 
 /*******************************************************************************
@@ -161,92 +186,83 @@ static int AerospikeScan_Type_Init(AerospikeScan *self, PyObject *args,
     return 0;
 }
 
+static PyObject *AerospikeScan_Type_GetAttro(AerospikeScan *self,
+                                             PyObject *py_name)
+{
+    // The scan may be used before its client finished connecting, or after
+    // a fork() without its client being touched.
+    if (self->client && AerospikeClient_Ensure_Connected(self->client) == -1) {
+        return NULL;
+    }
+
+    return PyObject_GenericGetAttr((PyObject *)self, py_name);
+}
+
 static void AerospikeScan_Type_Dealloc(AerospikeScan *self)
 {
     as_scan_destroy(&self->scan);
 
     if (self->unicodeStrVector != NULL) {
         for (unsigned int i = 0; i < self->unicodeStrVector->size; ++i) {
-            free(as_vector_get_ptr(self->unicodeStrVector, i));
+            allocator_free(as_vector_get_ptr(self->unicodeStrVector, i));
         }
 
         as_vector_destroy(self->unicodeStrVector);
     }
 
     Py_CLEAR(self->client);
-    Py_TYPE(self)->tp_free((PyObject *)self);
+    PyTypeObject *type = Py_TYPE(self);
+    type->tp_free((PyObject *)self);
+    Py_DECREF(type);
 }
 
 /*******************************************************************************
  * PYTHON TYPE DESCRIPTOR
  ******************************************************************************/
 
-static PyTypeObject AerospikeScan_Type = {
-    PyVarObject_HEAD_INIT(NULL, 0) "aerospike.Scan", // tp_name
-    sizeof(AerospikeScan),                           // tp_basicsize
-    0,                                               // tp_itemsize
-    (destructor)AerospikeScan_Type_Dealloc,
-    // tp_dealloc
-    0, // tp_print
-    0, // tp_getattr
-    0, // tp_setattr
-    0, // tp_compare
-    0, // tp_repr
-    0, // tp_as_number
-    0, // tp_as_sequence
-    0, // tp_as_mapping
-    0, // tp_hash
-    0, // tp_call
-    0, // tp_str
-    0, // tp_getattro
-    0, // tp_setattro
-    0, // tp_as_buffer
-    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
-    // tp_flags
-    "The Scan class assists in populating the parameters of a scan\n"
-    "operation. To create a new instance of the Scan class, call the\n"
-    "scan() method on an instance of a Client class.\n",
-    // tp_doc
-    0,                          // tp_traverse
-    0,                          // tp_clear
-    0,                          // tp_richcompare
-    0,                          // tp_weaklistoffset
-    0,                          // tp_iter
-    0,                          // tp_iternext
-    AerospikeScan_Type_Methods, // tp_methods
-    0,                          // tp_members
-    0,                          // tp_getset
-    0,                          // tp_base
-    0,                          // tp_dict
-    0,                          // tp_descr_get
-    0,                          // tp_descr_set
-    0,                          // tp_dictoffset
-    (initproc)AerospikeScan_Type_Init,
-    // tp_init
-    0,                      // tp_alloc
-    AerospikeScan_Type_New, // tp_new
-    0,                      // tp_free
-    0,                      // tp_is_gc
-    0                       // tp_bases
-};
+static PyType_Slot AerospikeScan_Type_Slots[] = {
+    {Py_tp_dealloc, (destructor)AerospikeScan_Type_Dealloc},
+    {Py_tp_getattro, (getattrofunc)AerospikeScan_Type_GetAttro},
+    {Py_tp_doc,
+     "The Scan class assists in populating the parameters of a scan\n"
+     "operation. To create a new instance of the Scan class, call the\n"
+     "scan() method on an instance of a Client class.\n"},
+    {Py_tp_methods, AerospikeScan_Type_Methods},
+    {Py_tp_init, (initproc)AerospikeScan_Type_Init},
+    {Py_tp_new, AerospikeScan_Type_New},
+    {0, NULL}};
+
+static PyType_Spec AerospikeScan_Type_Spec = {
+    .name = "aerospike.Scan",
+    .basicsize = sizeof(AerospikeScan),
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+    .slots = AerospikeScan_Type_Slots};
 
 /*******************************************************************************
  * PUBLIC FUNCTIONS
  ******************************************************************************/
 
-PyTypeObject *AerospikeScan_Ready()
+PyTypeObject *AerospikeScan_Ready(PyObject *module)
 {
-    return PyType_Ready(&AerospikeScan_Type) == 0 ? &AerospikeScan_Type : NULL;
+    return Aerospike_New_Type(module, &AerospikeScan_Type_Spec, NULL);
 }
 
 AerospikeScan *AerospikeScan_New(AerospikeClient *client, PyObject *args,
                                  PyObject *kwds)
 {
-    AerospikeScan *self = (AerospikeScan *)AerospikeScan_Type.tp_new(
-        &AerospikeScan_Type, args, kwds);
+    struct Aerospike_State *state = Aerospike_Get_Type_State(Py_TYPE(client));
+    if (!state) {
+        return NULL;
+    }
+
+    PyTypeObject *type = state->scan;
+    AerospikeScan *self = (AerospikeScan *)type->tp_new(type, args, kwds);
+    if (!self) {
+        return NULL;
+    }
     self->client = client;
     Py_INCREF(client);
-    if (AerospikeScan_Type.tp_init((PyObject *)self, args, kwds) != -1) {
+    if (type->tp_init((PyObject *)self, args, kwds) != -1) {
         return self;
     }
     else {
@@ -20,17 +20,63 @@
 #include <aerospike/as_key.h>
 #include <aerospike/as_error.h>
 #include <aerospike/as_record.h>
+#include <citrusleaf/alloc.h>
 
 #include "client.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "module_state.h"
+#include "msgpack_conversions.h"
+#include "native_serializer.h"
 #include "policy.h"
 #include "serializer.h"
 
-uint32_t is_user_serializer_registered = 0;
-uint32_t is_user_deserializer_registered = 0;
+/*
+ * The serializer and deserializer registered for the module are kept in its
+ * state, NULL when unset. Registering publishes a new struct instead of
+ * changing the current one, as other threads may be using it without the GIL.
+ * Replaced structs and their callbacks are not freed for the same reason.
+ */
+static user_serializer_callback *registered_callback(AerospikeClient *self,
+                                                     bool deserializer)
+{
+    struct Aerospike_State *state =
+        self ? Aerospike_Get_Type_State(Py_TYPE(self)) : Aerospike_Get_State();
+    if (!state) {
+        // Without the module there is nothing registered.
+        PyErr_Clear();
+        return NULL;
+    }
+
+    return __atomic_load_n(deserializer ? &state->user_deserializer
+                                        : &state->user_serializer,
+                           __ATOMIC_ACQUIRE);
+}
+
+static void register_callback(user_serializer_callback **slot,
+                              PyObject *py_func, bool batch, bool buffer)
+{
+    user_serializer_callback *callback = NULL;
+
+    if (py_func) {
+        callback = (user_serializer_callback *)cf_calloc(
+            1, sizeof(user_serializer_callback));
+        Py_INCREF(py_func);
+        callback->callback = py_func;
+        callback->batch = batch;
+        callback->buffer = buffer;
+    }
+    __atomic_store_n(slot, callback, __ATOMIC_RELEASE);
+}
+
+// Whether the put() being run passed a serializer. Kept per thread, as calls
+// on the same client may run concurrently without the GIL.
+static __thread bool client_put_serializer;
 
-user_serializer_callback user_serializer_call_info, user_deserializer_call_info;
+void set_client_put_serializer(bool is_client_put_serializer)
+{
+    client_put_serializer = is_client_put_serializer;
+}
 
 /**
  ******************************************************************************************************
@@ -44,44 +90,33 @@ user_serializer_callback user_serializer_call_info, user_deserializer_call_info;
  * Returns  integer handle for the serializer being set.
  *******************************************************************************************************
  */
-PyObject *AerospikeClient_Set_Serializer(AerospikeClient *self, PyObject *args,
+PyObject *AerospikeClient_Set_Serializer(PyObject *parent, PyObject *args,
                                          PyObject *kwds)
 {
     // Python Function Arguments
     PyObject *py_func = NULL;
+    int batch = 0;
 
     // Python Function Keyword Arguments
-    static char *kwlist[] = {"function", NULL};
+    static char *kwlist[] = {"function", "batch", NULL};
     as_error err;
     // Initialize error
     as_error_init(&err);
 
     // Python Function Argument Parsing
-    if (PyArg_ParseTupleAndKeywords(args, kwds, "O:set_serializer", kwlist,
-                                    &py_func) == false) {
+    if (PyArg_ParseTupleAndKeywords(args, kwds, "O|p:set_serializer", kwlist,
+                                    &py_func, &batch) == false) {
         return NULL;
     }
 
-    if (!is_user_serializer_registered) {
-        memset(&user_serializer_call_info, 0,
-               sizeof(user_serializer_call_info));
-    }
-
-    if (user_serializer_call_info.callback == py_func) {
-        return PyLong_FromLong(0);
-    }
     if (!PyCallable_Check(py_func)) {
         as_error_update(&err, AEROSPIKE_ERR_PARAM,
                         "Parameter must be a callable");
         goto CLEANUP;
     }
 
-    if (user_serializer_call_info.callback) {
-        Py_DECREF(user_serializer_call_info.callback);
-    }
-    is_user_serializer_registered = 1;
-    user_serializer_call_info.callback = py_func;
-    Py_INCREF(py_func);
+    register_callback(&Aerospike_State(parent)->user_serializer, py_func,
+                      batch, false);
 
 CLEANUP:
     if (err.code != AEROSPIKE_OK) {
@@ -104,43 +139,34 @@ CLEANUP:
  * Returns  integer handle for the deserializer being set
  *******************************************************************************************************
  */
-PyObject *AerospikeClient_Set_Deserializer(AerospikeClient *self,
-                                           PyObject *args, PyObject *kwds)
+PyObject *AerospikeClient_Set_Deserializer(PyObject *parent, PyObject *args,
+                                           PyObject *kwds)
 {
     // Python Function Arguments
     PyObject *py_func = NULL;
+    int batch = 0;
+    int buffer = 0;
 
     // Python Function Keyword Arguments
-    static char *kwlist[] = {"function", NULL};
+    static char *kwlist[] = {"function", "batch", "buffer", NULL};
     as_error err;
     as_error_init(&err);
 
     // Python Function Argument Parsing
-    if (PyArg_ParseTupleAndKeywords(args, kwds, "O:set_deserializer", kwlist,
-                                    &py_func) == false) {
+    if (PyArg_ParseTupleAndKeywords(args, kwds, "O|pp:set_deserializer",
+                                    kwlist, &py_func, &batch,
+                                    &buffer) == false) {
         return NULL;
     }
 
-    if (!is_user_deserializer_registered) {
-        memset(&user_deserializer_call_info, 0,
-               sizeof(user_deserializer_call_info));
-    }
-
-    if (user_deserializer_call_info.callback == py_func) {
-        return PyLong_FromLong(0);
-    }
-
     if (!PyCallable_Check(py_func)) {
         as_error_update(&err, AEROSPIKE_ERR_PARAM,
                         "Parameter must be a callable");
         goto CLEANUP;
     }
-    is_user_deserializer_registered = 1;
-    if (user_deserializer_call_info.callback) {
-        Py_DECREF(user_deserializer_call_info.callback);
-    }
-    user_deserializer_call_info.callback = py_func;
-    Py_INCREF(py_func);
+
+    register_callback(&Aerospike_State(parent)->user_deserializer, py_func,
+                      batch, buffer);
 
 CLEANUP:
     if (err.code != AEROSPIKE_OK) {
@@ -193,6 +219,300 @@ CLEANUP:
     return;
 }
 
+/*
+ *******************************************************************************************************
+ * Stores a value returned by a user serializer into bytes. str and any object
+ * supporting the buffer protocol (bytes, bytearray, memoryview,
+ * pickle.PickleBuffer) are accepted.
+ *
+ * If static_pool holds buffers (see POOL_HOLD_BUFFERS), the as_bytes wraps the
+ * memory of the returned object, which the pool keeps alive until the command
+ * is done. Otherwise the payload is copied.
+ *
+ * @param bytes                 The as_bytes to be set.
+ * @param py_value              The value returned by the serializer.
+ * @param static_pool           The pool bytes was taken from, or NULL.
+ * @param error_p               The as_error to be populated by the function
+ *                              with encountered error if any.
+ *******************************************************************************************************
+ */
+static void set_as_bytes_from_pyobject(as_bytes **bytes, PyObject *py_value,
+                                       as_static_pool *static_pool,
+                                       as_error *error_p)
+{
+    PyObject *py_owner = NULL;
+    uint8_t *buffer = NULL;
+    Py_ssize_t len = 0;
+
+    if (PyUnicode_Check(py_value)) {
+        buffer = (uint8_t *)PyUnicode_AsUTF8AndSize(py_value, &len);
+        if (!buffer) {
+            as_error_update(error_p, AEROSPIKE_ERR,
+                            "Unable to encode serialized value");
+            goto CLEANUP;
+        }
+        Py_INCREF(py_value);
+        py_owner = py_value;
+    }
+    else if (PyObject_CheckBuffer(py_value)) {
+        // Non contiguous buffers are copied into a contiguous one here.
+        py_owner = PyMemoryView_GetContiguous(py_value, PyBUF_READ, 'C');
+        if (!py_owner) {
+            as_error_update(error_p, AEROSPIKE_ERR,
+                            "Unable to read serialized value buffer");
+            goto CLEANUP;
+        }
+        Py_buffer *view = PyMemoryView_GET_BUFFER(py_owner);
+        buffer = (uint8_t *)view->buf;
+        len = view->len;
+    }
+    else {
+        as_error_update(error_p, AEROSPIKE_ERR,
+                        "Serializer must return str or a bytes-like object");
+        goto CLEANUP;
+    }
+
+    if (len > INT32_MAX) {
+        as_error_update(error_p, AEROSPIKE_ERR,
+                        "Serialized value is too large");
+        goto CLEANUP;
+    }
+
+    if (static_pool && static_pool->py_buffers &&
+        PyList_Append(static_pool->py_buffers, py_owner) == 0) {
+        as_bytes_init_wrap(*bytes, buffer, (uint32_t)len, false);
+        as_bytes_set_type(*bytes, AS_BYTES_BLOB);
+    }
+    else {
+        PyErr_Clear();
+        set_as_bytes(bytes, buffer, (int32_t)len, AS_BYTES_BLOB, error_p);
+    }
+
+CLEANUP:
+    Py_XDECREF(py_owner);
+    if (error_p->code != AEROSPIKE_OK) {
+        raise_exception(error_p);
+    }
+}
+
+/*
+ * Owner of the memory behind the views passed to buffer deserializers. It
+ * holds either a reference to a heap as_bytes, or the buffer of an as_bytes
+ * embedded in a record bin, taken over from it.
+ */
+typedef struct {
+    PyObject_HEAD
+    as_bytes *bytes;
+    uint8_t *value;
+    uint32_t size;
+} AerospikeBytesView;
+
+static int AerospikeBytesView_Get_Buffer(PyObject *self, Py_buffer *view,
+                                         int flags)
+{
+    AerospikeBytesView *owner = (AerospikeBytesView *)self;
+    return PyBuffer_FillInfo(view, self, owner->value, owner->size, 1, flags);
+}
+
+static void AerospikeBytesView_Type_Dealloc(PyObject *self)
+{
+    AerospikeBytesView *owner = (AerospikeBytesView *)self;
+    PyTypeObject *type = Py_TYPE(self);
+
+    if (owner->bytes) {
+        as_bytes_destroy(owner->bytes);
+    }
+    else if (owner->value) {
+        cf_free(owner->value);
+    }
+    type->tp_free(self);
+    Py_DECREF(type);
+}
+
+static PyType_Slot AerospikeBytesView_Type_Slots[] = {
+    {Py_tp_dealloc, AerospikeBytesView_Type_Dealloc},
+    {Py_bf_getbuffer, AerospikeBytesView_Get_Buffer},
+    {0, NULL}};
+
+static PyType_Spec AerospikeBytesView_Type_Spec = {
+    .name = "aerospike.BytesView",
+    .basicsize = sizeof(AerospikeBytesView),
+    .flags = Py_TPFLAGS_DEFAULT,
+    .slots = AerospikeBytesView_Type_Slots};
+
+PyTypeObject *AerospikeBytesView_Ready(PyObject *module)
+{
+    return Aerospike_New_Type(module, &AerospikeBytesView_Type_Spec, NULL);
+}
+
+/*
+ * Returns the owner of the memory of bytes without copying it, or NULL with
+ * no exception set if it must be copied: the as_bytes does not own its
+ * buffer, or there is no module state to create the owner from.
+ */
+static AerospikeBytesView *bytes_view_new(AerospikeClient *self,
+                                          as_bytes *bytes)
+{
+    if (!self || !self->state || !bytes->free || !bytes->value) {
+        return NULL;
+    }
+
+    PyTypeObject *type = self->state->bytes_view;
+    AerospikeBytesView *owner =
+        (AerospikeBytesView *)type->tp_alloc(type, 0);
+    if (!owner) {
+        PyErr_Clear();
+        return NULL;
+    }
+
+    owner->value = bytes->value;
+    owner->size = as_bytes_size(bytes);
+    if (bytes->_.free) {
+        // A list or map item, which is reference counted.
+        owner->bytes = (as_bytes *)as_val_reserve(bytes);
+    }
+    else {
+        // A bin, freed with its record. The owner takes over its buffer,
+        // and gives it back if the callback did not keep the view.
+        bytes->free = false;
+    }
+    return owner;
+}
+
+/*
+ *******************************************************************************************************
+ * Calls a deserializer registered with buffer=True with a read-only
+ * memoryview of the value. The view is over the value's own memory, which
+ * it keeps alive, so the callback may keep it, or return values referring
+ * to it, after the record is freed. The value is only copied if its memory
+ * cannot be shared.
+ *
+ * @param self                  The client reading the value.
+ * @param callback              The deserializer.
+ * @param bytes                 The as_bytes to be deserialized.
+ * @param in_list               Pass the view in a one item list, for batch
+ *                              deserializers.
+ *
+ * Returns the callback's return value, or NULL with a Python error set.
+ *******************************************************************************************************
+ */
+static PyObject *call_deserializer_with_view(AerospikeClient *self,
+                                             PyObject *callback,
+                                             as_bytes *bytes, bool in_list)
+{
+    AerospikeBytesView *owner = bytes_view_new(self, bytes);
+    PyObject *py_owner = (PyObject *)owner;
+    if (!py_owner) {
+        py_owner = PyBytes_FromStringAndSize((char *)as_bytes_get(bytes),
+                                             as_bytes_size(bytes));
+        if (!py_owner) {
+            return NULL;
+        }
+    }
+
+    PyObject *py_view = PyMemoryView_FromObject(py_owner);
+    PyObject *py_return = NULL;
+    if (!py_view) {
+        goto CLEANUP;
+    }
+
+    if (in_list) {
+        PyObject *py_arglist = PyList_New(1);
+        if (py_arglist) {
+            Py_INCREF(py_view);
+            PyList_SET_ITEM(py_arglist, 0, py_view);
+            py_return =
+                PyObject_CallFunctionObjArgs(callback, py_arglist, NULL);
+            Py_DECREF(py_arglist);
+        }
+    }
+    else {
+        py_return = PyObject_CallFunctionObjArgs(callback, py_view, NULL);
+    }
+    Py_DECREF(py_view);
+
+CLEANUP:
+    if (owner && !owner->bytes && Py_REFCNT(py_owner) == 1) {
+        // Nothing kept the view, so the bin's buffer goes back to it.
+        bytes->free = true;
+        owner->value = NULL;
+    }
+    Py_DECREF(py_owner);
+    return py_return;
+}
+
+/*
+ *******************************************************************************************************
+ * Runs a batch serializer/deserializer on a single value, for operations that
+ * do not collect values into a batch. The callback is passed a list holding
+ * the value (or its raw bytes) and must return a list of one result.
+ *******************************************************************************************************
+ */
+static void execute_batch_user_callback(
+    AerospikeClient *self, user_serializer_callback *user_callback_info,
+    as_bytes **bytes, PyObject **value, bool serialize_flag,
+    as_static_pool *static_pool, as_error *error_p)
+{
+    PyObject *py_return = NULL;
+    PyObject *py_values = NULL;
+
+    if (!serialize_flag && user_callback_info->buffer) {
+        py_return = call_deserializer_with_view(
+            self, user_callback_info->callback, *bytes, true);
+    }
+    else {
+        PyObject *py_item = NULL;
+        if (serialize_flag) {
+            py_item = *value;
+            Py_XINCREF(py_item);
+        }
+        else {
+            py_item = PyBytes_FromStringAndSize((char *)as_bytes_get(*bytes),
+                                                as_bytes_size(*bytes));
+        }
+
+        PyObject *py_arglist = py_item ? PyList_New(1) : NULL;
+        if (py_arglist) {
+            PyList_SET_ITEM(py_arglist, 0, py_item);
+            py_return = PyObject_CallFunctionObjArgs(
+                user_callback_info->callback, py_arglist, NULL);
+            Py_DECREF(py_arglist);
+        }
+        else {
+            Py_XDECREF(py_item);
+        }
+    }
+
+    if (py_return) {
+        py_values = PySequence_Fast(py_return, "");
+        Py_DECREF(py_return);
+    }
+
+    if (!py_values || PySequence_Fast_GET_SIZE(py_values) != 1) {
+        as_error_update(error_p, AEROSPIKE_ERR,
+                        serialize_flag ? "Unable to call user's registered "
+                                         "serializer callback"
+                                       : "Unable to call user's registered "
+                                         "deserializer callback");
+        goto CLEANUP;
+    }
+
+    PyObject *py_result = PySequence_Fast_GET_ITEM(py_values, 0);
+    if (serialize_flag) {
+        set_as_bytes_from_pyobject(bytes, py_result, static_pool, error_p);
+    }
+    else {
+        Py_INCREF(py_result);
+        *value = py_result;
+    }
+
+CLEANUP:
+    Py_XDECREF(py_values);
+    if (error_p->code != AEROSPIKE_OK) {
+        raise_exception(error_p);
+    }
+}
+
 /*
  *******************************************************************************************************
  * If serialize_flag == true, executes the passed user_serializer_callback,
@@ -201,53 +521,69 @@ CLEANUP:
  * by passing the as_bytes (bytes) to the deserializer and getting back
  * the corresponding Py_Object (value).
  *
+ * @param self                          The client the value belongs to.
  * @param user_callback_info            The user_serializer_callback for the user
  *                                      callback to be executed.
  * @param bytes                         The as_bytes to be stored/retrieved.
  * @param value                         The value to be retrieved/stored.
  * @param serialize_flag                The flag which indicates
  *                                      serialize/deserialize.
+ * @param static_pool                   The pool bytes was taken from when
+ *                                      serializing, or NULL.
  * @param error_p                       The as_error to be populated by the
  *                                      function with encountered error if any.
  *******************************************************************************************************
  */
-void execute_user_callback(user_serializer_callback *user_callback_info,
+void execute_user_callback(AerospikeClient *self,
+                           user_serializer_callback *user_callback_info,
                            as_bytes **bytes, PyObject **value,
-                           bool serialize_flag, as_error *error_p)
+                           bool serialize_flag, as_static_pool *static_pool,
+                           as_error *error_p)
 {
+    if (user_callback_info->batch) {
+        execute_batch_user_callback(self, user_callback_info, bytes, value,
+                                    serialize_flag, static_pool, error_p);
+        return;
+    }
+
     PyObject *py_return = NULL;
-    PyObject *py_value = NULL;
-    PyObject *py_arglist = PyTuple_New(1);
 
-    if (serialize_flag) {
-        Py_XINCREF(*value);
-        if (PyTuple_SetItem(py_arglist, 0, *value) != 0) {
-            Py_DECREF(py_arglist);
-            goto CLEANUP;
-        }
+    if (!serialize_flag && user_callback_info->buffer) {
+        py_return = call_deserializer_with_view(
+            self, user_callback_info->callback, *bytes, false);
     }
     else {
-        as_bytes *bytes_pointer = *bytes;
-        char *bytes_val_p = (char *)bytes_pointer->value;
-        py_value =
-            PyUnicode_FromStringAndSize(bytes_val_p, as_bytes_size(*bytes));
-        if (PyTuple_SetItem(py_arglist, 0, py_value) != 0) {
-            Py_DECREF(py_arglist);
-            goto CLEANUP;
+        PyObject *py_value = NULL;
+        PyObject *py_arglist = PyTuple_New(1);
+
+        if (serialize_flag) {
+            Py_XINCREF(*value);
+            if (PyTuple_SetItem(py_arglist, 0, *value) != 0) {
+                Py_DECREF(py_arglist);
+                goto CLEANUP;
+            }
+        }
+        else {
+            as_bytes *bytes_pointer = *bytes;
+            char *bytes_val_p = (char *)bytes_pointer->value;
+            py_value = PyUnicode_FromStringAndSize(bytes_val_p,
+                                                   as_bytes_size(*bytes));
+            if (PyTuple_SetItem(py_arglist, 0, py_value) != 0) {
+                Py_DECREF(py_arglist);
+                goto CLEANUP;
+            }
         }
-    }
 
-    Py_INCREF(user_callback_info->callback);
-    py_return = PyObject_Call(user_callback_info->callback, py_arglist, NULL);
-    Py_DECREF(user_callback_info->callback);
-    Py_DECREF(py_arglist);
+        Py_INCREF(user_callback_info->callback);
+        py_return =
+            PyObject_Call(user_callback_info->callback, py_arglist, NULL);
+        Py_DECREF(user_callback_info->callback);
+        Py_DECREF(py_arglist);
+    }
 
     if (py_return) {
         if (serialize_flag) {
-            char *py_val;
-            Py_ssize_t len;
-            py_val = (char *)PyUnicode_AsUTF8AndSize(py_return, &len);
-            set_as_bytes(bytes, (uint8_t *)py_val, len, AS_BYTES_BLOB, error_p);
+            set_as_bytes_from_pyobject(bytes, py_return, static_pool, error_p);
             Py_DECREF(py_return);
         }
         else {
@@ -275,6 +611,274 @@ CLEANUP:
     }
 }
 
+/*
+ * Returns the user serializer a value serialized with serializer_policy goes
+ * to, or NULL if it goes to a built-in serializer. Sets error_p if
+ * SERIALIZER_USER is selected but there is no serializer.
+ */
+static user_serializer_callback *
+select_user_serializer(AerospikeClient *self, int32_t serializer_policy,
+                       as_error *error_p)
+{
+    bool use_client_serializer = true;
+
+    if (client_put_serializer) {
+        if (serializer_policy == SERIALIZER_USER &&
+            !self->user_serializer_call_info.callback) {
+            use_client_serializer = false;
+        }
+    }
+    else if (self->user_serializer_call_info.callback) {
+        serializer_policy = SERIALIZER_USER;
+    }
+
+    if (serializer_policy != SERIALIZER_USER) {
+        return NULL;
+    }
+
+    user_serializer_callback *registered = registered_callback(self, false);
+    if (use_client_serializer) {
+        return &self->user_serializer_call_info;
+    }
+    else if (registered) {
+        return registered;
+    }
+    else if (self->user_serializer_call_info.callback) {
+        return &self->user_serializer_call_info;
+    }
+
+    as_error_update(error_p, AEROSPIKE_ERR,
+                    "No serializer callback registered");
+    return NULL;
+}
+
+/*
+ * Calls the batch callback of deferred with its values. Returns the results,
+ * one per value, or NULL.
+ */
+static PyObject *call_deferred_callback(deferred_values *deferred)
+{
+    PyObject *py_results = PyObject_CallFunctionObjArgs(
+        deferred->callback->callback, deferred->py_values, NULL);
+    if (!py_results) {
+        return NULL;
+    }
+
+    PyObject *py_list = PySequence_Fast(py_results, "");
+    Py_DECREF(py_results);
+    if (py_list && PySequence_Fast_GET_SIZE(py_list) !=
+                       PyList_GET_SIZE(deferred->py_values)) {
+        Py_CLEAR(py_list);
+    }
+    return py_list;
+}
+
+static bool deferred_values_append(deferred_values *deferred,
+                                   PyObject *py_value, PyObject *py_position)
+{
+    if (!deferred->py_values) {
+        deferred->py_values = PyList_New(0);
+        deferred->py_positions = PyList_New(0);
+    }
+    if (!deferred->py_values || !deferred->py_positions ||
+        PyList_Append(deferred->py_values, py_value) != 0) {
+        return false;
+    }
+    if (PyList_Append(deferred->py_positions, py_position) != 0) {
+        // The two lists stay the same length.
+        PyList_SetSlice(deferred->py_values,
+                        PyList_GET_SIZE(deferred->py_values) - 1,
+                        PyList_GET_SIZE(deferred->py_values), NULL);
+        return false;
+    }
+    return true;
+}
+
+void deferred_values_destroy(deferred_values *deferred)
+{
+    Py_CLEAR(deferred->py_values);
+    Py_CLEAR(deferred->py_positions);
+    deferred->callback = NULL;
+}
+
+/*
+ *******************************************************************************************************
+ * Sets py_value, the value of bin py_name, aside for the batch serializer
+ * instead of serializing it. The bin is added to the record by
+ * deferred_values_serialize().
+ *
+ * Returns true if the value was deferred. Otherwise it is serialized as
+ * usual, which includes values for another serializer than the ones already
+ * deferred.
+ *******************************************************************************************************
+ */
+bool deferred_values_add_value(AerospikeClient *self,
+                               deferred_values *deferred,
+                               int32_t serializer_policy, PyObject *py_value,
+                               PyObject *py_name)
+{
+    as_error err;
+    as_error_init(&err);
+
+    user_serializer_callback *callback =
+        select_user_serializer(self, serializer_policy, &err);
+    if (!callback || !callback->batch ||
+        (deferred->callback && deferred->callback != callback)) {
+        return false;
+    }
+
+    if (!deferred_values_append(deferred, py_value, py_name)) {
+        PyErr_Clear();
+        return false;
+    }
+    deferred->callback = callback;
+    return true;
+}
+
+/*
+ *******************************************************************************************************
+ * Calls the batch serializer once with the values set aside by
+ * deferred_values_add_value() and adds each result to rec as the bin it was
+ * set aside for. deferred is destroyed.
+ *
+ * @param deferred              The values set aside while converting rec.
+ * @param rec                   The record the values belong to.
+ * @param static_pool           The pool the as_bytes of rec are taken from.
+ * @param error_p               The as_error to be populated by the function
+ *                              with encountered error if any.
+ *******************************************************************************************************
+ */
+as_status deferred_values_serialize(deferred_values *deferred, as_record *rec,
+                                    as_static_pool *static_pool,
+                                    as_error *error_p)
+{
+    if (!deferred->py_values || error_p->code != AEROSPIKE_OK) {
+        deferred_values_destroy(deferred);
+        return error_p->code;
+    }
+
+    PyObject *py_results = call_deferred_callback(deferred);
+    if (!py_results) {
+        as_error_update(error_p, AEROSPIKE_ERR,
+                        "Unable to call user's registered serializer callback");
+        goto CLEANUP;
+    }
+
+    for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(py_results); i++) {
+        const char *name =
+            PyUnicode_AsUTF8(PyList_GET_ITEM(deferred->py_positions, i));
+        as_bytes *bytes = NULL;
+        GET_BYTES_POOL(bytes, static_pool, error_p);
+        if (!name || error_p->code != AEROSPIKE_OK) {
+            as_error_update(error_p, AEROSPIKE_ERR,
+                            "Unable to set serialized bin value");
+            break;
+        }
+        set_as_bytes_from_pyobject(&bytes,
+                                   PySequence_Fast_GET_ITEM(py_results, i),
+                                   static_pool, error_p);
+        if (error_p->code != AEROSPIKE_OK) {
+            break;
+        }
+        as_record_set_bytes(rec, name, bytes);
+    }
+
+CLEANUP:
+    Py_XDECREF(py_results);
+    deferred_values_destroy(deferred);
+    if (error_p->code != AEROSPIKE_OK) {
+        PyErr_Clear();
+    }
+    return error_p->code;
+}
+
+void deferred_values_init(AerospikeClient *self, deferred_values *deferred)
+{
+    deferred->py_values = NULL;
+    deferred->py_positions = NULL;
+
+    // Same precedence as deserialize_based_on_as_bytes_type().
+    user_serializer_callback *callback = NULL;
+    if (self->user_deserializer_call_info.callback) {
+        callback = &self->user_deserializer_call_info;
+    }
+    else {
+        callback = registered_callback(self, true);
+    }
+    deferred->callback = (callback && callback->batch) ? callback : NULL;
+}
+
+/*
+ *******************************************************************************************************
+ * Sets the raw bytes of bin name of py_bins aside for the batch deserializer
+ * of deferred, if it has one.
+ *
+ * Returns the value to store in the bin until deferred_values_deserialize()
+ * replaces it: the raw bytes, which is also what a failed deserializer
+ * leaves. NULL if the value is not deferred and must be converted as usual.
+ *******************************************************************************************************
+ */
+PyObject *deferred_values_add_bytes(deferred_values *deferred,
+                                    const as_val *val, PyObject *py_bins,
+                                    const char *name)
+{
+    if (!deferred || !deferred->callback || as_val_type(val) != AS_BYTES) {
+        return NULL;
+    }
+
+    as_bytes *bytes = as_bytes_fromval(val);
+    if (as_bytes_get_type(bytes) != AS_BYTES_BLOB) {
+        return NULL;
+    }
+
+    PyObject *py_bytes = PyBytes_FromStringAndSize(
+        (char *)as_bytes_get(bytes), as_bytes_size(bytes));
+    PyObject *py_position =
+        py_bytes ? Py_BuildValue("(Os)", py_bins, name) : NULL;
+    if (!py_position ||
+        !deferred_values_append(deferred, py_bytes, py_position)) {
+        PyErr_Clear();
+        Py_XDECREF(py_bytes);
+        Py_XDECREF(py_position);
+        return NULL;
+    }
+
+    Py_DECREF(py_position);
+    return py_bytes;
+}
+
+/*
+ *******************************************************************************************************
+ * Calls the batch deserializer once with the raw bytes set aside by
+ * deferred_values_add_bytes() and stores each result in the bin it was set
+ * aside for. If the deserializer fails, the bins keep their raw bytes, as
+ * they do for a single value. deferred is destroyed.
+ *
+ * @param deferred              The values set aside while converting records.
+ * @param resolve               false if the records are being discarded.
+ *******************************************************************************************************
+ */
+void deferred_values_deserialize(deferred_values *deferred, bool resolve)
+{
+    if (!deferred->py_values || !resolve) {
+        deferred_values_destroy(deferred);
+        return;
+    }
+
+    PyObject *py_results = call_deferred_callback(deferred);
+    for (Py_ssize_t i = 0;
+         py_results && i < PySequence_Fast_GET_SIZE(py_results); i++) {
+        PyObject *py_position = PyList_GET_ITEM(deferred->py_positions, i);
+        PyDict_SetItem(PyTuple_GET_ITEM(py_position, 0),
+                       PyTuple_GET_ITEM(py_position, 1),
+                       PySequence_Fast_GET_ITEM(py_results, i));
+    }
+
+    PyErr_Clear();
+    Py_XDECREF(py_results);
+    deferred_values_destroy(deferred);
+}
+
 /*
  *******************************************************************************************************
  * Checks serializer_policy.
@@ -285,27 +889,21 @@ CLEANUP:
  *                                  the serialization.
  * @param bytes                     The as_bytes to be set.
  * @param value                     The value to be serialized.
+ * @param static_pool               The pool bytes was taken from. Pass NULL if
+ *                                  bytes may be moved out of the pool, so that
+ *                                  it never borrows the serializer's buffer.
  * @param error_p                   The as_error to be populated by the function
  *                                  with encountered error if any.
  *******************************************************************************************************
  */
-extern as_status serialize_based_on_serializer_policy(AerospikeClient *self,
-                                                      int32_t serializer_policy,
-                                                      as_bytes **bytes,
-                                                      PyObject *value,
-                                                      as_error *error_p)
+extern as_status serialize_based_on_serializer_policy(
+    AerospikeClient *self, int32_t serializer_policy, as_bytes **bytes,
+    PyObject *value, as_static_pool *static_pool, as_error *error_p)
 {
-    uint8_t use_client_serializer = true;
     PyObject *initresult = NULL;
 
-    if (self->is_client_put_serializer) {
-        if (serializer_policy == SERIALIZER_USER) {
-            if (!self->user_serializer_call_info.callback) {
-                use_client_serializer = false;
-            }
-        }
-    }
-    else if (self->user_serializer_call_info.callback) {
+    // A serializer set on the client applies unless the put() passed one.
+    if (!client_put_serializer && self->user_serializer_call_info.callback) {
         serializer_policy = SERIALIZER_USER;
     }
 
@@ -339,45 +937,26 @@ extern as_status serialize_based_on_serializer_policy(AerospikeClient *self,
         }
     } break;
     case SERIALIZER_JSON:
-        /*
-			 *   TODO:
-			 *     Handle JSON serialization after support for AS_BYTES_JSON
-			 *     is added in aerospike-client-c
-			 */
-        as_error_update(error_p, AEROSPIKE_ERR,
-                        "Unable to serialize using standard json serializer");
-        goto CLEANUP;
+        // There is no AS_BYTES_JSON type, so values are stored with the
+        // built-in binary serializer, which covers the same ground and more.
+        if (pyobject_to_native_bytes(error_p, value, bytes) != AEROSPIKE_OK) {
+            goto CLEANUP;
+        }
+        break;
 
-    case SERIALIZER_USER:
-        if (use_client_serializer) {
-            execute_user_callback(&self->user_serializer_call_info, bytes,
-                                  &value, true, error_p);
-            if (AEROSPIKE_OK != (error_p->code)) {
-                goto CLEANUP;
-            }
+    case SERIALIZER_USER: {
+        user_serializer_callback *callback =
+            select_user_serializer(self, serializer_policy, error_p);
+        if (!callback) {
+            goto CLEANUP;
         }
-        else {
-            if (is_user_serializer_registered) {
-                execute_user_callback(&user_serializer_call_info, bytes, &value,
-                                      true, error_p);
-                if (AEROSPIKE_OK != (error_p->code)) {
-                    goto CLEANUP;
-                }
-            }
-            else if (self->user_serializer_call_info.callback) {
-                execute_user_callback(&self->user_serializer_call_info, bytes,
-                                      &value, true, error_p);
-                if (AEROSPIKE_OK != (error_p->code)) {
-                    goto CLEANUP;
-                }
-            }
-            else {
-                as_error_update(error_p, AEROSPIKE_ERR,
-                                "No serializer callback registered");
-                goto CLEANUP;
-            }
+
+        execute_user_callback(self, callback, bytes, &value, true,
+                              static_pool, error_p);
+        if (AEROSPIKE_OK != (error_p->code)) {
+            goto CLEANUP;
         }
-        break;
+    } break;
     default:
         as_error_update(error_p, AEROSPIKE_ERR, "Unsupported serializer");
         goto CLEANUP;
@@ -413,6 +992,10 @@ extern as_status deserialize_based_on_as_bytes_type(AerospikeClient *self,
 {
     switch (as_bytes_get_type(bytes)) {
     case AS_BYTES_PYTHON:;
+        if (is_native_bytes(bytes)) {
+            native_bytes_to_pyobject(error_p, bytes, retval);
+            break;
+        }
         // Automatically convert AS_BYTES_PYTHON server types to bytearrays.
         // This prevents the client from throwing an exception and
         // breaking applications that don't handle the exception
@@ -431,8 +1014,8 @@ extern as_status deserialize_based_on_as_bytes_type(AerospikeClient *self,
         as_error_update(error_p, AEROSPIKE_OK, NULL);
     case AS_BYTES_BLOB: {
         if (self->user_deserializer_call_info.callback) {
-            execute_user_callback(&self->user_deserializer_call_info, &bytes,
-                                  retval, false, error_p);
+            execute_user_callback(self, &self->user_deserializer_call_info,
+                                  &bytes, retval, false, NULL, error_p);
             if (AEROSPIKE_OK != (error_p->code)) {
                 uint32_t bval_size = as_bytes_size(bytes);
                 PyObject *py_val = PyBytes_FromStringAndSize(
@@ -447,9 +1030,11 @@ extern as_status deserialize_based_on_as_bytes_type(AerospikeClient *self,
             }
         }
         else {
-            if (is_user_deserializer_registered) {
-                execute_user_callback(&user_deserializer_call_info, &bytes,
-                                      retval, false, error_p);
+            user_serializer_callback *registered =
+                registered_callback(self, true);
+            if (registered) {
+                execute_user_callback(self, registered, &bytes, retval, false,
+                                      NULL, error_p);
                 if (AEROSPIKE_OK != (error_p->code)) {
                     uint32_t bval_size = as_bytes_size(bytes);
                     PyObject *py_val = PyBytes_FromStringAndSize(
@@ -476,6 +1061,16 @@ extern as_status deserialize_based_on_as_bytes_type(AerospikeClient *self,
             }
         }
     } break;
+    case AS_BYTES_LIST:
+    case AS_BYTES_MAP:
+        // Raw CDT bins are only returned when the policy disables
+        // deserialization; decode them here if the client asked for it.
+        if (self->direct_cdt_decode) {
+            msgpack_to_pyobject(self, error_p, as_bytes_get(bytes),
+                                as_bytes_size(bytes), retval);
+            break;
+        }
+        /* fall through */
     default: {
         // First try to return a raw byte array, if that fails raise an error
         uint32_t bval_size = as_bytes_size(bytes);
@@ -502,8 +1097,8 @@ CLEANUP:
     PyErr_Clear();
     return error_p->code;
 }
-PyObject *AerospikeClient_Unset_Serializers(AerospikeClient *self,
-                                            PyObject *args, PyObject *kwds)
+PyObject *AerospikeClient_Unset_Serializers(PyObject *parent, PyObject *args,
+                                            PyObject *kwds)
 {
     // Python Function Keyword Arguments
     static char *kwlist[] = {NULL};
@@ -516,11 +1111,9 @@ PyObject *AerospikeClient_Unset_Serializers(AerospikeClient *self,
         false) {
         return NULL;
     }
-    is_user_serializer_registered = 0;
-    is_user_deserializer_registered = 0;
-    memset(&user_deserializer_call_info, 0,
-           sizeof(user_deserializer_call_info));
-    memset(&user_serializer_call_info, 0, sizeof(user_serializer_call_info));
+    struct Aerospike_State *state = Aerospike_State(parent);
+    register_callback(&state->user_serializer, NULL, false, false);
+    register_callback(&state->user_deserializer, NULL, false, false);
 
     return PyLong_FromLong(0);
 }
@@ -0,0 +1,59 @@
+# -*- coding: utf-8 -*-
+
+import pytest
+from .test_base_class import TestBaseClass
+from aerospike import exception as e
+
+
+class TestAdaptivePolicy:
+    @pytest.fixture(autouse=True)
+    def setup(self, request):
+        self.key = ("test", "demo", "adaptive_policy")
+        config = {
+            "adaptive_timeouts": {"percentile": 90.0, "multiplier": 2.0, "min_timeout": 50},
+            "retry_budget": {"ratio": 0.5, "max_tokens": 10},
+        }
+        self.client = TestBaseClass.get_new_connection(config)
+        yield
+        self.client.remove(self.key)
+        self.client.close()
+
+    def test_commands(self):
+        # Enough commands for the timeouts to adapt.
+        for i in range(300):
+            self.client.put(self.key, {"i": i})
+            _, meta, bins = self.client.get(self.key)
+            assert bins == {"i": i}
+            assert self.client.exists(self.key)[1]["gen"] == meta["gen"]
+            self.client.increment(self.key, "i", 1)
+            _, _, bins = self.client.select(self.key, ["i"])
+            assert bins == {"i": i + 1}
+
+    def test_command_with_policy(self):
+        self.client.put(self.key, {"i": 1}, policy={"socket_timeout": 1000, "max_retries": 2})
+        _, _, bins = self.client.get(self.key, {"socket_timeout": 1000, "max_retries": 2})
+        assert bins == {"i": 1}
+
+    def test_not_found_does_not_fail(self):
+        with pytest.raises(e.RecordNotFound):
+            self.client.get(("test", "demo", "adaptive_policy_missing"))
+        self.client.put(self.key, {"i": 1})
+
+
+@pytest.mark.parametrize(
+    "config",
+    [
+        {"adaptive_timeouts": []},
+        {"adaptive_timeouts": {"percentile": 0}},
+        {"adaptive_timeouts": {"percentile": 100}},
+        {"adaptive_timeouts": {"multiplier": 0}},
+        {"adaptive_timeouts": {"min_timeout": "1"}},
+        {"retry_budget": []},
+        {"retry_budget": {"ratio": 0}},
+        {"retry_budget": {"ratio": 2}},
+        {"retry_budget": {"max_tokens": 0}},
+    ],
+)
+def test_invalid_config(config):
+    with pytest.raises(e.ParamError):
+        TestBaseClass.get_new_connection(config)
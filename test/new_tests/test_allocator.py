@@ -0,0 +1,74 @@
+# -*- coding: utf-8 -*-
+
+import os
+import subprocess
+import sys
+
+import pytest
+from .test_base_class import TestBaseClass
+
+import aerospike
+
+
+def test_allocator_stats():
+    stats = aerospike.get_allocator_stats()
+
+    assert stats["allocator"] in ("system", "pymem", "cached")
+    assert stats["reserved_bytes"] >= 0
+    assert set(stats["subsystems"]) == {"client", "batch", "read_cache", "hedged_read", "operations"}
+    for counters in stats["subsystems"].values():
+        assert set(counters) == {"bytes", "blocks", "total_bytes"}
+
+
+def test_read_cache_bytes_are_counted():
+    key = ("test", "demo", "allocator")
+    client = TestBaseClass.get_new_connection({"read_cache": {"max_records": 100}})
+    before = aerospike.get_allocator_stats()["subsystems"]
+
+    client.put(key, {"a": 1})
+    client.get(key)
+    after = aerospike.get_allocator_stats()["subsystems"]
+    assert after["read_cache"]["total_bytes"] > before["read_cache"]["total_bytes"]
+    assert after["client"]["blocks"] > 0
+
+    client.remove(key)
+    client.close()
+
+
+def test_operation_strings_are_counted():
+    key = ("test", "demo", "allocator_operations")
+    client = TestBaseClass.get_new_connection()
+    client.put(key, {"name": "a"})
+    before = aerospike.get_allocator_stats()["subsystems"]["operations"]
+
+    client.operate(key, [{"op": aerospike.OPERATOR_APPEND, "bin": "name", "val": "b"}])
+    after = aerospike.get_allocator_stats()["subsystems"]["operations"]
+    assert after["total_bytes"] > before["total_bytes"]
+    assert after["blocks"] == before["blocks"]
+
+    client.remove(key)
+    client.close()
+
+
+@pytest.mark.parametrize("allocator", ("system", "pymem", "cached"))
+def test_allocator_mode(allocator):
+    script = (
+        "import aerospike\n"
+        "stats = aerospike.get_allocator_stats()\n"
+        "assert stats['allocator'] == %r, stats\n" % allocator
+    )
+    env = dict(os.environ, AEROSPIKE_ALLOCATOR=allocator)
+    subprocess.run([sys.executable, "-c", script], env=env, check=True)
+
+
+def test_unknown_allocator_warns():
+    script = (
+        "import warnings\n"
+        "with warnings.catch_warnings(record=True) as caught:\n"
+        "    warnings.simplefilter('always')\n"
+        "    import aerospike\n"
+        "assert aerospike.get_allocator_stats()['allocator'] == 'system'\n"
+        "assert any(issubclass(w.category, RuntimeWarning) for w in caught)\n"
+    )
+    env = dict(os.environ, AEROSPIKE_ALLOCATOR="jemalloc")
+    subprocess.run([sys.executable, "-c", script], env=env, check=True)
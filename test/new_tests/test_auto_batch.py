@@ -0,0 +1,75 @@
+# -*- coding: utf-8 -*-
+
+import threading
+
+import pytest
+from .test_base_class import TestBaseClass
+from aerospike import exception as e
+
+THREADS = 16
+
+
+def run_concurrently(func):
+    results = [None] * THREADS
+    barrier = threading.Barrier(THREADS)
+
+    def worker(i):
+        barrier.wait()
+        try:
+            results[i] = func(i)
+        except e.AerospikeError as exception:
+            results[i] = exception
+
+    threads = [threading.Thread(target=worker, args=(i,)) for i in range(THREADS)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    return results
+
+
+class TestAutoBatch:
+    @pytest.fixture(autouse=True)
+    def setup(self, request):
+        self.keys = [("test", "demo", "auto_batch_%d" % i) for i in range(THREADS)]
+        self.client = TestBaseClass.get_new_connection({"auto_batch": {"window": 2000, "max_keys": 8}})
+        yield
+        for key in self.keys:
+            try:
+                self.client.remove(key)
+            except e.RecordNotFound:
+                pass
+        self.client.close()
+
+    def test_concurrent_put_and_get(self):
+        results = run_concurrently(lambda i: self.client.put(self.keys[i], {"i": i, "list": [i]}, meta={"ttl": 1000}))
+        assert results == [0] * THREADS
+
+        results = run_concurrently(lambda i: self.client.get(self.keys[i]))
+        for i, (key, meta, bins) in enumerate(results):
+            assert key[:2] == ("test", "demo")
+            assert meta["gen"] == 1
+            assert bins == {"i": i, "list": [i]}
+
+    def test_concurrent_get_not_found(self):
+        results = run_concurrently(lambda i: self.client.get(self.keys[i]))
+        for result in results:
+            assert isinstance(result, e.RecordNotFound)
+
+    def test_get_with_policy_is_not_batched(self):
+        self.client.put(self.keys[0], {"i": 0})
+        _, _, bins = self.client.get(self.keys[0], {"total_timeout": 1000})
+        assert bins == {"i": 0}
+
+    @pytest.mark.parametrize(
+        "config",
+        [
+            "yes",
+            {"window": 0},
+            {"window": "1"},
+            {"max_keys": 0},
+        ],
+    )
+    def test_invalid_config(self, config):
+        with pytest.raises(e.ParamError):
+            TestBaseClass.get_new_connection({"auto_batch": config})
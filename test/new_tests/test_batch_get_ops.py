@@ -144,7 +144,9 @@ class TestBatchExpressionsOperations(TestBaseClass):
 
         assert rec[0][-1] is not None
         assert rec[1][-1] is not None
-        assert rec[2][-2] == e.RecordNotFound
+        assert isinstance(rec[2][-2], e.RecordNotFound)
+        assert rec[2][-2].code == e.RecordNotFound.code
+        assert rec[2][-2].msg
         assert rec[2][-1] is None
 
         # rec = self.as_connection.select_many([non_existent_key], ['name'])
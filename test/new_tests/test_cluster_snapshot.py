@@ -0,0 +1,89 @@
+# -*- coding: utf-8 -*-
+
+import threading
+
+import pytest
+from .test_base_class import TestBaseClass
+import aerospike
+from aerospike import exception as e
+
+
+class TestClusterSnapshot:
+    @pytest.fixture(autouse=True)
+    def setup(self, request):
+        self.client = TestBaseClass.get_new_connection()
+        self.key = ("test", "demo", "cluster_snapshot")
+        self.client.put(self.key, {"bin": 1})
+        yield
+        self.client.remove(self.key)
+        self.client.close()
+
+    def test_export_cluster_snapshot(self):
+        snapshot = self.client.export_cluster_snapshot()
+        assert isinstance(snapshot, bytes)
+        # One line per node after the header.
+        assert len(snapshot.splitlines()) == len(self.client.get_nodes()) + 1
+
+    def test_connect_with_snapshot(self):
+        snapshot = self.client.export_cluster_snapshot()
+        client = TestBaseClass.get_new_connection({"cluster_snapshot": snapshot})
+        _, _, bins = client.get(self.key)
+        assert bins == {"bin": 1}
+        client.close()
+
+    def test_connect_with_invalid_snapshot(self):
+        config = TestBaseClass.get_connection_config()
+        config["cluster_snapshot"] = b"not a snapshot"
+        with pytest.raises(e.ParamError):
+            aerospike.client(config)
+
+    def test_lazy_connect(self):
+        client = TestBaseClass.get_new_connection({"lazy_connect": True})
+        # The first operation waits for the connection.
+        _, _, bins = client.get(self.key)
+        assert bins == {"bin": 1}
+        assert client.is_connected()
+        client.close()
+
+    def test_lazy_connect_awaited_by_many_threads(self):
+        client = TestBaseClass.get_new_connection({"lazy_connect": True})
+        results = []
+
+        def read():
+            results.append(client.get(self.key)[2])
+
+        threads = [threading.Thread(target=read) for _ in range(8)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+
+        assert results == [{"bin": 1}] * 8
+        client.close()
+
+    def test_connect_with_unreachable_first_seed(self):
+        config = TestBaseClass.get_connection_config()
+        # The seeds are probed, so the live ones are tried before this one.
+        config["hosts"] = [("127.0.0.1", 1)] + list(config["hosts"])
+        client = aerospike.client(config)
+        _, _, bins = client.get(self.key)
+        assert bins == {"bin": 1}
+        client.close()
+
+    def test_lazy_reconnect_with_snapshot(self):
+        snapshot = self.client.export_cluster_snapshot()
+        client = TestBaseClass.get_new_connection()
+        client.close()
+        client.connect(lazy=True, snapshot=snapshot)
+        _, _, bins = client.get(self.key)
+        assert bins == {"bin": 1}
+        client.close()
+
+    def test_lazy_connect_failure_raised_on_first_use(self):
+        config = TestBaseClass.get_connection_config()
+        config["hosts"] = [("127.0.0.1", 1)]
+        config["lazy_connect"] = True
+        client = aerospike.client(config)
+        with pytest.raises(e.AerospikeError):
+            client.get(self.key)
+        assert not client.is_connected()
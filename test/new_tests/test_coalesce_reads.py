@@ -0,0 +1,63 @@
+# -*- coding: utf-8 -*-
+
+import threading
+
+import pytest
+from .test_base_class import TestBaseClass
+from aerospike import exception as e
+
+THREADS = 16
+
+
+def run_concurrently(func):
+    results = [None] * THREADS
+    barrier = threading.Barrier(THREADS)
+
+    def worker(i):
+        barrier.wait()
+        try:
+            results[i] = func()
+        except e.AerospikeError as exception:
+            results[i] = exception
+
+    threads = [threading.Thread(target=worker, args=(i,)) for i in range(THREADS)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    return results
+
+
+class TestCoalesceReads:
+    @pytest.fixture(autouse=True)
+    def setup(self, request):
+        self.key = ("test", "demo", "coalesce_reads")
+        self.client = TestBaseClass.get_new_connection({"coalesce_reads": True})
+        self.client.put(self.key, {"name": "John", "list": [1, 2]})
+        yield
+        self.client.remove(self.key)
+        self.client.close()
+
+    def test_concurrent_get(self):
+        results = run_concurrently(lambda: self.client.get(self.key))
+        for _, meta, bins in results:
+            assert meta["gen"] == 1
+            assert bins == {"name": "John", "list": [1, 2]}
+        # Each caller owns its bins dict and the values nested in it.
+        results[0][2]["name"] = "Jane"
+        results[0][2]["list"].append(3)
+        for _, _, bins in results[1:]:
+            assert bins == {"name": "John", "list": [1, 2]}
+        _, _, bins = self.client.get(self.key)
+        assert bins["list"] == [1, 2]
+
+    def test_concurrent_select(self):
+        results = run_concurrently(lambda: self.client.select(self.key, ["name"]))
+        for _, _, bins in results:
+            assert bins == {"name": "John"}
+
+    def test_concurrent_get_not_found(self):
+        key = ("test", "demo", "coalesce_reads_missing")
+        results = run_concurrently(lambda: self.client.get(key))
+        for result in results:
+            assert isinstance(result, e.RecordNotFound)
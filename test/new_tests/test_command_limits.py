@@ -0,0 +1,224 @@
+# -*- coding: utf-8 -*-
+
+import threading
+import time
+
+import pytest
+from .test_base_class import TestBaseClass
+from aerospike import exception as e
+
+import aerospike
+
+
+class TestCommandLimits:
+    @pytest.fixture(autouse=True)
+    def setup(self, request):
+        self.keys = [("test", "demo", "command_limits_%d" % i) for i in range(4)]
+        config = {
+            "command_limits": [
+                {"namespace": "test", "set": "demo", "commands": ["write"], "rate": 20, "burst": 1},
+                {"namespace": "test", "max_concurrent": 2},
+                {"namespace": "other", "rate": 1},
+            ]
+        }
+        self.client = TestBaseClass.get_new_connection(config)
+        yield
+        for key in self.keys:
+            try:
+                self.client.remove(key)
+            except e.RecordNotFound:
+                pass
+        self.client.close()
+
+    def test_rate(self):
+        start = time.monotonic()
+        for i in range(10):
+            self.client.put(self.keys[0], {"i": i})
+        # The first write uses the burst, the other 9 wait for 20 tokens a second.
+        assert time.monotonic() - start >= 0.4
+
+        stats = self.client.get_command_limit_stats()
+        assert stats[0]["namespace"] == "test"
+        assert stats[0]["set"] == "demo"
+        assert stats[0]["commands"] == 10
+        assert stats[0]["waits"] >= 9
+        assert stats[0]["wait_time"] > 0
+        assert stats[2]["commands"] == 0
+
+    def test_reads_are_not_rate_limited(self):
+        self.client.put(self.keys[0], {"i": 1})
+        for _ in range(20):
+            _, _, bins = self.client.get(self.keys[0])
+            assert bins == {"i": 1}
+
+        stats = self.client.get_command_limit_stats()
+        assert stats[0]["commands"] == 1
+        assert stats[1]["commands"] == 21
+
+    def test_concurrency(self):
+        self.client.put(self.keys[0], {"i": 1})
+        errors = []
+
+        def read():
+            try:
+                for _ in range(20):
+                    self.client.get(self.keys[0])
+            except Exception as ex:
+                errors.append(ex)
+
+        threads = [threading.Thread(target=read) for _ in range(4)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+
+        assert not errors
+        assert self.client.get_command_limit_stats()[1]["in_flight"] == 0
+
+    def test_batch(self):
+        records = self.client.get_many(self.keys)
+        assert len(records) == len(self.keys)
+
+        stats = self.client.get_command_limit_stats()
+        assert stats[1]["commands"] == 1
+
+    def test_wait_bounded_by_total_timeout(self):
+        self.client.put(self.keys[0], {"i": 1})
+        # The bucket holds one write and refills in 50ms.
+        with pytest.raises(e.TimeoutError):
+            self.client.put(self.keys[0], {"i": 2}, policy={"total_timeout": 10})
+
+        stats = self.client.get_command_limit_stats()
+        assert stats[0]["timeouts"] == 1
+        assert stats[0]["commands"] == 1
+        assert stats[1]["in_flight"] == 0
+        _, _, bins = self.client.get(self.keys[0])
+        assert bins == {"i": 1}
+
+
+class TestPriorityLanes:
+    @pytest.fixture(autouse=True)
+    def setup(self, request):
+        self.keys = [("test", "demo", "priority_lanes_%d" % i) for i in range(4)]
+        config = {
+            "command_limits": [
+                {"priority": "bulk", "max_concurrent": 1},
+                {"priority": "interactive", "commands": ["read"], "max_concurrent": 8},
+            ]
+        }
+        self.client = TestBaseClass.get_new_connection(config)
+        for key in self.keys:
+            self.client.put(key, {"a": 1})
+        yield
+        for key in self.keys:
+            self.client.remove(key)
+        self.client.close()
+
+    def test_default_lanes(self):
+        self.client.get_many(self.keys)
+        self.client.get(self.keys[0])
+        self.client.query("test", "demo").results()
+        self.client.scan("test", "demo").results()
+
+        stats = self.client.get_command_limit_stats()
+        assert stats[0]["commands"] == 3
+        # Puts match neither limit.
+        assert stats[1]["commands"] == 1
+
+    def test_priority_policy(self):
+        self.client.get_many(self.keys, {"priority": aerospike.POLICY_PRIORITY_INTERACTIVE})
+        self.client.get(self.keys[0], {"priority": aerospike.POLICY_PRIORITY_BULK})
+        self.client.get(self.keys[0], {"priority": aerospike.POLICY_PRIORITY_DEFAULT})
+
+        stats = self.client.get_command_limit_stats()
+        assert stats[0]["commands"] == 1
+        assert stats[1]["commands"] == 1
+
+    def test_bulk_does_not_block_interactive(self):
+        errors = []
+
+        def scan():
+            try:
+                for _ in range(5):
+                    self.client.scan("test", "demo").results()
+            except Exception as ex:
+                errors.append(ex)
+
+        threads = [threading.Thread(target=scan) for _ in range(3)]
+        for thread in threads:
+            thread.start()
+        for _ in range(20):
+            self.client.get(self.keys[0])
+        for thread in threads:
+            thread.join()
+
+        assert not errors
+        stats = self.client.get_command_limit_stats()
+        assert stats[0]["commands"] == 15
+        assert stats[0]["in_flight"] == 0
+        assert stats[1]["waits"] == 0
+
+    def test_foreach_callback_sends_bulk_commands(self):
+        keys = []
+
+        def callback(record):
+            key, _, _ = record
+            # Would wait forever for the only bulk slot if the scan held it.
+            self.client.get_many([key])
+            keys.append(key)
+
+        self.client.scan("test", "demo").foreach(callback)
+        self.client.query("test", "demo").foreach(callback)
+
+        assert len(keys) >= 2 * len(self.keys)
+        assert self.client.get_command_limit_stats()[0]["in_flight"] == 0
+
+    def test_foreach_holds_bulk_slot(self):
+        started = threading.Event()
+
+        def callback(record):
+            started.set()
+            time.sleep(0.05)
+
+        thread = threading.Thread(target=lambda: self.client.scan("test", "demo").foreach(callback))
+        thread.start()
+        assert started.wait(5)
+        # Waits for the slot of the scan.
+        self.client.get_many(self.keys)
+        thread.join()
+
+        stats = self.client.get_command_limit_stats()
+        assert stats[0]["waits"] >= 1
+        assert stats[0]["in_flight"] == 0
+
+    @pytest.mark.parametrize("priority", (3, -1, "bulk"))
+    def test_invalid_priority(self, priority):
+        with pytest.raises(e.ParamError):
+            self.client.get(self.keys[0], {"priority": priority})
+
+
+def test_stats_without_limits():
+    client = TestBaseClass.get_new_connection()
+    assert client.get_command_limit_stats() is None
+    client.close()
+
+
+@pytest.mark.parametrize(
+    "config",
+    [
+        {"command_limits": {}},
+        {"command_limits": [1]},
+        {"command_limits": [{"namespace": 1}]},
+        {"command_limits": [{"set": "s" * 64}]},
+        {"command_limits": [{"commands": "read"}]},
+        {"command_limits": [{"commands": ["index"]}]},
+        {"command_limits": [{"priority": "high"}]},
+        {"command_limits": [{"rate": 0}]},
+        {"command_limits": [{"burst": -1}]},
+        {"command_limits": [{"max_concurrent": 1.5}]},
+        {"command_limits": [{"max_concurrent": 1}] * 33},
+    ],
+)
+def test_invalid_config(config):
+    with pytest.raises(e.ParamError):
+        TestBaseClass.get_new_connection(config)
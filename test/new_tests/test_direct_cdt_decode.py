@@ -0,0 +1,109 @@
+# -*- coding: utf-8 -*-
+import pytest
+from aerospike import exception as e
+from aerospike_helpers.operations import list_operations, map_operations
+from .test_base_class import TestBaseClass
+
+import aerospike
+
+
+class TestDirectCdtDecode(object):
+    @pytest.fixture(autouse=True)
+    def setup(self, request, as_connection):
+        self.test_key = "test", "demo", "direct_cdt_decode"
+        self.bins = {
+            "list": [1, -1, 2**40, -(2**40), 1.5, "str", "", b"blob", bytearray(b"ba"), None, True, False],
+            "map": {"a": 1, 2: "b", 3.5: [1, 2], "nested": {"x": {"y": [{}]}}},
+            "ordered": aerospike.KeyOrderedDict({"b": 2, "a": 1}),
+            "big_list": list(range(5000)),
+            "big_map": {i: str(i) for i in range(5000)},
+            "geo": [aerospike.GeoJSON({"type": "Point", "coordinates": [-122.0, 37.5]})],
+        }
+        self.as_connection.put(self.test_key, self.bins)
+
+        config = TestBaseClass.get_connection_config()
+        config["direct_cdt_decode"] = True
+        self.client = aerospike.client(config).connect(config["user"], config["password"])
+
+        yield
+
+        self.client.close()
+        try:
+            self.as_connection.remove(self.test_key)
+        except e.AerospikeError:
+            pass
+
+    def test_direct_cdt_decode_get(self):
+        _, _, bins = self.client.get(self.test_key)
+        _, _, expected = self.as_connection.get(self.test_key)
+
+        assert bins.pop("geo")[0].unwrap() == expected.pop("geo")[0].unwrap()
+        assert bins == expected
+        assert bins["ordered"] == {"a": 1, "b": 2}
+
+    def test_direct_cdt_decode_operate(self):
+        ops = [
+            list_operations.list_append("list", 5),
+            list_operations.list_get_range("list", 0, 2),
+            map_operations.map_get_by_key("map", "nested", aerospike.MAP_RETURN_VALUE),
+        ]
+        _, _, bins = self.client.operate(self.test_key, ops)
+
+        assert bins["list"] == [1, -1]
+        assert bins["map"] == {"x": {"y": [{}]}}
+
+    def test_direct_cdt_decode_batch(self):
+        records = self.client.get_many([self.test_key])
+
+        assert records[0][2]["big_map"] == self.bins["big_map"]
+        assert records[0][2]["big_list"] == self.bins["big_list"]
+
+    def test_direct_cdt_decode_scan_and_query(self):
+        scanned = [bins for _, _, bins in self.client.scan("test", "demo").results() if "big_map" in bins]
+        queried = [bins for _, _, bins in self.client.query("test", "demo").results() if "big_map" in bins]
+
+        assert scanned[0]["map"] == queried[0]["map"] == self.bins["map"]
+        assert scanned[0]["big_list"] == queried[0]["big_list"] == self.bins["big_list"]
+
+    @pytest.mark.parametrize("depth, fails", [(200, False), (300, True)])
+    def test_direct_cdt_decode_nesting_limit(self, depth, fails):
+        key = "test", "demo", "direct_cdt_decode_nested"
+        nested = []
+        for _ in range(depth):
+            nested = [nested]
+        try:
+            self.as_connection.put(key, {"nested": nested})
+        except e.ServerError:
+            pytest.skip("server does not store lists nested this deep")
+
+        try:
+            if fails:
+                with pytest.raises(e.ClientError):
+                    self.client.get(key)
+            else:
+                _, _, bins = self.client.get(key)
+                assert bins["nested"] == nested
+        finally:
+            self.as_connection.remove(key)
+
+    @pytest.mark.parametrize("send_bool_as", [aerospike.AS_BOOL, aerospike.INTEGER])
+    def test_direct_cdt_encode_put(self, send_bool_as):
+        config = TestBaseClass.get_connection_config()
+        config["direct_cdt_encode"] = True
+        config["send_bool_as"] = send_bool_as
+        client = aerospike.client(config).connect(config["user"], config["password"])
+        key = "test", "demo", "direct_cdt_encode"
+
+        try:
+            client.put(key, self.bins)
+            _, _, bins = self.as_connection.get(key)
+            _, _, expected = self.as_connection.get(self.test_key)
+        finally:
+            client.close()
+            self.as_connection.remove(key)
+
+        assert bins.pop("geo")[0].unwrap() == expected.pop("geo")[0].unwrap()
+        if send_bool_as == aerospike.INTEGER:
+            assert bins["list"][10:] == [1, 0]
+            bins["list"][10:] = expected["list"][10:]
+        assert bins == expected
@@ -0,0 +1,89 @@
+# -*- coding: utf-8 -*-
+
+import os
+import sys
+
+import pytest
+from .test_base_class import TestBaseClass
+import aerospike
+
+pytestmark = pytest.mark.skipif(
+    not hasattr(os, "fork") or sys.platform == "darwin",
+    reason="Requires fork()")
+
+
+def run_in_child(func):
+    """
+    Runs func in a forked child and returns the child's exit status.
+    """
+    pid = os.fork()
+    if pid == 0:
+        status = 1
+        try:
+            status = 0 if func() else 1
+        finally:
+            os._exit(status)
+    _, status = os.waitpid(pid, 0)
+    return os.WEXITSTATUS(status)
+
+
+class TestFork:
+    @pytest.fixture(autouse=True)
+    def setup(self, request):
+        self.key = ("test", "demo", "fork")
+        yield
+        client = TestBaseClass.get_new_connection()
+        try:
+            client.remove(self.key)
+        except aerospike.exception.RecordNotFound:
+            pass
+        client.close()
+
+    def test_client_used_in_child(self):
+        """
+        A client connected before fork() works in the child
+        """
+        client = TestBaseClass.get_new_connection()
+
+        def child():
+            client.put(self.key, {"pid": os.getpid()})
+            _, _, bins = client.get(self.key)
+            return bins["pid"] == os.getpid() and client.is_connected()
+
+        assert run_in_child(child) == 0
+        # The parent's connection is untouched by the child.
+        assert client.is_connected()
+        client.put(self.key, {"pid": os.getpid()})
+        client.close()
+
+    def test_shared_client_used_in_child(self):
+        """
+        Clients sharing a connection reconnect it once in the child
+        """
+        shared = {"use_shared_connection": True}
+        first = TestBaseClass.get_new_connection(shared)
+        second = TestBaseClass.get_new_connection(shared)
+
+        def child():
+            first.put(self.key, {"pid": os.getpid()})
+            _, _, bins = second.get(self.key)
+            return bins["pid"] == os.getpid()
+
+        assert run_in_child(child) == 0
+        assert second.is_connected()
+        second.close()
+        first.close()
+
+    def test_client_closed_in_child(self):
+        """
+        Closing an inherited client in the child leaves the parent connected
+        """
+        client = TestBaseClass.get_new_connection()
+
+        def child():
+            client.close()
+            return not client.is_connected()
+
+        assert run_in_child(child) == 0
+        assert client.is_connected()
+        client.close()
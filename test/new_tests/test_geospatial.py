@@ -5,7 +5,9 @@ from .test_base_class import TestBaseClass
 from .as_status_codes import AerospikeStatus
 from aerospike import exception as e
 from aerospike import predicates as p
+from aerospike_helpers import expressions as exp
 from aerospike_helpers.operations import operations
+import threading
 import time
 
 import aerospike
@@ -641,6 +643,79 @@ class TestGeospatial(object):
         obj = aerospike.geojson(geojson_str)
         assert obj.unwrap() == geo_object.unwrap()
 
+    @pytest.mark.parametrize(
+        "geo_data",
+        [
+            {"type": "Point", "coordinates": [-122.0, 37.5]},
+            {"type": "Polygon", "coordinates": [[[-1e-05, 1], [2, 3.25], [-1e-05, 1]]]},
+            {"type": "AeroCircle", "coordinates": [[-122, 37], 250], "name": "caf\u00e9 \"\U0001f600\""},
+        ],
+    )
+    def test_geospatial_dumps_matches_json(self, geo_data):
+        """
+        Verify the native GeoJSON encoding matches json.dumps and round trips.
+        """
+        import json
+
+        geo_object = aerospike.GeoJSON(geo_data)
+
+        assert geo_object.dumps() == json.dumps(geo_data)
+        assert aerospike.geojson(geo_object.dumps()).unwrap() == geo_data
+
+    def test_geospatial_read_is_lazy(self):
+        """
+        Read a geospatial bin, use it and write it back.
+        """
+        key = ("test", "demo", "lazy_geo")
+        geo_data = {"type": "Point", "coordinates": [42.34, 58.62]}
+        self.as_connection.put(key, {"loc": aerospike.GeoJSON(geo_data)})
+        self.keys.append(key)
+
+        _, _, bins = self.as_connection.get(key)
+        assert str(bins["loc"]) == aerospike.GeoJSON(geo_data).dumps()
+
+        self.as_connection.put(key, {"loc2": bins["loc"]})
+        _, _, bins = self.as_connection.get(key)
+        assert bins["loc2"].unwrap() == geo_data
+
+        # Changes made after unwrapping are written.
+        bins["loc"].unwrap()["coordinates"] = [1.5, 2.5]
+        self.as_connection.put(key, {"loc": bins["loc"]})
+        _, _, bins = self.as_connection.get(key)
+        assert bins["loc"].geo_data == {"type": "Point", "coordinates": [1.5, 2.5]}
+
+    def test_geospatial_lazy_read_from_threads(self):
+        key = ("test", "demo", "lazy_geo_threads")
+        geo_data = {"type": "Point", "coordinates": [42.34, 58.62]}
+        self.as_connection.put(key, {"loc": aerospike.GeoJSON(geo_data)})
+        self.keys.append(key)
+
+        _, _, bins = self.as_connection.get(key)
+        results = []
+
+        def read():
+            results.append(bins["loc"].unwrap())
+            results.append(bins["loc"].dumps())
+
+        threads = [threading.Thread(target=read) for _ in range(8)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+
+        assert results.count(geo_data) == 8
+
+    def test_geospatial_expression_value(self):
+        key = ("test", "demo", "geo_expression")
+        geo_data = {"type": "Point", "coordinates": [42.34, 58.62]}
+        self.as_connection.put(key, {"loc": aerospike.GeoJSON(geo_data)})
+        self.keys.append(key)
+
+        region = aerospike.GeoJSON({"type": "AeroCircle", "coordinates": [[42.34, 58.62], 1000]})
+        expr = exp.CmpGeo(exp.GeoBin("loc"), region).compile()
+        _, _, bins = self.as_connection.get(key, {"expressions": expr})
+        assert bins["loc"].unwrap() == geo_data
+
     def test_geospatial_repr_positive(self):
         """
         Perform a positive repr. Verify using eval()
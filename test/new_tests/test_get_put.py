@@ -881,3 +881,23 @@ class TestGetPut:
         assert 0 == self.as_connection.put(key, null_bin)
         with pytest.raises(e.RecordNotFound):
             res = self.as_connection.get(key)
+
+    def test_pos_get_put_large_cdt_bins(self, put_data):
+        """
+        Invoke get() for a record with large list and map bins, including
+        nested and key ordered maps.
+        """
+        key = ("test", "demo", "large_cdt_bins")
+        large_map = {"key%d" % i: i for i in range(10000)}
+        large_list = list(range(10000))
+        nested = [{"inner": [i, str(i)]} for i in range(1000)]
+        ordered = aerospike.KeyOrderedDict({i: [i] for i in range(1000)})
+        record = {"map": large_map, "list": large_list, "nested": nested, "ordered": ordered}
+
+        put_data(self.as_connection, key, record)
+        _, _, bins = self.as_connection.get(key)
+
+        assert bins["map"] == large_map
+        assert bins["list"] == large_list
+        assert bins["nested"] == nested
+        assert bins["ordered"] == dict(ordered)
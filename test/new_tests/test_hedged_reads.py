@@ -0,0 +1,84 @@
+# -*- coding: utf-8 -*-
+
+import threading
+
+import pytest
+from .test_base_class import TestBaseClass
+from aerospike import exception as e
+
+import aerospike
+
+
+class TestHedgedReads:
+    @pytest.fixture(autouse=True)
+    def setup(self, request):
+        self.key = ("test", "demo", "hedged_reads")
+        # A delay of 1 microsecond hedges nearly every read.
+        self.client = TestBaseClass.get_new_connection({"hedged_reads": {"delay": 1, "threads": 4}})
+        self.client.put(self.key, {"name": "John", "age": 30})
+        yield
+        self.client.remove(self.key)
+        self.client.close()
+
+    def test_get(self):
+        for _ in range(20):
+            _, meta, bins = self.client.get(self.key)
+            assert meta["gen"] == 1
+            assert bins == {"name": "John", "age": 30}
+
+    def test_select(self):
+        for _ in range(20):
+            _, _, bins = self.client.select(self.key, ["name"])
+            assert bins == {"name": "John"}
+
+    def test_get_not_found(self):
+        with pytest.raises(e.RecordNotFound):
+            self.client.get(("test", "demo", "hedged_reads_missing"))
+
+    def test_get_with_master_replica_policy(self):
+        _, _, bins = self.client.get(self.key, {"replica": aerospike.POLICY_REPLICA_MASTER})
+        assert bins == {"name": "John", "age": 30}
+
+    def test_concurrent_get(self):
+        errors = []
+
+        def worker():
+            try:
+                for _ in range(20):
+                    _, _, bins = self.client.get(self.key)
+                    assert bins["name"] == "John"
+            except Exception as exception:
+                errors.append(exception)
+
+        threads = [threading.Thread(target=worker) for _ in range(16)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        assert errors == []
+
+    def test_percentile_delay(self):
+        client = TestBaseClass.get_new_connection({"hedged_reads": {"percentile": 90.0, "min_delay": 0}})
+        try:
+            for _ in range(300):
+                _, _, bins = client.get(self.key)
+                assert bins["age"] == 30
+        finally:
+            client.close()
+
+
+@pytest.mark.parametrize(
+    "config",
+    (
+        [],
+        {"delay": "10"},
+        {"delay": 0},
+        {"threads": 0},
+        {"percentile": 100},
+        {"percentile": "high"},
+        {"min_delay": 10, "max_delay": 5},
+    ),
+)
+def test_invalid_hedged_reads_config(config):
+    with pytest.raises(e.ParamError):
+        TestBaseClass.get_new_connection({"hedged_reads": config})
@@ -0,0 +1,102 @@
+# -*- coding: utf-8 -*-
+
+import pickle
+
+import pytest
+from aerospike import exception as e
+
+import aerospike
+
+
+class TestKeyObject(object):
+    def test_key_digest_matches_calc_digest(self):
+        key = aerospike.Key("test", "demo", 1)
+
+        assert key.namespace == "test"
+        assert key.set == "demo"
+        assert key.key == 1
+        assert isinstance(key.digest, bytes)
+        assert key.digest == aerospike.calc_digest("test", "demo", 1)
+
+    def test_key_is_a_tuple(self):
+        key = aerospike.Key("test", "demo", "k")
+
+        assert isinstance(key, tuple)
+        assert len(key) == 4
+        assert key == ("test", "demo", "k", aerospike.calc_digest("test", "demo", "k"))
+
+    def test_key_from_digest_only(self):
+        digest = aerospike.calc_digest("test", "demo", 1)
+        key = aerospike.Key("test", "demo", digest=digest)
+
+        assert key.key is None
+        assert key.digest == digest
+
+    def test_key_with_matching_digest(self):
+        digest = aerospike.calc_digest("test", "demo", 1)
+        key = aerospike.Key("test", "demo", 1, digest)
+
+        assert key.digest == digest
+
+    def test_key_with_mismatched_digest(self):
+        digest = aerospike.calc_digest("test", "demo", 2)
+
+        with pytest.raises(e.ParamError):
+            aerospike.Key("test", "demo", 1, digest)
+
+    def test_key_without_key_or_digest(self):
+        with pytest.raises(e.ParamError):
+            aerospike.Key("test", "demo")
+
+    @pytest.mark.parametrize("key", ((1, "demo", 1), ("test", 1, 1), ("test", "demo", 1.5)))
+    def test_key_with_invalid_parts(self, key):
+        with pytest.raises(e.ParamError):
+            aerospike.Key(*key)
+
+    def test_key_pickle_round_trip(self):
+        key = aerospike.Key("test", "demo", 1)
+        copy = pickle.loads(pickle.dumps(key))
+
+        assert type(copy) is aerospike.Key
+        assert copy == key
+
+
+@pytest.mark.usefixtures("as_connection")
+class TestKeyObjectOperations(object):
+    @pytest.fixture(autouse=True)
+    def setup(self, request, as_connection):
+        self.test_key = aerospike.Key("test", "demo", "key_object")
+        as_connection.put(self.test_key, {"a": 1})
+
+        yield
+
+        as_connection.remove(self.test_key)
+
+    def test_get_with_key_object(self):
+        key, meta, bins = self.as_connection.get(self.test_key)
+
+        assert type(key) is aerospike.Key
+        assert key.digest == self.test_key.digest
+        assert meta is not None
+        assert bins == {"a": 1}
+
+    def test_returned_key_can_be_reused(self):
+        key, _, _ = self.as_connection.get(self.test_key)
+        self.as_connection.increment(key, "a", 1)
+
+        _, _, bins = self.as_connection.get(("test", "demo", "key_object"))
+        assert bins == {"a": 2}
+
+    def test_get_many_returns_key_objects(self):
+        records = self.as_connection.get_many([self.test_key])
+
+        assert type(records[0][0]) is aerospike.Key
+        assert records[0][0].digest == self.test_key.digest
+
+    def test_look_alike_key_is_not_trusted(self):
+        # A tuple subclass which only shares the name must not have its digest used.
+        Key = type("Key", (tuple,), {"__module__": "aerospike"})
+        fake = Key(("test", "demo", "key_object", b"\x00" * 20))
+
+        _, _, bins = self.as_connection.get(fake)
+        assert bins == {"a": 1}
@@ -0,0 +1,76 @@
+# -*- coding: utf-8 -*-
+
+import time
+
+import pytest
+from .test_base_class import TestBaseClass
+from aerospike import exception as e
+
+import aerospike
+
+
+class TestLatencyProbes:
+    def test_node_latencies(self):
+        client = TestBaseClass.get_new_connection({"latency_probes": {"interval": 10}})
+        try:
+            deadline = time.time() + 5
+            latencies = client.get_node_latencies()
+            while not latencies and time.time() < deadline:
+                time.sleep(0.05)
+                latencies = client.get_node_latencies()
+
+            assert latencies
+            for stats in latencies.values():
+                assert stats["latency"] is None or stats["latency"] > 0
+                assert 0 <= stats["error_rate"] <= 1
+                assert isinstance(stats["healthy"], bool)
+                assert isinstance(stats["racks"], list)
+        finally:
+            client.close()
+
+    def test_reads_with_latency_probes(self):
+        config = {"rack_aware": True, "rack_ids": [0, 1], "latency_probes": {"interval": 10}}
+        client = TestBaseClass.get_new_connection(config)
+        key = ("test", "demo", "latency_probes")
+        try:
+            client.put(key, {"a": 1})
+            for _ in range(20):
+                _, _, bins = client.get(key, {"replica": aerospike.POLICY_REPLICA_PREFER_RACK})
+                assert bins == {"a": 1}
+            client.remove(key)
+        finally:
+            client.close()
+
+    def test_shared_connection(self):
+        config = {"use_shared_connection": True, "latency_probes": {"interval": 10}}
+        client = TestBaseClass.get_new_connection(config)
+        try:
+            deadline = time.time() + 5
+            while not client.get_node_latencies() and time.time() < deadline:
+                time.sleep(0.05)
+            assert client.get_node_latencies()
+        finally:
+            client.close()
+
+    def test_not_enabled(self):
+        client = TestBaseClass.get_new_connection()
+        try:
+            assert client.get_node_latencies() is None
+        finally:
+            client.close()
+
+    @pytest.mark.parametrize(
+        "config",
+        [
+            [],
+            {"interval": 0},
+            {"interval": "1"},
+            {"timeout": 0},
+            {"alpha": 0},
+            {"alpha": 1.5},
+            {"max_error_rate": "high"},
+        ],
+    )
+    def test_invalid_config(self, config):
+        with pytest.raises(e.ParamError):
+            TestBaseClass.get_new_connection({"latency_probes": config})
@@ -38,6 +38,57 @@ class TestLog(object):
         assert response == 0
         client.close()
 
+    def test_log_handler_batched_delivery(self):
+        """
+        Test that queued log records reach the handler through drain_logs
+        """
+        records = []
+
+        def handler(level, func, path, line, msg):
+            records.append((level, func, path, line, msg))
+
+        aerospike.set_log_level(aerospike.LOG_LEVEL_DEBUG)
+        aerospike.set_log_handler(handler)
+
+        client = TestBaseClass.get_new_connection()
+        client.close()
+        aerospike.drain_logs()
+
+        aerospike.set_log_level(aerospike.LOG_LEVEL_ERROR)
+        aerospike.set_log_handler(None)
+
+        assert records
+        level, func, path, line, msg = records[0]
+        assert isinstance(level, int)
+        assert isinstance(line, int)
+        assert isinstance(msg, str)
+
+        stats = aerospike.get_log_stats()
+        assert stats["delivered"] >= len(records)
+        assert stats["dropped"] >= 0
+
+    def test_drain_logs_from_handler(self):
+        """
+        Test that the log handler may call drain_logs
+        """
+        drained = []
+
+        def handler(level, func, path, line, msg):
+            drained.append(aerospike.drain_logs())
+
+        aerospike.set_log_level(aerospike.LOG_LEVEL_DEBUG)
+        aerospike.set_log_handler(handler)
+
+        client = TestBaseClass.get_new_connection()
+        client.close()
+        aerospike.drain_logs()
+
+        aerospike.set_log_level(aerospike.LOG_LEVEL_ERROR)
+        aerospike.set_log_handler(None)
+
+        assert drained
+        assert all(isinstance(count, int) for count in drained)
+
     @pytest.mark.parametrize("level", [None, [], {}, 1.5, "serious"])
     def test_set_log_level_with_invalid_type(self, level):
         """
@@ -0,0 +1,125 @@
+# -*- coding: utf-8 -*-
+
+import pytest
+from .test_base_class import TestBaseClass
+import aerospike
+from aerospike import exception as e
+
+
+class TestReadCache:
+    @pytest.fixture(autouse=True)
+    def setup(self, request):
+        self.key = ("test", "demo", "read_cache")
+        self.other = TestBaseClass.get_new_connection()
+        self.other.put(self.key, {"name": "John", "age": 1})
+        self.client = TestBaseClass.get_new_connection({"read_cache": {"max_records": 2}})
+        yield
+        self.other.remove(self.key)
+        self.other.close()
+        self.client.close()
+
+    def test_get_served_from_cache(self):
+        _, _, bins = self.client.get(self.key)
+        # Not seen by the cached client until the record ages out.
+        self.other.put(self.key, {"age": 2})
+        _, meta, cached = self.client.get(self.key)
+        assert cached == bins
+        assert meta["gen"] == 1
+        stats = self.client.get_read_cache_stats()
+        assert stats["hits"] == 1
+        assert stats["misses"] == 1
+        assert stats["records"] == 1
+
+    def test_served_records_are_copies(self):
+        _, _, bins = self.client.get(self.key)
+        bins["age"] = 100
+        _, _, cached = self.client.get(self.key)
+        assert cached["age"] == 1
+
+    def test_served_nested_values_are_copies(self):
+        self.other.put(self.key, {"list": [1, 2], "map": {"a": [1]}})
+        _, _, bins = self.client.get(self.key)
+        bins["list"].append(3)
+        bins["map"]["a"].append(2)
+        _, _, cached = self.client.get(self.key)
+        assert cached["list"] == [1, 2]
+        assert cached["map"] == {"a": [1]}
+        _, _, selected = self.client.select(self.key, ["list"])
+        selected["list"].append(4)
+        _, _, cached = self.client.get(self.key)
+        assert cached["list"] == [1, 2]
+        assert self.client.get_read_cache_stats()["hits"] == 3
+
+    def test_policy_changing_results_bypasses_cache(self):
+        self.other.put(self.key, {"list": [1, 2]})
+        self.client.get(self.key, {"deserialize": False})
+        _, _, bins = self.client.get(self.key)
+        assert bins == {"list": [1, 2]}
+        self.client.get(self.key, {"read_mode_sc": aerospike.POLICY_READ_MODE_SC_LINEARIZE})
+        stats = self.client.get_read_cache_stats()
+        assert stats["hits"] == 0
+        assert stats["records"] == 1
+
+        # Policies which only change how the read is made share the entry.
+        _, _, bins = self.client.get(self.key, {"total_timeout": 1000})
+        assert bins == {"list": [1, 2]}
+        assert self.client.get_read_cache_stats()["hits"] == 1
+
+    def test_select_served_from_cache(self):
+        self.client.get(self.key)
+        _, _, bins = self.client.select(self.key, ["age"])
+        assert bins == {"age": 1}
+        assert self.client.get_read_cache_stats()["hits"] == 1
+
+    def test_write_invalidates(self):
+        self.client.get(self.key)
+        self.client.put(self.key, {"age": 2})
+        _, _, bins = self.client.get(self.key)
+        assert bins["age"] == 2
+
+    def test_validation_detects_change(self):
+        client = TestBaseClass.get_new_connection(
+            {"read_cache": {"max_records": 2, "validate_size": 1}})
+        client.get(self.key)
+        self.other.put(self.key, {"age": 2})
+        _, _, bins = client.get(self.key)
+        assert bins["age"] == 2
+        stats = client.get_read_cache_stats()
+        assert stats["validations"] == 1
+        assert stats["stale"] == 1
+        client.close()
+
+    def test_max_records(self):
+        keys = [("test", "demo", "read_cache_%d" % i) for i in range(3)]
+        for key in keys:
+            self.other.put(key, {"i": 1})
+            self.client.get(key)
+        stats = self.client.get_read_cache_stats()
+        assert stats["records"] == 2
+        assert stats["evictions"] == 1
+        for key in keys:
+            self.other.remove(key)
+
+    def test_sets_scope(self):
+        client = TestBaseClass.get_new_connection(
+            {"read_cache": {"max_records": 2, "sets": [("test", "other")]}})
+        client.get(self.key)
+        assert client.get_read_cache_stats()["records"] == 0
+        client.close()
+
+    def test_clear_read_cache(self):
+        self.client.get(self.key)
+        self.client.clear_read_cache()
+        assert self.client.get_read_cache_stats()["records"] == 0
+
+    def test_no_read_cache(self):
+        assert self.other.get_read_cache_stats() is None
+
+    @pytest.mark.parametrize(
+        "read_cache",
+        [{}, {"max_records": "10"}, {"max_records": 10, "sets": ["test", 1]}, []])
+    def test_invalid_read_cache(self, read_cache):
+        config = TestBaseClass.get_connection_config()
+        config["read_cache"] = read_cache
+        with pytest.raises(e.ParamError):
+            aerospike.client(config)
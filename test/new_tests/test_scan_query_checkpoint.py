@@ -0,0 +1,47 @@
+# -*- coding: utf-8 -*-
+import pytest
+from aerospike import exception as e
+from .test_base_class import TestBaseClass
+
+
+class TestScanQueryCheckpoint(TestBaseClass):
+    @pytest.fixture(autouse=True)
+    def setup(self, request, as_connection):
+        self.test_ns = "test"
+        self.test_set = "checkpoint"
+        self.keys = [(self.test_ns, self.test_set, i) for i in range(100)]
+        for key in self.keys:
+            as_connection.put(key, {"i": key[2]})
+
+        yield
+
+        for key in self.keys:
+            as_connection.remove(key)
+
+    @pytest.mark.parametrize("kind", ["scan", "query"])
+    def test_checkpoint_resume(self, kind):
+        first = getattr(self.as_connection, kind)(self.test_ns, self.test_set)
+        first.paginate()
+        records = first.results({"max_records": 30})
+        checkpoint = first.checkpoint()
+
+        assert isinstance(checkpoint, bytes)
+
+        resumed = getattr(self.as_connection, kind)(self.test_ns, self.test_set)
+        resumed.resume(checkpoint)
+        while not resumed.is_done():
+            records.extend(resumed.results({"max_records": 30}))
+
+        assert sorted(bins["i"] for _, _, bins in records) == list(range(100))
+        assert resumed.checkpoint() != checkpoint
+
+    @pytest.mark.parametrize("kind", ["scan", "query"])
+    def test_checkpoint_not_tracking(self, kind):
+        with pytest.raises(e.ParamError):
+            getattr(self.as_connection, kind)(self.test_ns, self.test_set).checkpoint()
+
+    @pytest.mark.parametrize("checkpoint", [b"", b"ASPS", b"XXXX\x01\x00\x00\x00\x10\x00", "str", 1])
+    def test_resume_invalid_checkpoint(self, checkpoint):
+        scan = self.as_connection.scan(self.test_ns, self.test_set)
+        with pytest.raises(e.ParamError):
+            scan.resume(checkpoint)
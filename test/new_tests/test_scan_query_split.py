@@ -0,0 +1,66 @@
+# -*- coding: utf-8 -*-
+import pickle
+
+import pytest
+from aerospike import exception as e
+from .test_base_class import TestBaseClass
+
+
+class TestScanQuerySplit(TestBaseClass):
+    @pytest.fixture(autouse=True)
+    def setup(self, request, as_connection):
+        self.test_ns = "test"
+        self.test_set = "split"
+        self.keys = [(self.test_ns, self.test_set, i) for i in range(100)]
+        for key in self.keys:
+            as_connection.put(key, {"i": key[2]})
+
+        yield
+
+        for key in self.keys:
+            as_connection.remove(key)
+
+    @pytest.mark.parametrize("n", [1, 3, 4, 4096])
+    def test_scan_split_covers_all_partitions(self, n):
+        filters = self.as_connection.scan(self.test_ns, self.test_set).split(n)
+
+        assert len(filters) == n
+        begin = 0
+        for partition_filter in filters:
+            assert partition_filter["begin"] == begin
+            begin += partition_filter["count"]
+        assert begin == 4096
+        assert max(f["count"] for f in filters) - min(f["count"] for f in filters) <= 1
+
+    def test_scan_split_results(self):
+        filters = self.as_connection.scan(self.test_ns, self.test_set).split(4)
+
+        records = []
+        for partition_filter in pickle.loads(pickle.dumps(filters)):
+            scan = self.as_connection.scan(self.test_ns, self.test_set)
+            records.extend(scan.results({"partition_filter": partition_filter}))
+
+        assert sorted(bins["i"] for _, _, bins in records) == list(range(100))
+
+    def test_query_split_resumes_partition_status(self):
+        query = self.as_connection.query(self.test_ns, self.test_set)
+        query.paginate()
+        first_page = query.results({"max_records": 10, "partition_filter": {"begin": 0, "count": 4096}})
+
+        filters = query.split(3)
+        for partition_filter in filters:
+            status = partition_filter["partition_status"]
+            part_ids = range(partition_filter["begin"], partition_filter["begin"] + partition_filter["count"])
+            assert set(status) - {"done", "retry"} == set(part_ids)
+
+        records = list(first_page)
+        for partition_filter in filters:
+            query = self.as_connection.query(self.test_ns, self.test_set)
+            records.extend(query.results({"partition_filter": partition_filter}))
+
+        assert sorted(bins["i"] for _, _, bins in records) == list(range(100))
+
+    @pytest.mark.parametrize("n", [0, -1, 4097])
+    def test_scan_split_invalid_n(self, n):
+        with pytest.raises(e.ParamError):
+            self.as_connection.scan(self.test_ns, self.test_set).split(n)
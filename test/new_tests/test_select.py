@@ -175,6 +175,32 @@ class TestSelect(object):
 
         assert "argument 'key' (pos 1)" in str(typeError.value)
 
+    def test_select_with_keyword_arguments(self):
+        _, _, bins = self.as_connection.select(bins=["a"], key=self.test_key, policy=None)
+
+        assert list(bins) == ["a"]
+
+    def test_select_with_extra_parameter(self):
+
+        with pytest.raises(TypeError) as typeError:
+            self.as_connection.select(self.test_key, ["a"], {}, None)
+
+        assert "select() takes at most 3 arguments (4 given)" in str(typeError.value)
+
+    def test_select_with_invalid_keyword(self):
+
+        with pytest.raises(TypeError) as typeError:
+            self.as_connection.select(self.test_key, ["a"], polcy={})
+
+        assert "'polcy' is an invalid keyword argument for select()" in str(typeError.value)
+
+    def test_select_with_argument_given_twice(self):
+
+        with pytest.raises(TypeError) as typeError:
+            self.as_connection.select(self.test_key, ["a"], bins=["a"])
+
+        assert "given by name ('bins') and position (2)" in str(typeError.value)
+
     def test_select_with_key_and_bins_without_connection(self):
 
         bins_to_select = ["a"]
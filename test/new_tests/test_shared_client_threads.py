@@ -0,0 +1,112 @@
+# -*- coding: utf-8 -*-
+
+import threading
+
+import pytest
+from .test_base_class import TestBaseClass
+from aerospike import exception as e
+from aerospike_helpers.batch.records import BatchRecords, Read
+
+# On free-threaded builds (3.13t and later) these calls run in parallel on the
+# shared client.
+THREADS = 16
+ROUNDS = 50
+
+
+def run_concurrently(func):
+    errors = []
+    barrier = threading.Barrier(THREADS)
+
+    def worker(i):
+        barrier.wait()
+        try:
+            func(i)
+        except Exception as exception:
+            errors.append(exception)
+
+    threads = [threading.Thread(target=worker, args=(i,)) for i in range(THREADS)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    assert errors == []
+
+
+class TestSharedClientThreads:
+    @pytest.fixture(autouse=True)
+    def setup(self, request):
+        self.client = TestBaseClass.get_new_connection()
+        self.keys = [("test", "demo", "shared_client_threads_%d" % i) for i in range(THREADS)]
+        yield
+        for key in self.keys:
+            try:
+                self.client.remove(key)
+            except e.RecordNotFound:
+                pass
+        self.client.close()
+
+    def test_concurrent_put_get(self):
+        def worker(i):
+            key = self.keys[i]
+            for n in range(ROUNDS):
+                bins = {"thread": i, "n": n, "list": [i, n], "map": {"n": n}}
+                self.client.put(key, bins)
+                _, _, read = self.client.get(key)
+                assert read == bins
+
+        run_concurrently(worker)
+
+    def test_concurrent_put_same_key(self):
+        key = self.keys[0]
+        self.client.put(key, {"thread": -1, "list": []})
+
+        def worker(i):
+            for n in range(ROUNDS):
+                self.client.put(key, {"thread": i, "list": [i] * n})
+                _, _, bins = self.client.get(key)
+                # Another thread may have written in between, but never a mix.
+                assert bins["list"] == [bins["thread"]] * len(bins["list"])
+
+        run_concurrently(worker)
+
+    def test_concurrent_batches(self):
+        for i, key in enumerate(self.keys):
+            self.client.put(key, {"thread": i})
+
+        def worker(i):
+            for _ in range(ROUNDS):
+                if i % 2:
+                    self.client.put(self.keys[i], {"thread": i})
+                    continue
+                records = self.client.get_many(self.keys)
+                assert [bins["thread"] for _, _, bins in records] == list(range(THREADS))
+                batch = self.client.batch_read(self.keys, ["thread"])
+                assert [r.record[2]["thread"] for r in batch.batch_records] == list(range(THREADS))
+                reads = BatchRecords([Read(key, None, read_all_bins=True) for key in self.keys])
+                batch = self.client.batch_write(reads)
+                assert [r.record[2]["thread"] for r in batch.batch_records] == list(range(THREADS))
+
+        run_concurrently(worker)
+
+    def test_concurrent_exceptions(self):
+        missing = [("test", "demo", "shared_client_threads_missing_%d" % i) for i in range(THREADS)]
+
+        def worker(i):
+            for _ in range(ROUNDS):
+                with pytest.raises(e.RecordNotFound) as exc_info:
+                    self.client.get(missing[i])
+                # Each thread sees the details of its own error.
+                assert exc_info.value.key == missing[i]
+                assert exc_info.value.code == e.RecordNotFound.code
+
+        run_concurrently(worker)
+
+    def test_concurrent_connect_close(self):
+        def worker(i):
+            for _ in range(ROUNDS // 10):
+                client = TestBaseClass.get_new_connection()
+                client.put(self.keys[i], {"thread": i})
+                assert client.get(self.keys[i])[2] == {"thread": i}
+                client.close()
+
+        run_concurrently(worker)
@@ -0,0 +1,101 @@
+# -*- coding: utf-8 -*-
+
+import textwrap
+
+import pytest
+from .test_base_class import TestBaseClass
+import aerospike
+
+try:
+    import _interpreters as interpreters
+except ImportError:
+    try:
+        import _xxsubinterpreters as interpreters
+    except ImportError:
+        interpreters = None
+
+pytestmark = pytest.mark.skipif(interpreters is None, reason="Requires subinterpreters")
+
+
+def run_in_subinterpreter(script, out_path):
+    """
+    Runs script in a new subinterpreter and returns what it wrote to out_path.
+    """
+    interp = interpreters.create()
+    try:
+        result = interpreters.run_string(interp, textwrap.dedent(script))
+        assert result is None
+    finally:
+        interpreters.destroy(interp)
+    with open(out_path) as out:
+        return out.read()
+
+
+class TestSubinterpreters:
+    @pytest.fixture(autouse=True)
+    def setup(self, request, tmp_path):
+        self.key = ("test", "demo", "subinterpreter")
+        self.out_path = str(tmp_path / "out")
+        yield
+        client = TestBaseClass.get_new_connection()
+        try:
+            client.remove(self.key)
+        except aerospike.exception.RecordNotFound:
+            pass
+        client.close()
+
+    def test_import_in_subinterpreter(self):
+        """
+        A subinterpreter gets classes of its own
+        """
+        script = """
+            import aerospike
+            with open(%r, "w") as out:
+                out.write(aerospike.Client.__name__ + " " + aerospike.exception.ParamError.__name__)
+        """ % (self.out_path,)
+
+        assert run_in_subinterpreter(script, self.out_path) == "Client ParamError"
+
+    def test_shared_connection_across_interpreters(self):
+        """
+        A client in a subinterpreter uses the connection shared by the main interpreter
+        """
+        config = TestBaseClass.get_connection_config()
+        config["use_shared_connection"] = True
+        client = aerospike.client(config).connect(config["user"], config["password"])
+        client.put(self.key, {"a": 1})
+
+        script = """
+            import aerospike
+            config = %r
+            client = aerospike.client(config).connect(config["user"], config["password"])
+            _, _, bins = client.get(%r)
+            shm_key = client.shm_key()
+            client.close()
+            with open(%r, "w") as out:
+                out.write(repr((bins, shm_key)))
+        """ % (config, self.key, self.out_path)
+
+        try:
+            assert run_in_subinterpreter(script, self.out_path) == repr(({"a": 1}, client.shm_key()))
+            # The subinterpreter closing its client leaves this one connected.
+            assert client.get(self.key)[2] == {"a": 1}
+        finally:
+            client.close()
+
+    def test_log_handler_requires_main_interpreter(self):
+        """
+        set_log_handler() is rejected outside the main interpreter
+        """
+        script = """
+            import aerospike
+            try:
+                aerospike.set_log_handler(lambda *args: None)
+                result = "set"
+            except aerospike.exception.ParamError:
+                result = "rejected"
+            with open(%r, "w") as out:
+                out.write(result)
+        """ % (self.out_path,)
+
+        assert run_in_subinterpreter(script, self.out_path) == "rejected"
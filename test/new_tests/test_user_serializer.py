@@ -3,6 +3,7 @@
 import pytest
 import json
 import marshal
+import pickle
 from .test_base_class import TestBaseClass
 from aerospike import exception as e
 
@@ -341,3 +342,195 @@ class TestUserSerializer(object):
         }
         client.close()
         self.delete_keys.append(key)
+
+    def test_batch_serializer_and_deserializer(self):
+        """
+        Batch serializers are called once per record, batch deserializers
+        once per batch read, with the bin values.
+        """
+        calls = {"serialize": 0, "deserialize": 0}
+
+        def batch_serialize(values):
+            calls["serialize"] += 1
+            return [pickle.dumps(value) for value in values]
+
+        def batch_deserialize(values):
+            calls["deserialize"] += 1
+            return [pickle.loads(value) for value in values]
+
+        aerospike.set_serializer(batch_serialize, batch=True)
+        aerospike.set_deserializer(batch_deserialize, batch=True)
+        keys = [("test", "demo", "batch_serializer_%d" % i) for i in range(3)]
+        rec = {"a": {1, 2}, "b": frozenset([3]), "c": {4}, "d": 1}
+
+        try:
+            for key in keys:
+                TestUserSerializer.client.put(key, rec, {}, {}, aerospike.SERIALIZER_USER)
+                self.delete_keys.append(key)
+            assert calls["serialize"] == len(keys)
+
+            records = TestUserSerializer.client.get_many(keys)
+            assert calls["deserialize"] == 1
+            for _, _, bins in records:
+                assert bins == rec
+
+            _, _, bins = TestUserSerializer.client.get(keys[0])
+            assert calls["deserialize"] == 2
+            assert bins == rec
+        finally:
+            aerospike.unset_serializers()
+
+    def test_batch_deserializer_batch_read(self):
+        def batch_serialize(values):
+            return [pickle.dumps(value) for value in values]
+
+        def batch_deserialize(values):
+            return [pickle.loads(value) for value in values]
+
+        aerospike.set_serializer(batch_serialize, batch=True)
+        aerospike.set_deserializer(batch_deserialize, batch=True)
+        keys = [("test", "demo", "batch_deserializer_read_%d" % i) for i in range(2)]
+        rec = {"a": {1, 2}, "b": [frozenset([3]), {"c": {4}}]}
+
+        try:
+            for key in keys:
+                TestUserSerializer.client.put(key, rec, {}, {}, aerospike.SERIALIZER_USER)
+                self.delete_keys.append(key)
+
+            res = TestUserSerializer.client.batch_read(keys)
+            for batch_record in res.batch_records:
+                assert batch_record.record[2] == rec
+        finally:
+            aerospike.unset_serializers()
+
+    def test_batch_serializer_reentered(self):
+        """
+        A batch serializer or deserializer may use the client itself.
+        """
+        inner_key = ("test", "demo", "batch_serializer_inner")
+        outer_key = ("test", "demo", "batch_serializer_outer")
+        inner_bins = []
+
+        def batch_serialize(values):
+            if not inner_bins:
+                inner_bins.append(None)
+                TestUserSerializer.client.put(inner_key, {"x": {5}}, {}, {}, aerospike.SERIALIZER_USER)
+            return [pickle.dumps(value) for value in values]
+
+        def batch_deserialize(values):
+            if inner_bins[-1] is None:
+                inner_bins.append(TestUserSerializer.client.get(inner_key)[2])
+            return [pickle.loads(value) for value in values]
+
+        aerospike.set_serializer(batch_serialize, batch=True)
+        aerospike.set_deserializer(batch_deserialize, batch=True)
+
+        try:
+            TestUserSerializer.client.put(outer_key, {"a": {1}, "b": [{2}]}, {}, {}, aerospike.SERIALIZER_USER)
+            self.delete_keys.extend([inner_key, outer_key])
+
+            _, _, bins = TestUserSerializer.client.get(outer_key)
+            assert bins == {"a": {1}, "b": [{2}]}
+            assert inner_bins[-1] == {"x": {5}}
+        finally:
+            aerospike.unset_serializers()
+
+    def test_batch_deserializer_failure_returns_bytes(self):
+        def batch_serialize(values):
+            return [pickle.dumps(value) for value in values]
+
+        def batch_deserialize(values):
+            raise ValueError("cannot deserialize")
+
+        aerospike.set_serializer(batch_serialize, batch=True)
+        aerospike.set_deserializer(batch_deserialize, batch=True)
+        key = ("test", "demo", "batch_serializer_failure")
+
+        try:
+            TestUserSerializer.client.put(key, {"a": {1}}, {}, {}, aerospike.SERIALIZER_USER)
+            self.delete_keys.append(key)
+
+            _, _, bins = TestUserSerializer.client.get(key)
+            assert bins == {"a": pickle.dumps({1})}
+        finally:
+            aerospike.unset_serializers()
+
+    @pytest.mark.parametrize(
+        "wrap",
+        [bytes, bytearray, memoryview, pickle.PickleBuffer],
+        ids=["bytes", "bytearray", "memoryview", "PickleBuffer"],
+    )
+    def test_serializer_returning_bytes_like(self, wrap):
+        received = []
+
+        def serialize(value):
+            return wrap(pickle.dumps(value, protocol=5))
+
+        def deserialize(view):
+            received.append(type(view))
+            return pickle.loads(view)
+
+        aerospike.set_serializer(serialize)
+        aerospike.set_deserializer(deserialize, buffer=True)
+        key = ("test", "demo", "serializer_bytes_like")
+
+        try:
+            TestUserSerializer.client.put(key, {"a": {1, 2}}, {}, {}, aerospike.SERIALIZER_USER)
+            self.delete_keys.append(key)
+
+            _, _, bins = TestUserSerializer.client.get(key)
+            assert bins == {"a": {1, 2}}
+            assert received == [memoryview]
+        finally:
+            aerospike.unset_serializers()
+
+    def test_buffer_deserializer_keeping_view(self):
+        calls = []
+
+        def serialize(value):
+            return pickle.dumps(value)
+
+        def deserialize(view):
+            # The view stays valid after the record is freed.
+            calls.append(view)
+            return memoryview(view)
+
+        aerospike.set_serializer(serialize)
+        aerospike.set_deserializer(deserialize, buffer=True)
+        key = ("test", "demo", "serializer_keep_view")
+
+        try:
+            TestUserSerializer.client.put(key, {"a": {1}}, {}, {}, aerospike.SERIALIZER_USER)
+            self.delete_keys.append(key)
+
+            _, _, bins = TestUserSerializer.client.get(key)
+            assert bytes(bins["a"]) == pickle.dumps({1})
+            assert len(calls) == 1
+            # Not a copy into a bytes object.
+            assert not isinstance(calls[0].obj, bytes)
+        finally:
+            aerospike.unset_serializers()
+
+    def test_buffer_deserializer_list_items(self):
+        views = []
+
+        def deserialize(view):
+            views.append(view)
+            return pickle.loads(view)
+
+        aerospike.set_serializer(pickle.dumps)
+        aerospike.set_deserializer(deserialize, buffer=True)
+        key = ("test", "demo", "serializer_view_list")
+
+        try:
+            TestUserSerializer.client.put(key, {"a": {1}, "l": [{2}, {3}]}, {}, {}, aerospike.SERIALIZER_USER)
+            self.delete_keys.append(key)
+
+            for _ in range(2):
+                _, _, bins = TestUserSerializer.client.get(key)
+                assert bins == {"a": {1}, "l": [{2}, {3}]}
+            # Kept views of bins and of list items stay readable.
+            assert len(views) == 6
+            assert all(pickle.loads(view) in ({1}, {2}, {3}) for view in views)
+        finally:
+            aerospike.unset_serializers()
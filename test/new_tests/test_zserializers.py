@@ -6,9 +6,12 @@ from aerospike import exception as e
 from aerospike_helpers.operations import operations
 from aerospike_helpers.expressions import base as expr
 
-import pytest
+import collections
+import enum
 import json
 
+import pytest
+
 import aerospike
 
 
@@ -443,3 +446,77 @@ class TestPythonSerializer(object):
             self.as_connection.get(self.test_key, {"expressions": exp})
 
         client.close()
+
+    def test_builtin_serializer_round_trip(self):
+        """
+        SERIALIZER_JSON stores the supported non native types without a
+        Python serializer and reads them back as the same types.
+        """
+        import datetime
+        import decimal
+        import uuid
+
+        tz = datetime.timezone(datetime.timedelta(hours=-5, minutes=-30))
+        record = {
+            "tuple": (1, "two", (3.0, None)),
+            "set": {1, 2, 3},
+            "frozen": frozenset(["a", "b"]),
+            "array": (bytearray(b"\x00\x01"),),
+            "when": datetime.datetime(2021, 3, 4, 5, 6, 7, 891011),
+            "aware": datetime.datetime(2021, 3, 4, 5, 6, 7, tzinfo=tz),
+            "day": datetime.date(1999, 12, 31),
+            "delta": datetime.timedelta(days=-2, seconds=5, microseconds=6),
+            "price": decimal.Decimal("-12.3400"),
+            "id": uuid.UUID("12345678-1234-5678-1234-567812345678"),
+            "big": (2**100, -(2**64)),
+            "nested": [{"key": (frozenset([1]), {decimal.Decimal("1.5")})}],
+        }
+
+        self.as_connection.put(self.test_key, record, serializer=aerospike.SERIALIZER_JSON)
+        _, _, bins = self.as_connection.get(self.test_key)
+
+        assert bins == record
+        for name, value in record.items():
+            assert type(bins[name]) is type(value)
+        assert bins["aware"].utcoffset() == tz.utcoffset(None)
+
+    def test_builtin_serializer_unsupported_type(self):
+        with pytest.raises(e.ClientError):
+            self.as_connection.put(
+                self.test_key, {"obj": (SomeClass(),)}, serializer=aerospike.SERIALIZER_JSON
+            )
+
+    @pytest.mark.parametrize(
+        "value",
+        [
+            collections.namedtuple("Point", "x y")(1, 2),
+            enum.IntEnum("Color", "RED")(1),
+            collections.OrderedDict(a=1),
+            collections.defaultdict(list, a=[1]),
+        ],
+        ids=["namedtuple", "IntEnum", "OrderedDict", "defaultdict"],
+    )
+    def test_builtin_serializer_rejects_subclasses(self, value):
+        """
+        Subclasses would come back as their base type, so they are refused.
+        """
+        with pytest.raises(e.ClientError):
+            self.as_connection.put(self.test_key, {"obj": (value,)}, serializer=aerospike.SERIALIZER_JSON)
+
+    def test_builtin_serializer_keeps_fold(self):
+        import datetime
+
+        tz = datetime.timezone(datetime.timedelta(hours=2))
+        record = {
+            "naive": (datetime.datetime(2021, 10, 31, 2, 30, fold=1),),
+            "aware": (datetime.datetime(2021, 10, 31, 2, 30, fold=1, tzinfo=tz),),
+            "unset": (datetime.datetime(2021, 10, 31, 2, 30),),
+        }
+
+        self.as_connection.put(self.test_key, record, serializer=aerospike.SERIALIZER_JSON)
+        _, _, bins = self.as_connection.get(self.test_key)
+
+        assert bins["naive"][0].fold == 1
+        assert bins["aware"][0].fold == 1
+        assert bins["unset"][0].fold == 0
+        assert bins == record